@@ -0,0 +1,107 @@
+/**
+ * @file bench_ring.cpp
+ * @brief Throughput of the builtin-to-builtin StreamBridge
+ *
+ * A producer thread pushes data through a bridge to a consumer thread, the
+ * way two builtin pipeline stages do. Three patterns are measured: raw ring
+ * writes/reads in 64 KiB blocks, stream write()/read() in 64 KiB blocks, and
+ * line-oriented operator<< / std::getline with 64-byte lines.
+ *
+ * Usage: bench_ring [MiB-per-run]
+ */
+
+#include "core/RingBuffer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using termidash::StreamBridge;
+
+namespace {
+
+const size_t blockSize = 64 * 1024;
+
+template <typename Producer, typename Consumer>
+double mibPerSecond(size_t total, Producer produce, Consumer consume) {
+    StreamBridge bridge;
+    size_t received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread writer([&]() {
+        produce(bridge, total);
+        bridge.closeWriter();
+    });
+    received = consume(bridge);
+    writer.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (received != total) {
+        std::fprintf(stderr, "lost data: sent %zu, received %zu\n", total, received);
+        std::exit(1);
+    }
+    return (total / double(1 << 20)) / elapsed.count();
+}
+
+double rawBlocks(size_t total) {
+    return mibPerSecond(total,
+        [](StreamBridge& bridge, size_t bytes) {
+            std::vector<char> block(blockSize, 'x');
+            for (size_t sent = 0; sent < bytes; sent += blockSize) {
+                bridge.buffer()->write(block.data(), std::min(blockSize, bytes - sent));
+            }
+        },
+        [](StreamBridge& bridge) {
+            std::vector<char> block(blockSize);
+            size_t received = 0;
+            while (size_t n = bridge.buffer()->read(block.data(), block.size())) received += n;
+            return received;
+        });
+}
+
+double streamBlocks(size_t total) {
+    return mibPerSecond(total,
+        [](StreamBridge& bridge, size_t bytes) {
+            std::vector<char> block(blockSize, 'x');
+            for (size_t sent = 0; sent < bytes; sent += blockSize) {
+                bridge.out().write(block.data(), std::min(blockSize, bytes - sent));
+            }
+        },
+        [](StreamBridge& bridge) {
+            std::vector<char> block(blockSize);
+            size_t received = 0;
+            while (bridge.in().read(block.data(), block.size()) || bridge.in().gcount() > 0) {
+                received += bridge.in().gcount();
+            }
+            return received;
+        });
+}
+
+double streamLines(size_t total) {
+    return mibPerSecond(total,
+        [](StreamBridge& bridge, size_t bytes) {
+            const std::string line(63, 'x');
+            for (size_t sent = 0; sent < bytes; sent += 64) {
+                bridge.out() << line << '\n';
+            }
+        },
+        [](StreamBridge& bridge) {
+            std::string line;
+            size_t received = 0;
+            while (std::getline(bridge.in(), line)) received += line.size() + 1;
+            return received;
+        });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    size_t total = mib << 20;
+
+    std::printf("%-28s %12s\n", "pattern", "MiB/s");
+    std::printf("%-28s %12.1f\n", "ring write/read 64 KiB", rawBlocks(total));
+    std::printf("%-28s %12.1f\n", "stream write/read 64 KiB", streamBlocks(total));
+    std::printf("%-28s %12.1f\n", "stream << / getline 64 B", streamLines(total));
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file bench_sort.cpp
+ * @brief The sort builtin against coreutils sort on generated input
+ *
+ * Writes a file of random lines (a word, a number and a float per line),
+ * then times the builtin and `LC_ALL=C sort` on it with the same options
+ * and memory budget, output going to /dev/null. A budget below the input
+ * size forces both through their external merge.
+ *
+ * Usage: bench_sort [input-MiB] [budget ...]
+ */
+
+#include "core/SortCommand.hpp"
+#include "core/FdStream.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using termidash::FdOutputStream;
+using termidash::SortCommand;
+
+namespace {
+
+void generate(const std::string& path, size_t bytes) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::perror(path.c_str());
+        std::exit(1);
+    }
+    std::mt19937_64 random(1);
+    std::string line;
+    for (size_t written = 0; written < bytes; written += line.size()) {
+        line.clear();
+        size_t length = 4 + random() % 12;
+        for (size_t i = 0; i < length; ++i) line += static_cast<char>('a' + random() % 26);
+        line += ' ' + std::to_string(random() % 1000000) + ' ' + std::to_string(random() % 100000) + '.' +
+                std::to_string(random() % 100) + '\n';
+        std::fwrite(line.data(), 1, line.size(), file);
+    }
+    std::fclose(file);
+}
+
+template <typename Fn>
+double seconds(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+double builtin(const std::vector<std::string>& options, const std::string& budget, const std::string& input) {
+    std::vector<std::string> args{"sort", "-S", budget};
+    args.insert(args.end(), options.begin(), options.end());
+    args.push_back(input);
+    long sink = PlatformUtils::openFileForWrite("/dev/null", false);
+    FdOutputStream out(sink);
+    ExecContext ctx(std::cin, out, std::cerr);
+    ctx.outFd = sink;
+    double elapsed = seconds([&]() {
+        if (SortCommand::run(args, ctx) != 0) std::exit(1);
+    });
+    PlatformUtils::closeFile(sink);
+    return elapsed;
+}
+
+double coreutils(const std::string& options, const std::string& budget, const std::string& input) {
+    std::string command = "LC_ALL=C sort -S " + budget + " " + options + " " + input + " > /dev/null";
+    return seconds([&]() {
+        if (std::system(command.c_str()) != 0) std::exit(1);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    std::vector<std::string> budgets;
+    for (int i = 2; i < argc; ++i) budgets.push_back(argv[i]);
+    if (budgets.empty()) budgets = {std::to_string(2 * mib) + "M", std::to_string(mib / 8 + 1) + "M"};
+
+    std::string input = (std::filesystem::temp_directory_path() / "termidash_bench_sort.txt").string();
+    generate(input, mib << 20);
+
+    // Each case as builtin words and as a shell command line
+    struct Case {
+        const char* name;
+        std::vector<std::string> words;
+        std::string shell;
+    };
+    const std::vector<Case> cases = {
+        {"lines", {}, ""},
+        {"-k2n", {"-k2n"}, "-k2n"},
+        {"-t' ' -k3nr", {"-t", " ", "-k3nr"}, "-t' ' -k3nr"},
+        {"-u -k1,1", {"-u", "-k1,1"}, "-u -k1,1"},
+    };
+
+    std::printf("%zu MiB input\n", mib);
+    std::printf("%-14s %8s %12s %12s %8s\n", "case", "budget", "builtin s", "coreutils s", "speedup");
+    for (const auto& budget : budgets) {
+        for (const auto& test : cases) {
+            double ours = builtin(test.words, budget, input);
+            double theirs = coreutils(test.shell, budget, input);
+            std::printf("%-14s %8s %12.2f %12.2f %7.2fx\n", test.name, budget.c_str(), ours, theirs, theirs / ours);
+        }
+    }
+    std::remove(input.c_str());
+    return 0;
+}
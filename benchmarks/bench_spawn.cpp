@@ -0,0 +1,63 @@
+/**
+ * @file bench_spawn.cpp
+ * @brief Spawns per second of LinuxProcessManager backends at several shell sizes
+ *
+ * fork() copies the parent's page tables, so its cost grows with the shell's
+ * resident set; posix_spawn does not. The benchmark grows its own RSS in
+ * steps and times spawn + wait of /bin/true with each backend.
+ *
+ * Usage: bench_spawn [spawns-per-run] [rss-MiB ...]
+ */
+
+#include "platform/linux/LinuxProcessManager.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using termidash::platform::linux_platform::LinuxProcessManager;
+using termidash::platform::linux_platform::SpawnBackend;
+
+static double spawnsPerSecond(LinuxProcessManager& manager, int count) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        long pid = manager.spawn("/bin/true", {}, false);
+        if (pid == -1) {
+            std::fprintf(stderr, "spawn failed: %s\n", manager.getLastError().c_str());
+            std::exit(1);
+        }
+        manager.wait(pid);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return count / elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 500;
+    std::vector<size_t> sizesMiB;
+    for (int i = 2; i < argc; ++i) sizesMiB.push_back(std::strtoul(argv[i], nullptr, 10));
+    if (sizesMiB.empty()) sizesMiB = {0, 64, 256, 1024};
+
+    LinuxProcessManager manager;
+    std::vector<std::vector<char>> ballast;
+    size_t current = 0;
+
+    std::printf("%10s %16s %16s %8s\n", "RSS MiB", "fork/s", "posix_spawn/s", "speedup");
+    for (size_t target : sizesMiB) {
+        // Grow the resident set by touching freshly allocated pages
+        if (target > current) {
+            ballast.emplace_back((target - current) << 20);
+            std::memset(ballast.back().data(), 1, ballast.back().size());
+            current = target;
+        }
+
+        manager.setBackend(SpawnBackend::Fork);
+        double forkRate = spawnsPerSecond(manager, count);
+        manager.setBackend(SpawnBackend::PosixSpawn);
+        double spawnRate = spawnsPerSecond(manager, count);
+
+        std::printf("%10zu %16.0f %16.0f %7.2fx\n", target, forkRate, spawnRate, spawnRate / forkRate);
+    }
+    return 0;
+}
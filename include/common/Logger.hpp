@@ -70,6 +70,12 @@ public:
    */
   static std::string getLogFilePath();
 
+  /**
+   * @brief Get the OS-specific cache directory (next to the log directory)
+   * @return Absolute path to cache directory
+   */
+  static std::string getCacheDirectory();
+
   /**
    * @brief Set the minimum log level
    */
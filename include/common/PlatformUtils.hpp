@@ -1,5 +1,9 @@
 #pragma once
 #include <string>
+#ifndef _WIN32
+#include <signal.h>
+#include <spawn.h>
+#endif
 
 namespace PlatformUtils {
 std::string getHistoryFilePath();
@@ -11,6 +15,70 @@ long openFileForRead(const std::string &path);
 long openFileForWrite(const std::string &path, bool append);
 void closeFile(long handle);
 
+// Read from a handle (file or pipe) until end of input, appending to out.
+// Returns false on a read error
+bool readAll(long handle, std::string &out);
+
+// The shell's standard input handle
+long standardInput();
+
+// The shell's standard error handle (not to be closed)
+long standardError();
+
+// Read up to size bytes from a handle. Returns the number read, 0 at end of
+// input, or -1 on error
+long readSome(long handle, char *buffer, size_t size);
+
+// Write all of data to a handle. Returns false on error (e.g. the reader of
+// a pipe has gone away)
+bool writeAll(long handle, const char *data, size_t size);
+
+// Copy everything left in one handle to another. Where the OS allows it the
+// data does not pass through user space (copy_file_range, sendfile or splice
+// on Linux); otherwise it is read and written in large blocks.
+// Returns false on a read or write error
+bool copyAll(long from, long to);
+
+// Make the file behind `to` share the data blocks of `from` (a reflink, on
+// Btrfs, XFS and other copy-on-write file systems). Returns false if the
+// file system or platform cannot, in which case nothing was changed
+bool cloneFile(long from, long to);
+
+// Make writes from the calling thread to a pipe without readers fail with an
+// error instead of raising SIGPIPE, which would terminate the shell.
+// No-op where there is no SIGPIPE
+void blockPipeSignal();
+
+// blockPipeSignal for the lifetime of the guard, for code running on a
+// shared thread: the previous mask is restored on destruction. A SIGPIPE
+// raised in between is discarded rather than delivered on restore
+class PipeSignalGuard {
+public:
+  PipeSignalGuard();
+  ~PipeSignalGuard();
+  PipeSignalGuard(const PipeSignalGuard &) = delete;
+  PipeSignalGuard &operator=(const PipeSignalGuard &) = delete;
+
+private:
+#ifndef _WIN32
+  sigset_t previous_;
+#endif
+};
+
+#ifndef _WIN32
+// Initialize posix_spawn attributes that start the child with an empty
+// signal mask and the default SIGPIPE action, whatever the spawning thread
+// has blocked or ignored. Returns false on failure; on success the caller
+// destroys attr with posix_spawnattr_destroy
+bool initSpawnAttributes(posix_spawnattr_t &attr);
+#endif
+
+// Readable handle whose contents are data (here-documents and here-strings).
+// Uses an anonymous memory file where available, otherwise a pipe that is fed
+// by a writer thread when data does not fit in the pipe buffer.
+// Returns -1 on failure
+long openMemoryForRead(const std::string &data);
+
 // Environment and Path
 std::string getEnv(const std::string &name);
 char getPathSeparator();
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace termidash {
+namespace ast {
+
+/**
+ * @brief Kind of a parsed shell statement
+ */
+enum class NodeKind {
+    Command,    // Simple command or pipeline, executed after runtime expansion
+    If,         // if <condition> ... [else ...] end
+    While,      // while <condition> ... end
+    For,        // for <var> in <items> ... end
+    Function    // function <name> ... end / name() { ... }
+};
+
+/**
+ * @brief What a redirection does, decoded once from its operator
+ */
+enum class RedirectKind : uint8_t {
+    Input,         // < file
+    HereDoc,       // << delimiter (body in Node::hereDoc)
+    HereString,    // <<< word
+    Output,        // > file, 1> file
+    Append,        // >> file, 1>> file
+    Error,         // 2> file
+    ErrorAppend,   // 2>> file
+    Both,          // &> file, >& file
+    BothAppend,    // &>> file
+    ErrorToOutput, // 2>&1
+    OutputToError, // >&2, 1>&2
+    None           // 1>&1, 2>&2: the descriptor already points there
+};
+
+/**
+ * @brief A redirection of a pipeline stage
+ */
+struct Redirection {
+    RedirectKind kind = RedirectKind::Output;
+    std::string target; // Raw target word, quotes kept; empty for ErrorToOutput/OutputToError
+};
+
+/**
+ * @brief One pipeline stage: its words and redirections
+ */
+struct Stage {
+    std::vector<std::string> words;        // Raw words, quotes kept
+    std::vector<Redirection> redirections;
+    bool trimAfter = false;                // Joined to the next stage by |>
+};
+
+/**
+ * @brief A lexed statement: pipeline stages, optionally run in the background
+ */
+struct Pipeline {
+    std::vector<Stage> stages;
+    bool background = false; // Ended with &
+};
+
+/**
+ * @brief A single statement of a parsed script or interactive block
+ *
+ * Structure (batch splitting, keyword detection, block nesting, here-document
+ * bodies, and the pipeline stages, words and redirections of each command) is
+ * resolved once by ScriptParser. Only the words themselves are expanded at
+ * execution time.
+ */
+struct Node {
+    NodeKind kind = NodeKind::Command;
+    std::string text;           // Command: command line; If/While: condition; Function: name
+    Pipeline pipeline;          // Command: the statement; If/While: the condition
+    std::string separator;      // Separator after this statement: "", ";", "&&" or "||"
+    std::string loopVar;        // For: iteration variable
+    std::vector<std::string> items; // For: raw item words
+    std::string hereDoc;        // Command: collected here-document body
+    bool hasHereDoc = false;    // Command: true if text contains a << redirection
+    std::vector<Node> body;     // Block body (then-branch for If)
+    std::vector<Node> elseBody; // Else branch (If only)
+    std::vector<std::string> source; // Function: raw body statements for FunctionManager
+};
+
+using NodeList = std::vector<Node>;
+
+} // namespace ast
+} // namespace termidash
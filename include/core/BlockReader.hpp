@@ -0,0 +1,69 @@
+#pragma once
+#include "core/ExecContext.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief Input for line-oriented builtins, delivered in blocks of whole lines
+ *
+ * Regular files are memory-mapped where possible and handed out as a
+ * single block; anything else (pipes, streams, the shell's input) is read
+ * in blocks of at least 256 KiB. Each block ends at a newline except the
+ * last one of the input, so callers can find lines with memchr without
+ * handling lines split across blocks.
+ */
+class BlockReader {
+public:
+    /**
+     * @brief Read a command's input (ctx.in, or its handle)
+     */
+    explicit BlockReader(ExecContext& ctx);
+
+    /**
+     * @brief Read a file; check ok() before use
+     */
+    explicit BlockReader(const std::string& path);
+
+    ~BlockReader();
+
+    BlockReader(const BlockReader&) = delete;
+    BlockReader& operator=(const BlockReader&) = delete;
+
+    bool ok() const { return ok_; }
+
+    /**
+     * @brief Next block of whole lines; false at end of input
+     *
+     * The view stays valid until the next call.
+     */
+    bool next(std::string_view& block);
+
+    /**
+     * @brief The last n lines of the input (n = 0 gives nothing)
+     *
+     * Mapped files are scanned backwards from the end, so only the tail is
+     * touched; other input is read through, keeping only the blocks that
+     * can still hold one of the last n lines.
+     */
+    std::string_view lastLines(size_t n);
+
+private:
+    size_t fill(char* buffer, size_t size);
+
+    ExecContext* ctx_ = nullptr;
+    long handle_ = -1;
+    bool ok_ = true;
+    bool done_ = false;
+    const char* map_ = nullptr;
+    size_t mapSize_ = 0;
+    std::vector<char> buffer_;
+    size_t carried_ = 0; // partial line kept at the front of buffer_
+    size_t pending_ = 0; // bytes of buffer_ handed out by the last next()
+    std::string tail_;
+};
+
+} // namespace termidash
@@ -24,6 +24,7 @@ public:
     
     /**
      * Check if the input contains any brace expansion patterns.
+     * {} and braces without a comma or range are literal, not patterns.
      */
     static bool hasBraces(const std::string& input);
     
@@ -34,6 +35,18 @@ private:
      */
     static size_t findMatchingBrace(const std::string& str, size_t openPos);
     
+    /**
+     * Find the first brace pair holding a comma list or range.
+     * @param closePos Set to the position of the matching }
+     * @return Position of { or std::string::npos if there is none
+     */
+    static size_t findExpansion(const std::string& str, size_t& closePos);
+    
+    /**
+     * Check if content has a comma outside any nested braces.
+     */
+    static bool hasTopLevelComma(const std::string& content);
+    
     /**
      * Expand a single brace expression (comma list or range).
      * @param prefix Text before the brace
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief Process-wide pool of pipeline bridge buffers
+ *
+ * Bridges between builtin pipeline stages take their ring storage from here
+ * and give it back when the pipeline finishes, so repeated pipelines reuse
+ * memory instead of allocating per stage. Blocks are power-of-two sized; the
+ * pool keeps at most retainLimit bytes of free blocks.
+ *
+ * The sizing policy (shell option "pipebuf", see `set -o`) decides how big a
+ * new bridge starts and how far it may grow under backpressure.
+ */
+class BufferPool {
+public:
+    using Block = std::unique_ptr<char[]>;
+
+    /**
+     * @brief Bridge sizing: initial ring size and growth cap, in bytes
+     */
+    struct Policy {
+        size_t initial = 4 * 1024;
+        size_t max = 1024 * 1024;
+    };
+
+    static constexpr size_t retainLimit = 8 * 1024 * 1024;
+
+    static BufferPool& instance();
+
+    /**
+     * @brief A block of exactly size bytes (reused if one is free)
+     */
+    Block acquire(size_t size);
+
+    /**
+     * @brief Return a block obtained from acquire()
+     */
+    void release(Block block, size_t size);
+
+    /**
+     * @brief Bytes held in free blocks
+     */
+    size_t pooledBytes() const;
+
+    /**
+     * @brief Free all pooled blocks
+     */
+    void clear();
+
+    Policy policy() const;
+    void setPolicy(const Policy& policy);
+
+    /**
+     * @brief Parse "INITIAL:MAX" with optional K/M/G suffixes (e.g. "4K:1M")
+     * @return false if the text is malformed or INITIAL > MAX
+     */
+    static bool parsePolicy(const std::string& text, Policy& out);
+    static std::string formatPolicy(const Policy& policy);
+
+private:
+    BufferPool() = default;
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    mutable std::mutex mutex_;
+    std::map<size_t, std::vector<Block>> free_;
+    size_t pooledBytes_ = 0;
+    Policy policy_;
+};
+
+} // namespace termidash
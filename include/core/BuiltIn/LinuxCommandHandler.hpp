@@ -3,7 +3,11 @@
 
 #include <string>
 #include <vector>
+#include <ctime>
+#include <cstdint>
 #include "core/ExecContext.hpp"
+#include "core/DirectoryReader.hpp"
+#include "core/TreeCopier.hpp"
 
 namespace termidash {
 
@@ -11,14 +15,19 @@ namespace termidash {
  * LinuxCommandHandler - Implements Linux-specific built-in commands
  * 
  * Commands:
- *   ls    - Directory listing with -l, -a, -h, -R options
- *   cp    - Copy files/directories with -r, -f options
- *   mv    - Move/rename files
- *   chmod - Change file permissions
- *   chown - Change file ownership
- *   ln    - Create links (-s for symbolic)
- *   df    - Disk space usage
+ *   ls    - Directory listing with -l, -a, -h, -R options (-R lists
+ *           subdirectories on worker threads, output in serial order)
+ *   cp    - Copy files/directories with -r, -f, --progress options
+ *           (reflink or copy_file_range, trees copied in parallel)
+ *   mv    - Move/rename files (copy and remove across file systems)
+ *   chmod - Change file permissions (octal or symbolic modes, -R)
+ *   chown - Change file ownership (-R)
+ *   ln    - Create links (-s for symbolic, -f to replace)
+ *   df    - Disk space usage, optionally of the file systems given
  *   free  - Memory usage
+ *   du    - Tree sizes with -s, -h, -d N, --apparent-size options
+ *           (directories scanned in parallel, hard links counted once)
+ *   find  - Parallel directory search (see FindCommand)
  */
 class LinuxCommandHandler {
 public:
@@ -29,7 +38,7 @@ public:
     
     /**
      * Handle a command with execution context for I/O.
-     * @return Exit code (0 = success)
+     * @return Exit code (0 = success), -1 if the command is not handled here
      */
     int handleWithContext(const std::vector<std::string>& tokens, ExecContext& ctx);
     
@@ -48,8 +57,30 @@ private:
     int handleLn(const std::vector<std::string>& args, ExecContext& ctx);
     int handleDf(const std::vector<std::string>& args, ExecContext& ctx);
     int handleFree(const std::vector<std::string>& args, ExecContext& ctx);
+    int handleDu(const std::vector<std::string>& args, ExecContext& ctx);
     
+    // ls helpers
+    struct LsOptions {
+        bool longFormat = false;
+        bool showHidden = false;
+        bool humanReadable = false;
+        bool recursive = false;
+    };
+    struct LsItem {
+        std::string name;
+        EntryType type = EntryType::Unknown;
+        FileStat info;
+        bool statted = false;
+        std::string target; // symlink target under -l
+    };
+    std::string listDirectory(const std::string& path, const LsOptions& options,
+                              std::vector<std::string>& subdirs, std::string& errors) const;
+    void listTree(const std::string& root, const LsOptions& options, std::string& out, bool& first,
+                  ExecContext& ctx, bool& ok) const;
+    void appendEntries(std::string& out, int dirFd, std::vector<LsItem>& items, const LsOptions& options) const;
+
     // Helper functions
+    std::string formatProgress(const TreeCopier::Progress& progress) const;
     std::string formatSize(uintmax_t bytes, bool humanReadable) const;
     std::string formatPermissions(unsigned int mode) const;
     std::string formatTime(std::time_t time) const;
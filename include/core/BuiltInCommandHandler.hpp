@@ -4,6 +4,8 @@
 #include "core/BuiltIn/CommonCommandHandler.hpp"
 #ifdef PLATFORM_WINDOWS
 #include "core/BuiltIn/WindowsCommandHandler.hpp"
+#else
+#include "core/BuiltIn/LinuxCommandHandler.hpp"
 #endif
 #include "core/ExecContext.hpp"
 #include "core/Environment.hpp"
@@ -15,6 +17,7 @@ public:
     BuiltInCommandHandler();
     bool handleCommand(const std::string& input);
     int handleCommandWithContext(const std::string& input, ExecContext& ctx);
+    int handleCommandWithContext(const std::string& input, const std::vector<std::string>& tokens, ExecContext& ctx);
     const std::vector<std::string>& getHistory() const;
     std::vector<std::string> tokenize(const std::string& input) const;
     bool isBuiltInCommand(const std::string &input) const;
@@ -22,6 +25,8 @@ public:
     CommonCommandHandler commonHandler;
 #ifdef PLATFORM_WINDOWS
     WindowsCommandHandler windowsHandler;
+#else
+    LinuxCommandHandler linuxHandler;
 #endif
 };
 
@@ -0,0 +1,99 @@
+#pragma once
+#include "core/Ast.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace termidash {
+namespace bytecode {
+
+/**
+ * @brief Operations understood by ScriptVM
+ *
+ * The VM has a command register (the expanded stages of the statement being
+ * built), a status register and a loop stack. Operands a/b are string pool,
+ * stage table, jump target or function table indices depending on the
+ * opcode. Exec, Run and ForInit consume the register, as does Call when it
+ * calls a function.
+ */
+enum class OpCode : uint8_t {
+    Stage,      // append expand(stages[a]) to reg; b = 1 for a word list (no aliases)
+    Call,       // if reg names a shell function: call it, then continue at a
+    Exec,       // status = execute reg; a = here-doc string or NoOperand, b = 1 in the background
+    Run,        // status = run reg as a plain command/pipeline (conditions)
+    Jump,       // pc = a
+    JumpIfFail, // if status != 0: pc = a
+    JumpIfOk,   // if status == 0: pc = a
+    SetStatus,  // status = a
+    LoopInit,   // push a while-loop frame (with iteration guard)
+    LoopNext,   // next while iteration; pc = a when the guard is exhausted
+    ForInit,    // push a for-loop frame over the words of reg
+    ForNext,    // strings[a] = next item, or pc = b when exhausted
+    EndLoop,    // pop loop frame, status = status of the last body run
+    Define,     // register functions[a]
+    Halt        // end of chunk (return from function)
+};
+
+constexpr uint32_t NoOperand = 0xFFFFFFFFu;
+
+struct Instruction {
+    OpCode op;
+    uint32_t a = NoOperand;
+    uint32_t b = NoOperand;
+};
+
+struct Chunk;
+
+/**
+ * @brief A function definition compiled alongside its enclosing chunk
+ */
+struct FunctionDef {
+    uint32_t name = NoOperand;          // string pool index
+    std::vector<uint32_t> source;       // raw body lines (string pool indices)
+    std::shared_ptr<const Chunk> body;  // compiled body
+};
+
+/**
+ * @brief Compiled script: flat instruction stream plus constant pools
+ *
+ * Pipeline stages are stored already parsed; only their words are expanded
+ * when they run.
+ */
+struct Chunk {
+    std::vector<Instruction> code;
+    std::vector<std::string> strings;
+    std::vector<ast::Stage> stages;
+    std::vector<FunctionDef> functions;
+};
+
+/**
+ * @brief Human-readable listing of a chunk (for debugging and tests)
+ */
+std::string disassemble(const Chunk& chunk);
+
+/**
+ * @brief Mnemonic of an opcode
+ */
+const char* opName(OpCode op);
+
+/**
+ * @brief Flatten a chunk, including nested function bodies, into bytes
+ *
+ * Integers are stored in host byte order; the result is meant for the
+ * script cache and precompiled .tdc files, not as an interchange format.
+ */
+std::string serialize(const Chunk& chunk);
+
+/**
+ * @brief Rebuild a chunk from serialize() output
+ *
+ * Every operand is bounds-checked against the decoded pools so a truncated
+ * or corrupted buffer is rejected instead of being handed to the VM.
+ * @return false if the data is malformed
+ */
+bool deserialize(const char* data, size_t size, Chunk& chunk);
+
+} // namespace bytecode
+} // namespace termidash
@@ -0,0 +1,45 @@
+#pragma once
+#include "core/Ast.hpp"
+#include "core/Bytecode.hpp"
+#include <string>
+#include <unordered_map>
+
+namespace termidash {
+
+/**
+ * @brief Lowers a parsed statement list into ScriptVM bytecode
+ *
+ * Control flow becomes jumps and loop ops, each command becomes a
+ * Stage.../Call/Exec sequence over its parsed pipeline stages, and function
+ * bodies are compiled into their own chunks referenced from the function
+ * table.
+ */
+class BytecodeCompiler {
+public:
+    /**
+     * @brief Revision of the parser and compiler output, stored with cached
+     * and precompiled chunks. Bump it whenever ScriptParser or this compiler
+     * would produce different bytecode for the same source.
+     */
+    static constexpr uint32_t Revision = 4;
+
+    /**
+     * @brief Compile statements into a self-contained chunk
+     */
+    static bytecode::Chunk compile(const ast::NodeList& nodes);
+
+private:
+    explicit BytecodeCompiler(bytecode::Chunk& chunk) : chunk_(chunk) {}
+
+    uint32_t intern(const std::string& s);
+    uint32_t emit(bytecode::OpCode op, uint32_t a = bytecode::NoOperand, uint32_t b = bytecode::NoOperand);
+    uint32_t here() const;
+    void compileStages(const ast::Pipeline& pipeline, bool command = true);
+    void compileList(const ast::NodeList& nodes);
+    void compileNode(const ast::Node& node);
+
+    bytecode::Chunk& chunk_;
+    std::unordered_map<std::string, uint32_t> stringIndex_;
+};
+
+} // namespace termidash
@@ -0,0 +1,116 @@
+#pragma once
+#ifndef _WIN32 // POSIX only
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief What a stat call should fetch; fields not asked for are left zero
+ */
+enum StatField : unsigned {
+    StatType = 1 << 0,
+    StatMode = 1 << 1,   // permission and set-id bits (implies StatType)
+    StatLinks = 1 << 2,
+    StatOwner = 1 << 3,  // uid and gid
+    StatSize = 1 << 4,
+    StatBlocks = 1 << 5, // 512-byte blocks allocated
+    StatMTime = 1 << 6,
+    StatIdentity = 1 << 7, // device and inode
+    StatATime = 1 << 8,
+};
+
+/**
+ * @brief Kind of a directory entry
+ */
+enum class EntryType : uint8_t { Unknown, Regular, Directory, Symlink, Other };
+
+struct FileStat {
+    EntryType type = EntryType::Unknown;
+    uint32_t mode = 0; // full st_mode
+    uint64_t links = 0;
+    uint32_t uid = 0;
+    uint32_t gid = 0;
+    uint64_t size = 0;
+    uint64_t blocks = 0;
+    int64_t mtime = 0;
+    uint32_t mtimeNsec = 0;
+    int64_t atime = 0;
+    uint32_t atimeNsec = 0;
+    uint64_t device = 0;
+    uint64_t inode = 0;
+};
+
+/**
+ * @brief Entries of one directory, read in large batches
+ *
+ * On Linux getdents64 fills a 64 KiB buffer per system call; elsewhere
+ * readdir is used. Entries carry the type from d_type when the file system
+ * reports it, so callers only need a stat for the details they print.
+ * "." and ".." are skipped.
+ */
+class DirectoryReader {
+public:
+    struct Entry {
+        std::string_view name; // valid until the next call to next()
+        EntryType type = EntryType::Unknown;
+        uint64_t inode = 0;
+    };
+
+    explicit DirectoryReader(const std::string& path);
+
+    /**
+     * @brief Open name relative to an open directory (without following a
+     *        final symlink)
+     */
+    DirectoryReader(int parentFd, const std::string& name);
+
+    ~DirectoryReader();
+
+    DirectoryReader(const DirectoryReader&) = delete;
+    DirectoryReader& operator=(const DirectoryReader&) = delete;
+
+    /**
+     * @brief False if the directory could not be opened; see error()
+     */
+    bool ok() const { return fd_ != -1; }
+
+    /**
+     * @brief errno of the failed open or read, 0 if none
+     */
+    int error() const { return error_; }
+
+    /**
+     * @brief Handle of the open directory, for the *at() calls
+     */
+    int fd() const { return fd_; }
+
+    /**
+     * @brief Next entry; false at the end of the directory or on error
+     */
+    bool next(Entry& entry);
+
+    /**
+     * @brief Stat name relative to dirFd without following a final symlink
+     * @param fields StatField bits wanted; with statx only those are fetched
+     * @return false with errno set if the lookup failed
+     */
+    static bool statAt(int dirFd, const char* name, unsigned fields, FileStat& info, bool followLinks = false);
+
+private:
+    void open(int parentFd, const char* path, bool noFollow);
+
+    int fd_ = -1;
+    int error_ = 0;
+    void* dir_ = nullptr; // DIR* for the readdir fallback
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t filled_ = 0;
+};
+
+} // namespace termidash
+
+#endif // _WIN32
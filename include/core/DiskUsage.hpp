@@ -0,0 +1,104 @@
+#pragma once
+#ifndef _WIN32 // POSIX only
+
+#include "core/DirectoryReader.hpp"
+#include "core/WorkerPool.hpp"
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief Tree sizes for du
+ *
+ * Directories are scanned by a WorkStealingGroup, one task per directory.
+ * A task adds up its files in a local sum and adds that to its directory
+ * once, so workers do not contend on shared counters. A directory's total
+ * is complete when its own scan and every subdirectory are done; it is
+ * then reported and added to its parent. Totals therefore merge bottom-up,
+ * and a directory is always reported after its subdirectories.
+ *
+ * A file with several hard links is counted once. Its (device, inode) pair
+ * goes into a set split into shards, each with its own lock. The set is
+ * kept across measure() calls, as du does across its operands.
+ */
+class DiskUsage {
+public:
+    struct Options {
+        bool apparentSize = false; // st_size instead of allocated blocks
+        int maxDepth = INT_MAX;    // deepest directory reported; operands are depth 0
+        size_t workers = 0;        // 0: one per core
+    };
+
+    /**
+     * @brief Receives a directory (or operand) and its size in bytes
+     *
+     * Calls are serialized. Return false to stop the walk.
+     */
+    using Report = std::function<bool(const std::string& path, uint64_t bytes)>;
+
+    DiskUsage(Options options, Report report);
+
+    /**
+     * @brief Measure one operand; it is reported last, whatever maxDepth is
+     * @return Its total size in bytes
+     */
+    uint64_t measure(const std::string& path);
+
+    /**
+     * @brief Messages for paths that could not be read, e.g.
+     *        "cannot read directory 'x': Permission denied"
+     */
+    const std::vector<std::string>& errors() const { return errors_; }
+
+private:
+    struct Directory {
+        std::string path;
+        std::shared_ptr<Directory> parent;
+        int depth = 0;
+        std::atomic<uint64_t> total{0};
+        std::atomic<size_t> pending{1}; // its own scan plus unfinished subdirectories
+    };
+
+    struct LinkKey {
+        uint64_t device;
+        uint64_t inode;
+        bool operator==(const LinkKey& other) const { return device == other.device && inode == other.inode; }
+    };
+    struct LinkKeyHash {
+        size_t operator()(const LinkKey& key) const {
+            return std::hash<uint64_t>()(key.inode * 0x9E3779B97F4A7C15ull ^ key.device);
+        }
+    };
+    struct LinkShard {
+        std::mutex mutex;
+        std::unordered_set<LinkKey, LinkKeyHash> seen;
+    };
+
+    static const size_t linkShards = 64;
+
+    uint64_t charge(const FileStat& info);
+    void scan(const std::shared_ptr<Directory>& directory);
+    void finish(std::shared_ptr<Directory> directory);
+    void fail(const std::string& message, int error);
+
+    Options options_;
+    Report report_;
+    WorkStealingGroup group_;
+    std::array<LinkShard, linkShards> links_;
+    std::mutex mutex_; // guards report_, errors_ and total_
+    std::vector<std::string> errors_;
+    uint64_t total_ = 0;
+};
+
+} // namespace termidash
+
+#endif // _WIN32
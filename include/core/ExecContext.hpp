@@ -1,10 +1,53 @@
 #pragma once
+#include "common/PlatformUtils.hpp"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <string_view>
 
 struct ExecContext {
     std::istream& in;
     std::ostream& out;
     std::ostream& err;
+    // Set when nobody will read this command's output any more
+    const std::atomic<bool>* cancel = nullptr;
+    // OS handles behind in and out when they are files or pipes, -1 otherwise.
+    // Not owned; they let builtins move data in blocks or between handles
+    long inFd = -1;
+    long outFd = -1;
     ExecContext(std::istream& inStream, std::ostream& outStream, std::ostream& errStream)
         : in(inStream), out(outStream), err(errStream) {}
+
+    // Long-running builtins check this and stop early: the next pipeline
+    // stage has exited or a write already failed (EPIPE)
+    bool cancelled() const {
+        return out.bad() || (cancel && cancel->load(std::memory_order_relaxed));
+    }
+
+    // Read up to size bytes of input, blocking until some is available.
+    // Data already buffered in `in` comes first. Returns 0 at end of input
+    size_t read(char* buffer, size_t size) {
+        std::streambuf* buf = in.rdbuf();
+        std::streamsize avail = buf->in_avail();
+        if (avail <= 0 && inFd != -1) {
+            long n = PlatformUtils::readSome(inFd, buffer, size);
+            return n > 0 ? static_cast<size_t>(n) : 0;
+        }
+        if (avail <= 0) {
+            if (std::istream::traits_type::eq_int_type(buf->sgetc(), std::istream::traits_type::eof())) return 0;
+            avail = std::max<std::streamsize>(buf->in_avail(), 1);
+        }
+        return static_cast<size_t>(buf->sgetn(buffer, std::min(avail, static_cast<std::streamsize>(size))));
+    }
+
+    // Write a block of output, straight to the handle when there is one.
+    // Returns false once output has failed
+    bool write(const char* data, size_t size) {
+        if (outFd == -1) return static_cast<bool>(out.write(data, static_cast<std::streamsize>(size)));
+        if (!out.flush()) return false;
+        if (PlatformUtils::writeAll(outFd, data, size)) return true;
+        out.setstate(std::ios::badbit);
+        return false;
+    }
+    bool write(std::string_view data) { return write(data.data(), data.size()); }
 };
@@ -0,0 +1,102 @@
+#pragma once
+#include "common/PlatformUtils.hpp"
+#include <streambuf>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace termidash {
+
+// FdInputBuf: buffered reads from an OS handle (file or pipe).
+// The handle is not owned and must outlive the buffer.
+class FdInputBuf : public std::streambuf {
+public:
+    explicit FdInputBuf(long handle, size_t bufferSize = 64 * 1024)
+        : handle_(handle), buffer_(bufferSize) {
+        setg(buffer_.data(), buffer_.data(), buffer_.data());
+    }
+protected:
+    int_type underflow() override {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        long n = PlatformUtils::readSome(handle_, buffer_.data(), buffer_.size());
+        if (n <= 0) return traits_type::eof();
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+        return traits_type::to_int_type(*gptr());
+    }
+private:
+    long handle_;
+    std::vector<char> buffer_;
+};
+
+// FdOutputBuf: buffered writes to an OS handle (file or pipe).
+// Once a write fails (e.g. the reading end of a pipe was closed) all further
+// output is refused, which sets badbit on the owning stream.
+class FdOutputBuf : public std::streambuf {
+public:
+    explicit FdOutputBuf(long handle, size_t bufferSize = 64 * 1024)
+        : handle_(handle), buffer_(bufferSize) {
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+    ~FdOutputBuf() override { sync(); }
+    bool failed() const { return failed_; }
+protected:
+    int_type overflow(int_type ch) override {
+        if (!flushBuffer()) return traits_type::eof();
+        if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+    // Large blocks bypass the buffer
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        if (n < epptr() - pptr()) return std::streambuf::xsputn(s, n);
+        if (!flushBuffer() || !PlatformUtils::writeAll(handle_, s, static_cast<size_t>(n))) {
+            failed_ = true;
+            return 0;
+        }
+        return n;
+    }
+    int sync() override { return flushBuffer() ? 0 : -1; }
+private:
+    bool flushBuffer() {
+        size_t pending = static_cast<size_t>(pptr() - pbase());
+        if (failed_) {
+            pbump(-static_cast<int>(pending));
+            return false;
+        }
+        if (pending > 0 && !PlatformUtils::writeAll(handle_, pbase(), pending)) failed_ = true;
+        pbump(-static_cast<int>(pending));
+        return !failed_;
+    }
+
+    long handle_;
+    std::vector<char> buffer_;
+    bool failed_ = false;
+};
+
+// FdInputStream: istream reading from an OS handle
+class FdInputStream : public std::istream {
+public:
+    explicit FdInputStream(long handle) : std::istream(nullptr), buf_(handle) { rdbuf(&buf_); }
+private:
+    FdInputBuf buf_;
+};
+
+// The shell's standard input as one buffered stream shared by every builtin
+// that reads it, so input read ahead for one command (e.g. `read`) is still
+// there for the next. Never destroyed: it may be in use at exit
+inline FdInputStream& shellInput() {
+    static FdInputStream* stream = new FdInputStream(PlatformUtils::standardInput());
+    return *stream;
+}
+
+// FdOutputStream: ostream writing to an OS handle, flushed on destruction
+class FdOutputStream : public std::ostream {
+public:
+    explicit FdOutputStream(long handle) : std::ostream(nullptr), buf_(handle) { rdbuf(&buf_); }
+    bool failed() const { return buf_.failed(); }
+private:
+    FdOutputBuf buf_;
+};
+
+} // namespace termidash
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef _WIN32 // POSIX only
+
+#include "core/ExecContext.hpp"
+#include <string>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief The find builtin
+ *
+ * find [path...] [expression]
+ *
+ * The walk runs on a WorkStealingGroup. Each directory is one task: it
+ * reads its entries with DirectoryReader (getdents64 and d_type on Linux)
+ * and queues its subdirectories, so every core can read a wide tree. An
+ * entry is only stat'ed when a test needs more than its type.
+ *
+ * The expression is compiled once into a predicate tree. Each -name and
+ * -path pattern is classified in advance. Literals, prefixes, suffixes and
+ * infixes are compared directly; only real globs go through
+ * GlobExpander::matchPattern.
+ *
+ * Supported:
+ * - Tests: -name, -path, -type [fdlpsbc], -size [+-]N[cwbkMG],
+ *   -mtime [+-]N, -true, -false
+ * - Actions: -print, -print0, -prune, -exec cmd {} ; and -exec cmd {} +.
+ *   The + form batches paths up to ARG_MAX.
+ * - Options: -maxdepth N, -mindepth N
+ * - Operators: ( ), !, -not, -a, -and, -o, -or. Adjacent terms are joined
+ *   by an implied -a.
+ *
+ * Output is written as each directory finishes, or every 64 KiB. It
+ * streams, but directories are not listed in a fixed order.
+ */
+class FindCommand {
+public:
+    /**
+     * @param args Command words including "find"
+     * @return 0 on success, 1 if a path could not be read, a command run by
+     *         -exec ... + failed, or the expression was invalid
+     */
+    static int run(const std::vector<std::string>& args, ExecContext& ctx);
+};
+
+} // namespace termidash
+
+#endif // _WIN32
@@ -1,6 +1,8 @@
 #pragma once
+#include "core/Bytecode.hpp"
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace termidash {
@@ -10,8 +12,13 @@ public:
     static FunctionManager& instance();
 
     void define(const std::string& name, const std::vector<std::string>& body);
+    // Define with a compiled body so calls skip re-parsing
+    void define(const std::string& name, const std::vector<std::string>& body,
+                std::shared_ptr<const bytecode::Chunk> compiled);
     bool has(const std::string& name) const;
     const std::vector<std::string>& getBody(const std::string& name) const;
+    // Compiled body, or nullptr if the function was defined from source lines only
+    std::shared_ptr<const bytecode::Chunk> getCompiled(const std::string& name) const;
     void unset(const std::string& name);
     std::map<std::string, std::vector<std::string>> getAll() const;
 
@@ -22,6 +29,7 @@ private:
     FunctionManager& operator=(const FunctionManager&) = delete;
 
     std::map<std::string, std::vector<std::string>> functions;
+    std::map<std::string, std::shared_ptr<const bytecode::Chunk>> compiledFunctions;
 };
 
 } // namespace termidash
@@ -32,8 +32,7 @@ public:
      * Expand multiple tokens, handling globs in each.
      */
     static std::vector<std::string> expandTokens(const std::vector<std::string>& tokens);
-    
-private:
+
     /**
      * Match a pattern against a string.
      * @param pattern The glob pattern
@@ -42,6 +41,7 @@ private:
      */
     static bool matchPattern(const std::string& pattern, const std::string& str);
     
+private:
     /**
      * Match a character class pattern like [abc] or [a-z].
      * @return Number of characters consumed from pattern, 0 if no match
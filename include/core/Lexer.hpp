@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief Kinds of token produced by the Lexer
+ */
+enum class TokenKind : uint8_t {
+    Word,       // Command word (quotes, $(...), `...` and ((...)) kept inside)
+    AndIf,      // &&
+    OrIf,       // ||
+    Semicolon,  // ;
+    Pipe,       // |
+    TrimPipe,   // |>
+    Background, // &
+    Redirect    // <, <<, <<<, >, >>, N>, N>>, N>&M, >&, &>, &>>
+};
+
+/**
+ * @brief One token, viewing the text of the line it was lexed from
+ *
+ * Tokens never own memory: the line must outlive them.
+ */
+struct Token {
+    TokenKind kind = TokenKind::Word;
+    std::string_view text;
+    bool quoted = false; // Word contains quote characters (see Lexer::unquote)
+};
+
+/**
+ * @brief Single-pass shell lexer shared by every parsing stage
+ *
+ * Splits a line into words and operators in one scan. Both quote types are
+ * honoured, and command substitutions ($(...), `...`) and arithmetic
+ * ((...)) stay inside a single word, so operators within them do not split
+ * the line. Between a [[ that starts a command and its ]], && || < and >
+ * are words for the test command. Backslash is not an escape character,
+ * which keeps Windows paths intact.
+ */
+class Lexer {
+public:
+    /**
+     * @brief Lex a line into tokens
+     */
+    static std::vector<Token> lex(std::string_view line);
+
+    /**
+     * @brief Lex a line, appending to an existing token buffer
+     */
+    static void lex(std::string_view line, std::vector<Token>& out);
+
+    /**
+     * @brief Remove quote characters from a word
+     */
+    static std::string unquote(std::string_view word);
+
+    /**
+     * @brief Text of a token with quotes removed (copies only when quoted)
+     */
+    static std::string value(const Token& token);
+
+    /**
+     * @brief Lex a line and return every token's value (argv style)
+     */
+    static std::vector<std::string> words(std::string_view line);
+
+    /**
+     * @brief Source text from the start of one token to the end of another
+     */
+    static std::string_view span(const Token& first, const Token& last);
+
+    /**
+     * @brief Trim whitespace from both ends of a view
+     */
+    static std::string_view trim(std::string_view s);
+};
+
+} // namespace termidash
@@ -1,4 +1,6 @@
 #pragma once
+#include "core/Ast.hpp"
+#include "core/Lexer.hpp"
 #include <string>
 #include <vector>
 #include <utility>
@@ -9,6 +11,8 @@ namespace termidash {
  * @brief Shell command parser utilities
  * 
  * This module handles tokenization, redirection parsing, and batch command splitting.
+ * All of them consume the token stream produced by Lexer, so quoting and
+ * operators are interpreted the same way at every stage.
  */
 class Parser {
 public:
@@ -24,7 +28,7 @@ public:
     static std::vector<std::pair<std::string, std::string>> splitBatch(const std::string& input);
 
     /**
-     * @brief Tokenize a command respecting quotes
+     * @brief Tokenize a command respecting quotes (quotes are removed)
      */
     static std::vector<std::string> tokenize(const std::string& cmd);
 
@@ -40,6 +44,11 @@ public:
         bool appendErr = false;   // True if 2>> instead of 2>
         std::string hereDocDelim; // Delimiter for <<
         bool isHereDoc = false;   // True if << present
+        std::string hereString;   // Word after <<<
+        bool isHereString = false; // True if <<< present
+        bool errToOut = false;    // True for 2>&1
+        bool outToErr = false;    // True for >&2 and 1>&2
+        std::vector<std::string> args; // Command words with quotes removed
     };
 
     /**
@@ -47,6 +56,42 @@ public:
      */
     static RedirectionInfo parseRedirection(const std::string& cmd);
 
+    /**
+     * @brief Parse redirections from an already lexed token range
+     * @param oneLine True if the tokens view a single line; expanded words
+     *        live in separate buffers and the command text is rebuilt instead
+     */
+    static RedirectionInfo parseRedirection(const Token* begin, const Token* end, bool oneLine = true);
+
+    /**
+     * @brief Decode a Redirect token
+     * @return false for forms the shell does not support; they stay words
+     */
+    static bool redirectKind(std::string_view op, ast::RedirectKind& kind);
+
+    /**
+     * @brief Operator text of a redirection kind, e.g. ">>" ("" for None)
+     */
+    static const char* redirectOperator(ast::RedirectKind kind);
+
+    /**
+     * @brief True if a redirection of this kind is followed by a target word
+     */
+    static bool takesTarget(ast::RedirectKind kind);
+
+    /**
+     * @brief Record one redirection in a RedirectionInfo
+     */
+    static void applyRedirection(RedirectionInfo& info, ast::RedirectKind kind, std::string target);
+
+    /**
+     * @brief Split a lexed statement into stages, words and redirections
+     *
+     * Words keep their quotes; they are expanded each time the statement
+     * runs. A trailing & marks the pipeline as a background job.
+     */
+    static ast::Pipeline parsePipeline(const Token* begin, const Token* end);
+
     /**
      * @brief Pipeline segment with trim operator info
      */
@@ -61,7 +106,26 @@ public:
     static std::vector<PipelineSegment> splitPipelineOperators(const std::string& line);
 
     /**
-     * @brief Apply trim to each line of input
+     * @brief Token range of one pipeline stage
+     */
+    struct TokenSegment {
+        const Token* begin;
+        const Token* end;
+        bool trimBeforeNext;
+    };
+
+    /**
+     * @brief Split lexed tokens by pipe operators without copying any text
+     */
+    static std::vector<TokenSegment> splitPipeline(const std::vector<Token>& tokens);
+
+    /**
+     * @brief Split a token range by pipe operators
+     */
+    static std::vector<TokenSegment> splitPipeline(const Token* begin, const Token* end);
+
+    /**
+     * @brief Apply trim to each line of input (whole-buffer TrimFilter)
      */
     static std::string applyTrimToLines(const std::string& input);
 };
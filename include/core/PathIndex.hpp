@@ -0,0 +1,70 @@
+#pragma once
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief Index of the executables reachable through PATH
+ *
+ * Maps command names to absolute paths (first PATH directory wins) and keeps
+ * a sorted name list for prefix completion. The index is rebuilt lazily
+ * when PATH changes or one of its directories is modified, so command
+ * execution and tab completion share a single directory scan.
+ */
+class PathIndex {
+public:
+    static PathIndex& instance();
+
+    /**
+     * @brief Absolute path of a command, or "" if PATH has no such executable
+     *
+     * Records a hit for the command (see hits()).
+     */
+    std::string resolve(const std::string& name);
+
+    /**
+     * @brief Command names starting with prefix, in sorted order
+     */
+    std::vector<std::string> complete(const std::string& prefix);
+
+    /**
+     * @brief Commands resolved since the last reset: (name, hits, path)
+     */
+    struct Hit {
+        std::string name;
+        size_t hits;
+        std::string path;
+    };
+    std::vector<Hit> hits();
+
+    /**
+     * @brief Forget the index and the hit table (hash -r)
+     */
+    void reset();
+
+    /**
+     * @brief Number of indexed commands
+     */
+    size_t size();
+
+private:
+    PathIndex() = default;
+
+    void refreshIfStale();
+    void rebuild(const std::string& path);
+
+    std::mutex mutex_;
+    bool built_ = false;
+    std::string path_; // PATH value the index was built from
+    std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> dirs_;
+    std::unordered_map<std::string, std::string> commands_;
+    std::vector<std::string> names_; // sorted
+    std::unordered_map<std::string, size_t> hits_;
+};
+
+} // namespace termidash
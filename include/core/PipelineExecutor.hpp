@@ -2,6 +2,7 @@
 #include "core/Parser.hpp"
 #include "core/BuiltInCommandHandler.hpp"
 #include "core/CommandExecutor.hpp"
+#include "core/WordExpander.hpp"
 #include "platform/interfaces/IProcessManager.hpp"
 #include "platform/interfaces/ITerminal.hpp"
 #include <string>
@@ -34,6 +35,13 @@ public:
         bool trimBeforeNext = false;
         std::string hereDocDelim;
         bool isHereDoc = false;
+        std::string hereString;
+        bool isHereString = false;
+        std::string inputData;     // Here-document or here-string body, once read
+        bool hasInputData = false;
+        bool errToOut = false;
+        bool outToErr = false;
+        std::vector<std::string> args; // Command words with quotes removed
     };
 
     /**
@@ -56,6 +64,60 @@ public:
         platform::ITerminal* terminal = nullptr
     );
 
+    /**
+     * @brief Execute a pipeline of already expanded tokens
+     *
+     * Word tokens hold final argument values (see WordExpander) and are not
+     * lexed or unquoted again.
+     *
+     * @param begin First token
+     * @param end One past the last token
+     * @return Exit code of the last command in the pipeline
+     */
+    static int execute(
+        const Token* begin,
+        const Token* end,
+        BuiltInCommandHandler& builtInHandler,
+        ICommandExecutor* executor,
+        platform::IProcessManager* processManager,
+        std::istream* inputSource = nullptr,
+        platform::ITerminal* terminal = nullptr
+    );
+
+    /**
+     * @brief Execute a pipeline expanded from parsed stages
+     *
+     * Stages, words and redirections are used as they are; nothing is
+     * lexed or split again (see WordExpander::expandStage).
+     *
+     * @return Exit code of the last command in the pipeline
+     */
+    static int execute(
+        const ExpandedCommand& command,
+        BuiltInCommandHandler& builtInHandler,
+        platform::IProcessManager* processManager,
+        std::istream* inputSource = nullptr,
+        platform::ITerminal* terminal = nullptr
+    );
+
+    /**
+     * @brief Run an expanded command list and capture its standard output
+     *
+     * Used for command substitution. Builtins write into memory, external
+     * commands are read through a pipe, and a bare "< file" reads the file.
+     * Stages may be joined by ;, && and ||.
+     *
+     * @param output Receives everything written to standard output
+     * @return Exit code of the last command run
+     */
+    static int capture(
+        const Token* begin,
+        const Token* end,
+        BuiltInCommandHandler& builtInHandler,
+        platform::IProcessManager* processManager,
+        std::string& output
+    );
+
     /**
      * @brief Execute a single command (no pipes)
      * 
@@ -76,22 +138,116 @@ public:
         platform::ITerminal* terminal = nullptr
     );
 
+    /**
+     * @brief Status of each stage of the last foreground pipeline
+     *
+     * Builtin stages report their exit code only. The codes are also
+     * published as the PIPESTATUS variable (space separated).
+     */
+    static const std::vector<platform::ChildStatus>& lastPipeStatus();
+
 private:
+    /**
+     * @brief Remember per-stage statuses and update PIPESTATUS
+     */
+    static void recordStatus(std::vector<platform::ChildStatus> statuses);
+
+    /**
+     * @brief Build a segment from one lexed pipeline stage
+     */
+    static SegmentInfo makeSegment(const Token* begin, const Token* end, bool trimBeforeNext, bool oneLine = true);
+
+    /**
+     * @brief Build a segment from a parsed command
+     */
+    static SegmentInfo makeSegment(Parser::RedirectionInfo redirInfo, bool trimBeforeNext);
+
+    /**
+     * @brief Execute the stages of a split token range
+     */
+    static int executeSegments(
+        const std::vector<Parser::TokenSegment>& rawSegments,
+        bool oneLine,
+        BuiltInCommandHandler& builtInHandler,
+        platform::IProcessManager* processManager,
+        std::istream* inputSource,
+        platform::ITerminal* terminal,
+        std::string* captureOut = nullptr
+    );
+
+    /**
+     * @brief Execute built segments: one command, or a pipeline
+     */
+    static int runSegments(
+        std::vector<SegmentInfo>& segments,
+        BuiltInCommandHandler& builtInHandler,
+        platform::IProcessManager* processManager,
+        std::istream* inputSource,
+        platform::ITerminal* terminal,
+        std::string* captureOut = nullptr
+    );
+
+    /**
+     * @brief Execute one already parsed command
+     * @param statuses Receives the child's status if an external command ran
+     * @param captureOut If set, standard output is collected here
+     */
+    static int runSegment(
+        SegmentInfo& info,
+        BuiltInCommandHandler& builtInHandler,
+        platform::IProcessManager* processManager,
+        std::istream* inputSource,
+        platform::ITerminal* terminal,
+        std::vector<platform::ChildStatus>& statuses,
+        std::string* captureOut = nullptr
+    );
+
     /**
      * @brief Execute pipeline of all built-in commands using StreamBridge
      */
     static int executeBuiltInPipeline(
         const std::vector<SegmentInfo>& segments,
-        BuiltInCommandHandler& builtInHandler
+        BuiltInCommandHandler& builtInHandler,
+        std::vector<platform::ChildStatus>& statuses,
+        std::string* captureOut = nullptr
     );
 
     /**
      * @brief Execute pipeline with external commands using OS pipes
+     *
+     * Builtin stages run on WorkerPool threads that read and write the pipe
+     * handles directly, so they need no process of their own. All child
+     * processes are reaped concurrently; a stage that could not be started
+     * reports exit code 1.
      */
     static int executeExternalPipeline(
         const std::vector<SegmentInfo>& segments,
         BuiltInCommandHandler& builtInHandler,
-        platform::IProcessManager* processManager
+        platform::IProcessManager* processManager,
+        std::vector<platform::ChildStatus>& statuses,
+        std::string* captureOut = nullptr
+    );
+
+    /**
+     * @brief Run a builtin pipeline stage against OS handles
+     *
+     * A handle of -1 means the shell's own stream. The handles are not closed.
+     */
+    static int runBuiltInStage(
+        const SegmentInfo& info,
+        BuiltInCommandHandler& builtInHandler,
+        long stdIn,
+        long stdOut,
+        long stdErr
+    );
+
+    /**
+     * @brief Collect the here-document or here-string body of a segment
+     */
+    static void loadInputData(
+        SegmentInfo& info,
+        std::istream* inputSource,
+        platform::ITerminal* terminal
     );
 
     /**
@@ -0,0 +1,43 @@
+#pragma once
+#include "core/ExecContext.hpp"
+#include <string>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief The read builtin
+ *
+ * read [-r] [-d delim] [-a name] [name...]
+ *
+ * Reads one record (a line, or up to delim) from ctx.in and assigns its
+ * IFS-separated fields to the names; the last name gets the rest of the
+ * record, and REPLY is used when no name is given. Without -r a backslash
+ * quotes the next character and a backslash-newline continues the record.
+ *
+ * Input always comes through a buffered stream, never byte by byte: pipes
+ * and files of a single command have their own stream, and the shell's
+ * standard input is one stream shared by all builtins (see shellInput), so
+ * read-ahead left by one read is used by the next.
+ */
+class ReadCommand {
+public:
+    /**
+     * @param args Command words including "read"
+     * @return 0 if a whole record was read, 1 at end of input, 2 on a usage error
+     */
+    static int run(const std::vector<std::string>& args, ExecContext& ctx);
+
+    /**
+     * @brief Split a record into at most count fields by IFS rules
+     *
+     * @param literal Characters that were quoted with a backslash (never
+     *        separators); may be empty when nothing was quoted
+     * @param count Number of fields wanted; the last one keeps the rest.
+     *        0 splits every field
+     */
+    static std::vector<std::string> split(const std::string& text, const std::vector<bool>& literal,
+                                          const std::string& ifs, size_t count);
+};
+
+} // namespace termidash
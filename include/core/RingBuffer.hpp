@@ -1,140 +1,285 @@
 #pragma once
+#include "core/BufferPool.hpp"
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <streambuf>
 #include <istream>
 #include <ostream>
-#include <chrono>
 #include <string>
 
 namespace termidash {
 
+// CircularBuffer: single-producer/single-consumer byte ring.
+// The writer only advances tail_ and the reader only advances head_. Both
+// indices grow without wrapping and are published with atomic stores, so a
+// transfer is at most two memcpy calls and takes no lock. A side blocks
+// only when the ring is full (writer) or empty (reader); the other side
+// takes the lock to wake it only if it is actually waiting.
+//
+// Storage comes from BufferPool. A ring may start small and double each time
+// the writer has had to block on a full ring, up to its maximum capacity.
 class CircularBuffer {
 public:
-    explicit CircularBuffer(size_t capacity = 1 << 20)
-        : buf_(capacity), capacity_(capacity), head_(0), tail_(0), closed_(false) {}
+    // Fixed-size ring
+    explicit CircularBuffer(size_t capacity = 1 << 20) : CircularBuffer(capacity, capacity) {}
 
-    // write up to n bytes, block until at least one byte written or closed.
+    // Ring that starts at initial bytes and may grow to max
+    CircularBuffer(size_t initial, size_t max)
+        : capacity_(roundUpToPowerOfTwo(initial)),
+          maxCapacity_(std::max(capacity_, roundUpToPowerOfTwo(max))),
+          mask_(capacity_ - 1),
+          buf_(BufferPool::instance().acquire(capacity_)) {}
+
+    ~CircularBuffer() {
+        BufferPool::instance().release(std::move(buf_), capacity_);
+    }
+
+    CircularBuffer(const CircularBuffer&) = delete;
+    CircularBuffer& operator=(const CircularBuffer&) = delete;
+
+    // write n bytes, blocking while the ring is full.
+    // Returns fewer than n only if either side closed the buffer.
     size_t write(const char* data, size_t n) {
         size_t written = 0;
-        while (written < n) {
-            std::unique_lock<std::mutex> lk(mutex_);
-            not_full_.wait(lk, [&]{ return closed_ || free_space() > 0; });
-            if (closed_) break;
-            size_t space = free_space();
-            if (space == 0) continue;
-            size_t toWrite = std::min(space, n - written);
-            for (size_t i = 0; i < toWrite; ++i) {
-                buf_[(tail_ + i) % capacity_] = data[written + i];
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        while (written < n && !closed_.load(std::memory_order_acquire) && !readerClosed()) {
+            size_t space = capacity_ - (tail - head_.load(std::memory_order_acquire));
+            if (space == 0) {
+                park(writerWaiting_, notFull_, [&] {
+                    return closed_.load() || readerClosed_.load() || tail - head_.load() < capacity_;
+                });
+                continue;
             }
-            tail_ = (tail_ + toWrite) % capacity_;
-            written += toWrite;
-            lk.unlock();
-            not_empty_.notify_one();
+            size_t count = std::min(space, n - written);
+            copyIn(tail, data + written, count);
+            tail += count;
+            tail_.store(tail);
+            written += count;
+            wake(readerWaiting_, notEmpty_);
         }
         return written;
     }
 
-    // read up to n bytes, block until at least one byte read or closed and empty.
+    // read up to n bytes, blocking until at least one byte is available.
+    // Returns 0 once the buffer is closed and drained.
     size_t read(char* out, size_t n) {
-        size_t read = 0;
-        while (read < n) {
-            std::unique_lock<std::mutex> lk(mutex_);
-            not_empty_.wait(lk, [&]{ return closed_ || available() > 0; });
-            size_t avail = available();
-            if (avail == 0) {
-                if (closed_) break;
-                else continue;
-            }
-            size_t toRead = std::min(avail, n - read);
-            for (size_t i = 0; i < toRead; ++i) {
-                out[read + i] = buf_[(head_ + i) % capacity_];
-            }
-            head_ = (head_ + toRead) % capacity_;
-            read += toRead;
-            lk.unlock();
-            not_full_.notify_one();
+        if (n == 0) return 0;
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t avail = tail_.load(std::memory_order_acquire) - head;
+        if (avail == 0) {
+            park(readerWaiting_, notEmpty_, [&] { return closed_.load() || tail_.load() != head; });
+            avail = tail_.load(std::memory_order_acquire) - head;
+            if (avail == 0) return 0;
         }
-        return read;
+        size_t count = std::min(avail, n);
+        copyOut(head, out, count);
+        head_.store(head + count);
+        if (capacity_ < maxCapacity_ && writerWaiting_.load()) grow();
+        wake(writerWaiting_, notFull_);
+        return count;
     }
 
     void close() {
+        closed_.store(true);
         {
             std::lock_guard<std::mutex> lk(mutex_);
-            closed_ = true;
         }
-        not_empty_.notify_all();
-        not_full_.notify_all();
+        notEmpty_.notify_all();
+        notFull_.notify_all();
     }
 
     bool closed() const {
-        return closed_;
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    // The reader will not read any more (e.g. head has printed its lines):
+    // a blocked write returns at once and later writes write nothing
+    void closeReader() {
+        readerClosed_.store(true);
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+        }
+        notFull_.notify_all();
     }
 
+    bool readerClosed() const {
+        return readerClosed_.load(std::memory_order_acquire);
+    }
+
+    // Points to true once the reader has closed (for ExecContext::cancel)
+    const std::atomic<bool>* readerClosedFlag() const { return &readerClosed_; }
+
     size_t available() const {
-        if (tail_ >= head_) return tail_ - head_;
-        return capacity_ - (head_ - tail_);
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
     }
 
     size_t free_space() const {
-        return capacity_ - available() - 1;
+        return capacity_ - available();
     }
 
     size_t capacity() const { return capacity_; }
+    size_t maxCapacity() const { return maxCapacity_; }
 
 private:
-    std::vector<char> buf_;
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t p = 4096;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    void copyIn(size_t pos, const char* data, size_t count) {
+        size_t offset = pos & mask_;
+        size_t first = std::min(count, capacity_ - offset);
+        std::memcpy(buf_.get() + offset, data, first);
+        std::memcpy(buf_.get(), data + first, count - first);
+    }
+
+    // Called by the reader. The storage may only be swapped while the writer
+    // is parked: it then holds no pointer into the ring, and it reloads the
+    // new storage after taking the lock to wake up.
+    void grow() {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (!writerWaiting_.load()) return;
+        size_t head = head_.load();
+        size_t count = tail_.load() - head;
+        size_t capacity = std::min(capacity_ * 2, maxCapacity_);
+        BufferPool::Block grown = BufferPool::instance().acquire(capacity);
+
+        // Same indices, new modulus: copy the unread bytes to their new slots
+        size_t offset = head & mask_;
+        size_t first = std::min(count, capacity_ - offset);
+        size_t target = head & (capacity - 1);
+        size_t split = std::min(first, capacity - target);
+        std::memcpy(grown.get() + target, buf_.get() + offset, split);
+        std::memcpy(grown.get(), buf_.get() + offset + split, first - split);
+        size_t rest = count - first;
+        target = (head + first) & (capacity - 1);
+        split = std::min(rest, capacity - target);
+        std::memcpy(grown.get() + target, buf_.get(), split);
+        std::memcpy(grown.get(), buf_.get() + split, rest - split);
+
+        BufferPool::instance().release(std::move(buf_), capacity_);
+        buf_ = std::move(grown);
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+    }
+
+    void copyOut(size_t pos, char* out, size_t count) const {
+        size_t offset = pos & mask_;
+        size_t first = std::min(count, capacity_ - offset);
+        std::memcpy(out, buf_.get() + offset, first);
+        std::memcpy(out + first, buf_.get(), count - first);
+    }
+
+    // The waiting flag store and the index loads in ready() are sequentially
+    // consistent, as are the index stores and the flag load in wake(): either
+    // the waker sees the flag or the waiter sees the new index.
+    template <typename Ready>
+    void park(std::atomic<bool>& waiting, std::condition_variable& cv, Ready ready) {
+        std::unique_lock<std::mutex> lk(mutex_);
+        waiting.store(true);
+        while (!ready()) cv.wait(lk);
+        waiting.store(false, std::memory_order_relaxed);
+    }
+
+    void wake(std::atomic<bool>& waiting, std::condition_variable& cv) {
+        if (!waiting.load()) return;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+        }
+        cv.notify_one();
+    }
+
     size_t capacity_;
-    size_t head_;
-    size_t tail_;
-    bool closed_;
-    mutable std::mutex mutex_;
-    std::condition_variable not_empty_;
-    std::condition_variable not_full_;
+    const size_t maxCapacity_;
+    size_t mask_;
+    BufferPool::Block buf_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<bool> closed_{false};
+    std::atomic<bool> readerClosed_{false};
+    std::atomic<bool> readerWaiting_{false};
+    std::atomic<bool> writerWaiting_{false};
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
 };
 
-// streambuf writers/reader adapters
+// streambuf writers/reader adapters. Both keep a local chunk so single
+// characters and short lines do not touch the shared ring.
 class CircularOutputBuf : public std::streambuf {
 public:
-    explicit CircularOutputBuf(std::shared_ptr<CircularBuffer> buf) : buf_(buf) {}
+    explicit CircularOutputBuf(std::shared_ptr<CircularBuffer> buf, size_t chunkSize = 64 * 1024)
+        : buf_(buf), area_(chunkSize) {
+        setp(area_.data(), area_.data() + area_.size());
+    }
 protected:
     int_type overflow(int_type ch) override {
+        if (!flushArea()) return traits_type::eof();
         if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
-        char c = traits_type::to_char_type(ch);
-        buf_->write(&c, 1);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
         return ch;
     }
+    // Blocks larger than the chunk go straight to the ring
     std::streamsize xsputn(const char* s, std::streamsize n) override {
-        size_t wrote = buf_->write(s, static_cast<size_t>(n));
-        return static_cast<std::streamsize>(wrote);
+        if (n < epptr() - pptr()) return std::streambuf::xsputn(s, n);
+        if (!flushArea()) return 0;
+        return static_cast<std::streamsize>(buf_->write(s, static_cast<size_t>(n)));
     }
-    int sync() override { return 0; }
+    int sync() override { return flushArea() ? 0 : -1; }
 private:
+    bool flushArea() {
+        size_t pending = static_cast<size_t>(pptr() - pbase());
+        size_t wrote = pending > 0 ? buf_->write(pbase(), pending) : 0;
+        setp(area_.data(), area_.data() + area_.size());
+        return wrote == pending;
+    }
+
     std::shared_ptr<CircularBuffer> buf_;
+    std::vector<char> area_;
 };
 
 class CircularInputBuf : public std::streambuf {
 public:
-    explicit CircularInputBuf(std::shared_ptr<CircularBuffer> buf, size_t chunkSize = 8192)
+    explicit CircularInputBuf(std::shared_ptr<CircularBuffer> buf, size_t chunkSize = 64 * 1024)
         : buf_(buf), chunkSize_(chunkSize), tmp_(chunkSize_) {
         setg(tmp_.data(), tmp_.data(), tmp_.data());
     }
 protected:
     int_type underflow() override {
         if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
-        // read into tmp_
+        // read blocks until data arrives; 0 means closed and drained
         size_t n = buf_->read(tmp_.data(), chunkSize_);
-        if (n == 0) {
-            if (buf_->closed()) return traits_type::eof();
-            // no data but not closed, wait briefly then try again
-            // The CircularBuffer::read already blocks until data or closed, so we shouldn't get here
-            return traits_type::eof();
-        }
+        if (n == 0) return traits_type::eof();
         setg(tmp_.data(), tmp_.data(), tmp_.data() + n);
         return traits_type::to_int_type(*gptr());
     }
+    // Large reads bypass the chunk once it is drained
+    std::streamsize xsgetn(char* s, std::streamsize n) override {
+        std::streamsize got = std::min<std::streamsize>(n, egptr() - gptr());
+        std::memcpy(s, gptr(), static_cast<size_t>(got));
+        gbump(static_cast<int>(got));
+        while (got < n) {
+            if (n - got < static_cast<std::streamsize>(chunkSize_)) {
+                if (traits_type::eq_int_type(underflow(), traits_type::eof())) break;
+                std::streamsize more = std::min<std::streamsize>(n - got, egptr() - gptr());
+                std::memcpy(s + got, gptr(), static_cast<size_t>(more));
+                gbump(static_cast<int>(more));
+                got += more;
+            } else {
+                size_t more = buf_->read(s + got, static_cast<size_t>(n - got));
+                if (more == 0) break;
+                got += static_cast<std::streamsize>(more);
+            }
+        }
+        return got;
+    }
 private:
     std::shared_ptr<CircularBuffer> buf_;
     size_t chunkSize_;
@@ -143,17 +288,32 @@ private:
 
 class StreamBridge {
 public:
-    explicit StreamBridge(size_t capacity = 1 << 20) {
-        buf_ = std::make_shared<CircularBuffer>(capacity);
-        outbuf_ = std::make_unique<CircularOutputBuf>(buf_);
-        inbuf_ = std::make_unique<CircularInputBuf>(buf_);
+    // Sized by the pool policy (shell option pipebuf)
+    StreamBridge() : StreamBridge(BufferPool::instance().policy()) {}
+
+    // Fixed-size ring
+    explicit StreamBridge(size_t capacity) : StreamBridge(BufferPool::Policy{capacity, capacity}) {}
+
+    explicit StreamBridge(const BufferPool::Policy& policy) {
+        buf_ = std::make_shared<CircularBuffer>(policy.initial, policy.max);
+        // Stream chunks scale with the ring so small pipelines stay small
+        size_t chunkSize = std::min<size_t>(buf_->capacity(), 64 * 1024);
+        outbuf_ = std::make_unique<CircularOutputBuf>(buf_, chunkSize);
+        inbuf_ = std::make_unique<CircularInputBuf>(buf_, chunkSize);
         out_stream_ = std::make_unique<std::ostream>(outbuf_.get());
         in_stream_ = std::make_unique<std::istream>(inbuf_.get());
     }
 
     std::ostream& out() { return *out_stream_; }
     std::istream& in() { return *in_stream_; }
-    void closeWriter() { buf_->close(); }
+    // Flushes buffered output, then signals end of input to the reader
+    void closeWriter() {
+        out_stream_->flush();
+        buf_->close();
+    }
+    // Signals the writer that its output is no longer wanted: its writes
+    // fail and its stream goes bad, like EPIPE on an OS pipe
+    void closeReader() { buf_->closeReader(); }
     std::shared_ptr<CircularBuffer> buffer() const { return buf_; }
 
 private:
@@ -0,0 +1,75 @@
+#pragma once
+#include "core/Bytecode.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace termidash {
+
+/**
+ * @brief On-disk cache of compiled scripts
+ *
+ * Each script is stored as one entry file named after a hash of its absolute
+ * path. An entry records the source mtime, size and content hash, and the
+ * BytecodeCompiler::Revision that produced it; it is used only when all of
+ * these still match, otherwise the script is recompiled and the entry
+ * rewritten. Entries are memory-mapped and decoded in a single pass, so
+ * a hit skips lexing, parsing and compilation entirely.
+ *
+ * The same file format (flagged as standalone) is used for precompiled .tdc
+ * scripts, which are loaded without any source check.
+ */
+class ScriptCache {
+public:
+    /**
+     * @brief Create a cache rooted at a directory
+     * @param directory Cache directory (created on first store); empty disables storing
+     */
+    explicit ScriptCache(std::string directory);
+
+    /**
+     * @brief Get the compiled form of a script, compiling it on a miss
+     * @param scriptPath Path to the script source
+     * @return Compiled chunk, or nullptr if the script cannot be read
+     */
+    std::shared_ptr<const bytecode::Chunk> load(const std::string& scriptPath);
+
+    /**
+     * @brief True if the last load() was served from the cache
+     */
+    bool lastLoadWasHit() const { return lastHit_; }
+
+    /**
+     * @brief Path of the cache entry used for a script
+     */
+    std::string entryPath(const std::string& scriptPath) const;
+
+    /**
+     * @brief Compile a script into a standalone .tdc file
+     * @return true on success; errors are reported on stderr
+     */
+    static bool compileFile(const std::string& scriptPath, const std::string& outputPath);
+
+    /**
+     * @brief Load a standalone .tdc file
+     * @return Compiled chunk, or nullptr (with an error on stderr) if invalid
+     */
+    static std::shared_ptr<const bytecode::Chunk> loadCompiled(const std::string& path);
+
+    /**
+     * @brief True if the path names a precompiled script (.tdc extension)
+     */
+    static bool isCompiledPath(const std::string& path);
+
+    /**
+     * @brief 64-bit FNV-1a hash used for entry names and content checks
+     */
+    static uint64_t hash(const char* data, size_t size);
+
+private:
+    std::string directory_;
+    bool lastHit_ = false;
+};
+
+} // namespace termidash
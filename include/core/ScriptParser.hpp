@@ -0,0 +1,76 @@
+#pragma once
+#include "core/Ast.hpp"
+#include <string>
+#include <vector>
+#include <istream>
+
+namespace termidash {
+
+/**
+ * @brief Builds an AST from script or interactive input
+ *
+ * Input is fed one physical line at a time. Batch splitting, control-flow
+ * keyword detection, block nesting and here-document collection are done
+ * here exactly once, so loop and function bodies can be executed repeatedly
+ * without being re-parsed.
+ *
+ * Completed top-level statements are appended to the caller's list as soon
+ * as they are closed, which lets the shell execute a script incrementally.
+ */
+class ScriptParser {
+public:
+    /**
+     * @brief Feed one line of input
+     * @param line Raw input line
+     * @param out Receives every top-level statement completed by this line
+     */
+    void feed(const std::string& line, ast::NodeList& out);
+
+    /**
+     * @brief Flush pending input at end of stream
+     *
+     * A here-document without its delimiter is completed with the lines
+     * collected so far. Unterminated blocks are reported and discarded.
+     */
+    void finish(ast::NodeList& out);
+
+    /**
+     * @brief True while a block or here-document is still open
+     */
+    bool needsMoreInput() const;
+
+    /**
+     * @brief True while here-document body lines are being collected
+     */
+    bool inHereDoc() const;
+
+    /**
+     * @brief Parse a complete stream into a statement list
+     */
+    static ast::NodeList parse(std::istream& in);
+
+    /**
+     * @brief Parse a list of lines (e.g. a stored function body)
+     */
+    static ast::NodeList parse(const std::vector<std::string>& lines);
+
+private:
+    struct OpenBlock {
+        ast::Node node;
+        bool inElse = false;
+    };
+
+    void processLine(const std::vector<std::pair<std::string, std::string>>& statements, ast::NodeList& out);
+    void addStatement(const std::string& cmd, const std::string& sep, std::string* hereDoc, ast::NodeList& out);
+    void recordSource(const std::string& cmd);
+    ast::NodeList& currentList(ast::NodeList& out);
+
+    std::vector<OpenBlock> blocks_;
+
+    // Line waiting for its here-document bodies
+    std::vector<std::pair<std::string, std::string>> heldStatements_;
+    std::vector<std::string> hereDocDelims_;
+    std::vector<std::string> hereDocBodies_;
+};
+
+} // namespace termidash
@@ -0,0 +1,103 @@
+#pragma once
+#include "core/Bytecode.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace termidash {
+
+class ExpandedCommand;
+
+/**
+ * @brief Dispatch loop that executes compiled shell bytecode
+ *
+ * The VM owns control flow, loops and shell function calls. Anything that
+ * touches the outside world (expansion, builtins, processes) is delegated
+ * to a Host so the VM itself stays platform independent.
+ */
+class ScriptVM {
+public:
+    /**
+     * @brief Services the VM needs from the shell
+     */
+    class Host {
+    public:
+        virtual ~Host() = default;
+
+        /**
+         * @brief Expand aliases, variables and substitutions in the words of
+         * a parsed stage and append the stage to @p out
+         * @param out Views the words of @p stage where possible
+         * @param command False for a plain word list: no alias substitution
+         */
+        virtual void expand(const ast::Stage& stage, ExpandedCommand& out, bool command) = 0;
+
+        /**
+         * @brief Execute an expanded statement (assignment, job control,
+         * builtin, external command or pipeline)
+         * @param hereDoc Collected here-document body, or nullptr
+         * @param background Started as a job (the statement ended with &)
+         * @return Exit status
+         */
+        virtual int execute(const ExpandedCommand& command, const std::string* hereDoc, bool background) = 0;
+
+        /**
+         * @brief Run an expanded if/while condition
+         * @return Exit status
+         */
+        virtual int run(const ExpandedCommand& command) = 0;
+    };
+
+    /**
+     * @brief Execution counters, collected on every run
+     */
+    struct Profile {
+        uint64_t instructions = 0;
+        uint64_t commands = 0;
+        uint64_t functionCalls = 0;
+        std::array<uint64_t, static_cast<size_t>(bytecode::OpCode::Halt) + 1> opCounts{};
+    };
+
+    explicit ScriptVM(Host& host) : host_(host) {}
+
+    /**
+     * @brief Stop any single while loop after @p limit iterations, with a
+     * warning on stderr. 0 (the default) means no limit.
+     */
+    void setMaxWhileIterations(uint64_t limit) { maxWhileIterations_ = limit; }
+
+    /**
+     * @brief Execute a chunk to completion
+     * @return Exit status of the last statement
+     */
+    int run(const bytecode::Chunk& chunk);
+
+    const Profile& profile() const { return profile_; }
+    void resetProfile() { profile_ = Profile(); }
+
+private:
+    struct Frame {
+        const bytecode::Chunk* chunk;
+        std::shared_ptr<const bytecode::Chunk> hold; // keeps function bodies alive
+        size_t pc;
+        size_t loopBase;
+    };
+
+    struct Loop {
+        std::vector<std::string> items; // for loops
+        size_t next = 0;
+        uint64_t iterations = 0; // while loops
+        int status = 0;
+        bool started = false;
+    };
+
+    std::shared_ptr<const bytecode::Chunk> functionBody(const std::string& name);
+
+    Host& host_;
+    Profile profile_;
+    uint64_t maxWhileIterations_ = 0;
+};
+
+} // namespace termidash
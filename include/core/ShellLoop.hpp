@@ -4,6 +4,6 @@
 
 namespace termidash {
     void runShell(platform::ITerminal* terminal, platform::IProcessManager* processManager);
-    void runCommand(const std::string& commandLine, platform::ITerminal* terminal, platform::IProcessManager* processManager);
-    void runScript(const std::string& path, platform::ITerminal* terminal, platform::IProcessManager* processManager);
+    void runCommand(const std::string& commandLine, platform::IProcessManager* processManager);
+    void runScript(const std::string& path, platform::IProcessManager* processManager);
 }
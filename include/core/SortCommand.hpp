@@ -0,0 +1,42 @@
+#pragma once
+#include "core/ExecContext.hpp"
+#include <string>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief The sort builtin
+ *
+ * sort [-bnru] [-t sep] [-k key]... [-S size] [-T dir] [--parallel=N] [file...]
+ *
+ * Lines are copied into an arena and sorted as fixed-size records that hold
+ * offsets into it (plus the first 8 bytes of the key), never as separate
+ * strings. The arena is limited to the -S memory budget: when it is full
+ * the chunk is sorted in parallel pieces and written to a temporary run
+ * file, and the runs are k-way merged at the end, at most 16 at a time.
+ * Input that fits in the budget never touches the disk.
+ *
+ * Ordering is bytewise (C locale). Keys follow POSIX -k F[.C][bnr][,F[.C][bnr]];
+ * lines whose keys compare equal are ordered by the whole line, except
+ * with -u, which outputs only the first line of each run of equal keys.
+ */
+class SortCommand {
+public:
+    /**
+     * @param args Command words including "sort"
+     * @return 0 on success, 2 on a usage or I/O error
+     */
+    static int run(const std::vector<std::string>& args, ExecContext& ctx);
+
+    /**
+     * @brief Compare two numbers as -n does
+     *
+     * Leading blanks are skipped, then an optional '-', digits and a
+     * fraction; anything that is not a number compares as zero.
+     * @return Negative, zero or positive like memcmp
+     */
+    static int compareNumbers(const char* a, const char* aEnd, const char* b, const char* bEnd);
+};
+
+} // namespace termidash
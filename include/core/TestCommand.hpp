@@ -0,0 +1,40 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief The test, [ and [[ builtins
+ *
+ * Evaluated in the shell process so if/while conditions need no fork.
+ * Supports string (-z -n = == != < >), integer (-eq -ne -lt -le -gt -ge)
+ * and file (-e -f -d -h -L -p -S -b -c -s -r -w -x -u -g -k -O -G -nt -ot
+ * -ef) predicates, -t, and ! -a -o ( ) for combining them. Each file
+ * operand is looked up with a single stat call (statx on Linux); -w also
+ * checks access, which sees read-only mounts.
+ *
+ * Inside [[ ]] tests are combined with && and || instead of -a and -o,
+ * the right side of == and != is a glob pattern and =~ matches an
+ * extended regular expression.
+ */
+class TestCommand {
+public:
+    /**
+     * @brief Evaluate a test command
+     * @param args Command words including the name ("test", "[" or "[[")
+     * @param err Receives usage errors
+     * @return 0 if true, 1 if false, 2 on a usage error
+     */
+    static int run(const std::vector<std::string>& args, std::ostream& err);
+
+    /**
+     * @brief True for the names this class implements
+     */
+    static bool isTestCommand(const std::string& name) {
+        return name == "test" || name == "[" || name == "[[";
+    }
+};
+
+} // namespace termidash
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace termidash {
+
+/**
+ * @brief Fixed-string search over large buffers
+ *
+ * Candidate positions are found 16 bytes at a time by comparing the first
+ * and last byte of the needle at once (SSE2 where available, memchr
+ * otherwise); only candidates are confirmed with memcmp. Builtins search
+ * whole input blocks with it instead of one line at a time.
+ */
+class SubstringFinder {
+public:
+    explicit SubstringFinder(std::string needle) : needle_(std::move(needle)) {}
+
+    /**
+     * @brief First occurrence in [begin, end), or nullptr
+     */
+    const char* find(const char* begin, const char* end) const;
+
+    const std::string& needle() const { return needle_; }
+
+private:
+    std::string needle_;
+};
+
+} // namespace termidash
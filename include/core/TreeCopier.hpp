@@ -0,0 +1,96 @@
+#pragma once
+#ifndef _WIN32 // POSIX only
+
+#include "core/DirectoryReader.hpp"
+#include "core/WorkerPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief Copy engine behind cp and cross-device mv
+ *
+ * Each file is first cloned (a FICLONE reflink on copy-on-write file
+ * systems). If that fails it is copied with copy_file_range, so the data
+ * stays in the kernel, and as a last resort through a 256 KiB buffer (see
+ * PlatformUtils::copyAll). Directory trees are copied by a
+ * WorkStealingGroup: every directory and file is a task, so a tree of many
+ * small files keeps every core busy. Symlinks inside a tree are copied as
+ * symlinks.
+ */
+class TreeCopier {
+public:
+    struct Progress {
+        uint64_t files = 0;
+        uint64_t directories = 0;
+        uint64_t bytes = 0;
+        uint64_t cloned = 0; // files copied as reflinks
+        double seconds = 0;
+    };
+
+    struct Options {
+        bool recursive = false; // copy directories; without it they are an error
+        bool preserve = false;  // keep mode bits and timestamps exactly (mv)
+        size_t workers = 0;     // 0: one per core
+        // Called from a worker about four times a second while copying
+        std::function<void(const Progress&)> progress;
+    };
+
+    explicit TreeCopier(Options options);
+
+    /**
+     * @brief Queue a copy of from to the path to (not into it)
+     *
+     * Without recursive a symlink operand is followed; with it the link
+     * itself is copied.
+     */
+    void add(const std::string& from, const std::string& to);
+
+    /**
+     * @brief Copy everything queued
+     * @return false if anything failed; see errors()
+     */
+    bool run();
+
+    /**
+     * @brief Messages for the failed files, e.g. "cannot copy 'a' to 'b': reason"
+     */
+    const std::vector<std::string>& errors() const { return errors_; }
+
+    Progress progress() const;
+
+private:
+    void copyEntry(const std::string& from, const std::string& to, const FileStat& info);
+    void copyDirectory(const std::string& from, const std::string& to, const FileStat& info);
+    void copyFile(const std::string& from, const std::string& to, const FileStat& info);
+    void copyLink(const std::string& from, const std::string& to, const FileStat& info);
+    void fail(const std::string& from, const std::string& to, int error);
+    void report();
+
+    struct DirectoryFixup {
+        std::string path;
+        FileStat info;
+    };
+
+    Options options_;
+    WorkStealingGroup group_;
+    std::chrono::steady_clock::time_point start_;
+    std::atomic<uint64_t> files_{0};
+    std::atomic<uint64_t> directories_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> cloned_{0};
+    std::mutex mutex_; // guards errors_, fixups_ and reporting
+    std::vector<std::string> errors_;
+    std::vector<DirectoryFixup> fixups_;
+    std::chrono::steady_clock::time_point lastReport_;
+};
+
+} // namespace termidash
+
+#endif // _WIN32
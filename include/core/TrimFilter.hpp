@@ -0,0 +1,42 @@
+#pragma once
+#include "core/ExecContext.hpp"
+#include <cstddef>
+
+namespace termidash {
+
+/**
+ * @brief Streaming line trimmer behind the `|>` pipe operator
+ *
+ * Removes leading and trailing spaces and tabs from every line and drops
+ * lines that are left empty. Input is processed block by block and trimmed
+ * in place: line boundaries are found with memchr and kept text is moved
+ * down over removed whitespace, so memory use does not depend on input size.
+ */
+class TrimFilter {
+public:
+    /**
+     * @brief Trim data[0, size) in place
+     *
+     * Whitespace at the end of the block that may still be followed by text
+     * on the same line cannot be decided yet; it is left at data[consumed,
+     * size) and must be passed again in front of the next block.
+     *
+     * @return Length of the trimmed output now at the start of data
+     */
+    size_t filter(char* data, size_t size, size_t& consumed);
+
+    /**
+     * @brief True if the last line was cut off without its newline
+     */
+    bool pendingNewline() const { return !lineStart_; }
+
+    /**
+     * @brief Copy ctx.in to ctx.out, trimming every line
+     */
+    static void run(ExecContext& ctx, size_t blockSize = 256 * 1024);
+
+private:
+    bool lineStart_ = true; // nothing of the current line written yet
+};
+
+} // namespace termidash
@@ -0,0 +1,166 @@
+#pragma once
+#include "core/Ast.hpp"
+#include "core/Lexer.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief A statement after expansion: final argv words plus operators
+ *
+ * Word tokens hold their final values (quotes removed, expansions applied,
+ * fields split). A word that needed no expansion views the statement text
+ * it came from; every other word lives in one buffer owned by this object.
+ * The statement text must therefore outlive the result, and the object is
+ * not copyable. Reuse one instance so its buffers keep their capacity.
+ *
+ * A statement expanded from parsed stages (WordExpander::expandStage) has
+ * no operator tokens. Its structure is in stages() and redirects(), and
+ * tokens() holds the words and redirection targets of every stage.
+ */
+class ExpandedCommand {
+public:
+    static constexpr uint32_t NoTarget = 0xFFFFFFFFu;
+
+    /**
+     * @brief One pipeline stage: tokens()[firstWord, firstWord + wordCount)
+     *        are its words, redirects()[firstRedirect, ...) its redirections
+     */
+    struct Stage {
+        uint32_t firstWord = 0;
+        uint32_t wordCount = 0;
+        uint32_t firstRedirect = 0;
+        uint32_t redirectCount = 0;
+        bool trimAfter = false;
+    };
+
+    /**
+     * @brief A redirection whose target is one token, or NoTarget
+     */
+    struct Redirect {
+        ast::RedirectKind kind;
+        uint32_t target;
+    };
+
+    ExpandedCommand() = default;
+    ExpandedCommand(const ExpandedCommand&) = delete;
+    ExpandedCommand& operator=(const ExpandedCommand&) = delete;
+
+    const std::vector<Token>& tokens() const { return tokens_; }
+    const std::vector<Stage>& stages() const { return stages_; }
+    const std::vector<Redirect>& redirects() const { return redirects_; }
+    bool empty() const { return tokens_.empty() && stages_.empty(); }
+
+    /**
+     * @brief Final text of a redirection target ("" for NoTarget)
+     */
+    std::string_view target(const Redirect& redirect) const;
+
+    /**
+     * @brief Values of all tokens (argv style)
+     */
+    std::vector<std::string> words() const;
+
+    /**
+     * @brief Tokens joined by single spaces (for messages and job titles);
+     *        stages are shown with their pipes and redirections
+     */
+    std::string text() const;
+
+    void clear();
+
+private:
+    friend class WordExpander;
+
+    static constexpr uint32_t InSource = 0xFFFFFFFFu;
+
+    void startStage();
+    void pointIntoBuffer();
+
+    std::string source_;              // statement text after alias substitution
+    std::string buffer_;              // text of expanded words
+    std::vector<Token> lexed_;        // scratch: lexed statement
+    std::vector<Token> tokens_;
+    std::vector<uint32_t> offsets_;   // buffer offset per token, or InSource
+    std::vector<Stage> stages_;
+    std::vector<Redirect> redirects_;
+};
+
+/**
+ * @brief Single-pass, word-oriented shell expansion
+ *
+ * Walks the lexed words of a statement once, applying in order: alias
+ * substitution (first word), brace expansion, $VAR / ${VAR}, $((...)),
+ * $(...) and `...` with field splitting of unquoted results, quote removal
+ * and globbing. Words without $, `, {, *, ?, [ or quotes take a fast path
+ * and are not copied at all. Words of a [[ ]] command are neither split
+ * nor globbed.
+ */
+class WordExpander {
+public:
+    /**
+     * @brief Runs a command substitution and returns its output
+     */
+    using SubstituteFunc = std::function<std::string(const std::string&)>;
+
+    /**
+     * @param substitute Command substitution handler; without one, $(...)
+     *        and `...` are left as written
+     */
+    explicit WordExpander(SubstituteFunc substitute = nullptr);
+
+    /**
+     * @brief Expand a statement into final words and operators
+     * @param text Statement text (must outlive @p out)
+     * @param out Receives the result; previous contents are discarded
+     */
+    void expand(const std::string& text, ExpandedCommand& out);
+
+    /**
+     * @brief Expand one parsed pipeline stage and append it to @p out
+     *
+     * Only the words are expanded; the stages and redirections come from
+     * the parser and are not lexed again. Each redirection target becomes
+     * exactly one word. An alias on the first word of the first stage is
+     * the exception: its text is lexed, and may add stages or redirections.
+     * @param stage Parsed stage (must outlive @p out)
+     * @param command False for a plain word list (for-loop items), whose
+     *                first word is never an alias
+     */
+    void expandStage(const ast::Stage& stage, ExpandedCommand& out, bool command = true);
+
+    /**
+     * @brief Expand $-forms in a string without splitting or globbing
+     *
+     * Quotes are kept as written and single-quoted text is not expanded.
+     * Used for arithmetic expressions and substituted command text.
+     */
+    std::string expandText(std::string_view text);
+
+    /**
+     * @brief True if a word needs no expansion or quote removal
+     */
+    static bool isPlain(std::string_view word);
+
+private:
+    struct Dollar;
+    class FieldBuilder;
+
+    Dollar scanDollar(std::string_view text, size_t pos) const;
+    std::string evaluate(const Dollar& dollar);
+    struct PendingRedirect;
+
+    void expandWord(std::string_view word, ExpandedCommand& out, bool conditional);
+    void addWord(std::string_view word, ExpandedCommand& out, bool conditional);
+    void addAlias(const std::string& name, std::vector<PendingRedirect>& redirects, ExpandedCommand& out);
+    void endStage(const std::vector<PendingRedirect>& redirects, bool trimAfter, ExpandedCommand& out);
+    void expandFields(std::string_view word, FieldBuilder& fields);
+
+    SubstituteFunc substitute_;
+};
+
+} // namespace termidash
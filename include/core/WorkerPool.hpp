@@ -0,0 +1,172 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace termidash {
+
+/**
+ * @brief Persistent worker threads for builtin pipeline stages
+ *
+ * Pipeline stages block on each other through bridges, so every stage of a
+ * pipeline must be running at the same time: a task is never queued behind
+ * a busy worker. It goes to an idle worker if there is one, otherwise a new
+ * worker is started. Workers park between tasks; up to one per core is kept
+ * indefinitely and the rest retire after an idle timeout, so thread
+ * creation only happens when a pipeline is wider than anything run recently.
+ */
+class WorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    static WorkerPool& instance();
+
+    /**
+     * @brief Run task on a worker thread (never waits for a busy worker)
+     * @param done Called on the worker once it is available again
+     */
+    void submit(Task task, Task done = nullptr);
+
+    /**
+     * @brief Number of worker threads, busy or idle
+     */
+    size_t size() const;
+
+    /**
+     * @brief Number of parked workers
+     */
+    size_t idle() const;
+
+    /**
+     * @brief Idle workers kept without a timeout (defaults to the core count)
+     */
+    size_t retained() const { return retain_; }
+
+    explicit WorkerPool(size_t retain, std::chrono::milliseconds idleTimeout = std::chrono::seconds(5));
+
+    /**
+     * @brief Waits for running tasks, then stops every worker
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+private:
+    struct Job {
+        Task task;
+        Task done;
+    };
+
+    void workerLoop(Job job);
+
+    const size_t retain_;
+    const std::chrono::milliseconds idleTimeout_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable retired_;
+    std::deque<Job> queue_;
+    size_t workers_ = 0;
+    size_t idle_ = 0; // parked workers not yet claimed by a queued task
+    bool stopping_ = false;
+};
+
+/**
+ * @brief A set of tasks run on a WorkerPool that can be waited for together
+ *
+ * Replaces a vector of std::thread plus join(): the destructor waits.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkerPool& pool = WorkerPool::instance()) : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(WorkerPool::Task task);
+
+    /**
+     * @brief Block until every task started with run() has finished
+     */
+    void wait();
+
+private:
+    WorkerPool& pool_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    size_t pending_ = 0;
+};
+
+/**
+ * @brief Tasks that spawn more tasks, run by a fixed set of workers
+ *
+ * For tree walks, where the work is only discovered while doing it. Each
+ * worker keeps its own deque: tasks spawned by a task go on the front of its
+ * worker's deque and are taken from there (depth first, cache-warm), and a
+ * worker that runs out steals from the back of the others' (the oldest,
+ * usually largest subtrees). Unlike TaskGroup the number of threads stays
+ * fixed however many tasks are queued.
+ */
+class WorkStealingGroup {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param workers Number of workers including the thread calling run();
+     *        0 means one per core
+     */
+    explicit WorkStealingGroup(size_t workers = 0, WorkerPool& pool = WorkerPool::instance());
+
+    WorkStealingGroup(const WorkStealingGroup&) = delete;
+    WorkStealingGroup& operator=(const WorkStealingGroup&) = delete;
+
+    /**
+     * @brief Queue a task; called from one of this group's tasks, it goes on
+     *        that worker's own deque
+     */
+    void spawn(Task task);
+
+    /**
+     * @brief Run until every task, including those spawned meanwhile, has
+     *        finished. The calling thread works too
+     */
+    void run();
+
+    /**
+     * @brief Drop queued tasks; run() returns once the running ones finish
+     */
+    void cancel();
+
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    size_t workers() const { return queues_.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool take(size_t index, Task& task);
+    void finished();
+
+    WorkerPool& pool_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::atomic<size_t> pending_{0}; // queued or running
+    std::atomic<size_t> queued_{0};  // waiting in a deque
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<bool> cancelled_{false};
+    std::mutex idleMutex_;
+    std::condition_variable idle_;
+    size_t sleeping_ = 0;
+};
+
+} // namespace termidash
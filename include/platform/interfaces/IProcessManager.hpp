@@ -6,6 +6,18 @@
 namespace termidash {
 namespace platform {
 
+/**
+ * @brief How one child process ended, with its resource usage
+ */
+struct ChildStatus {
+    long pid = -1;
+    int exitCode = -1;      // Exit status, 128 + signal if killed, -1 if unknown
+    int termSignal = 0;     // Terminating signal, 0 if it exited normally
+    double userSeconds = 0.0;
+    double systemSeconds = 0.0;
+    long maxRssKb = 0;      // Peak resident set size
+};
+
 /**
  * @brief Interface for platform-specific process management
  * 
@@ -39,6 +51,21 @@ public:
      * @return Exit code, or -1 on failure
      */
     virtual int wait(long pid) = 0;
+
+    /**
+     * @brief Wait for several processes (e.g. pipeline stages)
+     *
+     * Implementations may collect the processes in any order as they
+     * finish; results are returned in the order of @p pids.
+     */
+    virtual std::vector<ChildStatus> waitAll(const std::vector<long>& pids) {
+        std::vector<ChildStatus> statuses(pids.size());
+        for (size_t i = 0; i < pids.size(); ++i) {
+            statuses[i].pid = pids[i];
+            statuses[i].exitCode = wait(pids[i]);
+        }
+        return statuses;
+    }
     
     /**
      * @brief Kill a specific process
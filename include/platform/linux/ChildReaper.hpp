@@ -0,0 +1,62 @@
+#pragma once
+#include "platform/interfaces/IProcessManager.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <sys/types.h>
+#include <unordered_map>
+
+namespace termidash {
+namespace platform {
+namespace linux_platform {
+
+/**
+ * @brief Reaps every child the shell starts
+ *
+ * Each child is registered right after it is spawned. The reaper opens a
+ * pidfd for it and watches all of them from one epoll instance on its own
+ * thread, so a child is reaped as soon as it exits, whether anyone is
+ * waiting for it or not. Its status is kept until wait() or poll() takes it.
+ *
+ * Children are only ever reaped by pid, never with waitpid(-1), so nothing
+ * else's status can be stolen. Without pidfd support (old kernels, other
+ * systems) wait() and poll() reap the given pid directly instead.
+ */
+class ChildReaper {
+public:
+    static ChildReaper& instance();
+
+    /**
+     * @brief Take charge of a child that has just been spawned
+     */
+    void add(pid_t pid);
+
+    /**
+     * @brief Block until a child has exited and take its status
+     */
+    ChildStatus wait(pid_t pid);
+
+    /**
+     * @brief Take a child's status if it has already exited
+     * @return false if it is still running (or stopped)
+     */
+    bool poll(pid_t pid, ChildStatus& status);
+
+private:
+    struct Child {
+        int pidfd = -1; // -1: not watched, reaped by its waiter
+        bool exited = false;
+        ChildStatus status;
+    };
+
+    ChildReaper();
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable exited_;
+    std::unordered_map<pid_t, Child> children_;
+    int epfd_ = -1;
+};
+
+} // namespace linux_platform
+} // namespace platform
+} // namespace termidash
@@ -6,6 +6,14 @@ namespace termidash {
 namespace platform {
 namespace linux_platform {
 
+/**
+ * @brief How child processes are started
+ */
+enum class SpawnBackend {
+    PosixSpawn, // posix_spawnp: vfork-style, no page-table copy
+    Fork        // fork + execvp: fallback when posix_spawn is unavailable
+};
+
 class LinuxProcessManager : public IProcessManager {
 public:
     LinuxProcessManager() = default;
@@ -14,13 +22,24 @@ public:
     long spawn(const std::string& command, const std::vector<std::string>& args, bool background,
                long stdIn = -1, long stdOut = -1, long stdErr = -1) override;
     int wait(long pid) override;
+    std::vector<ChildStatus> waitAll(const std::vector<long>& pids) override;
     bool kill(long pid) override;
     bool createPipe(long& readHandle, long& writeHandle) override;
     void closeHandle(long handle) override;
     std::string getLastError() override;
 
+    /**
+     * @brief Select the spawn backend (PosixSpawn by default)
+     */
+    void setBackend(SpawnBackend backend) { backend_ = backend; }
+    SpawnBackend backend() const { return backend_; }
+
 private:
+    long spawnWithPosixSpawn(const char* file, char* const argv[], long stdIn, long stdOut, long stdErr);
+    long spawnWithFork(const char* file, char* const argv[], long stdIn, long stdOut, long stdErr);
+
     std::string lastError;
+    SpawnBackend backend_ = SpawnBackend::PosixSpawn;
 };
 
 } // namespace linux_platform
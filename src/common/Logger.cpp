@@ -79,6 +79,17 @@ std::string Logger::getLogFilePath() {
 #endif
 }
 
+std::string Logger::getCacheDirectory() {
+  std::filesystem::path logDir(getLogDirectory());
+#ifdef __APPLE__
+  // macOS: ~/Library/Caches/Termidash
+  return (logDir.parent_path().parent_path() / "Caches" / "Termidash").string();
+#else
+  // Windows: %APPDATA%\Termidash\cache, Linux: ~/.local/share/termidash/cache
+  return (logDir.parent_path() / "cache").string();
+#endif
+}
+
 void Logger::init() {
   if (s_initialized) {
     return;
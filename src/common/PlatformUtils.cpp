@@ -6,15 +6,27 @@
 
 #pragma comment(lib, "Shell32.lib")
 #else
+#include <cerrno>
+#include <csignal>
 #include <fcntl.h>
+#include <pthread.h>
 #include <pwd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #endif
 
+#include <algorithm>
 #include <filesystem>
+#include <memory>
+#include <thread>
 
 namespace PlatformUtils {
 
@@ -60,7 +72,7 @@ long openFileForRead(const std::string &path) {
     return -1;
   return (long)hFile;
 #else
-  int fd = open(path.c_str(), O_RDONLY);
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
   return (long)fd;
 #endif
 }
@@ -83,7 +95,7 @@ long openFileForWrite(const std::string &path, bool append) {
   }
   return (long)hFile;
 #else
-  int flags = O_WRONLY | O_CREAT;
+  int flags = O_WRONLY | O_CREAT | O_CLOEXEC;
   if (append)
     flags |= O_APPEND;
   else
@@ -103,6 +115,285 @@ void closeFile(long handle) {
 #endif
 }
 
+bool readAll(long handle, std::string &out) {
+  const size_t chunk = 64 * 1024;
+  while (true) {
+    size_t used = out.size();
+    out.resize(used + chunk);
+#ifdef _WIN32
+    DWORD got = 0;
+    if (!ReadFile((HANDLE)handle, &out[used], (DWORD)chunk, &got, NULL)) {
+      out.resize(used);
+      return GetLastError() == ERROR_BROKEN_PIPE; // writer closed the pipe
+    }
+#else
+    ssize_t got = read((int)handle, &out[used], chunk);
+    if (got < 0 && errno == EINTR) {
+      out.resize(used);
+      continue;
+    }
+    if (got < 0) {
+      out.resize(used);
+      return false;
+    }
+#endif
+    out.resize(used + static_cast<size_t>(got));
+    if (got == 0)
+      return true;
+  }
+}
+
+long standardInput() {
+#ifdef _WIN32
+  return (long)GetStdHandle(STD_INPUT_HANDLE);
+#else
+  return STDIN_FILENO;
+#endif
+}
+
+long standardError() {
+#ifdef _WIN32
+  return (long)GetStdHandle(STD_ERROR_HANDLE);
+#else
+  return STDERR_FILENO;
+#endif
+}
+
+long readSome(long handle, char *buffer, size_t size) {
+#ifdef _WIN32
+  DWORD got = 0;
+  if (!ReadFile((HANDLE)handle, buffer, (DWORD)size, &got, NULL))
+    return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+  return (long)got;
+#else
+  while (true) {
+    ssize_t got = read((int)handle, buffer, size);
+    if (got < 0 && errno == EINTR)
+      continue;
+    return (long)got;
+  }
+#endif
+}
+
+bool writeAll(long handle, const char *data, size_t size) {
+  while (size > 0) {
+#ifdef _WIN32
+    DWORD written = 0;
+    if (!WriteFile((HANDLE)handle, data, (DWORD)size, &written, NULL))
+      return false;
+    size_t n = written;
+#else
+    ssize_t n = write((int)handle, data, size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+#endif
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+namespace {
+
+#ifdef __linux__
+// Errors meaning this kind of transfer does not apply to the handles, so
+// another method should be tried (nothing has been copied yet)
+bool transferUnsupported(int error) {
+  return error == EINVAL || error == EXDEV || error == ENOSYS || error == EOPNOTSUPP || error == EBADF;
+}
+
+// Move data between kernel objects with the given call until end of input.
+// Returns 1 when done, 0 if the call does not apply here, -1 on error
+template <typename Transfer> int transferLoop(Transfer transfer) {
+  const size_t chunk = 1 << 30;
+  bool moved = false;
+  while (true) {
+    ssize_t n = transfer(chunk);
+    if (n > 0) {
+      moved = true;
+      continue;
+    }
+    if (n == 0)
+      return 1;
+    if (errno == EINTR)
+      continue;
+    return !moved && transferUnsupported(errno) ? 0 : -1;
+  }
+}
+#endif
+
+} // namespace
+
+bool copyAll(long from, long to) {
+#ifdef __linux__
+  int in = (int)from;
+  int out = (int)to;
+  struct stat inStat, outStat;
+  if (fstat(in, &inStat) == 0 && fstat(out, &outStat) == 0) {
+    int done = 0;
+    // Files reporting no size (procfs, sysfs) must be read normally
+    bool sizedFile = S_ISREG(inStat.st_mode) && inStat.st_size > 0;
+    if (sizedFile && S_ISREG(outStat.st_mode))
+      done = transferLoop([=](size_t n) { return copy_file_range(in, nullptr, out, nullptr, n, 0); });
+    if (done == 0 && sizedFile)
+      done = transferLoop([=](size_t n) { return sendfile(out, in, nullptr, n); });
+    if (done == 0 && (S_ISFIFO(inStat.st_mode) || S_ISFIFO(outStat.st_mode)))
+      done = transferLoop([=](size_t n) { return splice(in, nullptr, out, nullptr, n, SPLICE_F_MOVE); });
+    if (done != 0)
+      return done > 0;
+  }
+#endif
+  std::unique_ptr<char[]> buffer(new char[256 * 1024]);
+  while (true) {
+    long n = readSome(from, buffer.get(), 256 * 1024);
+    if (n <= 0)
+      return n == 0;
+    if (!writeAll(to, buffer.get(), static_cast<size_t>(n)))
+      return false;
+  }
+}
+
+bool cloneFile(long from, long to) {
+#if defined(__linux__) && defined(FICLONE)
+  return ioctl((int)to, FICLONE, (int)from) == 0;
+#else
+  (void)from;
+  (void)to;
+  return false;
+#endif
+}
+
+void blockPipeSignal() {
+#ifndef _WIN32
+  sigset_t pipeSignal;
+  sigemptyset(&pipeSignal);
+  sigaddset(&pipeSignal, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipeSignal, nullptr);
+#endif
+}
+
+PipeSignalGuard::PipeSignalGuard() {
+#ifndef _WIN32
+  sigset_t pipeSignal;
+  sigemptyset(&pipeSignal);
+  sigaddset(&pipeSignal, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipeSignal, &previous_);
+#endif
+}
+
+PipeSignalGuard::~PipeSignalGuard() {
+#ifndef _WIN32
+  if (!sigismember(&previous_, SIGPIPE)) {
+    // A failed write left SIGPIPE pending; unblocking would deliver it
+    sigset_t pending;
+    sigpending(&pending);
+    if (sigismember(&pending, SIGPIPE)) {
+      sigset_t pipeSignal;
+      sigemptyset(&pipeSignal);
+      sigaddset(&pipeSignal, SIGPIPE);
+      int signal = 0;
+      sigwait(&pipeSignal, &signal);
+    }
+  }
+  pthread_sigmask(SIG_SETMASK, &previous_, nullptr);
+#endif
+}
+
+#ifndef _WIN32
+bool initSpawnAttributes(posix_spawnattr_t &attr) {
+  if (posix_spawnattr_init(&attr) != 0)
+    return false;
+  sigset_t none;
+  sigset_t pipeSignal;
+  sigemptyset(&none);
+  sigemptyset(&pipeSignal);
+  sigaddset(&pipeSignal, SIGPIPE);
+  if (posix_spawnattr_setsigmask(&attr, &none) != 0 ||
+      posix_spawnattr_setsigdefault(&attr, &pipeSignal) != 0 ||
+      posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF) != 0) {
+    posix_spawnattr_destroy(&attr);
+    return false;
+  }
+  return true;
+}
+#endif
+
+namespace {
+
+// Data up to this size fits in a fresh pipe's buffer on every platform
+// (macOS starts at 16 KiB), so it can be written without a thread
+const size_t pipeBufferSize = 16 * 1024;
+
+} // namespace
+
+long openMemoryForRead(const std::string &data) {
+#ifdef _WIN32
+  SECURITY_ATTRIBUTES sa;
+  sa.nLength = sizeof(SECURITY_ATTRIBUTES);
+  sa.lpSecurityDescriptor = NULL;
+  sa.bInheritHandle = TRUE;
+
+  HANDLE readEnd = NULL;
+  HANDLE writeEnd = NULL;
+  DWORD size = (DWORD)std::min(data.size(), pipeBufferSize);
+  if (!CreatePipe(&readEnd, &writeEnd, &sa, size))
+    return -1;
+  SetHandleInformation(writeEnd, HANDLE_FLAG_INHERIT, 0);
+
+  auto writeBody = [](HANDLE handle, const std::string &body) {
+    size_t offset = 0;
+    while (offset < body.size()) {
+      DWORD written = 0;
+      DWORD chunk = (DWORD)std::min(body.size() - offset, pipeBufferSize);
+      if (!WriteFile(handle, body.data() + offset, chunk, &written, NULL))
+        break;
+      offset += written;
+    }
+    CloseHandle(handle);
+  };
+  if (data.size() <= pipeBufferSize) {
+    writeBody(writeEnd, data);
+  } else {
+    std::thread(writeBody, writeEnd, data).detach();
+  }
+  return (long)readEnd;
+#else
+#ifdef __linux__
+  int memfd = memfd_create("termidash-input", MFD_CLOEXEC);
+  if (memfd != -1) {
+    if (!writeAll(memfd, data.data(), data.size()) || lseek(memfd, 0, SEEK_SET) != 0) {
+      close(memfd);
+      return -1;
+    }
+    return (long)memfd;
+  }
+#endif
+  int fds[2];
+  if (pipe(fds) == -1)
+    return -1;
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+  if (data.size() <= pipeBufferSize) {
+    writeAll(fds[1], data.data(), data.size());
+    close(fds[1]);
+    return (long)fds[0];
+  }
+
+  auto body = std::make_shared<std::string>(data);
+  int writeEnd = fds[1];
+  std::thread([body, writeEnd]() {
+    // A reader that exits early must not kill the shell with SIGPIPE
+    blockPipeSignal();
+    writeAll(writeEnd, body->data(), body->size());
+    close(writeEnd);
+  }).detach();
+  return (long)fds[0];
+#endif
+}
+
 std::string getEnv(const std::string &name) {
 #ifdef _WIN32
   char *buf = nullptr;
@@ -0,0 +1,140 @@
+#include "core/BlockReader.hpp"
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace termidash {
+
+namespace {
+
+const size_t blockSize = 256 * 1024;
+
+const char* lastNewline(const char* data, size_t size) {
+#ifdef __GLIBC__
+    return static_cast<const char*>(memrchr(data, '\n', size));
+#else
+    for (const char* p = data + size; p > data; --p) {
+        if (p[-1] == '\n') return p - 1;
+    }
+    return nullptr;
+#endif
+}
+
+// The last n lines of data; a final line without newline counts as a line
+std::string_view lastLinesOf(std::string_view data, size_t n) {
+    const char* begin = data.data();
+    const char* p = begin + data.size();
+    if (p > begin && p[-1] == '\n') --p;
+    for (size_t count = 0; p > begin;) {
+        const char* newline = lastNewline(begin, static_cast<size_t>(p - begin));
+        if (!newline) return data;
+        if (++count == n) {
+            p = newline + 1;
+            break;
+        }
+        p = newline;
+    }
+    return data.substr(static_cast<size_t>(p - begin));
+}
+
+} // namespace
+
+BlockReader::BlockReader(ExecContext& ctx) : ctx_(&ctx) {}
+
+BlockReader::BlockReader(const std::string& path) {
+    handle_ = PlatformUtils::openFileForRead(path);
+    if (handle_ == -1) {
+        ok_ = false;
+        return;
+    }
+#ifndef _WIN32
+    struct stat st;
+    int fd = static_cast<int>(handle_);
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            map_ = static_cast<const char*>(map);
+            mapSize_ = static_cast<size_t>(st.st_size);
+            madvise(map, mapSize_, MADV_SEQUENTIAL);
+        }
+    }
+#endif
+}
+
+BlockReader::~BlockReader() {
+#ifndef _WIN32
+    if (map_) munmap(const_cast<char*>(map_), mapSize_);
+#endif
+    PlatformUtils::closeFile(handle_);
+}
+
+size_t BlockReader::fill(char* buffer, size_t size) {
+    if (ctx_) return ctx_->read(buffer, size);
+    long n = PlatformUtils::readSome(handle_, buffer, size);
+    return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+bool BlockReader::next(std::string_view& block) {
+    if (map_) {
+        if (done_) return false;
+        done_ = true;
+        block = std::string_view(map_, mapSize_);
+        return true;
+    }
+
+    // Drop the block handed out last time; its partial last line stays
+    if (pending_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + pending_, carried_);
+        pending_ = 0;
+    }
+    if (buffer_.empty()) buffer_.resize(blockSize);
+    while (!done_) {
+        // One line longer than the buffer
+        if (carried_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+        size_t n = fill(buffer_.data() + carried_, buffer_.size() - carried_);
+        if (n == 0) {
+            done_ = true;
+            break;
+        }
+        size_t filled = carried_ + n;
+        const char* newline = lastNewline(buffer_.data() + carried_, n);
+        if (!newline) {
+            carried_ = filled;
+            continue;
+        }
+        pending_ = static_cast<size_t>(newline - buffer_.data()) + 1;
+        carried_ = filled - pending_;
+        block = std::string_view(buffer_.data(), pending_);
+        return true;
+    }
+
+    // End of input: whatever is left is a last line without newline
+    if (carried_ == 0) return false;
+    block = std::string_view(buffer_.data(), carried_);
+    pending_ = carried_;
+    carried_ = 0;
+    return true;
+}
+
+std::string_view BlockReader::lastLines(size_t n) {
+    if (n == 0) return std::string_view();
+    if (map_) return lastLinesOf(std::string_view(map_, mapSize_), n);
+
+    // Drop lines that can no longer be among the last n, but only once the
+    // kept text has grown enough that rescanning it stays cheap overall
+    size_t kept = 0;
+    std::string_view block;
+    while (next(block)) {
+        tail_.append(block.data(), block.size());
+        if (tail_.size() > 2 * kept + blockSize) {
+            tail_.erase(0, tail_.size() - lastLinesOf(tail_, n).size());
+            kept = tail_.size();
+        }
+    }
+    return lastLinesOf(tail_, n);
+}
+
+} // namespace termidash
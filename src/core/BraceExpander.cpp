@@ -6,13 +6,47 @@
 namespace termidash {
 
 bool BraceExpander::hasBraces(const std::string& input) {
-    // Look for { followed by } with content in between
-    size_t openPos = input.find('{');
-    if (openPos == std::string::npos) {
-        return false;
+    size_t closePos = 0;
+    return findExpansion(input, closePos) != std::string::npos;
+}
+
+size_t BraceExpander::findExpansion(const std::string& str, size_t& closePos) {
+    // Like bash, {} and braces without a comma or range stay literal, so
+    // find -exec cmd {} \; and a{b}c keep their braces
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] != '{') {
+            continue;
+        }
+        size_t close = findMatchingBrace(str, i);
+        if (close == std::string::npos) {
+            continue;
+        }
+        std::string content = str.substr(i + 1, close - i - 1);
+        if (isRange(content) || hasTopLevelComma(content)) {
+            closePos = close;
+            return i;
+        }
+    }
+    return std::string::npos;
+}
+
+bool BraceExpander::hasTopLevelComma(const std::string& content) {
+    int depth = 0;
+    bool escaped = false;
+    for (char c : content) {
+        if (escaped) {
+            escaped = false;
+        } else if (c == '\\') {
+            escaped = true;
+        } else if (c == '{') {
+            ++depth;
+        } else if (c == '}') {
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            return true;
+        }
     }
-    size_t closePos = findMatchingBrace(input, openPos);
-    return closePos != std::string::npos;
+    return false;
 }
 
 size_t BraceExpander::findMatchingBrace(const std::string& str, size_t openPos) {
@@ -208,17 +242,9 @@ std::vector<std::string> BraceExpander::expandBraceContent(
 std::vector<std::string> BraceExpander::expand(const std::string& input) {
     std::vector<std::string> result;
     
-    // Find the first { that has a matching }
-    size_t openPos = std::string::npos;
-    for (size_t i = 0; i < input.size(); ++i) {
-        if (input[i] == '{') {
-            size_t closePos = findMatchingBrace(input, i);
-            if (closePos != std::string::npos) {
-                openPos = i;
-                break;
-            }
-        }
-    }
+    // Find the first brace pair that is a comma list or range
+    size_t closePos = 0;
+    size_t openPos = findExpansion(input, closePos);
     
     if (openPos == std::string::npos) {
         // No braces to expand
@@ -226,8 +252,6 @@ std::vector<std::string> BraceExpander::expand(const std::string& input) {
         return result;
     }
     
-    size_t closePos = findMatchingBrace(input, openPos);
-    
     std::string prefix = input.substr(0, openPos);
     std::string braceContent = input.substr(openPos + 1, closePos - openPos - 1);
     std::string suffix = input.substr(closePos + 1);
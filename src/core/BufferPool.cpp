@@ -0,0 +1,95 @@
+#include "core/BufferPool.hpp"
+#include <cctype>
+#include <cstdlib>
+
+namespace termidash {
+
+namespace {
+
+bool parseSize(const std::string& text, size_t& out) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    std::string suffix(end);
+    if (suffix == "K" || suffix == "k") value <<= 10;
+    else if (suffix == "M" || suffix == "m") value <<= 20;
+    else if (suffix == "G" || suffix == "g") value <<= 30;
+    else if (!suffix.empty()) return false;
+    if (value == 0) return false;
+    out = static_cast<size_t>(value);
+    return true;
+}
+
+std::string formatSize(size_t size) {
+    if (size % (1 << 30) == 0) return std::to_string(size >> 30) + "G";
+    if (size % (1 << 20) == 0) return std::to_string(size >> 20) + "M";
+    if (size % (1 << 10) == 0) return std::to_string(size >> 10) + "K";
+    return std::to_string(size);
+}
+
+} // namespace
+
+BufferPool& BufferPool::instance() {
+    static BufferPool instance;
+    return instance;
+}
+
+BufferPool::Block BufferPool::acquire(size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = free_.find(size);
+        if (it != free_.end() && !it->second.empty()) {
+            Block block = std::move(it->second.back());
+            it->second.pop_back();
+            pooledBytes_ -= size;
+            return block;
+        }
+    }
+    return Block(new char[size]);
+}
+
+void BufferPool::release(Block block, size_t size) {
+    if (!block) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pooledBytes_ + size > retainLimit) return; // block is freed
+    free_[size].push_back(std::move(block));
+    pooledBytes_ += size;
+}
+
+size_t BufferPool::pooledBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pooledBytes_;
+}
+
+void BufferPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.clear();
+    pooledBytes_ = 0;
+}
+
+BufferPool::Policy BufferPool::policy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+void BufferPool::setPolicy(const Policy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+}
+
+bool BufferPool::parsePolicy(const std::string& text, Policy& out) {
+    size_t colon = text.find(':');
+    if (colon == std::string::npos) return false;
+    Policy policy;
+    if (!parseSize(text.substr(0, colon), policy.initial) || !parseSize(text.substr(colon + 1), policy.max))
+        return false;
+    if (policy.initial > policy.max) return false;
+    out = policy;
+    return true;
+}
+
+std::string BufferPool::formatPolicy(const Policy& policy) {
+    return formatSize(policy.initial) + ":" + formatSize(policy.max);
+}
+
+} // namespace termidash
@@ -2,12 +2,25 @@
 #include "core/AliasManager.hpp"
 #include "core/VariableManager.hpp"
 #include "core/PromptEngine.hpp"
+#include "core/Lexer.hpp"
+#include "core/PathIndex.hpp"
+#include "core/BufferPool.hpp"
+#include "core/TestCommand.hpp"
+#include "core/ReadCommand.hpp"
+#include "core/SortCommand.hpp"
+#include "core/BlockReader.hpp"
+#include "core/TextSearch.hpp"
+#include "common/PlatformUtils.hpp"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <vector>
 #include <string>
 #include <sstream>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -18,6 +31,68 @@
 
 namespace termidash
 {
+    namespace
+    {
+        // cat: copy one input (a handle, or ctx.in when -1) to the output.
+        // Handle to handle needs no user-space buffer at all; otherwise data
+        // moves in large blocks. Returns false on a read error
+        bool copyInput(::ExecContext& ctx, long handle)
+        {
+            if (handle != -1 && ctx.outFd != -1)
+            {
+                if (ctx.out.flush() && !PlatformUtils::copyAll(handle, ctx.outFd))
+                    ctx.out.setstate(std::ios::badbit);
+                return true;
+            }
+            std::vector<char> buffer(256 * 1024);
+            while (!ctx.cancelled())
+            {
+                long n = handle != -1 ? PlatformUtils::readSome(handle, buffer.data(), buffer.size())
+                                      : static_cast<long>(ctx.read(buffer.data(), buffer.size()));
+                if (n < 0)
+                    return false;
+                if (n == 0 || !ctx.write(buffer.data(), static_cast<size_t>(n)))
+                    break;
+            }
+            return true;
+        }
+
+        // Run fn on every input a line-oriented builtin names: each file, or
+        // the command's own input when none is given or for "-". Returns
+        // false if a file could not be opened (after reporting it)
+        bool forEachInput(::ExecContext& ctx, const std::string& cmd, const std::vector<std::string>& files,
+                          const std::function<void(BlockReader&, const std::string&)>& fn)
+        {
+            if (files.empty())
+            {
+                BlockReader reader(ctx);
+                fn(reader, "(standard input)");
+                return true;
+            }
+            bool ok = true;
+            for (const auto& file : files)
+            {
+                if (ctx.cancelled())
+                    break;
+                if (file == "-")
+                {
+                    BlockReader reader(ctx);
+                    fn(reader, "(standard input)");
+                    continue;
+                }
+                BlockReader reader(file);
+                if (!reader.ok())
+                {
+                    ctx.err << cmd << ": " << file << ": No such file\n";
+                    ok = false;
+                    continue;
+                }
+                fn(reader, file);
+            }
+            return ok;
+        }
+    } // namespace
+
     CommonCommandHandler::CommonCommandHandler()
     {
     }
@@ -56,13 +131,24 @@ namespace termidash
 
         const std::string &cmd = tokens[0];
 
+        // Condition builtins first: loops evaluate them on every iteration
+        if (cmd == "true" || cmd == ":")
+            return 0;
+        if (cmd == "false")
+            return 1;
+        if (TestCommand::isTestCommand(cmd))
+            return TestCommand::run(tokens, ctx.err);
+        if (cmd == "read")
+            return ReadCommand::run(tokens, ctx);
+
         if (cmd == "help")
         {
             ctx.out << "Available commands:\n";
             ctx.out << "  cd, cls, ver, getenv, setenv, cwd, drives, type, mkdir, rmdir, copy, del\n";
             ctx.out << "  tasklist, taskkill, ping, ipconfig, whoami, hostname, assoc, systeminfo, netstat\n";
             ctx.out << "  echo, pause, time, date, dir, attrib\n";
-            ctx.out << "  clear, help, exit, version, alias, unalias, pwd, touch, rm, cat, uptime, grep, sort, head, tail, history\n";
+            ctx.out << "  clear, help, exit, version, alias, unalias, pwd, touch, rm, cat, uptime, grep, sort, head, tail, history, hash\n";
+            ctx.out << "  test, [, [[, true, false, :, read\n";
             return 0;
         }
         else if (cmd == "clear")
@@ -199,6 +285,37 @@ namespace termidash
         }
         else if (cmd == "set")
         {
+            if (tokens.size() > 1 && tokens[1] == "-o")
+            {
+                // set -o: list options; set -o name=value: change one
+                if (tokens.size() == 2)
+                {
+                    ctx.out << "pipebuf\t" << BufferPool::formatPolicy(BufferPool::instance().policy()) << "\n";
+                    return 0;
+                }
+                int ret = 0;
+                for (size_t i = 2; i < tokens.size(); ++i)
+                {
+                    size_t eq = tokens[i].find('=');
+                    std::string name = tokens[i].substr(0, eq);
+                    BufferPool::Policy policy;
+                    if (name != "pipebuf")
+                    {
+                        ctx.err << "set: " << name << ": invalid option name\n";
+                        ret = 1;
+                    }
+                    else if (eq == std::string::npos || !BufferPool::parsePolicy(tokens[i].substr(eq + 1), policy))
+                    {
+                        ctx.err << "set: pipebuf: expected INITIAL:MAX, e.g. pipebuf=4K:1M\n";
+                        ret = 1;
+                    }
+                    else
+                    {
+                        BufferPool::instance().setPolicy(policy);
+                    }
+                }
+                return ret;
+            }
             // List all variables
             auto vars = VariableManager::instance().getAll();
             for (const auto& pair : vars)
@@ -262,26 +379,32 @@ namespace termidash
         {
             if (tokens.size() < 2)
             {
-                // Read from stdin
-                std::string line;
-                while (std::getline(ctx.in, line)) {
-                    ctx.out << line << "\n";
+                // Read from stdin, directly from its handle unless the stream
+                // already holds some of it
+                bool direct = ctx.inFd != -1 && ctx.in.rdbuf()->in_avail() <= 0;
+                if (!copyInput(ctx, direct ? ctx.inFd : -1))
+                {
+                    ctx.err << "cat: read error\n";
+                    return 1;
                 }
                 return 0;
             }
             int ret = 0;
-            for (size_t i = 1; i < tokens.size(); ++i)
+            for (size_t i = 1; i < tokens.size() && !ctx.cancelled(); ++i)
             {
-                std::ifstream file(tokens[i]);
-                if (file)
+                long file = PlatformUtils::openFileForRead(tokens[i]);
+                if (file == -1)
                 {
-                    ctx.out << file.rdbuf() << "\n";
+                    ctx.err << "cat: " << tokens[i] << ": No such file or directory\n";
+                    ret = 1;
+                    continue;
                 }
-                else
+                if (!copyInput(ctx, file))
                 {
-                    ctx.err << "cat: " << tokens[i] << ": No such file or directory\n";
+                    ctx.err << "cat: " << tokens[i] << ": Read error\n";
                     ret = 1;
                 }
+                PlatformUtils::closeFile(file);
             }
             return ret;
         }
@@ -292,114 +415,139 @@ namespace termidash
         }
         else if (cmd == "history")
         {
-            for (size_t i = 0; i < history.size(); ++i)
+            for (size_t i = 0; i < history.size() && !ctx.cancelled(); ++i)
             {
                 ctx.out << i + 1 << "  " << history[i] << "\n";
             }
             return 0;
         }
-        else if (cmd == "grep")
+        else if (cmd == "hash")
         {
-             if (tokens.size() < 3) {
-                ctx.err << "grep: usage: grep pattern file\n";
-                return 1;
-            }
-            std::string pattern = tokens[1];
-            std::string filename = tokens[2];
-            std::ifstream file(filename);
-            if (!file) {
-                ctx.err << "grep: " << filename << ": No such file\n";
-                return 1;
+            // hash: list remembered commands; hash -r: forget them; hash name: look up
+            if (tokens.size() == 1)
+            {
+                auto hits = PathIndex::instance().hits();
+                if (hits.empty())
+                {
+                    ctx.out << "hash: hash table empty\n";
+                    return 0;
+                }
+                ctx.out << "hits\tcommand\n";
+                for (const auto& hit : hits)
+                {
+                    ctx.out << "   " << hit.hits << "\t" << hit.path << "\n";
+                }
+                return 0;
             }
-            std::string line;
-            bool found = false;
-            while (std::getline(file, line)) {
-                if (line.find(pattern) != std::string::npos) {
-                    ctx.out << line << "\n";
-                    found = true;
+            int ret = 0;
+            for (size_t i = 1; i < tokens.size(); ++i)
+            {
+                if (tokens[i] == "-r")
+                {
+                    PathIndex::instance().reset();
+                }
+                else if (PathIndex::instance().resolve(tokens[i]).empty())
+                {
+                    ctx.err << "hash: " << tokens[i] << ": not found\n";
+                    ret = 1;
                 }
             }
-            return found ? 0 : 1;
+            return ret;
         }
-        else if (cmd == "sort")
+        else if (cmd == "grep")
         {
             if (tokens.size() < 2) {
-                ctx.err << "sort: usage: sort file\n";
+                ctx.err << "grep: usage: grep pattern [file...]\n";
                 return 1;
             }
-            std::string filename = tokens[1];
-            std::ifstream file(filename);
-             if (!file) {
-                ctx.err << "sort: " << filename << ": No such file\n";
-                return 1;
-            }
-            std::vector<std::string> lines;
-            std::string line;
-            while (std::getline(file, line)) {
-                lines.push_back(line);
-            }
-            std::sort(lines.begin(), lines.end());
-            for (const auto& l : lines) {
-                ctx.out << l << "\n";
-            }
-            return 0;
+            // Search whole blocks for the pattern and only then find the
+            // line around each match
+            SubstringFinder finder(tokens[1]);
+            std::vector<std::string> files(tokens.begin() + 2, tokens.end());
+            bool prefix = files.size() > 1;
+            bool found = false;
+            bool ok = forEachInput(ctx, cmd, files, [&](BlockReader& reader, const std::string& name) {
+                std::string_view block;
+                while (!ctx.cancelled() && reader.next(block)) {
+                    const char* p = block.data();
+                    const char* end = p + block.size();
+                    while (p < end) {
+                        const char* hit = finder.find(p, end);
+                        if (!hit) break;
+                        const char* lineStart = hit;
+                        while (lineStart > p && lineStart[-1] != '\n') --lineStart;
+                        const char* lineEnd = static_cast<const char*>(std::memchr(hit, '\n', static_cast<size_t>(end - hit)));
+                        if (!lineEnd) lineEnd = end;
+                        if (prefix) ctx.out << name << ':';
+                        ctx.out.write(lineStart, lineEnd - lineStart);
+                        ctx.out << '\n';
+                        found = true;
+                        if (lineEnd == end) break;
+                        p = lineEnd + 1;
+                    }
+                }
+            });
+            return !ok ? 2 : found ? 0 : 1;
         }
-        else if (cmd == "head")
+        else if (cmd == "sort")
         {
-             if (tokens.size() < 2) {
-                ctx.err << "head: usage: head file\n";
-                return 1;
-            }
-            std::string filename = tokens[1];
-            std::ifstream file(filename);
-             if (!file) {
-                ctx.err << "head: " << filename << ": No such file\n";
-                return 1;
-            }
-            std::string line;
-            int count = 0;
-            while (count < 10 && std::getline(file, line)) {
-                ctx.out << line << "\n";
-                count++;
-            }
-            return 0;
+            return SortCommand::run(tokens, ctx);
         }
-        else if (cmd == "tail")
+        else if (cmd == "head" || cmd == "tail")
         {
-             if (tokens.size() < 2) {
-                ctx.err << "tail: usage: tail file\n";
-                return 1;
-            }
-            std::string filename = tokens[1];
-            std::ifstream file(filename);
-             if (!file) {
-                ctx.err << "tail: " << filename << ": No such file\n";
-                return 1;
-            }
-            std::vector<std::string> lines;
-            std::string line;
-            while (std::getline(file, line)) {
-                lines.push_back(line);
-            }
-            int n = 10;
-            int start = (std::max)(0, (int)lines.size() - n);
-            for (int i = start; i < lines.size(); ++i) {
-                ctx.out << lines[i] << "\n";
-            }
-            return 0;
+            // head/tail [-n N | -N] [file...]
+            size_t n = 10;
+            size_t arg = 1;
+            if (arg < tokens.size() && tokens[arg] == "-n" && arg + 1 < tokens.size()) {
+                n = static_cast<size_t>(std::max(0, std::atoi(tokens[arg + 1].c_str())));
+                arg += 2;
+            } else if (arg < tokens.size() && tokens[arg].size() > 1 && tokens[arg][0] == '-' &&
+                       std::isdigit(static_cast<unsigned char>(tokens[arg][1]))) {
+                n = static_cast<size_t>(std::atoi(tokens[arg].c_str() + 1));
+                ++arg;
+            }
+            std::vector<std::string> files(tokens.begin() + arg, tokens.end());
+            bool headers = files.size() > 1;
+            bool first = true;
+            bool ok = forEachInput(ctx, cmd, files, [&](BlockReader& reader, const std::string& name) {
+                if (headers) {
+                    ctx.out << (first ? "" : "\n") << "==> " << name << " <==\n";
+                    first = false;
+                }
+                if (cmd == "tail") {
+                    // Mapped files are read backwards from the end
+                    std::string_view last = reader.lastLines(n);
+                    ctx.write(last.data(), last.size());
+                    return;
+                }
+                // Stop reading as soon as n lines are out
+                size_t remaining = n;
+                std::string_view block;
+                while (remaining > 0 && !ctx.cancelled() && reader.next(block)) {
+                    const char* p = block.data();
+                    const char* end = p + block.size();
+                    const char* cut = p;
+                    while (remaining > 0 && cut < end) {
+                        const char* newline = static_cast<const char*>(std::memchr(cut, '\n', static_cast<size_t>(end - cut)));
+                        cut = newline ? newline + 1 : end;
+                        --remaining;
+                    }
+                    ctx.write(p, static_cast<size_t>(cut - p));
+                }
+            });
+            return ok ? 0 : 1;
         }
 
-
         return -1;
     }
 
     bool CommonCommandHandler::isCommand(const std::string& cmd) const
     {
+        // Only commands handled here; platform handlers report their own
         static const std::vector<std::string> commands = {
-            "cd", "cls", "ver", "getenv", "setenv", "cwd", "drives", "type", "mkdir", "rmdir", "copy", "del",
-            "tasklist", "taskkill", "ping", "ipconfig", "whoami", "hostname", "assoc", "systeminfo", "netstat",
-            "echo", "pause", "time", "date", "dir", "attrib", "help", "clear", "exit", "version", "alias", "unalias",
-            "pwd", "touch", "rm", "cat", "uptime", "history", "grep", "sort", "head", "tail", "unset", "export", "set"
+            "help", "clear", "exit", "version", "alias", "unalias", "pwd", "touch", "rm", "cat", "uptime",
+            "history", "grep", "sort", "head", "tail", "unset", "export", "set", "hash",
+            "test", "[", "[[", "true", "false", ":", "read"
         };
         return std::find(commands.begin(), commands.end(), cmd) != commands.end();
     }
@@ -420,15 +568,7 @@ namespace termidash
 
     std::vector<std::string> CommonCommandHandler::tokenize(const std::string& input) const
     {
-        std::stringstream ss(input);
-        std::string segment;
-        std::vector<std::string> tokens;
-        while (std::getline(ss, segment, ' '))
-        {
-            if (!segment.empty())
-                tokens.push_back(segment);
-        }
-        return tokens;
+        return Lexer::words(input);
     }
 
     const std::vector<std::string>& CommonCommandHandler::getHistory() const
@@ -1,13 +1,25 @@
 #ifndef _WIN32  // Linux/macOS only
 
 #include "core/BuiltIn/LinuxCommandHandler.hpp"
+#include "core/DiskUsage.hpp"
+#include "core/FindCommand.hpp"
+#include "core/WorkerPool.hpp"
+#include <cstdio>
 #include <filesystem>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <ctime>
 #include <unordered_set>
+#include <unordered_map>
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <unistd.h>
@@ -19,9 +31,49 @@ namespace fs = std::filesystem;
 
 namespace termidash {
 
+namespace {
+
+// User and group names, looked up once per id for the whole session
+class IdNameCache {
+public:
+    std::string user(uint32_t uid) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = users_.find(uid);
+        if (it != users_.end()) return it->second;
+        struct passwd entry;
+        struct passwd* result = nullptr;
+        std::vector<char> buffer(16 * 1024);
+        getpwuid_r(uid, &entry, buffer.data(), buffer.size(), &result);
+        return users_[uid] = result ? result->pw_name : std::to_string(uid);
+    }
+
+    std::string group(uint32_t gid) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = groups_.find(gid);
+        if (it != groups_.end()) return it->second;
+        struct group entry;
+        struct group* result = nullptr;
+        std::vector<char> buffer(16 * 1024);
+        getgrgid_r(gid, &entry, buffer.data(), buffer.size(), &result);
+        return groups_[gid] = result ? result->gr_name : std::to_string(gid);
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<uint32_t, std::string> users_;
+    std::unordered_map<uint32_t, std::string> groups_;
+};
+
+IdNameCache& idNames() {
+    static IdNameCache cache;
+    return cache;
+}
+
+} // namespace
+
 bool LinuxCommandHandler::isCommand(const std::string& cmd) const {
     static const std::unordered_set<std::string> commands = {
-        "ls", "cp", "mv", "chmod", "chown", "ln", "df", "free"
+        "ls", "cp", "mv", "chmod", "chown", "ln", "df", "free", "find", "du"
     };
     return commands.find(cmd) != commands.end();
 }
@@ -32,7 +84,7 @@ bool LinuxCommandHandler::handle(const std::vector<std::string>& tokens) {
 }
 
 int LinuxCommandHandler::handleWithContext(const std::vector<std::string>& tokens, ExecContext& ctx) {
-    if (tokens.empty()) return 1;
+    if (tokens.empty()) return -1;
     
     const std::string& cmd = tokens[0];
     std::vector<std::string> args(tokens.begin() + 1, tokens.end());
@@ -45,8 +97,10 @@ int LinuxCommandHandler::handleWithContext(const std::vector<std::string>& token
     if (cmd == "ln") return handleLn(args, ctx);
     if (cmd == "df") return handleDf(args, ctx);
     if (cmd == "free") return handleFree(args, ctx);
+    if (cmd == "find") return FindCommand::run(tokens, ctx);
+    if (cmd == "du") return handleDu(args, ctx);
     
-    return 1;
+    return -1;
 }
 
 std::string LinuxCommandHandler::formatSize(uintmax_t bytes, bool humanReadable) const {
@@ -104,26 +158,24 @@ std::string LinuxCommandHandler::formatPermissions(unsigned int mode) const {
 
 std::string LinuxCommandHandler::formatTime(std::time_t time) const {
     char buffer[32];
-    std::strftime(buffer, sizeof(buffer), "%b %d %H:%M", std::localtime(&time));
+    struct tm local;
+    std::strftime(buffer, sizeof(buffer), "%b %d %H:%M", localtime_r(&time, &local));
     return std::string(buffer);
 }
 
 int LinuxCommandHandler::handleLs(const std::vector<std::string>& args, ExecContext& ctx) {
-    bool longFormat = false;
-    bool showHidden = false;
-    bool humanReadable = false;
-    bool recursive = false;
+    LsOptions options;
     std::vector<std::string> paths;
     
     // Parse arguments
     for (const auto& arg : args) {
-        if (arg[0] == '-') {
+        if (arg.size() > 1 && arg[0] == '-') {
             for (size_t i = 1; i < arg.size(); ++i) {
                 switch (arg[i]) {
-                    case 'l': longFormat = true; break;
-                    case 'a': showHidden = true; break;
-                    case 'h': humanReadable = true; break;
-                    case 'R': recursive = true; break;
+                    case 'l': options.longFormat = true; break;
+                    case 'a': options.showHidden = true; break;
+                    case 'h': options.humanReadable = true; break;
+                    case 'R': options.recursive = true; break;
                 }
             }
         } else {
@@ -135,78 +187,370 @@ int LinuxCommandHandler::handleLs(const std::vector<std::string>& args, ExecCont
         paths.push_back(".");
     }
     
+    // Files named on the command line are listed first, then directories
+    bool ok = true;
+    std::vector<LsItem> files;
+    std::vector<std::string> directories;
     for (const auto& path : paths) {
-        try {
-            if (!fs::exists(path)) {
-                ctx.err << "ls: cannot access '" << path << "': No such file or directory\n";
-                continue;
+        FileStat info;
+        if (DirectoryReader::statAt(AT_FDCWD, path.c_str(), StatType, info, true) ||
+            DirectoryReader::statAt(AT_FDCWD, path.c_str(), StatType, info)) {
+            if (info.type == EntryType::Directory) {
+                directories.push_back(path);
+            } else {
+                LsItem item;
+                item.name = path;
+                item.type = info.type;
+                files.push_back(std::move(item));
             }
-            
-            if (paths.size() > 1) {
-                ctx.out << path << ":\n";
+        } else {
+            ctx.err << "ls: cannot access '" << path << "': " << std::generic_category().message(errno) << "\n";
+            ok = false;
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const LsItem& a, const LsItem& b) { return a.name < b.name; });
+    std::sort(directories.begin(), directories.end());
+    
+    // Everything goes out in one write (per 256 KiB for -R)
+    std::string out;
+    appendEntries(out, AT_FDCWD, files, options);
+    bool first = files.empty();
+    bool headers = options.recursive || paths.size() > 1;
+    for (const auto& path : directories) {
+        if (ctx.cancelled()) break;
+        if (options.recursive) {
+            listTree(path, options, out, first, ctx, ok);
+            continue;
+        }
+        std::vector<std::string> subdirs;
+        std::string errors;
+        if (headers) {
+            out += first ? "" : "\n";
+            out += path + ":\n";
+        }
+        first = false;
+        out += listDirectory(path, options, subdirs, errors);
+        if (!errors.empty()) {
+            ctx.write(out);
+            out.clear();
+            ctx.err << errors;
+            ok = false;
+        }
+    }
+    ctx.write(out);
+    
+    return ok ? 0 : 2;
+}
+
+std::string LinuxCommandHandler::listDirectory(const std::string& path, const LsOptions& options,
+                                               std::vector<std::string>& subdirs, std::string& errors) const {
+    DirectoryReader reader(path);
+    if (!reader.ok()) {
+        errors += "ls: cannot open directory '" + path + "': " + std::generic_category().message(reader.error()) + "\n";
+        return std::string();
+    }
+    
+    std::vector<LsItem> items;
+    DirectoryReader::Entry entry;
+    while (reader.next(entry)) {
+        if (!options.showHidden && entry.name[0] == '.') continue;
+        LsItem item;
+        item.name = std::string(entry.name);
+        item.type = entry.type;
+        items.push_back(std::move(item));
+    }
+    if (reader.error() != 0) {
+        errors += "ls: reading directory '" + path + "': " + std::generic_category().message(reader.error()) + "\n";
+    }
+    
+    // Sort by name
+    std::sort(items.begin(), items.end(), [](const LsItem& a, const LsItem& b) { return a.name < b.name; });
+    
+    std::string text;
+    appendEntries(text, reader.fd(), items, options);
+    
+    if (options.recursive) {
+        for (const auto& item : items) {
+            EntryType type = item.type;
+            if (type == EntryType::Unknown) {
+                // d_type not filled in by this file system
+                FileStat info;
+                if (DirectoryReader::statAt(reader.fd(), item.name.c_str(), StatType, info)) type = info.type;
             }
-            
-            std::vector<fs::directory_entry> entries;
-            for (const auto& entry : fs::directory_iterator(path)) {
-                std::string name = entry.path().filename().string();
-                if (!showHidden && !name.empty() && name[0] == '.') {
-                    continue;
-                }
-                entries.push_back(entry);
+            if (type == EntryType::Directory) subdirs.push_back(item.name);
+        }
+    }
+    return text;
+}
+
+void LinuxCommandHandler::listTree(const std::string& root, const LsOptions& options, std::string& out, bool& first,
+                                   ExecContext& ctx, bool& ok) const {
+    // Each directory is one task that queues its subdirectories. Listings
+    // are written in the order of a serial walk: whichever task finishes
+    // the next one due writes it, and every finished one after it
+    struct Node {
+        std::string path;
+        std::string text;
+        std::string errors;
+        std::vector<std::unique_ptr<Node>> children;
+        bool done = false;
+    };
+    WorkStealingGroup group;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Node>> pending; // next to write at the back
+    
+    auto writeReady = [&]() {
+        while (!pending.empty() && pending.back()->done) {
+            std::unique_ptr<Node> node = std::move(pending.back());
+            pending.pop_back();
+            out += first ? "" : "\n";
+            out += node->text;
+            first = false;
+            if (!node->errors.empty() || out.size() >= 256 * 1024) {
+                ctx.write(out);
+                out.clear();
             }
-            
-            // Sort by name
-            std::sort(entries.begin(), entries.end(), 
-                [](const fs::directory_entry& a, const fs::directory_entry& b) {
-                    return a.path().filename() < b.path().filename();
-                });
-            
-            for (const auto& entry : entries) {
-                if (longFormat) {
-                    struct stat st;
-                    if (stat(entry.path().c_str(), &st) == 0) {
-                        ctx.out << formatPermissions(st.st_mode) << " ";
-                        ctx.out << std::setw(3) << st.st_nlink << " ";
-                        
-                        struct passwd* pw = getpwuid(st.st_uid);
-                        ctx.out << std::setw(8) << (pw ? pw->pw_name : std::to_string(st.st_uid)) << " ";
-                        
-                        struct group* gr = getgrgid(st.st_gid);
-                        ctx.out << std::setw(8) << (gr ? gr->gr_name : std::to_string(st.st_gid)) << " ";
-                        
-                        ctx.out << std::setw(8) << formatSize(st.st_size, humanReadable) << " ";
-                        ctx.out << formatTime(st.st_mtime) << " ";
-                    }
-                }
-                
-                ctx.out << entry.path().filename().string();
-                
-                if (longFormat && fs::is_symlink(entry.path())) {
-                    ctx.out << " -> " << fs::read_symlink(entry.path()).string();
-                }
-                
-                ctx.out << "\n";
+            if (!node->errors.empty()) {
+                ctx.err << node->errors;
+                ok = false;
             }
-            
-        } catch (const fs::filesystem_error& e) {
-            ctx.err << "ls: " << e.what() << "\n";
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) pending.push_back(std::move(*it));
+        }
+        if (ctx.cancelled()) group.cancel();
+    };
+    
+    std::function<void(Node*)> list = [&](Node* node) {
+        std::vector<std::string> subdirs;
+        node->text = node->path + ":\n" + listDirectory(node->path, options, subdirs, node->errors);
+        std::string prefix = node->path.back() == '/' ? node->path : node->path + "/";
+        for (const auto& name : subdirs) {
+            node->children.push_back(std::make_unique<Node>());
+            node->children.back()->path = prefix + name;
+        }
+        for (const auto& child : node->children) {
+            Node* next = child.get();
+            group.spawn([&list, next]() { list(next); });
         }
+        std::lock_guard<std::mutex> lock(mutex);
+        node->done = true;
+        writeReady();
+    };
+    
+    pending.push_back(std::make_unique<Node>());
+    pending.back()->path = root;
+    Node* rootNode = pending.back().get();
+    group.spawn([&list, rootNode]() { list(rootNode); });
+    group.run();
+}
+
+void LinuxCommandHandler::appendEntries(std::string& out, int dirFd, std::vector<LsItem>& items,
+                                        const LsOptions& options) const {
+    if (!options.longFormat) {
+        for (const auto& item : items) {
+            out += item.name;
+            out += '\n';
+        }
+        return;
     }
     
-    return 0;
+    // Only what the long format prints, relative to the open directory;
+    // large directories are split between worker threads
+    const unsigned fields = StatMode | StatLinks | StatOwner | StatSize | StatMTime;
+    auto statRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            LsItem& item = items[i];
+            item.statted = DirectoryReader::statAt(dirFd, item.name.c_str(), fields, item.info);
+            if (!item.statted) continue;
+            item.type = item.info.type;
+            if (item.type == EntryType::Symlink) {
+                char target[4096];
+                ssize_t n = readlinkat(dirFd, item.name.c_str(), target, sizeof(target));
+                if (n > 0) item.target.assign(target, static_cast<size_t>(n));
+            }
+        }
+    };
+    size_t pieces = std::min(WorkerPool::instance().retained(), items.size() / 256);
+    if (pieces > 1) {
+        TaskGroup group;
+        for (size_t i = 1; i < pieces; ++i) {
+            group.run([&, i]() { statRange(items.size() * i / pieces, items.size() * (i + 1) / pieces); });
+        }
+        statRange(0, items.size() / pieces);
+        group.wait();
+    } else {
+        statRange(0, items.size());
+    }
+    
+    // Column widths from the widest value in this listing
+    std::vector<std::string> links, owners, groups, sizes;
+    size_t linksWidth = 0, ownerWidth = 0, groupWidth = 0, sizeWidth = 0;
+    for (const auto& item : items) {
+        links.push_back(item.statted ? std::to_string(item.info.links) : "?");
+        owners.push_back(item.statted ? idNames().user(item.info.uid) : "?");
+        groups.push_back(item.statted ? idNames().group(item.info.gid) : "?");
+        sizes.push_back(item.statted ? formatSize(item.info.size, options.humanReadable) : "?");
+        linksWidth = std::max(linksWidth, links.back().size());
+        ownerWidth = std::max(ownerWidth, owners.back().size());
+        groupWidth = std::max(groupWidth, groups.back().size());
+        sizeWidth = std::max(sizeWidth, sizes.back().size());
+    }
+    
+    auto pad = [&out](const std::string& text, size_t width, bool right) {
+        if (right) out.append(width - text.size(), ' ');
+        out += text;
+        if (!right) out.append(width - text.size(), ' ');
+        out += ' ';
+    };
+    for (size_t i = 0; i < items.size(); ++i) {
+        const LsItem& item = items[i];
+        out += item.statted ? formatPermissions(item.info.mode) : "??????????";
+        out += ' ';
+        pad(links[i], linksWidth, true);
+        pad(owners[i], ownerWidth, false);
+        pad(groups[i], groupWidth, false);
+        pad(sizes[i], sizeWidth, true);
+        out += item.statted ? formatTime(static_cast<std::time_t>(item.info.mtime)) : "            ";
+        out += ' ';
+        out += item.name;
+        if (!item.target.empty()) {
+            out += " -> ";
+            out += item.target;
+        }
+        out += '\n';
+    }
+}
+
+namespace {
+
+// Where a source goes for cp/mv: into dest when it is a directory
+std::string targetFor(const std::string& source, const std::string& dest, bool destIsDirectory) {
+    if (!destIsDirectory) return dest;
+    fs::path path(source);
+    std::string name = path.filename().string();
+    if (name.empty()) name = path.parent_path().filename().string(); // "dir/"
+    return (fs::path(dest) / name).string();
+}
+
+bool isDirectory(const std::string& path) {
+    FileStat info;
+    return DirectoryReader::statAt(AT_FDCWD, path.c_str(), StatType, info, true) && info.type == EntryType::Directory;
+}
+
+// The umask, read without changing it where /proc allows
+mode_t currentUmask() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "Umask:") == 0) return static_cast<mode_t>(std::stoul(line.substr(6), nullptr, 8));
+    }
+    mode_t mask = umask(0);
+    umask(mask);
+    return mask;
+}
+
+// An octal mode, or symbolic clauses like u+x,go-w,a=r applied to current
+bool parseMode(const std::string& spec, mode_t current, bool directory, mode_t& mode) {
+    if (!spec.empty() && spec.size() <= 4 &&
+        std::all_of(spec.begin(), spec.end(), [](char c) { return c >= '0' && c <= '7'; })) {
+        mode = static_cast<mode_t>(std::stoul(spec, nullptr, 8));
+        return true;
+    }
+    
+    const mode_t anyExecute = S_IXUSR | S_IXGRP | S_IXOTH;
+    mode = current & 07777;
+    size_t i = 0;
+    while (true) {
+        mode_t who = 0;
+        for (; i < spec.size() && std::strchr("ugoa", spec[i]); ++i) {
+            switch (spec[i]) {
+                case 'u': who |= S_IRWXU | S_ISUID; break;
+                case 'g': who |= S_IRWXG | S_ISGID; break;
+                case 'o': who |= S_IRWXO | S_ISVTX; break;
+                case 'a': who |= 07777; break;
+            }
+        }
+        // Without u, g, o or a the umask limits what is set
+        mode_t allowed = who ? who : 07777 & ~currentUmask();
+        if (!who) who = 07777;
+        if (i == spec.size() || !std::strchr("+-=", spec[i])) return false;
+        
+        while (i < spec.size() && std::strchr("+-=", spec[i])) {
+            char op = spec[i++];
+            mode_t bits = 0;
+            for (; i < spec.size() && std::strchr("rwxXst", spec[i]); ++i) {
+                switch (spec[i]) {
+                    case 'r': bits |= S_IRUSR | S_IRGRP | S_IROTH; break;
+                    case 'w': bits |= S_IWUSR | S_IWGRP | S_IWOTH; break;
+                    case 'x': bits |= anyExecute; break;
+                    case 'X': if (directory || (current & anyExecute)) bits |= anyExecute; break;
+                    case 's': bits |= S_ISUID | S_ISGID; break;
+                    case 't': bits |= S_ISVTX; break;
+                }
+            }
+            bits &= allowed;
+            if (op == '+') mode |= bits;
+            else if (op == '-') mode &= ~bits;
+            else mode = (mode & ~who) | bits;
+        }
+        if (i == spec.size()) return true;
+        if (spec[i++] != ',') return false;
+    }
+}
+
+// A user or group name, or a numeric id
+bool lookupId(const std::string& name, bool group, uint32_t& id) {
+    if (group) {
+        if (struct group* entry = getgrnam(name.c_str())) {
+            id = entry->gr_gid;
+            return true;
+        }
+    } else if (struct passwd* entry = getpwnam(name.c_str())) {
+        id = entry->pw_uid;
+        return true;
+    }
+    if (name.empty() || !std::all_of(name.begin(), name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    id = static_cast<uint32_t>(std::stoul(name));
+    return true;
+}
+
+// Calls apply on path and, when recursive, everything below it
+bool forTree(const std::string& path, bool recursive, const std::function<bool(const std::string&, bool)>& apply) {
+    bool ok = apply(path, true);
+    if (!recursive || !isDirectory(path)) return ok;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        ok = apply(it->path().string(), false) && ok;
+    }
+    return ok;
+}
+
+} // namespace
+
+std::string LinuxCommandHandler::formatProgress(const TreeCopier::Progress& progress) const {
+    double rate = progress.seconds > 0 ? progress.bytes / progress.seconds : 0;
+    std::ostringstream oss;
+    oss << progress.files << " files, " << progress.directories << " directories, "
+        << formatSize(progress.bytes, true) << " in " << std::fixed << std::setprecision(1) << progress.seconds
+        << "s (" << formatSize(static_cast<uintmax_t>(rate), true) << "/s)";
+    if (progress.cloned > 0) oss << ", " << progress.cloned << " reflinked";
+    return oss.str();
 }
 
 int LinuxCommandHandler::handleCp(const std::vector<std::string>& args, ExecContext& ctx) {
-    bool recursive = false;
-    bool force = false;
+    TreeCopier::Options options;
+    bool showProgress = false;
     std::vector<std::string> paths;
     
     for (const auto& arg : args) {
-        if (arg[0] == '-') {
+        if (arg == "--progress") {
+            showProgress = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
             for (size_t i = 1; i < arg.size(); ++i) {
                 switch (arg[i]) {
-                    case 'r': case 'R': recursive = true; break;
-                    case 'f': force = true; break;
+                    case 'r': case 'R': options.recursive = true; break;
+                    case 'f': break; // existing files are always replaced
                 }
             }
         } else {
@@ -221,28 +565,35 @@ int LinuxCommandHandler::handleCp(const std::vector<std::string>& args, ExecCont
     
     std::string dest = paths.back();
     paths.pop_back();
-    
-    try {
-        fs::copy_options opts = fs::copy_options::none;
-        if (recursive) opts |= fs::copy_options::recursive;
-        if (force) opts |= fs::copy_options::overwrite_existing;
-        
-        for (const auto& src : paths) {
-            fs::copy(src, dest, opts);
-        }
-    } catch (const fs::filesystem_error& e) {
-        ctx.err << "cp: " << e.what() << "\n";
+    bool destIsDirectory = isDirectory(dest);
+    if (paths.size() > 1 && !destIsDirectory) {
+        ctx.err << "cp: target '" << dest << "' is not a directory\n";
         return 1;
     }
     
-    return 0;
+    if (showProgress) {
+        options.progress = [this, &ctx](const TreeCopier::Progress& progress) {
+            ctx.err << "\rcp: " << formatProgress(progress) << std::flush;
+        };
+    }
+    TreeCopier copier(options);
+    for (const auto& src : paths) {
+        copier.add(src, targetFor(src, dest, destIsDirectory));
+    }
+    bool ok = copier.run();
+    if (showProgress) ctx.err << "\n";
+    for (const auto& error : copier.errors()) {
+        ctx.err << "cp: " << error << "\n";
+    }
+    
+    return ok ? 0 : 1;
 }
 
 int LinuxCommandHandler::handleMv(const std::vector<std::string>& args, ExecContext& ctx) {
     std::vector<std::string> paths;
     
     for (const auto& arg : args) {
-        if (arg[0] != '-') {
+        if (arg.empty() || arg[0] != '-') {
             paths.push_back(arg);
         }
     }
@@ -254,120 +605,261 @@ int LinuxCommandHandler::handleMv(const std::vector<std::string>& args, ExecCont
     
     std::string dest = paths.back();
     paths.pop_back();
+    bool destIsDirectory = isDirectory(dest);
+    if (paths.size() > 1 && !destIsDirectory) {
+        ctx.err << "mv: target '" << dest << "' is not a directory\n";
+        return 1;
+    }
     
-    try {
-        for (const auto& src : paths) {
-            fs::rename(src, dest);
+    bool ok = true;
+    for (const auto& src : paths) {
+        std::string target = targetFor(src, dest, destIsDirectory);
+        if (rename(src.c_str(), target.c_str()) == 0) continue;
+        if (errno != EXDEV) {
+            ctx.err << "mv: cannot move '" << src << "' to '" << target << "': "
+                    << std::generic_category().message(errno) << "\n";
+            ok = false;
+            continue;
+        }
+        
+        // Across file systems: copy with modes and times kept, then remove
+        // the source, but only if everything arrived
+        TreeCopier::Options options;
+        options.recursive = true;
+        options.preserve = true;
+        TreeCopier copier(options);
+        copier.add(src, target);
+        if (!copier.run()) {
+            for (const auto& error : copier.errors()) {
+                ctx.err << "mv: " << error << "\n";
+            }
+            ok = false;
+            continue;
+        }
+        std::error_code ec;
+        fs::remove_all(src, ec);
+        if (ec) {
+            ctx.err << "mv: cannot remove '" << src << "': " << ec.message() << "\n";
+            ok = false;
         }
-    } catch (const fs::filesystem_error& e) {
-        ctx.err << "mv: " << e.what() << "\n";
-        return 1;
     }
     
-    return 0;
+    return ok ? 0 : 1;
 }
 
 int LinuxCommandHandler::handleChmod(const std::vector<std::string>& args, ExecContext& ctx) {
-    if (args.size() < 2) {
+    bool recursive = false;
+    std::string modeStr;
+    std::vector<std::string> paths;
+    
+    for (const auto& arg : args) {
+        // -x, -w and -r are modes, not options
+        if (modeStr.empty() && arg == "-R") {
+            recursive = true;
+        } else if (modeStr.empty()) {
+            modeStr = arg;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    
+    if (paths.empty()) {
         ctx.err << "chmod: missing operand\n";
         return 1;
     }
-    
-    std::string modeStr = args[0];
-    unsigned int mode = 0;
-    
-    // Parse octal mode
-    try {
-        mode = std::stoul(modeStr, nullptr, 8);
-    } catch (...) {
-        ctx.err << "chmod: invalid mode: " << modeStr << "\n";
+    mode_t check;
+    if (!parseMode(modeStr, 0, false, check)) {
+        ctx.err << "chmod: invalid mode: '" << modeStr << "'\n";
         return 1;
     }
     
-    for (size_t i = 1; i < args.size(); ++i) {
-        if (chmod(args[i].c_str(), mode) != 0) {
-            ctx.err << "chmod: cannot change permissions of '" << args[i] << "'\n";
-            return 1;
-        }
+    bool ok = true;
+    for (const auto& path : paths) {
+        ok = forTree(path, recursive, [&](const std::string& file, bool named) {
+            struct stat st;
+            if ((named ? stat(file.c_str(), &st) : lstat(file.c_str(), &st)) != 0) {
+                ctx.err << "chmod: cannot access '" << file << "': " << std::generic_category().message(errno) << "\n";
+                return false;
+            }
+            if (S_ISLNK(st.st_mode)) return true; // links found by -R are not followed
+            mode_t mode;
+            parseMode(modeStr, st.st_mode, S_ISDIR(st.st_mode), mode);
+            if (chmod(file.c_str(), mode) != 0) {
+                ctx.err << "chmod: changing permissions of '" << file << "': "
+                        << std::generic_category().message(errno) << "\n";
+                return false;
+            }
+            return true;
+        }) && ok;
     }
     
-    return 0;
+    return ok ? 0 : 1;
 }
 
 int LinuxCommandHandler::handleChown(const std::vector<std::string>& args, ExecContext& ctx) {
-    if (args.size() < 2) {
+    bool recursive = false;
+    std::vector<std::string> operands;
+    
+    for (const auto& arg : args) {
+        if (arg == "-R") {
+            recursive = true;
+        } else {
+            operands.push_back(arg);
+        }
+    }
+    
+    if (operands.size() < 2) {
         ctx.err << "chown: missing operand\n";
         return 1;
     }
     
-    std::string ownerSpec = args[0];
+    // OWNER, OWNER:GROUP or :GROUP
+    std::string ownerSpec = operands[0];
     uid_t uid = -1;
     gid_t gid = -1;
-    
     size_t colonPos = ownerSpec.find(':');
-    if (colonPos != std::string::npos) {
-        std::string user = ownerSpec.substr(0, colonPos);
-        std::string group = ownerSpec.substr(colonPos + 1);
-        
-        if (!user.empty()) {
-            struct passwd* pw = getpwnam(user.c_str());
-            if (pw) uid = pw->pw_uid;
-        }
-        if (!group.empty()) {
-            struct group* gr = getgrnam(group.c_str());
-            if (gr) gid = gr->gr_gid;
+    std::string user = ownerSpec.substr(0, colonPos);
+    std::string group = colonPos == std::string::npos ? "" : ownerSpec.substr(colonPos + 1);
+    uint32_t id;
+    if (!user.empty()) {
+        if (!lookupId(user, false, id)) {
+            ctx.err << "chown: invalid user: '" << ownerSpec << "'\n";
+            return 1;
         }
-    } else {
-        struct passwd* pw = getpwnam(ownerSpec.c_str());
-        if (pw) uid = pw->pw_uid;
+        uid = id;
     }
-    
-    for (size_t i = 1; i < args.size(); ++i) {
-        if (chown(args[i].c_str(), uid, gid) != 0) {
-            ctx.err << "chown: cannot change ownership of '" << args[i] << "'\n";
+    if (!group.empty()) {
+        if (!lookupId(group, true, id)) {
+            ctx.err << "chown: invalid group: '" << ownerSpec << "'\n";
             return 1;
         }
+        gid = id;
     }
     
-    return 0;
+    bool ok = true;
+    for (size_t i = 1; i < operands.size(); ++i) {
+        ok = forTree(operands[i], recursive, [&](const std::string& file, bool named) {
+            if ((named ? chown(file.c_str(), uid, gid) : lchown(file.c_str(), uid, gid)) != 0) {
+                ctx.err << "chown: changing ownership of '" << file << "': "
+                        << std::generic_category().message(errno) << "\n";
+                return false;
+            }
+            return true;
+        }) && ok;
+    }
+    
+    return ok ? 0 : 1;
 }
 
 int LinuxCommandHandler::handleLn(const std::vector<std::string>& args, ExecContext& ctx) {
     bool symbolic = false;
+    bool force = false;
     std::vector<std::string> paths;
     
     for (const auto& arg : args) {
-        if (arg == "-s") {
-            symbolic = true;
-        } else if (arg[0] != '-') {
+        if (arg.size() > 1 && arg[0] == '-') {
+            for (size_t i = 1; i < arg.size(); ++i) {
+                switch (arg[i]) {
+                    case 's': symbolic = true; break;
+                    case 'f': force = true; break;
+                    default:
+                        ctx.err << "ln: invalid option -- '" << arg[i] << "'\n";
+                        return 1;
+                }
+            }
+        } else {
             paths.push_back(arg);
         }
     }
     
-    if (paths.size() < 2) {
-        ctx.err << "ln: missing destination file operand\n";
+    if (paths.empty()) {
+        ctx.err << "ln: missing file operand\n";
+        return 1;
+    }
+    // ln TARGET makes the link in the current directory
+    std::string dest = paths.size() == 1 ? "." : paths.back();
+    if (paths.size() > 1) paths.pop_back();
+    bool destIsDirectory = isDirectory(dest);
+    if (paths.size() > 1 && !destIsDirectory) {
+        ctx.err << "ln: target '" << dest << "' is not a directory\n";
         return 1;
     }
     
-    try {
-        if (symbolic) {
-            fs::create_symlink(paths[0], paths[1]);
-        } else {
-            fs::create_hard_link(paths[0], paths[1]);
+    bool ok = true;
+    for (const auto& src : paths) {
+        std::string link = destIsDirectory ? targetFor(src, dest, true) : dest;
+        if (force && unlink(link.c_str()) != 0 && errno != ENOENT) {
+            ctx.err << "ln: cannot remove '" << link << "': " << std::generic_category().message(errno) << "\n";
+            ok = false;
+            continue;
+        }
+        int result = symbolic ? symlink(src.c_str(), link.c_str()) : ::link(src.c_str(), link.c_str());
+        if (result != 0) {
+            ctx.err << "ln: failed to create " << (symbolic ? "symbolic " : "hard ") << "link '" << link
+                    << "': " << std::generic_category().message(errno) << "\n";
+            ok = false;
         }
-    } catch (const fs::filesystem_error& e) {
-        ctx.err << "ln: " << e.what() << "\n";
-        return 1;
     }
     
-    return 0;
+    return ok ? 0 : 1;
 }
 
 int LinuxCommandHandler::handleDf(const std::vector<std::string>& args, ExecContext& ctx) {
     bool humanReadable = false;
+    std::vector<std::string> paths;
     
     for (const auto& arg : args) {
         if (arg == "-h") humanReadable = true;
+        else paths.push_back(arg);
+    }
+    
+    struct Mount {
+        std::string device;
+        std::string mountpoint;
+        bool real = false;
+    };
+    std::vector<Mount> mounts;
+    std::ifstream table("/proc/mounts");
+    std::string line;
+    while (std::getline(table, line)) {
+        std::istringstream iss(line);
+        Mount mount;
+        std::string fstype;
+        iss >> mount.device >> mount.mountpoint >> fstype;
+        if (mount.device.empty()) continue;
+        mount.real = mount.device[0] == '/' || fstype == "tmpfs";
+        mounts.push_back(std::move(mount));
+    }
+    
+    // Without operands every real file system is listed once. An operand
+    // selects the one it is on; the last mount of that device wins, as it
+    // hides those below it
+    bool ok = true;
+    std::vector<const Mount*> selected;
+    std::unordered_set<std::string> seen;
+    if (paths.empty()) {
+        for (const auto& mount : mounts) {
+            if (mount.real && seen.insert(mount.device).second) selected.push_back(&mount);
+        }
+    }
+    for (const auto& path : paths) {
+        struct stat target;
+        if (stat(path.c_str(), &target) != 0) {
+            ctx.err << "df: " << path << ": " << std::generic_category().message(errno) << "\n";
+            ok = false;
+            continue;
+        }
+        const Mount* found = nullptr;
+        for (const auto& mount : mounts) {
+            struct stat st;
+            if (stat(mount.mountpoint.c_str(), &st) == 0 && st.st_dev == target.st_dev) found = &mount;
+        }
+        if (!found) {
+            ctx.err << "df: " << path << ": no file system found\n";
+            ok = false;
+        } else {
+            selected.push_back(found);
+        }
     }
     
     ctx.out << std::setw(20) << std::left << "Filesystem"
@@ -377,38 +869,87 @@ int LinuxCommandHandler::handleDf(const std::vector<std::string>& args, ExecCont
             << std::setw(8) << "Use%"
             << " Mounted on\n";
     
-    std::ifstream mounts("/proc/mounts");
-    std::string line;
-    std::unordered_set<std::string> seen;
-    
-    while (std::getline(mounts, line)) {
-        std::istringstream iss(line);
-        std::string device, mountpoint, fstype;
-        iss >> device >> mountpoint >> fstype;
-        
-        // Skip non-real filesystems
-        if (device[0] != '/' && fstype != "tmpfs") continue;
-        if (seen.count(device)) continue;
-        seen.insert(device);
-        
+    for (const Mount* mount : selected) {
         struct statvfs vfs;
-        if (statvfs(mountpoint.c_str(), &vfs) == 0) {
+        if (statvfs(mount->mountpoint.c_str(), &vfs) == 0) {
             uintmax_t total = vfs.f_blocks * vfs.f_frsize;
             uintmax_t free = vfs.f_bfree * vfs.f_frsize;
             uintmax_t avail = vfs.f_bavail * vfs.f_frsize;
             uintmax_t used = total - free;
             int usePercent = total > 0 ? (used * 100 / total) : 0;
             
-            ctx.out << std::setw(20) << std::left << device
+            ctx.out << std::setw(20) << std::left << mount->device
                     << std::setw(12) << std::right << formatSize(total, humanReadable)
                     << std::setw(12) << formatSize(used, humanReadable)
                     << std::setw(12) << formatSize(avail, humanReadable)
                     << std::setw(7) << usePercent << "%"
-                    << " " << mountpoint << "\n";
+                    << " " << mount->mountpoint << "\n";
         }
     }
     
-    return 0;
+    return ok ? 0 : 1;
+}
+
+int LinuxCommandHandler::handleDu(const std::vector<std::string>& args, ExecContext& ctx) {
+    DiskUsage::Options options;
+    bool humanReadable = false;
+    std::vector<std::string> paths;
+    
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        std::string depth;
+        if (arg == "--apparent-size") {
+            options.apparentSize = true;
+            continue;
+        } else if (arg.compare(0, 12, "--max-depth=") == 0) {
+            depth = arg.substr(12);
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            for (size_t j = 1; j < arg.size(); ++j) {
+                if (arg[j] == 's') {
+                    options.maxDepth = 0;
+                } else if (arg[j] == 'h') {
+                    humanReadable = true;
+                } else if (arg[j] == 'd') {
+                    // -d N or -dN
+                    depth = j + 1 < arg.size() ? arg.substr(j + 1) : (i + 1 < args.size() ? args[++i] : "");
+                    if (depth.empty()) {
+                        ctx.err << "du: option requires an argument -- 'd'\n";
+                        return 1;
+                    }
+                    break;
+                } else {
+                    ctx.err << "du: invalid option -- '" << arg[j] << "'\n";
+                    return 1;
+                }
+            }
+        } else {
+            paths.push_back(arg);
+        }
+        if (!depth.empty()) {
+            if (depth.find_first_not_of("0123456789") != std::string::npos || depth.size() > 9) {
+                ctx.err << "du: invalid maximum depth '" << depth << "'\n";
+                return 1;
+            }
+            options.maxDepth = std::stoi(depth);
+        }
+    }
+    if (paths.empty()) paths.push_back(".");
+    
+    // Sizes are shown in 1024-byte units, rounded up, unless -h
+    DiskUsage usage(options, [&](const std::string& path, uint64_t bytes) {
+        uintmax_t shown = humanReadable ? bytes : (bytes + 1023) / 1024;
+        ctx.out << formatSize(shown, humanReadable) << '\t' << path << '\n';
+        return !ctx.cancelled();
+    });
+    for (const auto& path : paths) {
+        if (ctx.cancelled()) break;
+        usage.measure(path);
+    }
+    for (const auto& error : usage.errors()) {
+        ctx.err << "du: " << error << "\n";
+    }
+    
+    return usage.errors().empty() ? 0 : 1;
 }
 
 int LinuxCommandHandler::handleFree(const std::vector<std::string>& args, ExecContext& ctx) {
@@ -350,7 +350,9 @@ bool WindowsCommandHandler::isCommand(const std::string &cmd) const
         "popd", "print", "prompt", "pushd", "rd", "recover", "rem", "rename", "replace", "rmdir",
         "robocopy", "set", "setlocal", "sc", "schtasks", "shift", "shutdown", "start", "subst",
         "systeminfo", "tasklist", "taskkill", "time", "title", "tree", "type", "ver", "verify", "vol",
-        "where", "whoami", "xcopy"};
+        "where", "whoami", "xcopy",
+        // termidash extensions
+        "cwd", "drives", "getenv", "setenv", "ping", "ipconfig", "hostname", "netstat"};
     return cmds.find(cmd) != cmds.end();
 }
 
@@ -10,7 +10,10 @@ bool BuiltInCommandHandler::handleCommand(const std::string& input) {
 }
 
 int BuiltInCommandHandler::handleCommandWithContext(const std::string& input, ExecContext& ctx) {
-    auto tokens = tokenize(input);
+    return handleCommandWithContext(input, tokenize(input), ctx);
+}
+
+int BuiltInCommandHandler::handleCommandWithContext(const std::string& input, const std::vector<std::string>& tokens, ExecContext& ctx) {
     if (tokens.empty()) return -1;
 
     int ret = commonHandler.handleWithContext(input, tokens, ctx);
@@ -19,6 +22,9 @@ int BuiltInCommandHandler::handleCommandWithContext(const std::string& input, Ex
 #ifdef PLATFORM_WINDOWS
     ret = windowsHandler.handleWithContext(tokens, ctx);
     if (ret != -1) return ret;
+#else
+    ret = linuxHandler.handleWithContext(tokens, ctx);
+    if (ret != -1) return ret;
 #endif
     return -1;
 }
@@ -40,6 +46,8 @@ bool BuiltInCommandHandler::isBuiltInCommand(const std::string &input) const {
     if (commonHandler.isCommand(cmd)) return true;
 #ifdef PLATFORM_WINDOWS
     if (windowsHandler.isCommand(cmd)) return true;
+#else
+    if (linuxHandler.isCommand(cmd)) return true;
 #endif
     return false;
 }
@@ -0,0 +1,247 @@
+#include "core/Bytecode.hpp"
+#include "core/Parser.hpp"
+#include <cstring>
+#include <sstream>
+
+namespace termidash {
+namespace bytecode {
+
+const char* opName(OpCode op) {
+    switch (op) {
+    case OpCode::Stage: return "STAGE";
+    case OpCode::Call: return "CALL";
+    case OpCode::Exec: return "EXEC";
+    case OpCode::Run: return "RUN";
+    case OpCode::Jump: return "JUMP";
+    case OpCode::JumpIfFail: return "JUMP_IF_FAIL";
+    case OpCode::JumpIfOk: return "JUMP_IF_OK";
+    case OpCode::SetStatus: return "SET_STATUS";
+    case OpCode::LoopInit: return "LOOP_INIT";
+    case OpCode::LoopNext: return "LOOP_NEXT";
+    case OpCode::ForInit: return "FOR_INIT";
+    case OpCode::ForNext: return "FOR_NEXT";
+    case OpCode::EndLoop: return "END_LOOP";
+    case OpCode::Define: return "DEFINE";
+    case OpCode::Halt: return "HALT";
+    }
+    return "?";
+}
+
+std::string disassemble(const Chunk& chunk) {
+    std::ostringstream out;
+    for (size_t i = 0; i < chunk.code.size(); ++i) {
+        const Instruction& ins = chunk.code[i];
+        out << i << ": " << opName(ins.op);
+        if (ins.a != NoOperand) out << " " << ins.a;
+        if (ins.b != NoOperand) out << " " << ins.b;
+        if (ins.op == OpCode::ForNext && ins.a < chunk.strings.size()) {
+            out << " ; " << chunk.strings[ins.a];
+        }
+        if (ins.op == OpCode::Stage && ins.a < chunk.stages.size()) {
+            const ast::Stage& stage = chunk.stages[ins.a];
+            out << " ;";
+            for (const auto& word : stage.words) out << " " << word;
+            for (const auto& redirection : stage.redirections) {
+                out << " " << Parser::redirectOperator(redirection.kind);
+                if (!redirection.target.empty()) out << " " << redirection.target;
+            }
+            if (stage.trimAfter) out << " |>";
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+namespace {
+
+void putU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, const std::string& str) {
+    putU32(out, static_cast<uint32_t>(str.size()));
+    out += str;
+}
+
+void putChunk(std::string& out, const Chunk& chunk) {
+    putU32(out, static_cast<uint32_t>(chunk.strings.size()));
+    for (const auto& str : chunk.strings) {
+        putString(out, str);
+    }
+
+    putU32(out, static_cast<uint32_t>(chunk.stages.size()));
+    for (const auto& stage : chunk.stages) {
+        putU32(out, static_cast<uint32_t>(stage.words.size()));
+        for (const auto& word : stage.words) {
+            putString(out, word);
+        }
+        putU32(out, static_cast<uint32_t>(stage.redirections.size()));
+        for (const auto& redirection : stage.redirections) {
+            out += static_cast<char>(redirection.kind);
+            putString(out, redirection.target);
+        }
+        out += static_cast<char>(stage.trimAfter);
+    }
+
+    putU32(out, static_cast<uint32_t>(chunk.code.size()));
+    for (const auto& ins : chunk.code) {
+        out += static_cast<char>(ins.op);
+        putU32(out, ins.a);
+        putU32(out, ins.b);
+    }
+
+    putU32(out, static_cast<uint32_t>(chunk.functions.size()));
+    for (const auto& def : chunk.functions) {
+        putU32(out, def.name);
+        putU32(out, static_cast<uint32_t>(def.source.size()));
+        for (uint32_t index : def.source) {
+            putU32(out, index);
+        }
+        putChunk(out, def.body ? *def.body : Chunk{});
+    }
+}
+
+struct Reader {
+    const char* pos;
+    const char* end;
+
+    bool u32(uint32_t& value) {
+        if (static_cast<size_t>(end - pos) < sizeof(value)) return false;
+        std::memcpy(&value, pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    }
+
+    bool u8(uint8_t& value) {
+        if (pos == end) return false;
+        value = static_cast<uint8_t>(*pos++);
+        return true;
+    }
+
+    bool bytes(size_t count, std::string& out) {
+        if (static_cast<size_t>(end - pos) < count) return false;
+        out.assign(pos, count);
+        pos += count;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        uint32_t length = 0;
+        return u32(length) && bytes(length, out);
+    }
+};
+
+bool readStage(Reader& in, ast::Stage& stage) {
+    uint32_t count = 0;
+    if (!in.u32(count)) return false;
+    stage.words.resize(count);
+    for (auto& word : stage.words) {
+        if (!in.string(word)) return false;
+    }
+
+    if (!in.u32(count)) return false;
+    stage.redirections.resize(count);
+    for (auto& redirection : stage.redirections) {
+        uint8_t kind = 0;
+        if (!in.u8(kind) || kind > static_cast<uint8_t>(ast::RedirectKind::None)) return false;
+        redirection.kind = static_cast<ast::RedirectKind>(kind);
+        if (!in.string(redirection.target)) return false;
+    }
+
+    uint8_t trimAfter = 0;
+    if (!in.u8(trimAfter) || trimAfter > 1) return false;
+    stage.trimAfter = trimAfter != 0;
+    return true;
+}
+
+bool validOperands(const Instruction& ins, const Chunk& chunk) {
+    size_t strings = chunk.strings.size();
+    size_t code = chunk.code.size();
+    switch (ins.op) {
+    case OpCode::Stage:
+        return ins.a < chunk.stages.size() && (ins.b == NoOperand || ins.b == 1);
+    case OpCode::Exec:
+        return (ins.a == NoOperand || ins.a < strings) && (ins.b == NoOperand || ins.b == 1);
+    case OpCode::Call:
+    case OpCode::Jump:
+    case OpCode::JumpIfFail:
+    case OpCode::JumpIfOk:
+    case OpCode::LoopNext:
+        return ins.a < code;
+    case OpCode::ForNext:
+        return ins.a < strings && ins.b < code;
+    case OpCode::Define:
+        return ins.a < chunk.functions.size();
+    case OpCode::Run:
+    case OpCode::SetStatus:
+    case OpCode::LoopInit:
+    case OpCode::ForInit:
+    case OpCode::EndLoop:
+    case OpCode::Halt:
+        return true;
+    }
+    return false;
+}
+
+bool readChunk(Reader& in, Chunk& chunk) {
+    uint32_t count = 0;
+    if (!in.u32(count)) return false;
+    chunk.strings.resize(count);
+    for (auto& str : chunk.strings) {
+        if (!in.string(str)) return false;
+    }
+
+    if (!in.u32(count)) return false;
+    chunk.stages.resize(count);
+    for (auto& stage : chunk.stages) {
+        if (!readStage(in, stage)) return false;
+    }
+
+    if (!in.u32(count)) return false;
+    chunk.code.resize(count);
+    for (auto& ins : chunk.code) {
+        uint8_t op = 0;
+        if (!in.u8(op) || op > static_cast<uint8_t>(OpCode::Halt)) return false;
+        ins.op = static_cast<OpCode>(op);
+        if (!in.u32(ins.a) || !in.u32(ins.b)) return false;
+    }
+
+    if (!in.u32(count)) return false;
+    chunk.functions.resize(count);
+    for (auto& def : chunk.functions) {
+        uint32_t sourceCount = 0;
+        if (!in.u32(def.name) || def.name >= chunk.strings.size()) return false;
+        if (!in.u32(sourceCount)) return false;
+        def.source.resize(sourceCount);
+        for (auto& index : def.source) {
+            if (!in.u32(index) || index >= chunk.strings.size()) return false;
+        }
+        auto body = std::make_shared<Chunk>();
+        if (!readChunk(in, *body)) return false;
+        def.body = std::move(body);
+    }
+
+    // The VM runs until HALT, so the stream must end with one
+    if (chunk.code.empty() || chunk.code.back().op != OpCode::Halt) return false;
+    for (const auto& ins : chunk.code) {
+        if (!validOperands(ins, chunk)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::string serialize(const Chunk& chunk) {
+    std::string out;
+    putChunk(out, chunk);
+    return out;
+}
+
+bool deserialize(const char* data, size_t size, Chunk& chunk) {
+    Reader in{data, data + size};
+    chunk = Chunk{};
+    return readChunk(in, chunk) && in.pos == in.end;
+}
+
+} // namespace bytecode
+} // namespace termidash
@@ -0,0 +1,129 @@
+#include "core/BytecodeCompiler.hpp"
+
+namespace termidash {
+
+using bytecode::OpCode;
+using bytecode::NoOperand;
+
+bytecode::Chunk BytecodeCompiler::compile(const ast::NodeList& nodes) {
+    bytecode::Chunk chunk;
+    BytecodeCompiler compiler(chunk);
+    compiler.compileList(nodes);
+    compiler.emit(OpCode::Halt);
+    return chunk;
+}
+
+uint32_t BytecodeCompiler::intern(const std::string& s) {
+    auto it = stringIndex_.find(s);
+    if (it != stringIndex_.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(chunk_.strings.size());
+    chunk_.strings.push_back(s);
+    stringIndex_.emplace(s, index);
+    return index;
+}
+
+uint32_t BytecodeCompiler::emit(OpCode op, uint32_t a, uint32_t b) {
+    chunk_.code.push_back({op, a, b});
+    return static_cast<uint32_t>(chunk_.code.size() - 1);
+}
+
+uint32_t BytecodeCompiler::here() const {
+    return static_cast<uint32_t>(chunk_.code.size());
+}
+
+void BytecodeCompiler::compileStages(const ast::Pipeline& pipeline, bool command) {
+    for (const auto& stage : pipeline.stages) {
+        emit(OpCode::Stage, static_cast<uint32_t>(chunk_.stages.size()), command ? NoOperand : 1);
+        chunk_.stages.push_back(stage);
+    }
+}
+
+void BytecodeCompiler::compileList(const ast::NodeList& nodes) {
+    const std::string* prevSep = nullptr;
+    for (const auto& node : nodes) {
+        // "a && b" skips b when a failed; "a || b" skips b when a succeeded
+        uint32_t skip = NoOperand;
+        if (prevSep && *prevSep == "&&") {
+            skip = emit(OpCode::JumpIfFail);
+        } else if (prevSep && *prevSep == "||") {
+            skip = emit(OpCode::JumpIfOk);
+        }
+
+        compileNode(node);
+
+        if (skip != NoOperand) {
+            chunk_.code[skip].a = here();
+        }
+        prevSep = &node.separator;
+    }
+}
+
+void BytecodeCompiler::compileNode(const ast::Node& node) {
+    switch (node.kind) {
+    case ast::NodeKind::Command: {
+        compileStages(node.pipeline);
+        uint32_t call = emit(OpCode::Call);
+        emit(OpCode::Exec, node.hasHereDoc ? intern(node.hereDoc) : NoOperand, node.pipeline.background ? 1 : NoOperand);
+        chunk_.code[call].a = here();
+        break;
+    }
+
+    case ast::NodeKind::If: {
+        compileStages(node.pipeline);
+        emit(OpCode::Run);
+        uint32_t toElse = emit(OpCode::JumpIfFail);
+        compileList(node.body);
+        uint32_t toEnd = emit(OpCode::Jump);
+        chunk_.code[toElse].a = here();
+        emit(OpCode::SetStatus, 0);
+        compileList(node.elseBody);
+        chunk_.code[toEnd].a = here();
+        break;
+    }
+
+    case ast::NodeKind::While: {
+        emit(OpCode::LoopInit);
+        uint32_t head = emit(OpCode::LoopNext);
+        compileStages(node.pipeline);
+        emit(OpCode::Run);
+        uint32_t toExit = emit(OpCode::JumpIfFail);
+        compileList(node.body);
+        emit(OpCode::Jump, head);
+        chunk_.code[head].a = here();
+        chunk_.code[toExit].a = here();
+        emit(OpCode::EndLoop);
+        break;
+    }
+
+    case ast::NodeKind::For: {
+        ast::Pipeline items;
+        items.stages.emplace_back();
+        items.stages[0].words = node.items;
+        compileStages(items, false);
+        emit(OpCode::ForInit);
+        uint32_t head = emit(OpCode::ForNext, intern(node.loopVar));
+        compileList(node.body);
+        emit(OpCode::Jump, head);
+        chunk_.code[head].b = here();
+        emit(OpCode::EndLoop);
+        break;
+    }
+
+    case ast::NodeKind::Function: {
+        bytecode::FunctionDef def;
+        def.name = intern(node.text);
+        for (const auto& line : node.source) {
+            def.source.push_back(intern(line));
+        }
+        def.body = std::make_shared<const bytecode::Chunk>(compile(node.body));
+        uint32_t index = static_cast<uint32_t>(chunk_.functions.size());
+        chunk_.functions.push_back(std::move(def));
+        emit(OpCode::Define, index);
+        break;
+    }
+    }
+}
+
+} // namespace termidash
@@ -0,0 +1,179 @@
+#ifndef _WIN32 // POSIX only
+
+#include "core/DirectoryReader.hpp"
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace termidash {
+
+namespace {
+
+#ifdef __linux__
+// Record layout filled in by getdents64
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+const size_t direntBufferSize = 64 * 1024;
+#endif
+
+EntryType typeFromDirent(unsigned char type) {
+    switch (type) {
+    case DT_REG: return EntryType::Regular;
+    case DT_DIR: return EntryType::Directory;
+    case DT_LNK: return EntryType::Symlink;
+    case DT_UNKNOWN: return EntryType::Unknown;
+    default: return EntryType::Other;
+    }
+}
+
+EntryType typeFromMode(uint32_t mode) {
+    if (S_ISREG(mode)) return EntryType::Regular;
+    if (S_ISDIR(mode)) return EntryType::Directory;
+    if (S_ISLNK(mode)) return EntryType::Symlink;
+    return EntryType::Other;
+}
+
+bool isDotOrDotDot(const char* name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+} // namespace
+
+DirectoryReader::DirectoryReader(const std::string& path) {
+    open(AT_FDCWD, path.c_str(), false);
+}
+
+DirectoryReader::DirectoryReader(int parentFd, const std::string& name) {
+    open(parentFd, name.c_str(), true);
+}
+
+void DirectoryReader::open(int parentFd, const char* path, bool noFollow) {
+    fd_ = openat(parentFd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC | (noFollow ? O_NOFOLLOW : 0));
+    if (fd_ == -1) {
+        error_ = errno;
+        return;
+    }
+#ifndef __linux__
+    DIR* dir = fdopendir(fd_);
+    if (!dir) {
+        error_ = errno;
+        close(fd_);
+        fd_ = -1;
+        return;
+    }
+    dir_ = dir;
+#endif
+}
+
+DirectoryReader::~DirectoryReader() {
+    if (dir_) {
+        closedir(static_cast<DIR*>(dir_)); // closes fd_ too
+    } else if (fd_ != -1) {
+        close(fd_);
+    }
+}
+
+bool DirectoryReader::next(Entry& entry) {
+    if (fd_ == -1) return false;
+#ifdef __linux__
+    while (true) {
+        if (pos_ >= filled_) {
+            if (buffer_.empty()) buffer_.resize(direntBufferSize);
+            long n = syscall(SYS_getdents64, fd_, buffer_.data(), buffer_.size());
+            if (n <= 0) {
+                if (n < 0) error_ = errno;
+                return false;
+            }
+            filled_ = static_cast<size_t>(n);
+            pos_ = 0;
+        }
+        const auto* dirent = reinterpret_cast<const LinuxDirent64*>(buffer_.data() + pos_);
+        pos_ += dirent->d_reclen;
+        if (isDotOrDotDot(dirent->d_name)) continue;
+        entry.name = std::string_view(dirent->d_name);
+        entry.type = typeFromDirent(dirent->d_type);
+        entry.inode = dirent->d_ino;
+        return true;
+    }
+#else
+    DIR* dir = static_cast<DIR*>(dir_);
+    while (true) {
+        errno = 0;
+        struct dirent* dirent = readdir(dir);
+        if (!dirent) {
+            error_ = errno;
+            return false;
+        }
+        if (isDotOrDotDot(dirent->d_name)) continue;
+        entry.name = std::string_view(dirent->d_name);
+        entry.type = typeFromDirent(dirent->d_type);
+        entry.inode = dirent->d_ino;
+        return true;
+    }
+#endif
+}
+
+bool DirectoryReader::statAt(int dirFd, const char* name, unsigned fields, FileStat& info, bool followLinks) {
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    unsigned mask = 0;
+    if (fields & StatType) mask |= STATX_TYPE;
+    if (fields & StatMode) mask |= STATX_TYPE | STATX_MODE;
+    if (fields & StatLinks) mask |= STATX_NLINK;
+    if (fields & StatOwner) mask |= STATX_UID | STATX_GID;
+    if (fields & StatSize) mask |= STATX_SIZE;
+    if (fields & StatBlocks) mask |= STATX_BLOCKS;
+    if (fields & StatMTime) mask |= STATX_MTIME;
+    if (fields & StatIdentity) mask |= STATX_INO;
+    if (fields & StatATime) mask |= STATX_ATIME;
+    struct statx stx;
+    int flags = AT_STATX_SYNC_AS_STAT | AT_NO_AUTOMOUNT | (followLinks ? 0 : AT_SYMLINK_NOFOLLOW);
+    if (statx(dirFd, name, flags, mask, &stx) != 0) return false;
+    info.type = typeFromMode(stx.stx_mode);
+    info.mode = stx.stx_mode;
+    info.links = stx.stx_nlink;
+    info.uid = stx.stx_uid;
+    info.gid = stx.stx_gid;
+    info.size = stx.stx_size;
+    info.blocks = stx.stx_blocks;
+    info.mtime = stx.stx_mtime.tv_sec;
+    info.mtimeNsec = stx.stx_mtime.tv_nsec;
+    info.atime = stx.stx_atime.tv_sec;
+    info.atimeNsec = stx.stx_atime.tv_nsec;
+    info.device = (static_cast<uint64_t>(stx.stx_dev_major) << 32) | stx.stx_dev_minor;
+    info.inode = stx.stx_ino;
+    return true;
+#else
+    (void)fields;
+    struct stat st;
+    if (fstatat(dirFd, name, &st, followLinks ? 0 : AT_SYMLINK_NOFOLLOW) != 0) return false;
+    info.type = typeFromMode(st.st_mode);
+    info.mode = st.st_mode;
+    info.links = static_cast<uint64_t>(st.st_nlink);
+    info.uid = st.st_uid;
+    info.gid = st.st_gid;
+    info.size = static_cast<uint64_t>(st.st_size);
+    info.blocks = static_cast<uint64_t>(st.st_blocks);
+    info.mtime = st.st_mtime;
+    info.atime = st.st_atime;
+    info.device = static_cast<uint64_t>(st.st_dev);
+    info.inode = static_cast<uint64_t>(st.st_ino);
+    return true;
+#endif
+}
+
+} // namespace termidash
+
+#endif // _WIN32
@@ -0,0 +1,118 @@
+#ifndef _WIN32 // POSIX only
+
+#include "core/DiskUsage.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <system_error>
+
+namespace termidash {
+
+namespace {
+
+const unsigned usageFields = StatType | StatLinks | StatSize | StatBlocks | StatIdentity;
+
+} // namespace
+
+DiskUsage::DiskUsage(Options options, Report report)
+    : options_(options), report_(std::move(report)), group_(options.workers) {}
+
+uint64_t DiskUsage::measure(const std::string& path) {
+    FileStat info;
+    if (!DirectoryReader::statAt(AT_FDCWD, path.c_str(), usageFields, info)) {
+        fail("cannot access '" + path + "'", errno);
+        return 0;
+    }
+    if (info.type != EntryType::Directory) {
+        uint64_t bytes = charge(info);
+        std::lock_guard<std::mutex> lock(mutex_);
+        report_(path, bytes);
+        return bytes;
+    }
+
+    auto root = std::make_shared<Directory>();
+    root->path = path;
+    root->total = charge(info);
+    total_ = 0;
+    group_.spawn([this, root]() { scan(root); });
+    root.reset();
+    group_.run();
+    return total_;
+}
+
+uint64_t DiskUsage::charge(const FileStat& info) {
+    // Only the first link found of a multiply linked file counts
+    if (info.links > 1 && info.type != EntryType::Directory) {
+        LinkKey key{info.device, info.inode};
+        LinkShard& shard = links_[LinkKeyHash()(key) % linkShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!shard.seen.insert(key).second) return 0;
+    }
+    return options_.apparentSize ? info.size : info.blocks * 512;
+}
+
+void DiskUsage::scan(const std::shared_ptr<Directory>& directory) {
+    DirectoryReader reader(directory->path);
+    if (!reader.ok()) {
+        fail("cannot read directory '" + directory->path + "'", reader.error());
+        finish(directory);
+        return;
+    }
+
+    uint64_t sum = 0;
+    DirectoryReader::Entry entry;
+    FileStat info;
+    while (!group_.cancelled() && reader.next(entry)) {
+        // Both getdents64 and readdir leave the name NUL-terminated
+        bool found = DirectoryReader::statAt(reader.fd(), entry.name.data(), usageFields, info);
+        int error = found ? 0 : errno;
+        if (found && info.type != EntryType::Directory) {
+            sum += charge(info);
+            continue;
+        }
+        std::string path = directory->path;
+        if (path.back() != '/') path += '/';
+        path += entry.name;
+        if (!found) {
+            fail("cannot access '" + path + "'", error);
+            continue;
+        }
+        auto child = std::make_shared<Directory>();
+        child->path = std::move(path);
+        child->parent = directory;
+        child->depth = directory->depth + 1;
+        child->total = charge(info);
+        directory->pending.fetch_add(1);
+        group_.spawn([this, child]() { scan(child); });
+    }
+    if (reader.error() != 0) fail("cannot read directory '" + directory->path + "'", reader.error());
+
+    directory->total.fetch_add(sum);
+    finish(directory);
+}
+
+void DiskUsage::finish(std::shared_ptr<Directory> directory) {
+    // The last one to finish in a directory completes it, then its parent
+    // if that was the parent's last piece, and so on up the tree
+    while (directory && directory->pending.fetch_sub(1) == 1) {
+        uint64_t total = directory->total.load();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (directory->depth <= options_.maxDepth && !group_.cancelled() &&
+                !report_(directory->path, total)) {
+                group_.cancel();
+            }
+            if (!directory->parent) total_ = total;
+        }
+        if (directory->parent) directory->parent->total.fetch_add(total);
+        directory = directory->parent;
+    }
+}
+
+void DiskUsage::fail(const std::string& message, int error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    errors_.push_back(message + ": " + std::generic_category().message(error));
+}
+
+} // namespace termidash
+
+#endif // _WIN32
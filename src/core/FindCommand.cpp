@@ -0,0 +1,683 @@
+#ifndef _WIN32 // POSIX only
+
+#include "core/FindCommand.hpp"
+#include "common/PlatformUtils.hpp"
+#include "core/DirectoryReader.hpp"
+#include "core/GlobExpander.hpp"
+#include "core/PathIndex.hpp"
+#include "core/WorkerPool.hpp"
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <spawn.h>
+#include <stdexcept>
+#include <string_view>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace termidash {
+
+namespace {
+
+// Output a directory task collects before it takes the output lock
+const size_t flushSize = 64 * 1024;
+
+const size_t noBatch = SIZE_MAX;
+
+/**
+ * @brief A -name or -path pattern, sorted by the cheapest way to match it
+ *
+ * Most patterns are a literal with stars at one or both ends ("*.o",
+ * "build*", "*cache*"); those are compared in place. Anything else is
+ * left to GlobExpander::matchPattern.
+ */
+class Pattern {
+public:
+    Pattern() = default;
+
+    explicit Pattern(const std::string& glob) : glob_(glob) {
+        size_t first = glob.find_first_not_of('*');
+        if (first == std::string::npos) {
+            kind_ = Kind::Any;
+            return;
+        }
+        size_t last = glob.find_last_not_of('*');
+        fixed_ = glob.substr(first, last - first + 1);
+        if (fixed_.find_first_of("*?[\\") != std::string::npos) {
+            kind_ = Kind::Glob;
+            return;
+        }
+        bool leading = first > 0;
+        bool trailing = last + 1 < glob.size();
+        if (leading && trailing) kind_ = Kind::Contains;
+        else if (leading) kind_ = Kind::Suffix;
+        else if (trailing) kind_ = Kind::Prefix;
+        else kind_ = Kind::Literal;
+    }
+
+    bool matches(std::string_view text) const {
+        switch (kind_) {
+        case Kind::Any: return true;
+        case Kind::Literal: return text == fixed_;
+        case Kind::Prefix: return text.size() >= fixed_.size() && text.compare(0, fixed_.size(), fixed_) == 0;
+        case Kind::Suffix:
+            return text.size() >= fixed_.size() &&
+                   text.compare(text.size() - fixed_.size(), fixed_.size(), fixed_) == 0;
+        case Kind::Contains: return text.find(fixed_) != std::string_view::npos;
+        case Kind::Glob: return GlobExpander::matchPattern(glob_, std::string(text));
+        }
+        return false;
+    }
+
+private:
+    enum class Kind { Any, Literal, Prefix, Suffix, Contains, Glob };
+
+    Kind kind_ = Kind::Any;
+    std::string glob_;
+    std::string fixed_; // the pattern without its outer stars
+};
+
+// A numeric argument: +N (more than N), -N (less than N) or N (exactly N)
+struct Comparison {
+    int sign = 0;
+    int64_t value = 0;
+
+    bool test(int64_t n) const { return sign > 0 ? n > value : sign < 0 ? n < value : n == value; }
+};
+
+struct Node {
+    enum class Kind { And, Or, Not, True, False, Name, Path, Type, Size, MTime, Prune, Print, Print0, Exec };
+
+    explicit Node(Kind k) : kind(k) {}
+
+    Kind kind;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+    Pattern pattern;
+    char type = 0;
+    Comparison comparison;
+    int64_t unit = 1;                 // -size unit in bytes
+    std::vector<std::string> command; // -exec words; the + form ends in "{}"
+    size_t batch = noBatch;           // -exec ... + batch
+};
+
+struct FindOptions {
+    int maxDepth = INT_MAX;
+    int minDepth = 0;
+    unsigned fields = StatType; // what the tests need from a stat
+    size_t batches = 0;
+    bool hasAction = false;
+};
+
+/**
+ * @brief Recursive descent over the expression words
+ *
+ * Precedence from low to high: -o, -a (or nothing), !. Errors are thrown
+ * as std::runtime_error with the message find prints.
+ */
+class ExpressionParser {
+public:
+    ExpressionParser(const std::vector<std::string>& words, size_t pos, FindOptions& options)
+        : words_(words), pos_(pos), options_(options) {}
+
+    std::unique_ptr<Node> parse() {
+        if (pos_ == words_.size()) return std::make_unique<Node>(Node::Kind::True);
+        auto node = parseOr();
+        if (pos_ < words_.size()) throw std::runtime_error("invalid expression; you have too many ')'");
+        return node;
+    }
+
+private:
+    using Kind = Node::Kind;
+
+    bool at(const char* word) const { return pos_ < words_.size() && words_[pos_] == word; }
+
+    std::unique_ptr<Node> join(Kind kind, std::unique_ptr<Node> left, std::unique_ptr<Node> right) {
+        auto node = std::make_unique<Node>(kind);
+        node->left = std::move(left);
+        node->right = std::move(right);
+        return node;
+    }
+
+    std::unique_ptr<Node> parseOr() {
+        auto node = parseAnd();
+        while (at("-o") || at("-or")) {
+            std::string op = words_[pos_++];
+            if (pos_ == words_.size()) throw std::runtime_error("expected an expression after '" + op + "'");
+            node = join(Kind::Or, std::move(node), parseAnd());
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> parseAnd() {
+        auto node = parseNot();
+        while (pos_ < words_.size() && !at("-o") && !at("-or") && !at(")")) {
+            if (at("-a") || at("-and")) {
+                std::string op = words_[pos_++];
+                if (pos_ == words_.size()) throw std::runtime_error("expected an expression after '" + op + "'");
+            }
+            node = join(Kind::And, std::move(node), parseNot());
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> parseNot() {
+        if (at("!") || at("-not")) {
+            ++pos_;
+            if (pos_ == words_.size()) throw std::runtime_error("expected an expression after '!'");
+            return join(Kind::Not, parseNot(), nullptr);
+        }
+        return parsePrimary();
+    }
+
+    const std::string& argument(const std::string& predicate) {
+        if (pos_ == words_.size()) throw std::runtime_error("missing argument to '" + predicate + "'");
+        return words_[pos_++];
+    }
+
+    // [+-]digits, with the rest of the word left in suffix
+    Comparison comparison(const std::string& predicate, const std::string& text, std::string& suffix) {
+        Comparison result;
+        size_t i = 0;
+        if (i < text.size() && (text[i] == '+' || text[i] == '-')) result.sign = text[i++] == '+' ? 1 : -1;
+        size_t digits = i;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9') ++i;
+        if (i == digits) throw std::runtime_error("invalid argument '" + text + "' to '" + predicate + "'");
+        result.value = std::strtoll(text.c_str() + digits, nullptr, 10);
+        suffix = text.substr(i);
+        return result;
+    }
+
+    int depth(const std::string& predicate) {
+        const std::string& text = argument(predicate);
+        std::string suffix;
+        Comparison value = comparison(predicate, text, suffix);
+        if (value.sign != 0 || !suffix.empty() || value.value > INT_MAX) {
+            throw std::runtime_error("invalid argument '" + text + "' to '" + predicate + "'");
+        }
+        return static_cast<int>(value.value);
+    }
+
+    std::unique_ptr<Node> parsePrimary() {
+        const std::string& word = words_[pos_++];
+        if (word == "(") {
+            auto node = parseOr();
+            if (!at(")")) {
+                throw std::runtime_error("invalid expression; I was expecting to find a ')' somewhere but did not see one");
+            }
+            ++pos_;
+            return node;
+        }
+        if (word == "-name" || word == "-path" || word == "-wholename") {
+            auto node = std::make_unique<Node>(word == "-name" ? Kind::Name : Kind::Path);
+            node->pattern = Pattern(argument(word));
+            return node;
+        }
+        if (word == "-type") {
+            const std::string& type = argument(word);
+            if (type.size() != 1 || std::strchr("fdlpsbc", type[0]) == nullptr) {
+                throw std::runtime_error("Unknown argument to -type: " + type);
+            }
+            auto node = std::make_unique<Node>(Kind::Type);
+            node->type = type[0];
+            if (std::strchr("psbc", type[0])) options_.fields |= StatMode;
+            return node;
+        }
+        if (word == "-size") {
+            const std::string& text = argument(word);
+            auto node = std::make_unique<Node>(Kind::Size);
+            std::string unit;
+            node->comparison = comparison(word, text, unit);
+            if (unit.empty() || unit == "b") node->unit = 512;
+            else if (unit == "c") node->unit = 1;
+            else if (unit == "w") node->unit = 2;
+            else if (unit == "k") node->unit = 1024;
+            else if (unit == "M") node->unit = 1024 * 1024;
+            else if (unit == "G") node->unit = 1024 * 1024 * 1024;
+            else throw std::runtime_error("invalid -size type '" + unit + "'");
+            options_.fields |= StatSize;
+            return node;
+        }
+        if (word == "-mtime") {
+            const std::string& text = argument(word);
+            auto node = std::make_unique<Node>(Kind::MTime);
+            std::string suffix;
+            node->comparison = comparison(word, text, suffix);
+            if (!suffix.empty()) throw std::runtime_error("invalid argument '" + text + "' to '-mtime'");
+            options_.fields |= StatMTime;
+            return node;
+        }
+        if (word == "-maxdepth") {
+            options_.maxDepth = depth(word);
+            return std::make_unique<Node>(Kind::True);
+        }
+        if (word == "-mindepth") {
+            options_.minDepth = depth(word);
+            return std::make_unique<Node>(Kind::True);
+        }
+        if (word == "-exec") {
+            auto node = std::make_unique<Node>(Kind::Exec);
+            bool terminated = false;
+            while (pos_ < words_.size()) {
+                const std::string& arg = words_[pos_++];
+                if (arg == ";" || (arg == "+" && !node->command.empty() && node->command.back() == "{}")) {
+                    if (arg == "+") node->batch = options_.batches++;
+                    terminated = true;
+                    break;
+                }
+                node->command.push_back(arg);
+            }
+            if (!terminated || node->command.empty() || (node->batch != noBatch && node->command.size() < 2)) {
+                throw std::runtime_error("missing argument to '-exec'");
+            }
+            options_.hasAction = true;
+            return node;
+        }
+        if (word == "-prune") return std::make_unique<Node>(Kind::Prune);
+        if (word == "-true") return std::make_unique<Node>(Kind::True);
+        if (word == "-false") return std::make_unique<Node>(Kind::False);
+        if (word == "-print" || word == "-print0") {
+            options_.hasAction = true;
+            return std::make_unique<Node>(word == "-print" ? Kind::Print : Kind::Print0);
+        }
+        if (!word.empty() && word[0] == '-') throw std::runtime_error("unknown predicate '" + word + "'");
+        throw std::runtime_error("paths must precede expression: '" + word + "'");
+    }
+
+    const std::vector<std::string>& words_;
+    size_t pos_;
+    FindOptions& options_;
+};
+
+// Name a start point is matched by -name with: its last component
+std::string_view baseName(const std::string& path) {
+    std::string_view name(path);
+    while (name.size() > 1 && name.back() == '/') name.remove_suffix(1);
+    size_t slash = name.find_last_of('/');
+    if (slash != std::string_view::npos && name.size() > 1) name.remove_prefix(slash + 1);
+    return name;
+}
+
+// How many bytes of arguments a command may be given, keeping 2 KiB spare
+// as POSIX asks of xargs
+size_t argumentLimit() {
+    long max = sysconf(_SC_ARG_MAX);
+    size_t limit = max > 0 ? static_cast<size_t>(max) : 128 * 1024;
+    size_t environment = 0;
+    for (char** env = environ; *env; ++env) environment += std::strlen(*env) + 1 + sizeof(char*);
+    size_t reserved = environment + 2048;
+    return limit > reserved + 4096 ? limit - reserved : 4096;
+}
+
+/**
+ * @brief One run of find: the walk, the output and the -exec batches
+ */
+class Finder {
+public:
+    Finder(ExecContext& ctx, std::unique_ptr<Node> root, const FindOptions& options)
+        : ctx_(ctx), root_(std::move(root)), options_(options), now_(std::time(nullptr)),
+          argLimit_(argumentLimit()) {
+        batches_.resize(options.batches);
+        collectBatches(*root_);
+    }
+
+    /**
+     * @brief Evaluate a start point and everything below it
+     */
+    void walk(const std::string& start) {
+        std::string out;
+        Visit visit(start, baseName(start), start.c_str(), AT_FDCWD, 0, EntryType::Unknown, out);
+        visitEntry(visit);
+        flush(out);
+        group_.run();
+    }
+
+    /**
+     * @brief Run what is left in the -exec ... + batches
+     */
+    void finish() {
+        for (auto& batch : batches_) {
+            if (!batch->paths.empty()) runBatch(*batch, std::move(batch->paths));
+        }
+    }
+
+    bool failed() const { return failed_; }
+
+private:
+    struct Visit {
+        Visit(const std::string& path, std::string_view name, const char* statName, int dirFd, int depth,
+              EntryType type, std::string& out)
+            : path(path), name(name), statName(statName), dirFd(dirFd), depth(depth), type(type), out(out) {}
+
+        const std::string& path;
+        std::string_view name; // matched by -name
+        const char* statName;  // relative to dirFd
+        int dirFd;
+        int depth;
+        EntryType type;
+        std::string& out; // output of the current task
+        FileStat info;
+        bool statted = false;
+        bool prune = false;
+    };
+
+    struct Batch {
+        const Node* node = nullptr;
+        std::mutex mutex;
+        std::vector<std::string> paths;
+        size_t base = 0; // bytes taken by the command words
+        size_t bytes = 0;
+    };
+
+    void collectBatches(const Node& node) {
+        if (node.batch != noBatch) {
+            auto batch = std::make_unique<Batch>();
+            batch->node = &node;
+            for (size_t i = 0; i + 1 < node.command.size(); ++i) {
+                batch->base += node.command[i].size() + 1 + sizeof(char*);
+            }
+            batch->bytes = batch->base;
+            batches_[node.batch] = std::move(batch);
+        }
+        if (node.left) collectBatches(*node.left);
+        if (node.right) collectBatches(*node.right);
+    }
+
+    bool stat(Visit& visit) {
+        if (visit.statted) return true;
+        if (!DirectoryReader::statAt(visit.dirFd, visit.statName, options_.fields, visit.info)) {
+            error(visit.path, errno);
+            return false;
+        }
+        visit.statted = true;
+        visit.type = visit.info.type;
+        return true;
+    }
+
+    void visitEntry(Visit& visit) {
+        if (visit.type == EntryType::Unknown && !stat(visit)) return;
+        if (visit.depth >= options_.minDepth) evaluate(*root_, visit);
+        if (visit.type == EntryType::Directory && !visit.prune && visit.depth < options_.maxDepth &&
+            !group_.cancelled()) {
+            group_.spawn([this, path = visit.path, depth = visit.depth + 1]() { walkDirectory(path, depth); });
+        }
+    }
+
+    void walkDirectory(const std::string& path, int depth) {
+        DirectoryReader reader(path);
+        if (!reader.ok()) {
+            error(path, reader.error());
+            return;
+        }
+        std::string out;
+        std::string child;
+        DirectoryReader::Entry entry;
+        while (!group_.cancelled() && reader.next(entry)) {
+            child.assign(path);
+            if (child.back() != '/') child += '/';
+            child.append(entry.name);
+            // Both getdents64 and readdir leave the name NUL-terminated
+            Visit visit(child, entry.name, entry.name.data(), reader.fd(), depth, entry.type, out);
+            visitEntry(visit);
+            if (out.size() >= flushSize) flush(out);
+        }
+        if (reader.error() != 0) error(path, reader.error());
+        flush(out);
+    }
+
+    bool evaluate(const Node& node, Visit& visit) {
+        using Kind = Node::Kind;
+        switch (node.kind) {
+        case Kind::And: return evaluate(*node.left, visit) && evaluate(*node.right, visit);
+        case Kind::Or: return evaluate(*node.left, visit) || evaluate(*node.right, visit);
+        case Kind::Not: return !evaluate(*node.left, visit);
+        case Kind::True: return true;
+        case Kind::False: return false;
+        case Kind::Name: return node.pattern.matches(visit.name);
+        case Kind::Path: return node.pattern.matches(visit.path);
+        case Kind::Type: return matchesType(node.type, visit);
+        case Kind::Size: {
+            if (!stat(visit)) return false;
+            int64_t size = static_cast<int64_t>(visit.info.size);
+            return node.comparison.test((size + node.unit - 1) / node.unit);
+        }
+        case Kind::MTime: {
+            if (!stat(visit)) return false;
+            // Whole days old, rounded down as find does
+            int64_t age = now_ - visit.info.mtime;
+            int64_t days = age >= 0 ? age / 86400 : -((-age + 86399) / 86400);
+            return node.comparison.test(days);
+        }
+        case Kind::Prune:
+            visit.prune = true;
+            return true;
+        case Kind::Print:
+            visit.out += visit.path;
+            visit.out += '\n';
+            return true;
+        case Kind::Print0:
+            visit.out += visit.path;
+            visit.out += '\0';
+            return true;
+        case Kind::Exec: return exec(node, visit);
+        }
+        return false;
+    }
+
+    bool matchesType(char type, Visit& visit) {
+        switch (type) {
+        case 'f': return visit.type == EntryType::Regular;
+        case 'd': return visit.type == EntryType::Directory;
+        case 'l': return visit.type == EntryType::Symlink;
+        }
+        if (visit.type != EntryType::Other || !stat(visit)) return false;
+        switch (type) {
+        case 'p': return S_ISFIFO(visit.info.mode);
+        case 's': return S_ISSOCK(visit.info.mode);
+        case 'b': return S_ISBLK(visit.info.mode);
+        case 'c': return S_ISCHR(visit.info.mode);
+        }
+        return false;
+    }
+
+    bool exec(const Node& node, Visit& visit) {
+        if (node.batch != noBatch) {
+            Batch& batch = *batches_[node.batch];
+            std::vector<std::string> full;
+            {
+                std::lock_guard<std::mutex> lock(batch.mutex);
+                size_t cost = visit.path.size() + 1 + sizeof(char*);
+                if (!batch.paths.empty() && batch.bytes + cost > argLimit_) {
+                    full.swap(batch.paths);
+                    batch.bytes = batch.base;
+                }
+                batch.paths.push_back(visit.path);
+                batch.bytes += cost;
+            }
+            if (!full.empty()) runBatch(batch, std::move(full));
+            return true;
+        }
+
+        std::vector<std::string> argv;
+        argv.reserve(node.command.size());
+        for (const auto& word : node.command) {
+            std::string arg;
+            size_t from = 0, brace;
+            while ((brace = word.find("{}", from)) != std::string::npos) {
+                arg.append(word, from, brace - from);
+                arg += visit.path;
+                from = brace + 2;
+            }
+            arg.append(word, from, std::string::npos);
+            argv.push_back(std::move(arg));
+        }
+        flush(visit.out); // what was printed for earlier entries comes first
+        return execute(argv) == 0;
+    }
+
+    void runBatch(const Batch& batch, std::vector<std::string> paths) {
+        const auto& command = batch.node->command;
+        std::vector<std::string> argv(command.begin(), command.end() - 1);
+        argv.insert(argv.end(), std::make_move_iterator(paths.begin()), std::make_move_iterator(paths.end()));
+        if (execute(argv) != 0) failed_ = true;
+    }
+
+    /**
+     * @brief Run a command to completion and return its exit status
+     *
+     * The output lock is held throughout so the command's output is not
+     * mixed with lines other tasks print. It writes to the output handle
+     * directly when there is one, otherwise through a pipe read here.
+     */
+    int execute(const std::vector<std::string>& argv) {
+        std::vector<char*> args;
+        args.reserve(argv.size() + 1);
+        for (const auto& arg : argv) args.push_back(const_cast<char*>(arg.c_str()));
+        args.push_back(nullptr);
+        std::string resolved;
+        if (argv[0].find('/') == std::string::npos) resolved = PathIndex::instance().resolve(argv[0]);
+        const char* file = resolved.empty() ? argv[0].c_str() : resolved.c_str();
+
+        std::lock_guard<std::mutex> lock(outputMutex_);
+        ctx_.out.flush();
+        int pipeFds[2] = {-1, -1};
+        int childOut = static_cast<int>(ctx_.outFd);
+        if (childOut == -1) {
+#ifdef __linux__
+            int rc = pipe2(pipeFds, O_CLOEXEC);
+#else
+            int rc = pipe(pipeFds);
+            if (rc == 0) {
+                fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+                fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+            }
+#endif
+            if (rc != 0) {
+                reportLocked(argv[0], errno);
+                return 127;
+            }
+            childOut = pipeFds[1];
+        }
+
+        // This may be a worker thread with SIGPIPE blocked; the child starts
+        // with a clean signal state either way
+        posix_spawnattr_t attr;
+        if (!PlatformUtils::initSpawnAttributes(attr)) {
+            if (pipeFds[0] != -1) close(pipeFds[0]);
+            if (pipeFds[1] != -1) close(pipeFds[1]);
+            reportLocked(argv[0], ENOMEM);
+            return 127;
+        }
+        posix_spawn_file_actions_t actions;
+        int rc = posix_spawn_file_actions_init(&actions);
+        if (rc == 0 && childOut != STDOUT_FILENO) rc = posix_spawn_file_actions_adddup2(&actions, childOut, STDOUT_FILENO);
+        pid_t pid = -1;
+        if (rc == 0) {
+            if (std::strchr(file, '/')) rc = posix_spawn(&pid, file, &actions, &attr, args.data(), environ);
+            else rc = posix_spawnp(&pid, file, &actions, &attr, args.data(), environ);
+            posix_spawn_file_actions_destroy(&actions);
+        }
+        posix_spawnattr_destroy(&attr);
+        if (pipeFds[1] != -1) close(pipeFds[1]);
+        if (rc != 0) {
+            if (pipeFds[0] != -1) close(pipeFds[0]);
+            reportLocked(argv[0], rc);
+            return 127;
+        }
+
+        if (pipeFds[0] != -1) {
+            char buffer[16 * 1024];
+            ssize_t n;
+            while ((n = read(pipeFds[0], buffer, sizeof(buffer))) != 0) {
+                if (n > 0) ctx_.write(buffer, static_cast<size_t>(n));
+                else if (errno != EINTR) break;
+            }
+            close(pipeFds[0]);
+        }
+        int status = 0;
+        while (waitpid(pid, &status, 0) == -1) {
+            if (errno != EINTR) return 127;
+        }
+        if (ctx_.cancelled()) group_.cancel();
+        return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    }
+
+    void flush(std::string& out) {
+        if (out.empty()) return;
+        std::lock_guard<std::mutex> lock(outputMutex_);
+        ctx_.write(out);
+        if (ctx_.cancelled()) group_.cancel();
+        out.clear();
+    }
+
+    void error(const std::string& path, int error) {
+        std::lock_guard<std::mutex> lock(outputMutex_);
+        reportLocked(path, error);
+    }
+
+    void reportLocked(const std::string& what, int error) {
+        ctx_.err << "find: '" << what << "': " << std::generic_category().message(error) << "\n";
+        failed_ = true;
+    }
+
+    ExecContext& ctx_;
+    std::unique_ptr<Node> root_;
+    FindOptions options_;
+    int64_t now_;
+    size_t argLimit_;
+    WorkStealingGroup group_;
+    std::mutex outputMutex_; // guards ctx_ and running commands
+    std::vector<std::unique_ptr<Batch>> batches_;
+    std::atomic<bool> failed_{false};
+};
+
+bool startsExpression(const std::string& word) {
+    return (word.size() > 1 && word[0] == '-') || word == "(" || word == ")" || word == "!";
+}
+
+} // namespace
+
+int FindCommand::run(const std::vector<std::string>& args, ExecContext& ctx) {
+    size_t pos = 1;
+    std::vector<std::string> starts;
+    while (pos < args.size() && !startsExpression(args[pos])) starts.push_back(args[pos++]);
+    if (starts.empty()) starts.push_back(".");
+
+    FindOptions options;
+    std::unique_ptr<Node> root;
+    try {
+        root = ExpressionParser(args, pos, options).parse();
+    } catch (const std::runtime_error& e) {
+        ctx.err << "find: " << e.what() << "\n";
+        return 1;
+    }
+    if (!options.hasAction) {
+        auto print = std::make_unique<Node>(Node::Kind::And);
+        print->left = std::move(root);
+        print->right = std::make_unique<Node>(Node::Kind::Print);
+        root = std::move(print);
+    }
+
+    Finder finder(ctx, std::move(root), options);
+    for (const auto& start : starts) {
+        if (ctx.cancelled()) break;
+        finder.walk(start);
+    }
+    finder.finish();
+    return finder.failed() ? 1 : 0;
+}
+
+} // namespace termidash
+
+#endif // _WIN32
@@ -9,6 +9,13 @@ FunctionManager& FunctionManager::instance() {
 
 void FunctionManager::define(const std::string& name, const std::vector<std::string>& body) {
     functions[name] = body;
+    compiledFunctions.erase(name);
+}
+
+void FunctionManager::define(const std::string& name, const std::vector<std::string>& body,
+                             std::shared_ptr<const bytecode::Chunk> compiled) {
+    functions[name] = body;
+    compiledFunctions[name] = std::move(compiled);
 }
 
 bool FunctionManager::has(const std::string& name) const {
@@ -24,8 +31,17 @@ const std::vector<std::string>& FunctionManager::getBody(const std::string& name
     return empty;
 }
 
+std::shared_ptr<const bytecode::Chunk> FunctionManager::getCompiled(const std::string& name) const {
+    auto it = compiledFunctions.find(name);
+    if (it != compiledFunctions.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
 void FunctionManager::unset(const std::string& name) {
     functions.erase(name);
+    compiledFunctions.erase(name);
 }
 
 std::map<std::string, std::vector<std::string>> FunctionManager::getAll() const {
@@ -0,0 +1,210 @@
+#include "core/Lexer.hpp"
+
+namespace termidash {
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool isOperatorChar(char c) {
+    return c == '&' || c == '|' || c == ';' || c == '<' || c == '>';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+size_t skipParens(std::string_view line, size_t i);
+
+// Skip a quoted section starting at line[i]; returns the index after it.
+// A $(...) inside double quotes may contain quotes of its own.
+size_t skipQuote(std::string_view line, size_t i) {
+    char quote = line[i];
+    for (++i; i < line.size(); ++i) {
+        if (line[i] == quote) return i + 1;
+        if (quote == '"' && line[i] == '$' && i + 1 < line.size() && line[i + 1] == '(') {
+            i = skipParens(line, i + 1) - 1;
+        }
+    }
+    return line.size();
+}
+
+// Skip a parenthesised group starting at line[i] == '('; quotes are honoured
+size_t skipParens(std::string_view line, size_t i) {
+    int depth = 0;
+    while (i < line.size()) {
+        char c = line[i];
+        if (c == '"' || c == '\'') {
+            i = skipQuote(line, i);
+            continue;
+        }
+        if (c == '(') {
+            ++depth;
+        } else if (c == ')' && --depth == 0) {
+            return i + 1;
+        }
+        ++i;
+    }
+    return i;
+}
+
+// Length of the operator at line[i], or 0 if none starts there
+size_t operatorLength(std::string_view line, size_t i, TokenKind& kind) {
+    auto at = [&](size_t k) { return i + k < line.size() ? line[i + k] : '\0'; };
+    char c = line[i];
+    switch (c) {
+    case '&':
+        if (at(1) == '&') { kind = TokenKind::AndIf; return 2; }
+        if (at(1) == '>') { kind = TokenKind::Redirect; return at(2) == '>' ? 3 : 2; }
+        kind = TokenKind::Background;
+        return 1;
+    case '|':
+        if (at(1) == '|') { kind = TokenKind::OrIf; return 2; }
+        if (at(1) == '>') { kind = TokenKind::TrimPipe; return 2; }
+        kind = TokenKind::Pipe;
+        return 1;
+    case ';':
+        kind = TokenKind::Semicolon;
+        return 1;
+    case '<':
+        kind = TokenKind::Redirect;
+        if (at(1) == '<') return at(2) == '<' ? 3 : 2;
+        return 1;
+    case '>':
+        kind = TokenKind::Redirect;
+        if (at(1) == '>') return 2;
+        if (at(1) == '&') return isDigit(at(2)) ? 3 : 2;
+        return 1;
+    default:
+        break;
+    }
+
+    // File-descriptor redirections: 2>, 2>>, 2>&1 (digit must start the word)
+    if (isDigit(c) && at(1) == '>') {
+        kind = TokenKind::Redirect;
+        if (at(2) == '>') return 3;
+        if (at(2) == '&' && isDigit(at(3))) return 4;
+        return 2;
+    }
+    return 0;
+}
+
+// True if the next token starts a command, where [[ is a keyword
+bool atCommandStart(const std::vector<Token>& out, size_t first) {
+    if (out.size() == first) return true;
+    const Token& last = out.back();
+    if (last.kind != TokenKind::Word) return last.kind != TokenKind::Redirect;
+    static const std::string_view keywords[] = {"if", "elif", "while", "until", "then", "else", "do", "!", "{"};
+    for (std::string_view keyword : keywords) {
+        if (!last.quoted && last.text == keyword) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void Lexer::lex(std::string_view line, std::vector<Token>& out) {
+    size_t first = out.size();
+    bool conditional = false; // inside [[ ]]
+    size_t i = 0;
+    while (i < line.size()) {
+        if (isSpace(line[i])) {
+            ++i;
+            continue;
+        }
+
+        TokenKind kind;
+        if (size_t length = operatorLength(line, i, kind)) {
+            // Inside [[ ]] these are operands of the test, not shell operators
+            if (conditional && (kind == TokenKind::AndIf || kind == TokenKind::OrIf ||
+                                (kind == TokenKind::Redirect && length == 1))) {
+                kind = TokenKind::Word;
+            }
+            out.push_back({kind, line.substr(i, length), false});
+            i += length;
+            continue;
+        }
+
+        size_t start = i;
+        bool quoted = false;
+
+        // Arithmetic command ((...)) is a single word
+        if (line.compare(i, 2, "((") == 0) {
+            i = skipParens(line, i);
+        }
+
+        while (i < line.size() && !isSpace(line[i]) && !isOperatorChar(line[i])) {
+            char c = line[i];
+            if (c == '"' || c == '\'') {
+                quoted = true;
+                i = skipQuote(line, i);
+            } else if (c == '`') {
+                size_t close = line.find('`', i + 1);
+                i = close == std::string_view::npos ? line.size() : close + 1;
+            } else if (c == '$' && i + 1 < line.size() && line[i + 1] == '(') {
+                i = skipParens(line, i + 1);
+            } else {
+                ++i;
+            }
+        }
+        std::string_view word = line.substr(start, i - start);
+        if (!quoted && word == "[[" && atCommandStart(out, first)) conditional = true;
+        else if (!quoted && word == "]]") conditional = false;
+        out.push_back({TokenKind::Word, word, quoted});
+    }
+}
+
+std::vector<Token> Lexer::lex(std::string_view line) {
+    std::vector<Token> tokens;
+    lex(line, tokens);
+    return tokens;
+}
+
+std::string Lexer::unquote(std::string_view word) {
+    std::string out;
+    out.reserve(word.size());
+    char quote = 0;
+    for (char c : word) {
+        if (quote) {
+            if (c == quote) quote = 0;
+            else out += c;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string Lexer::value(const Token& token) {
+    return token.quoted ? unquote(token.text) : std::string(token.text);
+}
+
+std::vector<std::string> Lexer::words(std::string_view line) {
+    std::vector<Token> tokens;
+    lex(line, tokens);
+    std::vector<std::string> out;
+    out.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        out.push_back(value(token));
+    }
+    return out;
+}
+
+std::string_view Lexer::span(const Token& first, const Token& last) {
+    return std::string_view(first.text.data(),
+                            static_cast<size_t>(last.text.data() + last.text.size() - first.text.data()));
+}
+
+std::string_view Lexer::trim(std::string_view s) {
+    size_t start = 0;
+    while (start < s.size() && isSpace(s[start])) ++start;
+    size_t end = s.size();
+    while (end > start && isSpace(s[end - 1])) --end;
+    return s.substr(start, end - start);
+}
+
+} // namespace termidash
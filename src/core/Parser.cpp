@@ -1,4 +1,6 @@
 #include "core/Parser.hpp"
+#include "core/TrimFilter.hpp"
+#include <cctype>
 
 namespace termidash {
 
@@ -12,174 +14,236 @@ std::string Parser::trim(const std::string& s) {
 
 std::vector<std::pair<std::string, std::string>> Parser::splitBatch(const std::string& input) {
     std::vector<std::pair<std::string, std::string>> result;
-    size_t i = 0;
-    std::string current;
-    while (i < input.size()) {
-        if (i + 1 < input.size()) {
-            std::string two = input.substr(i, 2);
-            if (two == "&&" || two == "||") {
-                result.emplace_back(trim(current), two);
-                current.clear();
-                i += 2;
-                continue;
-            }
-        }
-        if (input[i] == ';') {
-            result.emplace_back(trim(current), ";");
-            current.clear();
-            i++;
+    std::vector<Token> tokens = Lexer::lex(input);
+
+    const Token* first = nullptr;
+    const Token* last = nullptr;
+    for (const auto& token : tokens) {
+        if (token.kind == TokenKind::AndIf || token.kind == TokenKind::OrIf ||
+            token.kind == TokenKind::Semicolon) {
+            result.emplace_back(first ? std::string(Lexer::span(*first, *last)) : std::string(),
+                                std::string(token.text));
+            first = last = nullptr;
             continue;
         }
-        current += input[i++];
+        if (!first) first = &token;
+        last = &token;
     }
-    if (!current.empty()) {
-        result.emplace_back(trim(current), "");
+    if (first) {
+        result.emplace_back(std::string(Lexer::span(*first, *last)), "");
     }
     return result;
 }
 
 std::vector<std::string> Parser::tokenize(const std::string& cmd) {
-    std::vector<std::string> tokens;
-    std::string token;
-    bool inQuotes = false;
-    for (char c : cmd) {
-        if (c == '\"') {
-            inQuotes = !inQuotes;
-        } else if (c == ' ' && !inQuotes) {
-            if (!token.empty()) {
-                tokens.push_back(token);
-                token.clear();
-            }
-        } else {
-            token += c;
-        }
+    return Lexer::words(cmd);
+}
+
+Parser::RedirectionInfo Parser::parseRedirection(const std::string& cmd) {
+    std::vector<Token> tokens = Lexer::lex(cmd);
+    return parseRedirection(tokens.data(), tokens.data() + tokens.size());
+}
+
+bool Parser::redirectKind(std::string_view op, ast::RedirectKind& kind) {
+    using ast::RedirectKind;
+    // Descriptor duplication: [N]>&M, where N defaults to 1
+    size_t amp = op.find(">&");
+    if (amp != std::string_view::npos && amp + 3 == op.size() && std::isdigit(static_cast<unsigned char>(op.back()))) {
+        char from = amp == 0 ? '1' : op[0];
+        char to = op.back();
+        if (from == '2' && to == '1') kind = RedirectKind::ErrorToOutput;
+        else if (from == '1' && to == '2') kind = RedirectKind::OutputToError;
+        else if (from == to && (from == '1' || from == '2')) kind = RedirectKind::None;
+        else return false;
+        return true;
+    }
+
+    if (op == "<") kind = RedirectKind::Input;
+    else if (op == "<<") kind = RedirectKind::HereDoc;
+    else if (op == "<<<") kind = RedirectKind::HereString;
+    else if (op == ">" || op == "1>") kind = RedirectKind::Output;
+    else if (op == ">>" || op == "1>>") kind = RedirectKind::Append;
+    else if (op == "2>") kind = RedirectKind::Error;
+    else if (op == "2>>") kind = RedirectKind::ErrorAppend;
+    else if (op == "&>" || op == ">&") kind = RedirectKind::Both;
+    else if (op == "&>>") kind = RedirectKind::BothAppend;
+    else return false;
+    return true;
+}
+
+const char* Parser::redirectOperator(ast::RedirectKind kind) {
+    using ast::RedirectKind;
+    switch (kind) {
+    case RedirectKind::Input: return "<";
+    case RedirectKind::HereDoc: return "<<";
+    case RedirectKind::HereString: return "<<<";
+    case RedirectKind::Output: return ">";
+    case RedirectKind::Append: return ">>";
+    case RedirectKind::Error: return "2>";
+    case RedirectKind::ErrorAppend: return "2>>";
+    case RedirectKind::Both: return "&>";
+    case RedirectKind::BothAppend: return "&>>";
+    case RedirectKind::ErrorToOutput: return "2>&1";
+    case RedirectKind::OutputToError: return ">&2";
+    case RedirectKind::None: break;
     }
-    if (!token.empty()) {
-        tokens.push_back(token);
+    return "";
+}
+
+bool Parser::takesTarget(ast::RedirectKind kind) {
+    return kind != ast::RedirectKind::ErrorToOutput && kind != ast::RedirectKind::OutputToError &&
+           kind != ast::RedirectKind::None;
+}
+
+void Parser::applyRedirection(RedirectionInfo& info, ast::RedirectKind kind, std::string target) {
+    using ast::RedirectKind;
+    switch (kind) {
+    case RedirectKind::Input:
+        info.inFile = std::move(target);
+        break;
+    case RedirectKind::HereDoc:
+        info.hereDocDelim = std::move(target);
+        info.isHereDoc = true;
+        break;
+    case RedirectKind::HereString:
+        info.hereString = std::move(target);
+        info.isHereString = true;
+        break;
+    case RedirectKind::Output:
+    case RedirectKind::Append:
+        info.outFile = std::move(target);
+        info.appendOut = kind == RedirectKind::Append;
+        break;
+    case RedirectKind::Error:
+    case RedirectKind::ErrorAppend:
+        info.errFile = std::move(target);
+        info.appendErr = kind == RedirectKind::ErrorAppend;
+        break;
+    case RedirectKind::Both:
+    case RedirectKind::BothAppend:
+        // &>, >& and &>> send both streams to the file
+        info.outFile = target;
+        info.errFile = std::move(target);
+        info.appendOut = info.appendErr = kind == RedirectKind::BothAppend;
+        break;
+    case RedirectKind::ErrorToOutput:
+        info.errToOut = true;
+        break;
+    case RedirectKind::OutputToError:
+        info.outToErr = true;
+        break;
+    case RedirectKind::None:
+        break;
     }
-    return tokens;
 }
 
-Parser::RedirectionInfo Parser::parseRedirection(const std::string& cmd) {
+Parser::RedirectionInfo Parser::parseRedirection(const Token* begin, const Token* end, bool oneLine) {
     RedirectionInfo info;
-    
-    std::vector<std::string> toks;
-    // Split respecting quotes
-    std::string cur;
-    bool inQuotes = false;
-    for (size_t i = 0; i < cmd.size(); ++i) {
-        char c = cmd[i];
-        if (c == '\"') {
-            inQuotes = !inQuotes;
-            cur.push_back(c);
+    std::vector<std::string_view> kept; // raw text of the command's own tokens
+
+    for (const Token* t = begin; t != end; ++t) {
+        ast::RedirectKind kind;
+        if (t->kind != TokenKind::Redirect || !redirectKind(t->text, kind)) {
+            // Words, and unsupported operators as typed
+            kept.push_back(t->text);
+            info.args.push_back(t->kind == TokenKind::Redirect ? std::string(t->text) : Lexer::value(*t));
             continue;
         }
-        if (!inQuotes && (c == ' ' || c == '\t')) {
-            if (!cur.empty()) {
-                toks.push_back(cur);
-                cur.clear();
-            }
-        } else {
-            cur.push_back(c);
+        if (!takesTarget(kind)) {
+            applyRedirection(info, kind, std::string());
+            continue;
+        }
+        if (t + 1 == end || t[1].kind != TokenKind::Word) {
+            // Without a target the operator stays part of the command
+            kept.push_back(t->text);
+            info.args.push_back(std::string(t->text));
+            continue;
         }
+        ++t;
+        applyRedirection(info, kind, Lexer::value(*t));
     }
-    if (!cur.empty())
-        toks.push_back(cur);
-
-    for (size_t i = 0; i < toks.size(); ++i) {
-        const std::string& t = toks[i];
-        if (t == "<") {
-            if (i + 1 < toks.size())
-                info.inFile = toks[++i];
-        } else if (t == "<<") {
-            if (i + 1 < toks.size()) {
-                info.hereDocDelim = toks[++i];
-                info.isHereDoc = true;
-            }
-        } else if (t == ">>") {
-            if (i + 1 < toks.size()) {
-                info.outFile = toks[++i];
-                info.appendOut = true;
-            }
-        } else if (t == ">" || t == "1>") {
-            if (i + 1 < toks.size()) {
-                info.outFile = toks[++i];
-                info.appendOut = false;
-            }
-        } else if (t == "2>") {
-            if (i + 1 < toks.size()) {
-                info.errFile = toks[++i];
-                info.appendErr = false;
-            }
-        } else if (t == "2>>") {
-            if (i + 1 < toks.size()) {
-                info.errFile = toks[++i];
-                info.appendErr = true;
-            }
-        } else if (t == "&>" || t == ">&") {
-            if (i + 1 < toks.size()) {
-                info.outFile = toks[++i];
-                info.errFile = info.outFile;
-                info.appendOut = false;
-                info.appendErr = false;
-            }
-        } else if (t == "&>>") {
-            if (i + 1 < toks.size()) {
-                info.outFile = toks[++i];
-                info.errFile = info.outFile;
-                info.appendOut = true;
-                info.appendErr = true;
-            }
-        } else {
+
+    // Without redirections the command is the original text, as a single copy
+    if (oneLine && kept.size() == static_cast<size_t>(end - begin) && begin != end) {
+        info.command = std::string(Lexer::span(*begin, end[-1]));
+    } else {
+        for (std::string_view text : kept) {
             if (!info.command.empty())
                 info.command += ' ';
-            info.command += t;
+            info.command += text;
         }
     }
-    
     return info;
 }
 
-std::vector<Parser::PipelineSegment> Parser::splitPipelineOperators(const std::string& line) {
-    std::vector<PipelineSegment> segments;
-    size_t pos = 0;
-    std::string current;
-    while (pos < line.size()) {
-        if (pos + 1 < line.size() && line.substr(pos, 2) == "|>") {
-            segments.push_back({trim(current), true});
-            current.clear();
-            pos += 2;
-        } else if (line[pos] == '|') {
-            segments.push_back({trim(current), false});
-            current.clear();
-            pos++;
-        } else {
-            current += line[pos++];
+ast::Pipeline Parser::parsePipeline(const Token* begin, const Token* end) {
+    ast::Pipeline pipeline;
+    if (begin != end && end[-1].kind == TokenKind::Background) {
+        pipeline.background = true;
+        --end;
+    }
+
+    for (const TokenSegment& segment : splitPipeline(begin, end)) {
+        ast::Stage stage;
+        stage.trimAfter = segment.trimBeforeNext;
+        for (const Token* t = segment.begin; t != segment.end; ++t) {
+            ast::RedirectKind kind;
+            if (t->kind == TokenKind::Redirect && redirectKind(t->text, kind)) {
+                if (!takesTarget(kind)) {
+                    if (kind != ast::RedirectKind::None) stage.redirections.push_back({kind, std::string()});
+                    continue;
+                }
+                if (t + 1 != segment.end && t[1].kind == TokenKind::Word) {
+                    ++t;
+                    stage.redirections.push_back({kind, std::string(t->text)});
+                    continue;
+                }
+            }
+            // Words, and operators the shell does not handle, as typed
+            stage.words.emplace_back(t->text);
         }
+        pipeline.stages.push_back(std::move(stage));
     }
-    if (!current.empty()) {
-        segments.push_back({trim(current), false});
+    return pipeline;
+}
+
+std::vector<Parser::TokenSegment> Parser::splitPipeline(const std::vector<Token>& tokens) {
+    return splitPipeline(tokens.data(), tokens.data() + tokens.size());
+}
+
+std::vector<Parser::TokenSegment> Parser::splitPipeline(const Token* begin, const Token* end) {
+    std::vector<TokenSegment> segments;
+    const Token* start = begin;
+    for (const Token* t = begin; t != end; ++t) {
+        if (t->kind == TokenKind::Pipe || t->kind == TokenKind::TrimPipe) {
+            segments.push_back({start, t, t->kind == TokenKind::TrimPipe});
+            start = t + 1;
+        }
+    }
+    if (start != end) {
+        segments.push_back({start, end, false});
     }
     return segments;
 }
 
-std::string Parser::applyTrimToLines(const std::string& input) {
-    std::string out;
-    std::string line;
-    size_t start = 0;
-    while (start < input.size()) {
-        size_t npos = input.find('\n', start);
-        if (npos == std::string::npos)
-            npos = input.size();
-        line = input.substr(start, npos - start);
-        size_t s = line.find_first_not_of(" \t");
-        size_t e = line.find_last_not_of(" \t");
-        if (s != std::string::npos && e != std::string::npos && e >= s) {
-            out += line.substr(s, e - s + 1);
-            out += '\n';
-        }
-        start = (npos == input.size()) ? npos : npos + 1;
+std::vector<Parser::PipelineSegment> Parser::splitPipelineOperators(const std::string& line) {
+    std::vector<Token> tokens = Lexer::lex(line);
+    std::vector<PipelineSegment> segments;
+    for (const auto& segment : splitPipeline(tokens)) {
+        std::string cmd;
+        if (segment.begin != segment.end)
+            cmd = std::string(Lexer::span(*segment.begin, segment.end[-1]));
+        segments.push_back({cmd, segment.trimBeforeNext});
     }
+    return segments;
+}
+
+std::string Parser::applyTrimToLines(const std::string& input) {
+    std::string out = input;
+    TrimFilter trimmer;
+    size_t consumed = 0;
+    out.resize(trimmer.filter(&out[0], out.size(), consumed));
+    if (trimmer.pendingNewline()) out += '\n';
     return out;
 }
 
@@ -0,0 +1,133 @@
+#include "core/PathIndex.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace fs = std::filesystem;
+
+namespace termidash {
+
+namespace {
+
+#ifdef _WIN32
+const char pathListSeparator = ';';
+#else
+const char pathListSeparator = ':';
+#endif
+
+fs::file_time_type modificationTime(const fs::path& dir) {
+    std::error_code ec;
+    auto time = fs::last_write_time(dir, ec);
+    return ec ? fs::file_time_type::min() : time;
+}
+
+// Command name for a directory entry, or "" if it is not executable
+std::string commandName(const fs::directory_entry& entry) {
+    std::error_code ec;
+    if (!entry.is_regular_file(ec)) return "";
+    std::string name = entry.path().filename().string();
+#ifdef _WIN32
+    std::string ext = entry.path().extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (ext != ".exe" && ext != ".com" && ext != ".bat" && ext != ".cmd") return "";
+    return name.substr(0, name.size() - ext.size());
+#else
+    auto perms = entry.status(ec).permissions();
+    if (ec || (perms & (fs::perms::owner_exec | fs::perms::group_exec | fs::perms::others_exec)) == fs::perms::none)
+        return "";
+    return name;
+#endif
+}
+
+} // namespace
+
+PathIndex& PathIndex::instance() {
+    static PathIndex instance;
+    return instance;
+}
+
+void PathIndex::rebuild(const std::string& path) {
+    path_ = path;
+    dirs_.clear();
+    commands_.clear();
+    names_.clear();
+
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find(pathListSeparator, start);
+        if (end == std::string::npos) end = path.size();
+        std::string dir = path.substr(start, end - start);
+        start = end + 1;
+        if (dir.empty()) continue;
+
+        dirs_.emplace_back(dir, modificationTime(dir));
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), last; !ec && it != last; it.increment(ec)) {
+            std::string name = commandName(*it);
+            if (!name.empty() && commands_.emplace(name, fs::absolute(it->path()).string()).second) {
+                names_.push_back(std::move(name));
+            }
+        }
+    }
+    std::sort(names_.begin(), names_.end());
+    built_ = true;
+}
+
+void PathIndex::refreshIfStale() {
+    const char* env = std::getenv("PATH");
+    std::string path = env ? env : "";
+    bool stale = !built_ || path != path_;
+    for (size_t i = 0; !stale && i < dirs_.size(); ++i) {
+        stale = modificationTime(dirs_[i].first) != dirs_[i].second;
+    }
+    if (stale) rebuild(path);
+}
+
+std::string PathIndex::resolve(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshIfStale();
+    auto it = commands_.find(name);
+    if (it == commands_.end()) return "";
+    ++hits_[name];
+    return it->second;
+}
+
+std::vector<std::string> PathIndex::complete(const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshIfStale();
+    std::vector<std::string> out;
+    for (auto it = std::lower_bound(names_.begin(), names_.end(), prefix);
+         it != names_.end() && it->compare(0, prefix.size(), prefix) == 0; ++it) {
+        out.push_back(*it);
+    }
+    return out;
+}
+
+std::vector<PathIndex::Hit> PathIndex::hits() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshIfStale();
+    std::vector<Hit> out;
+    for (const auto& pair : hits_) {
+        auto it = commands_.find(pair.first);
+        out.push_back({pair.first, pair.second, it != commands_.end() ? it->second : std::string()});
+    }
+    std::sort(out.begin(), out.end(), [](const Hit& a, const Hit& b) { return a.name < b.name; });
+    return out;
+}
+
+void PathIndex::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    built_ = false;
+    dirs_.clear();
+    commands_.clear();
+    names_.clear();
+    hits_.clear();
+}
+
+size_t PathIndex::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshIfStale();
+    return names_.size();
+}
+
+} // namespace termidash
@@ -3,16 +3,117 @@
 #include "core/InputHandler.hpp"
 #include "core/ExecContext.hpp"
 #include "core/MemStream.hpp"
+#include "core/FdStream.hpp"
 #include "core/RingBuffer.hpp"
+#include "core/VariableManager.hpp"
+#include "core/WorkerPool.hpp"
+#include "core/TrimFilter.hpp"
 #include "common/PlatformUtils.hpp"
 #include <iostream>
-#include <fstream>
-#include <thread>
 #include <memory>
-#include <cstdlib>
 
 namespace termidash {
 
+namespace {
+
+std::vector<platform::ChildStatus> lastStatus;
+
+std::vector<platform::ChildStatus> builtinStatus(const std::vector<int>& exitCodes) {
+    std::vector<platform::ChildStatus> statuses(exitCodes.size());
+    for (size_t i = 0; i < exitCodes.size(); ++i) statuses[i].exitCode = exitCodes[i];
+    return statuses;
+}
+
+// Handle a child's stdout goes to: its stderr under >&2, which the caller
+// still owns (or the shell's own), otherwise stdOut
+long childOutput(const PipelineExecutor::SegmentInfo& info, long stdOut, long stdErr) {
+    if (!info.outToErr) return stdOut;
+    return stdErr != -1 ? stdErr : PlatformUtils::standardError();
+}
+
+// File redirections of a builtin, opened as OS handles so the builtin can
+// reach them directly (see ExecContext), with buffered streams on top
+struct RedirectFiles {
+    long in = -1;
+    long out = -1;
+    long err = -1;
+    std::unique_ptr<FdInputStream> inStream;
+    std::unique_ptr<FdOutputStream> outStream;
+    std::unique_ptr<FdOutputStream> errStream;
+
+    ~RedirectFiles() {
+        // Flush the streams before their handles go away
+        inStream.reset();
+        outStream.reset();
+        errStream.reset();
+        PlatformUtils::closeFile(in);
+        PlatformUtils::closeFile(out);
+        PlatformUtils::closeFile(err);
+    }
+
+    // Opens every redirection the segment names. Reports and returns false
+    // at the first file that cannot be opened
+    bool open(const PipelineExecutor::SegmentInfo& info) {
+        if (!info.hasInputData && !info.inFile.empty()) {
+            in = PlatformUtils::openFileForRead(info.inFile);
+            if (in == -1) {
+                std::cerr << "Error: Cannot open input file: " << info.inFile << "\n";
+                return false;
+            }
+            inStream = std::make_unique<FdInputStream>(in);
+        }
+        if (!info.outFile.empty()) {
+            out = PlatformUtils::openFileForWrite(info.outFile, info.appendOut);
+            if (out == -1) {
+                std::cerr << "Error: Cannot open output file: " << info.outFile << "\n";
+                return false;
+            }
+            outStream = std::make_unique<FdOutputStream>(out);
+        }
+        if (!info.errFile.empty() && info.errFile != info.outFile) {
+            err = PlatformUtils::openFileForWrite(info.errFile, info.appendErr);
+            if (err == -1) {
+                std::cerr << "Error: Cannot open error file: " << info.errFile << "\n";
+                return false;
+            }
+            errStream = std::make_unique<FdOutputStream>(err);
+        }
+        return true;
+    }
+};
+
+// The `|>` stage of a pipeline with OS pipes: trims lines from one pipe
+// into the next and closes both, which passes EOF on
+void trimBetweenHandles(long in, long out) {
+    PlatformUtils::PipeSignalGuard pipeSignal; // runs on a shared worker thread
+    {
+        FdInputStream inStream(in);
+        FdOutputStream outStream(out);
+        ExecContext ctx(inStream, outStream, std::cerr);
+        ctx.inFd = in;
+        ctx.outFd = out;
+        TrimFilter::run(ctx);
+    }
+    PlatformUtils::closeFile(in);
+    PlatformUtils::closeFile(out);
+}
+
+} // namespace
+
+const std::vector<platform::ChildStatus>& PipelineExecutor::lastPipeStatus() {
+    return lastStatus;
+}
+
+void PipelineExecutor::recordStatus(std::vector<platform::ChildStatus> statuses) {
+    std::string codes;
+    for (const auto& status : statuses) {
+        if (!codes.empty()) codes += ' ';
+        codes += std::to_string(status.exitCode);
+    }
+    lastStatus = std::move(statuses);
+    VariableManager::instance().set("PIPESTATUS", codes);
+}
+
 std::string PipelineExecutor::readHereDoc(
     const std::string& delimiter,
     std::istream* inputSource,
@@ -34,95 +135,126 @@ std::string PipelineExecutor::readHereDoc(
             break;
         }
         if (Parser::trim(line) == delimiter) break;
-        content += line + "\n";
+        content.append(line).push_back('\n');
     }
     return content;
 }
 
+void PipelineExecutor::loadInputData(
+    SegmentInfo& info,
+    std::istream* inputSource,
+    platform::ITerminal* terminal
+) {
+    if (info.isHereDoc) {
+        info.inputData = readHereDoc(info.hereDocDelim, inputSource, terminal);
+        info.hasInputData = true;
+    } else if (info.isHereString) {
+        info.inputData = info.hereString;
+        info.inputData += '\n';
+        info.hasInputData = true;
+    }
+}
+
+PipelineExecutor::SegmentInfo PipelineExecutor::makeSegment(const Token* begin, const Token* end, bool trimBeforeNext, bool oneLine) {
+    return makeSegment(Parser::parseRedirection(begin, end, oneLine), trimBeforeNext);
+}
+
+PipelineExecutor::SegmentInfo PipelineExecutor::makeSegment(Parser::RedirectionInfo redirInfo, bool trimBeforeNext) {
+    SegmentInfo info;
+    info.cleanCmd = std::move(redirInfo.command);
+    info.inFile = std::move(redirInfo.inFile);
+    info.outFile = std::move(redirInfo.outFile);
+    info.errFile = std::move(redirInfo.errFile);
+    info.appendOut = redirInfo.appendOut;
+    info.appendErr = redirInfo.appendErr;
+    info.trimBeforeNext = trimBeforeNext;
+    info.hereDocDelim = std::move(redirInfo.hereDocDelim);
+    info.isHereDoc = redirInfo.isHereDoc;
+    info.hereString = std::move(redirInfo.hereString);
+    info.isHereString = redirInfo.isHereString;
+    info.errToOut = redirInfo.errToOut;
+    info.outToErr = redirInfo.outToErr;
+    info.args = std::move(redirInfo.args);
+    return info;
+}
+
 int PipelineExecutor::executeSingle(
     const std::string& commandLine,
     BuiltInCommandHandler& builtInHandler,
-    ICommandExecutor* executor,
+    ICommandExecutor* /*executor*/,
     platform::IProcessManager* processManager,
     std::istream* inputSource,
     platform::ITerminal* terminal
 ) {
-    std::string trimmed = Parser::trim(commandLine);
-    if (trimmed.empty())
+    std::vector<Token> tokens = Lexer::lex(commandLine);
+    if (tokens.empty())
         return 0;
 
-    auto redirInfo = Parser::parseRedirection(trimmed);
-    std::string cleanCmd = redirInfo.command;
-    std::string inFile = redirInfo.inFile;
-    std::string outFile = redirInfo.outFile;
-    std::string errFile = redirInfo.errFile;
-    bool appendOut = redirInfo.appendOut;
-    bool appendErr = redirInfo.appendErr;
-
-    // Handle here-document
-    if (redirInfo.isHereDoc) {
-        std::string tempFile = ".heredoc_" + std::to_string(std::rand());
-        std::ofstream tempOut(tempFile);
-        if (!tempOut.is_open()) {
-            std::cerr << "Error: Cannot create temporary file for here-document\n";
-            return 1;
-        }
-        std::string content = readHereDoc(redirInfo.hereDocDelim, inputSource, terminal);
-        tempOut << content;
-        tempOut.close();
-        inFile = tempFile;
-    }
+    SegmentInfo info = makeSegment(tokens.data(), tokens.data() + tokens.size(), false);
+    std::vector<platform::ChildStatus> statuses;
+    int code = runSegment(info, builtInHandler, processManager, inputSource, terminal, statuses);
+    if (statuses.empty()) statuses = builtinStatus({code});
+    recordStatus(std::move(statuses));
+    return code;
+}
+
+int PipelineExecutor::runSegment(
+    SegmentInfo& info,
+    BuiltInCommandHandler& builtInHandler,
+    platform::IProcessManager* processManager,
+    std::istream* inputSource,
+    platform::ITerminal* terminal,
+    std::vector<platform::ChildStatus>& statuses,
+    std::string* captureOut
+) {
+    const std::string& cleanCmd = info.cleanCmd;
+    const std::string& inFile = info.inFile;
+    const std::string& outFile = info.outFile;
+    const std::string& errFile = info.errFile;
+    bool appendOut = info.appendOut;
+    bool appendErr = info.appendErr;
+
+    loadInputData(info, inputSource, terminal);
 
-    // Get command name
-    std::string cmdName;
-    size_t spacePos = cleanCmd.find(' ');
-    if (spacePos != std::string::npos)
-        cmdName = cleanCmd.substr(0, spacePos);
-    else
-        cmdName = cleanCmd;
+    if (info.args.empty())
+        return 0;
+    const std::string& cmdName = info.args[0];
 
     // Check if it's a built-in command
     if (builtInHandler.isBuiltInCommand(cmdName)) {
-        std::ifstream inFileStream;
-        std::ofstream outFileStream;
-        std::ofstream errFileStream;
-        std::istream* inPtr = &std::cin;
+        RedirectFiles files;
+        if (!files.open(info)) return 1;
+        std::istream* inPtr = &shellInput();
         std::ostream* outPtr = &std::cout;
         std::ostream* errPtr = &std::cerr;
 
-        if (!inFile.empty()) {
-            inFileStream.open(inFile);
-            if (!inFileStream.is_open()) {
-                std::cerr << "Error: Cannot open input file: " << inFile << "\n";
-                return 1;
-            }
-            inPtr = &inFileStream;
+        MemoryInputStream dataStream(info.hasInputData ? std::move(info.inputData) : std::string());
+        if (info.hasInputData) inPtr = &dataStream;
+        else if (files.inStream) inPtr = files.inStream.get();
+        if (files.outStream) outPtr = files.outStream.get();
+        if (files.errStream) errPtr = files.errStream.get();
+        else if (!errFile.empty() && files.outStream) errPtr = outPtr;
+
+        if (info.outToErr) {
+            outPtr = errPtr;
+        } else if (errFile.empty() && info.errToOut) {
+            errPtr = outPtr;
         }
 
-        if (!outFile.empty()) {
-            outFileStream.open(outFile, appendOut ? std::ios::app : std::ios::out);
-            if (!outFileStream.is_open()) {
-                std::cerr << "Error: Cannot open output file: " << outFile << "\n";
-                return 1;
-            }
-            outPtr = &outFileStream;
-        }
-
-        if (!errFile.empty()) {
-            if (errFile == outFile && outPtr == &outFileStream) {
-                errPtr = outPtr;
-            } else {
-                errFileStream.open(errFile, appendErr ? std::ios::app : std::ios::out);
-                if (!errFileStream.is_open()) {
-                    std::cerr << "Error: Cannot open error file: " << errFile << "\n";
-                    return 1;
-                }
-                errPtr = &errFileStream;
-            }
+        // Command substitution: collect output in memory, no process needed
+        MemoryOutputStream captureStream;
+        if (captureOut && outFile.empty() && !info.outToErr) {
+            outPtr = &captureStream;
+            if (info.errToOut && errFile.empty()) errPtr = outPtr;
         }
 
         ExecContext ctx(*inPtr, *outPtr, *errPtr);
-        return builtInHandler.handleCommandWithContext(cleanCmd, ctx);
+        if (inPtr == files.inStream.get()) ctx.inFd = files.in;
+        else if (inPtr == &shellInput()) ctx.inFd = PlatformUtils::standardInput();
+        if (outPtr == files.outStream.get()) ctx.outFd = files.out;
+        int code = builtInHandler.handleCommandWithContext(cleanCmd, info.args, ctx);
+        if (outPtr == &captureStream) *captureOut += captureStream.str();
+        return code;
     }
 
     // External command
@@ -130,7 +262,13 @@ int PipelineExecutor::executeSingle(
     long stdOut = -1;
     long stdErr = -1;
 
-    if (!inFile.empty()) {
+    if (info.hasInputData) {
+        stdIn = PlatformUtils::openMemoryForRead(info.inputData);
+        if (stdIn == -1) {
+            std::cerr << "Error: Cannot create here-document input\n";
+            return 1;
+        }
+    } else if (!inFile.empty()) {
         stdIn = PlatformUtils::openFileForRead(inFile);
         if (stdIn == -1) {
             std::cerr << "Error: Cannot open input file: " << inFile << "\n";
@@ -161,36 +299,49 @@ int PipelineExecutor::executeSingle(
         }
     }
 
-    // Parse command args
-    auto tokens = Parser::tokenize(cleanCmd);
-    if (tokens.empty()) {
-        if (stdIn != -1) PlatformUtils::closeFile(stdIn);
-        if (stdOut != -1) PlatformUtils::closeFile(stdOut);
-        if (stdErr != -1 && stdErr != stdOut) PlatformUtils::closeFile(stdErr);
-        return 0;
+    // Command substitution: read the command's output through a pipe
+    long captureRead = -1;
+    if (captureOut && outFile.empty()) {
+        if (!processManager->createPipe(captureRead, stdOut)) {
+            std::cerr << "Failed to create pipe: " << processManager->getLastError() << "\n";
+            if (stdIn != -1) PlatformUtils::closeFile(stdIn);
+            if (stdErr != -1) PlatformUtils::closeFile(stdErr);
+            return 1;
+        }
     }
 
-    std::string cmd = tokens[0];
-    std::vector<std::string> args;
-    if (tokens.size() > 1) args.assign(tokens.begin() + 1, tokens.end());
+    if (errFile.empty() && info.errToOut && !info.outToErr) {
+        stdErr = stdOut;
+    }
+
+    const std::string& cmd = info.args[0];
+    std::vector<std::string> args(info.args.begin() + 1, info.args.end());
 
-    long pid = processManager->spawn(cmd, args, false, stdIn, stdOut, stdErr);
+    long pid = processManager->spawn(cmd, args, false, stdIn, childOutput(info, stdOut, stdErr), stdErr);
 
     if (stdIn != -1) PlatformUtils::closeFile(stdIn);
     if (stdOut != -1) PlatformUtils::closeFile(stdOut);
     if (stdErr != -1 && stdErr != stdOut) PlatformUtils::closeFile(stdErr);
 
+    if (captureRead != -1) {
+        if (pid != -1) PlatformUtils::readAll(captureRead, *captureOut);
+        processManager->closeHandle(captureRead);
+    }
+
     if (pid == -1) {
         std::cerr << "Error: Failed to spawn: " << cmd << " Error: " << processManager->getLastError() << "\n";
         return 1;
     }
 
-    return processManager->wait(pid);
+    statuses = processManager->waitAll({pid});
+    return statuses[0].exitCode;
 }
 
 int PipelineExecutor::executeBuiltInPipeline(
     const std::vector<SegmentInfo>& segments,
-    BuiltInCommandHandler& builtInHandler
+    BuiltInCommandHandler& builtInHandler,
+    std::vector<platform::ChildStatus>& statuses,
+    std::string* captureOut
 ) {
     size_t n = segments.size();
     std::vector<std::shared_ptr<termidash::StreamBridge>> bridges;
@@ -198,87 +349,176 @@ int PipelineExecutor::executeBuiltInPipeline(
         bridges.push_back(std::make_shared<termidash::StreamBridge>());
     }
 
-    std::vector<std::thread> threads;
-    threads.reserve(n);
+    TaskGroup stages;
+
+    // `|>`: the stage writes into its own bridge and a trim task moves the
+    // trimmed lines on to the bridge the next stage reads
+    std::vector<std::shared_ptr<termidash::StreamBridge>> outBridges = bridges;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        if (!segments[i].trimBeforeNext) continue;
+        auto untrimmed = std::make_shared<termidash::StreamBridge>();
+        auto trimmed = bridges[i];
+        outBridges[i] = untrimmed;
+        stages.run([untrimmed, trimmed]() {
+            ExecContext ctx(untrimmed->in(), trimmed->out(), std::cerr);
+            ctx.cancel = trimmed->buffer()->readerClosedFlag();
+            TrimFilter::run(ctx);
+            untrimmed->closeReader();
+            trimmed->closeWriter();
+        });
+    }
     std::vector<int> exitCodes(n, 0);
+    MemoryOutputStream captureStream;
+    std::ostream* finalOut = captureOut ? static_cast<std::ostream*>(&captureStream) : &std::cout;
 
     for (size_t i = 0; i < n; ++i) {
         SegmentInfo info = segments[i];
         std::shared_ptr<termidash::StreamBridge> prevBridge = (i > 0) ? bridges[i - 1] : nullptr;
-        std::shared_ptr<termidash::StreamBridge> nextBridge = (i < n - 1) ? bridges[i] : nullptr;
+        std::shared_ptr<termidash::StreamBridge> nextBridge = (i < n - 1) ? outBridges[i] : nullptr;
 
-        std::thread th([info, prevBridge, nextBridge, &builtInHandler, &exitCodes, i]() {
-            std::ifstream inFileStream;
-            std::ofstream outFileStream;
-            std::ofstream errFileStream;
+        stages.run([info, prevBridge, nextBridge, finalOut, &builtInHandler, &exitCodes, i]() {
+            RedirectFiles files;
+            bool opened = files.open(info);
             std::istream* inPtr = nullptr;
             std::ostream* outPtr = nullptr;
             std::ostream* errPtr = &std::cerr;
 
-            if (!info.inFile.empty()) {
-                inFileStream.open(info.inFile);
-                if (inFileStream.is_open()) inPtr = &inFileStream;
-                else std::cerr << "Error: Cannot open input file: " << info.inFile << "\n";
+            MemoryInputStream dataStream(info.inputData);
+            if (info.hasInputData) {
+                inPtr = &dataStream;
+            } else if (!info.inFile.empty()) {
+                inPtr = files.inStream.get();
             } else if (prevBridge) {
                 inPtr = &prevBridge->in();
             } else {
-                inPtr = &std::cin;
+                inPtr = &shellInput();
             }
 
             if (!info.outFile.empty()) {
-                outFileStream.open(info.outFile, info.appendOut ? std::ios::app : std::ios::out);
-                if (outFileStream.is_open()) outPtr = &outFileStream;
-                else std::cerr << "Error: Cannot open output file: " << info.outFile << "\n";
+                outPtr = files.outStream.get();
             } else if (nextBridge) {
                 outPtr = &nextBridge->out();
             } else {
-                outPtr = &std::cout;
+                outPtr = finalOut;
             }
 
-            if (!info.errFile.empty()) {
-                if (info.errFile == info.outFile && outPtr == &outFileStream) {
-                    errPtr = outPtr;
-                } else {
-                    errFileStream.open(info.errFile, info.appendErr ? std::ios::app : std::ios::out);
-                    if (errFileStream.is_open()) errPtr = &errFileStream;
-                    else std::cerr << "Error: Cannot open error file: " << info.errFile << "\n";
-                }
+            if (files.errStream) {
+                errPtr = files.errStream.get();
+            } else if (!info.errFile.empty() && files.outStream) {
+                errPtr = outPtr;
             }
 
-            if (inPtr && outPtr) {
+            if (info.outToErr) {
+                outPtr = errPtr;
+            } else if (info.errFile.empty() && info.errToOut && outPtr) {
+                errPtr = outPtr;
+            }
+
+            // Output nobody reads must not fill the previous bridge
+            if (prevBridge && inPtr != &prevBridge->in()) prevBridge->closeReader();
+
+            if (opened && inPtr && outPtr) {
                 ExecContext ctx(*inPtr, *outPtr, *errPtr);
-                exitCodes[i] = builtInHandler.handleCommandWithContext(info.cleanCmd, ctx);
+                if (inPtr == files.inStream.get()) ctx.inFd = files.in;
+                else if (inPtr == &shellInput()) ctx.inFd = PlatformUtils::standardInput();
+                if (outPtr == files.outStream.get()) ctx.outFd = files.out;
+                if (nextBridge && outPtr == &nextBridge->out()) ctx.cancel = nextBridge->buffer()->readerClosedFlag();
+                exitCodes[i] = builtInHandler.handleCommandWithContext(info.cleanCmd, info.args, ctx);
             }
 
+            // Unblock the previous stage if it is still writing, then signal EOF
+            if (prevBridge) prevBridge->closeReader();
             if (nextBridge) nextBridge->closeWriter();
         });
-        threads.push_back(std::move(th));
-    }
-
-    for (auto& th : threads) {
-        if (th.joinable()) th.join();
     }
+    stages.wait();
 
+    if (captureOut) *captureOut += captureStream.str();
+    statuses = builtinStatus(exitCodes);
     return exitCodes.back();
 }
 
+int PipelineExecutor::runBuiltInStage(
+    const SegmentInfo& info,
+    BuiltInCommandHandler& builtInHandler,
+    long stdIn,
+    long stdOut,
+    long stdErr
+) {
+    // The next stage may exit first: a write must fail, not kill the shell.
+    // This is a shared worker thread, so the mask is restored afterwards
+    PlatformUtils::PipeSignalGuard pipeSignal;
+
+    std::unique_ptr<FdInputStream> inStream;
+    std::unique_ptr<FdOutputStream> outStream;
+    std::unique_ptr<FdOutputStream> errStream;
+    std::istream* inPtr = &shellInput();
+    std::ostream* outPtr = &std::cout;
+    std::ostream* errPtr = &std::cerr;
+
+    if (stdIn != -1) {
+        inStream = std::make_unique<FdInputStream>(stdIn);
+        inPtr = inStream.get();
+    }
+    if (stdOut != -1) {
+        outStream = std::make_unique<FdOutputStream>(stdOut);
+        outPtr = outStream.get();
+    }
+    if (stdErr != -1 && stdErr == stdOut) {
+        errPtr = outPtr;
+    } else if (stdErr != -1) {
+        errStream = std::make_unique<FdOutputStream>(stdErr);
+        errPtr = errStream.get();
+    }
+    if (info.outToErr) outPtr = errPtr;
+
+    ExecContext ctx(*inPtr, *outPtr, *errPtr);
+    ctx.inFd = inStream ? stdIn : PlatformUtils::standardInput();
+    if (outStream && outPtr == outStream.get()) ctx.outFd = stdOut;
+    int code = builtInHandler.handleCommandWithContext(info.cleanCmd, info.args, ctx);
+    outPtr->flush();
+    errPtr->flush();
+    return code;
+}
+
 int PipelineExecutor::executeExternalPipeline(
     const std::vector<SegmentInfo>& segments,
     BuiltInCommandHandler& builtInHandler,
-    platform::IProcessManager* processManager
+    platform::IProcessManager* processManager,
+    std::vector<platform::ChildStatus>& statuses,
+    std::string* captureOut
 ) {
     size_t n = segments.size();
     std::vector<long> pids;
+    std::vector<size_t> pidStages;
+    TaskGroup builtinStages;
+    statuses.assign(n, platform::ChildStatus());
     long prevRead = -1;
+    long captureRead = -1;
 
     for (size_t i = 0; i < n; ++i) {
         long nextRead = -1;
         long nextWrite = -1;
 
-        if (i < n - 1) {
+        // The last stage writes into a capture pipe for command substitution
+        bool capturing = i == n - 1 && captureOut && segments[i].outFile.empty();
+        if (i < n - 1 || capturing) {
             if (!processManager->createPipe(nextRead, nextWrite)) {
                 std::cerr << "Failed to create pipe: " << processManager->getLastError() << "\n";
-                return 1;
+                if (prevRead != -1) processManager->closeHandle(prevRead);
+                break;
+            }
+        }
+
+        // `|>`: a trim task on a second pipe sits between this stage and the next
+        long trimRead = -1;
+        if (segments[i].trimBeforeNext && nextRead != -1) {
+            long trimWrite = -1;
+            if (processManager->createPipe(trimRead, trimWrite)) {
+                builtinStages.run([nextRead, trimWrite]() { trimBetweenHandles(nextRead, trimWrite); });
+            } else {
+                std::cerr << "Failed to create pipe: " << processManager->getLastError() << "\n";
+                trimRead = -1;
             }
         }
 
@@ -286,7 +526,11 @@ int PipelineExecutor::executeExternalPipeline(
         long stdOut = -1;
         long stdErr = -1;
 
-        if (!segments[i].inFile.empty()) {
+        bool ownsIn = segments[i].hasInputData || !segments[i].inFile.empty();
+        if (segments[i].hasInputData) {
+            stdIn = PlatformUtils::openMemoryForRead(segments[i].inputData);
+            if (stdIn == -1) std::cerr << "Error: Cannot create here-document input\n";
+        } else if (!segments[i].inFile.empty()) {
             stdIn = PlatformUtils::openFileForRead(segments[i].inFile);
             if (stdIn == -1) std::cerr << "Error: Cannot open input file: " << segments[i].inFile << "\n";
         } else if (i > 0) {
@@ -296,7 +540,7 @@ int PipelineExecutor::executeExternalPipeline(
         if (!segments[i].outFile.empty()) {
             stdOut = PlatformUtils::openFileForWrite(segments[i].outFile, segments[i].appendOut);
             if (stdOut == -1) std::cerr << "Error: Cannot open output file: " << segments[i].outFile << "\n";
-        } else if (i < n - 1) {
+        } else if (nextWrite != -1) {
             stdOut = nextWrite;
         }
 
@@ -309,114 +553,227 @@ int PipelineExecutor::executeExternalPipeline(
             }
         }
 
-        auto tokens = Parser::tokenize(segments[i].cleanCmd);
-        if (tokens.empty()) {
-            if (stdIn != -1 && stdIn != prevRead) PlatformUtils::closeFile(stdIn);
-            if (stdOut != -1 && stdOut != nextWrite) PlatformUtils::closeFile(stdOut);
-            if (stdErr != -1 && stdErr != stdOut) PlatformUtils::closeFile(stdErr);
-            if (prevRead != -1) processManager->closeHandle(prevRead);
-            if (nextWrite != -1) processManager->closeHandle(nextWrite);
-            if (nextRead != -1) processManager->closeHandle(nextRead);
-            continue;
+        if (segments[i].errFile.empty() && segments[i].errToOut && !segments[i].outToErr) {
+            stdErr = stdOut;
         }
 
-        std::string cmd = tokens[0];
-        std::vector<std::string> args;
-        if (tokens.size() > 1) args.assign(tokens.begin() + 1, tokens.end());
+        // Builtin stages run on a worker thread against the pipe handles. The
+        // thread owns the stage's handles and closes them when it finishes,
+        // which is what delivers EOF to the next stage.
+        const auto& tokens = segments[i].args;
+        if (!tokens.empty() && builtInHandler.isBuiltInCommand(tokens[0])) {
+            if (prevRead != -1 && prevRead != stdIn) processManager->closeHandle(prevRead);
+            if (nextWrite != -1 && nextWrite != stdOut) processManager->closeHandle(nextWrite);
+            const SegmentInfo& segment = segments[i];
+            int& exitCode = statuses[i].exitCode;
+            builtinStages.run([&segment, &builtInHandler, &exitCode, stdIn, stdOut, stdErr]() {
+                exitCode = runBuiltInStage(segment, builtInHandler, stdIn, stdOut, stdErr);
+                if (stdIn != -1) PlatformUtils::closeFile(stdIn);
+                if (stdOut != -1) PlatformUtils::closeFile(stdOut);
+                if (stdErr != -1 && stdErr != stdOut) PlatformUtils::closeFile(stdErr);
+            });
+        } else {
+            // A stage that cannot run still passes EOF downstream, so the
+            // remaining stages run and every started stage is reaped
+            long pid = -1;
+            if (tokens.empty()) {
+                statuses[i].exitCode = 0;
+            } else {
+                std::string cmd = tokens[0];
+                std::vector<std::string> args;
+                if (tokens.size() > 1) args.assign(tokens.begin() + 1, tokens.end());
 
-        long pid = processManager->spawn(cmd, args, false, stdIn, stdOut, stdErr);
+                pid = processManager->spawn(cmd, args, false, stdIn, childOutput(segments[i], stdOut, stdErr), stdErr);
+                if (pid == -1) {
+                    std::cerr << "Failed to spawn: " << cmd << " Error: " << processManager->getLastError() << "\n";
+                }
+            }
 
-        if (!segments[i].inFile.empty() && stdIn != -1) PlatformUtils::closeFile(stdIn);
-        if (!segments[i].outFile.empty() && stdOut != -1) PlatformUtils::closeFile(stdOut);
-        if (!segments[i].errFile.empty() && stdErr != -1 && stdErr != stdOut) PlatformUtils::closeFile(stdErr);
+            if (ownsIn && stdIn != -1) PlatformUtils::closeFile(stdIn);
+            if (!segments[i].outFile.empty() && stdOut != -1) PlatformUtils::closeFile(stdOut);
+            if (!segments[i].errFile.empty() && stdErr != -1 && stdErr != stdOut) PlatformUtils::closeFile(stdErr);
+
+            if (pid != -1) {
+                pids.push_back(pid);
+                pidStages.push_back(i);
+            }
 
-        if (pid == -1) {
-            std::cerr << "Failed to spawn: " << cmd << " Error: " << processManager->getLastError() << "\n";
             if (prevRead != -1) processManager->closeHandle(prevRead);
             if (nextWrite != -1) processManager->closeHandle(nextWrite);
-            if (nextRead != -1) processManager->closeHandle(nextRead);
-            return 1;
         }
-        pids.push_back(pid);
-
-        if (prevRead != -1) processManager->closeHandle(prevRead);
-        if (nextWrite != -1) processManager->closeHandle(nextWrite);
+        prevRead = -1;
+        if (trimRead != -1) nextRead = trimRead;
 
-        prevRead = nextRead;
+        if (capturing) captureRead = nextRead;
+        else prevRead = nextRead;
     }
 
-    int lastExitCode = 0;
-    for (long pid : pids) {
-        int code = processManager->wait(pid);
-        if (pid == pids.back()) lastExitCode = code;
+    if (captureRead != -1) {
+        PlatformUtils::readAll(captureRead, *captureOut);
+        processManager->closeHandle(captureRead);
     }
 
-    return lastExitCode;
+    // Reap every stage as it exits, so an early stage cannot hold up the rest
+    std::vector<platform::ChildStatus> reaped = processManager->waitAll(pids);
+    for (size_t k = 0; k < reaped.size(); ++k) {
+        statuses[pidStages[k]] = reaped[k];
+    }
+    builtinStages.wait();
+    for (auto& status : statuses) {
+        if (status.exitCode == -1) status.exitCode = 1;
+    }
+    return statuses.back().exitCode;
 }
 
 int PipelineExecutor::execute(
     const std::string& pipelineLine,
     BuiltInCommandHandler& builtInHandler,
-    ICommandExecutor* executor,
+    ICommandExecutor* /*executor*/,
     platform::IProcessManager* processManager,
     std::istream* inputSource,
     platform::ITerminal* terminal
 ) {
-    auto rawSegments = Parser::splitPipelineOperators(pipelineLine);
-    if (rawSegments.empty())
-        return 0;
+    std::vector<Token> tokens = Lexer::lex(pipelineLine);
+    return executeSegments(Parser::splitPipeline(tokens), true, builtInHandler, processManager, inputSource, terminal);
+}
+
+int PipelineExecutor::execute(
+    const Token* begin,
+    const Token* end,
+    BuiltInCommandHandler& builtInHandler,
+    ICommandExecutor* /*executor*/,
+    platform::IProcessManager* processManager,
+    std::istream* inputSource,
+    platform::ITerminal* terminal
+) {
+    return executeSegments(Parser::splitPipeline(begin, end), false, builtInHandler, processManager, inputSource, terminal);
+}
 
+int PipelineExecutor::execute(
+    const ExpandedCommand& command,
+    BuiltInCommandHandler& builtInHandler,
+    platform::IProcessManager* processManager,
+    std::istream* inputSource,
+    platform::ITerminal* terminal
+) {
+    const std::vector<Token>& tokens = command.tokens();
     std::vector<SegmentInfo> segments;
-    bool allBuiltIn = true;
+    segments.reserve(command.stages().size());
+    for (const auto& stage : command.stages()) {
+        Parser::RedirectionInfo redirInfo;
+        for (uint32_t i = 0; i < stage.wordCount; ++i) {
+            std::string_view word = tokens[stage.firstWord + i].text;
+            if (i > 0) redirInfo.command += ' ';
+            redirInfo.command += word;
+            redirInfo.args.emplace_back(word);
+        }
+        for (uint32_t i = 0; i < stage.redirectCount; ++i) {
+            const ExpandedCommand::Redirect& redirect = command.redirects()[stage.firstRedirect + i];
+            Parser::applyRedirection(redirInfo, redirect.kind, std::string(command.target(redirect)));
+        }
+        segments.push_back(makeSegment(std::move(redirInfo), stage.trimAfter));
+    }
+    return runSegments(segments, builtInHandler, processManager, inputSource, terminal);
+}
 
+int PipelineExecutor::executeSegments(
+    const std::vector<Parser::TokenSegment>& rawSegments,
+    bool oneLine,
+    BuiltInCommandHandler& builtInHandler,
+    platform::IProcessManager* processManager,
+    std::istream* inputSource,
+    platform::ITerminal* terminal,
+    std::string* captureOut
+) {
+    std::vector<SegmentInfo> segments;
+    segments.reserve(rawSegments.size());
     for (const auto& raw : rawSegments) {
-        SegmentInfo info;
-        info.trimBeforeNext = raw.trimBeforeNext;
-        
-        auto redirInfo = Parser::parseRedirection(raw.cmd);
-        info.cleanCmd = redirInfo.command;
-        info.inFile = redirInfo.inFile;
-        info.outFile = redirInfo.outFile;
-        info.errFile = redirInfo.errFile;
-        info.appendOut = redirInfo.appendOut;
-        info.appendErr = redirInfo.appendErr;
-        info.hereDocDelim = redirInfo.hereDocDelim;
-        info.isHereDoc = redirInfo.isHereDoc;
-
-        // Handle here-document
-        if (info.isHereDoc) {
-            std::string tempFile = ".heredoc_" + std::to_string(std::rand());
-            std::ofstream tempOut(tempFile);
-            if (tempOut.is_open()) {
-                std::string content = readHereDoc(info.hereDocDelim, inputSource, terminal);
-                tempOut << content;
-                tempOut.close();
-                info.inFile = tempFile;
-            } else {
-                std::cerr << "Error: Cannot create temporary file for here-document\n";
-            }
-        }
+        segments.push_back(makeSegment(raw.begin, raw.end, raw.trimBeforeNext, oneLine));
+    }
+    return runSegments(segments, builtInHandler, processManager, inputSource, terminal, captureOut);
+}
 
-        segments.push_back(info);
+int PipelineExecutor::runSegments(
+    std::vector<SegmentInfo>& segments,
+    BuiltInCommandHandler& builtInHandler,
+    platform::IProcessManager* processManager,
+    std::istream* inputSource,
+    platform::ITerminal* terminal,
+    std::string* captureOut
+) {
+    if (segments.empty())
+        return 0;
+
+    std::vector<platform::ChildStatus> statuses;
+    int code;
+
+    if (segments.size() == 1) {
+        code = runSegment(segments[0], builtInHandler, processManager, inputSource, terminal, statuses, captureOut);
+        if (statuses.empty()) statuses = builtinStatus({code});
+        if (!captureOut) recordStatus(std::move(statuses));
+        return code;
+    }
+
+    bool allBuiltIn = true;
+    for (auto& info : segments) {
+        loadInputData(info, inputSource, terminal);
 
         // Check if command is built-in
-        std::string cmdName;
-        size_t spacePos = info.cleanCmd.find(' ');
-        if (spacePos != std::string::npos)
-            cmdName = info.cleanCmd.substr(0, spacePos);
-        else
-            cmdName = info.cleanCmd;
-
-        if (!builtInHandler.isBuiltInCommand(cmdName)) {
+        if (info.args.empty() || !builtInHandler.isBuiltInCommand(info.args[0])) {
             allBuiltIn = false;
         }
     }
 
     if (allBuiltIn) {
-        return executeBuiltInPipeline(segments, builtInHandler);
+        code = executeBuiltInPipeline(segments, builtInHandler, statuses, captureOut);
     } else {
-        return executeExternalPipeline(segments, builtInHandler, processManager);
+        code = executeExternalPipeline(segments, builtInHandler, processManager, statuses, captureOut);
+    }
+    if (!captureOut) recordStatus(std::move(statuses));
+    return code;
+}
+
+int PipelineExecutor::capture(
+    const Token* begin,
+    const Token* end,
+    BuiltInCommandHandler& builtInHandler,
+    platform::IProcessManager* processManager,
+    std::string& output
+) {
+    int status = 0;
+    TokenKind separator = TokenKind::Semicolon;
+    const Token* start = begin;
+
+    for (const Token* t = begin; ; ++t) {
+        bool atEnd = t == end;
+        if (!atEnd && t->kind != TokenKind::Semicolon && t->kind != TokenKind::AndIf && t->kind != TokenKind::OrIf)
+            continue;
+
+        bool skip = (separator == TokenKind::AndIf && status != 0) || (separator == TokenKind::OrIf && status == 0);
+        if (!skip && start != t) {
+            auto rawSegments = Parser::splitPipeline(start, t);
+            SegmentInfo first = makeSegment(rawSegments[0].begin, rawSegments[0].end, false, false);
+
+            if (rawSegments.size() == 1 && first.args.empty() && !first.inFile.empty() && first.outFile.empty()) {
+                // $(< file) reads the file directly
+                long handle = PlatformUtils::openFileForRead(first.inFile);
+                if (handle == -1) {
+                    std::cerr << "Error: Cannot open input file: " << first.inFile << "\n";
+                    status = 1;
+                } else {
+                    status = PlatformUtils::readAll(handle, output) ? 0 : 1;
+                    PlatformUtils::closeFile(handle);
+                }
+            } else {
+                status = executeSegments(rawSegments, false, builtInHandler, processManager, nullptr, nullptr, &output);
+            }
+        }
+
+        if (atEnd) break;
+        separator = t->kind;
+        start = t + 1;
     }
+    return status;
 }
 
 } // namespace termidash
@@ -0,0 +1,140 @@
+#include "core/ReadCommand.hpp"
+#include "core/VariableManager.hpp"
+
+namespace termidash {
+
+namespace {
+
+bool isIfsWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+// Remove backslash quoting, recording which characters it protected
+void unescape(std::string& text, std::vector<bool>& literal) {
+    if (text.find('\\') == std::string::npos) return;
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            literal.resize(out.size(), false);
+            out += text[++i];
+            literal.push_back(true);
+        } else if (text[i] != '\\') {
+            out += text[i];
+        }
+    }
+    literal.resize(out.size(), false);
+    text.swap(out);
+}
+
+// Even number of backslashes before the end: the last one is not quoted
+bool endsWithContinuation(const std::string& text) {
+    size_t count = 0;
+    for (size_t i = text.size(); i > 0 && text[i - 1] == '\\'; --i) ++count;
+    return count % 2 == 1;
+}
+
+} // namespace
+
+std::vector<std::string> ReadCommand::split(const std::string& text, const std::vector<bool>& literal,
+                                            const std::string& ifs, size_t count) {
+    auto isLiteral = [&](size_t i) { return i < literal.size() && literal[i]; };
+    auto isWhitespace = [&](size_t i) {
+        return !isLiteral(i) && isIfsWhitespace(text[i]) && ifs.find(text[i]) != std::string::npos;
+    };
+    auto isSeparator = [&](size_t i) { return !isLiteral(i) && ifs.find(text[i]) != std::string::npos; };
+
+    std::vector<std::string> fields;
+    size_t pos = 0;
+    size_t end = text.size();
+    while (pos < end && isWhitespace(pos)) ++pos;
+    while (end > pos && isWhitespace(end - 1)) --end;
+
+    while (pos < end) {
+        if (count > 0 && fields.size() + 1 == count) {
+            fields.push_back(text.substr(pos, end - pos));
+            return fields;
+        }
+        size_t start = pos;
+        while (pos < end && !isSeparator(pos)) ++pos;
+        fields.push_back(text.substr(start, pos - start));
+        // One separator: IFS whitespace around at most one other IFS character
+        while (pos < end && isWhitespace(pos)) ++pos;
+        if (pos < end && isSeparator(pos)) {
+            ++pos;
+            while (pos < end && isWhitespace(pos)) ++pos;
+        }
+    }
+    return fields;
+}
+
+int ReadCommand::run(const std::vector<std::string>& args, ExecContext& ctx) {
+    bool raw = false;
+    char delim = '\n';
+    std::string arrayName;
+    size_t arg = 1;
+    for (; arg < args.size() && args[arg].size() > 1 && args[arg][0] == '-'; ++arg) {
+        const std::string& option = args[arg];
+        if (option == "--") {
+            ++arg;
+            break;
+        }
+        if (option == "-r") {
+            raw = true;
+        } else if ((option == "-d" || option == "-a") && arg + 1 < args.size()) {
+            if (option == "-d") delim = args[arg + 1].empty() ? '\0' : args[arg + 1][0];
+            else arrayName = args[arg + 1];
+            ++arg;
+        } else {
+            ctx.err << "read: " << option << ": invalid option\n"
+                    << "usage: read [-r] [-d delim] [-a name] [name...]\n";
+            return 2;
+        }
+    }
+    std::vector<std::string> names(args.begin() + arg, args.end());
+    bool reply = names.empty() && arrayName.empty();
+
+    // getline scans the stream's buffer for the delimiter in bulk
+    std::string record;
+    bool complete = false;
+    while (true) {
+        std::string part;
+        if (!std::getline(ctx.in, part, delim)) break;
+        record += part;
+        complete = !ctx.in.eof();
+        if (raw || !complete || !endsWithContinuation(record)) break;
+        record.pop_back(); // backslash-delimiter joins the next part
+    }
+    // The shared shell input may get more data later (a terminal)
+    ctx.in.clear();
+    if (!complete && record.empty()) {
+        for (const auto& name : names) VariableManager::instance().set(name, "");
+        if (reply) VariableManager::instance().set("REPLY", "");
+        return 1;
+    }
+
+    std::vector<bool> literal;
+    if (!raw) unescape(record, literal);
+    auto& vars = VariableManager::instance();
+    std::string ifs = vars.has("IFS") ? vars.get("IFS") : " \t\n";
+
+    if (!arrayName.empty()) {
+        // No array variables: the fields are joined with single spaces,
+        // which unquoted expansion splits again
+        std::string joined;
+        for (const auto& field : split(record, literal, ifs, 0)) {
+            if (!joined.empty()) joined += ' ';
+            joined += field;
+        }
+        vars.set(arrayName, joined);
+    }
+    if (reply) {
+        vars.set("REPLY", record); // REPLY keeps the record unsplit
+    } else if (!names.empty()) {
+        std::vector<std::string> fields = split(record, literal, ifs, names.size());
+        for (size_t i = 0; i < names.size(); ++i) vars.set(names[i], i < fields.size() ? fields[i] : "");
+    }
+    return complete ? 0 : 1;
+}
+
+} // namespace termidash
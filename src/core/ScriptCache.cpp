@@ -0,0 +1,274 @@
+#include "core/ScriptCache.hpp"
+#include "core/BytecodeCompiler.hpp"
+#include "core/ScriptParser.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace termidash {
+
+namespace {
+
+constexpr char Magic[4] = {'T', 'D', 'B', 'C'};
+constexpr uint32_t FormatVersion = 1;
+constexpr uint32_t FlagStandalone = 1;
+
+// Fixed-size prefix of every cache entry and .tdc file
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t compilerRevision;
+    int64_t sourceMtime;
+    uint64_t sourceSize;
+    uint64_t sourceHash;
+};
+
+// Read-only mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file_ == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) return;
+        mapping_ = CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping_) return;
+        void* view = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (!view) return;
+        data_ = static_cast<const char*>(view);
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                data_ = static_cast<const char*>(addr);
+                size_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = NULL;
+#endif
+};
+
+bool readFile(const std::string& path, std::string& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str();
+    return true;
+}
+
+bool readHeader(const MappedFile& map, Header& header) {
+    if (!map.data() || map.size() < sizeof(Header)) return false;
+    std::memcpy(&header, map.data(), sizeof(Header));
+    return std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 && header.version == FormatVersion &&
+           header.compilerRevision == BytecodeCompiler::Revision;
+}
+
+std::shared_ptr<const bytecode::Chunk> decodeBody(const MappedFile& map) {
+    auto chunk = std::make_shared<bytecode::Chunk>();
+    if (!bytecode::deserialize(map.data() + sizeof(Header), map.size() - sizeof(Header), *chunk)) {
+        return nullptr;
+    }
+    return chunk;
+}
+
+std::string encode(const Header& header, const bytecode::Chunk& chunk) {
+    std::string out(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out += bytecode::serialize(chunk);
+    return out;
+}
+
+Header makeHeader(uint32_t flags, int64_t mtime, const std::string& source) {
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = FormatVersion;
+    header.flags = flags;
+    header.compilerRevision = BytecodeCompiler::Revision;
+    header.sourceMtime = mtime;
+    header.sourceSize = source.size();
+    header.sourceHash = ScriptCache::hash(source.data(), source.size());
+    return header;
+}
+
+// Write to a private temporary and rename it into place, so concurrent
+// shells never observe a partially written entry
+bool writeAtomically(const fs::path& target, const std::string& data) {
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+
+    std::ostringstream suffix;
+    suffix << ".tmp" << std::hash<std::thread::id>{}(std::this_thread::get_id())
+           << std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path temp = target;
+    temp += suffix.str();
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+bytecode::Chunk compileSource(const std::string& source) {
+    std::istringstream in(source);
+    return BytecodeCompiler::compile(ScriptParser::parse(in));
+}
+
+} // namespace
+
+ScriptCache::ScriptCache(std::string directory) : directory_(std::move(directory)) {}
+
+uint64_t ScriptCache::hash(const char* data, size_t size) {
+    uint64_t value = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+std::string ScriptCache::entryPath(const std::string& scriptPath) const {
+    std::error_code ec;
+    std::string key = fs::absolute(scriptPath, ec).lexically_normal().string();
+    if (ec) key = scriptPath;
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.tdc",
+                  static_cast<unsigned long long>(hash(key.data(), key.size())));
+    return (fs::path(directory_) / name).string();
+}
+
+std::shared_ptr<const bytecode::Chunk> ScriptCache::load(const std::string& scriptPath) {
+    lastHit_ = false;
+
+    std::error_code ec;
+    auto mtime = fs::last_write_time(scriptPath, ec);
+    std::string source;
+    if (ec || !readFile(scriptPath, source)) {
+        return nullptr;
+    }
+    Header expected = makeHeader(0, static_cast<int64_t>(mtime.time_since_epoch().count()), source);
+
+    std::string entry;
+    if (!directory_.empty()) {
+        entry = entryPath(scriptPath);
+        MappedFile map(entry);
+        Header stored;
+        if (readHeader(map, stored) && stored.flags == 0 &&
+            stored.sourceMtime == expected.sourceMtime &&
+            stored.sourceSize == expected.sourceSize &&
+            stored.sourceHash == expected.sourceHash) {
+            if (auto chunk = decodeBody(map)) {
+                lastHit_ = true;
+                return chunk;
+            }
+        }
+    }
+
+    auto chunk = std::make_shared<const bytecode::Chunk>(compileSource(source));
+    if (!entry.empty()) {
+        // A read-only or full cache directory only costs the next launch a recompile
+        writeAtomically(entry, encode(expected, *chunk));
+    }
+    return chunk;
+}
+
+bool ScriptCache::compileFile(const std::string& scriptPath, const std::string& outputPath) {
+    std::string source;
+    if (!readFile(scriptPath, source)) {
+        std::cerr << "Failed to open script: " << scriptPath << "\n";
+        return false;
+    }
+
+    bytecode::Chunk chunk = compileSource(source);
+    if (!writeAtomically(fs::path(outputPath), encode(makeHeader(FlagStandalone, 0, source), chunk))) {
+        std::cerr << "Failed to write compiled script: " << outputPath << "\n";
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const bytecode::Chunk> ScriptCache::loadCompiled(const std::string& path) {
+    MappedFile map(path);
+    if (!map.data()) {
+        std::cerr << "Failed to open script: " << path << "\n";
+        return nullptr;
+    }
+
+    Header header;
+    std::shared_ptr<const bytecode::Chunk> chunk;
+    if (readHeader(map, header) && (header.flags & FlagStandalone)) {
+        chunk = decodeBody(map);
+    }
+    if (!chunk) {
+        std::cerr << "Invalid compiled script: " << path << "\n";
+    }
+    return chunk;
+}
+
+bool ScriptCache::isCompiledPath(const std::string& path) {
+    return fs::path(path).extension() == ".tdc";
+}
+
+} // namespace termidash
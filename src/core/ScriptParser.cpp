@@ -0,0 +1,228 @@
+#include "core/ScriptParser.hpp"
+#include "core/Parser.hpp"
+#include <iostream>
+
+namespace termidash {
+
+// Cheap pre-check so ordinary statements are not lexed a second time
+static bool mayHaveHereDoc(const std::string& cmd) {
+    return cmd.find("<<") != std::string::npos;
+}
+
+// Lex a command or condition once into its stages, words and redirections
+static ast::Pipeline parseCommand(const std::string& cmd) {
+    std::vector<Token> tokens = Lexer::lex(cmd);
+    return Parser::parsePipeline(tokens.data(), tokens.data() + tokens.size());
+}
+
+bool ScriptParser::needsMoreInput() const {
+    return !blocks_.empty() || inHereDoc();
+}
+
+bool ScriptParser::inHereDoc() const {
+    return !hereDocDelims_.empty();
+}
+
+ast::NodeList& ScriptParser::currentList(ast::NodeList& out) {
+    if (blocks_.empty()) return out;
+    OpenBlock& top = blocks_.back();
+    return top.inElse ? top.node.elseBody : top.node.body;
+}
+
+void ScriptParser::recordSource(const std::string& cmd) {
+    // Every open function keeps its raw body text for FunctionManager
+    for (auto& block : blocks_) {
+        if (block.node.kind == ast::NodeKind::Function) {
+            block.node.source.push_back(cmd);
+        }
+    }
+}
+
+void ScriptParser::feed(const std::string& line, ast::NodeList& out) {
+    if (inHereDoc()) {
+        size_t current = hereDocBodies_.size() - 1;
+        if (Parser::trim(line) == hereDocDelims_[current]) {
+            if (hereDocBodies_.size() < hereDocDelims_.size()) {
+                hereDocBodies_.emplace_back();
+                return;
+            }
+            auto statements = std::move(heldStatements_);
+            heldStatements_.clear();
+            hereDocDelims_.clear();
+            processLine(statements, out);
+            hereDocBodies_.clear();
+        } else {
+            hereDocBodies_[current] += line;
+            hereDocBodies_[current] += '\n';
+        }
+        return;
+    }
+
+    std::string trimmed = Parser::trim(line);
+    if (trimmed.empty() || trimmed[0] == '#')
+        return;
+
+    auto statements = Parser::splitBatch(line);
+
+    // Here-document bodies follow the line, so hold it until they are read
+    for (const auto& statement : statements) {
+        if (!mayHaveHereDoc(statement.first)) continue;
+        auto redir = Parser::parseRedirection(statement.first);
+        if (redir.isHereDoc) {
+            hereDocDelims_.push_back(redir.hereDocDelim);
+        }
+    }
+    if (!hereDocDelims_.empty()) {
+        heldStatements_ = std::move(statements);
+        hereDocBodies_.assign(1, std::string());
+        return;
+    }
+
+    processLine(statements, out);
+}
+
+void ScriptParser::processLine(const std::vector<std::pair<std::string, std::string>>& statements, ast::NodeList& out) {
+    size_t hereDocIndex = 0;
+    for (const auto& statement : statements) {
+        const std::string& cmd = statement.first;
+        if (cmd.empty())
+            continue;
+
+        std::string* hereDoc = nullptr;
+        if (mayHaveHereDoc(cmd) && Parser::parseRedirection(cmd).isHereDoc) {
+            if (hereDocIndex < hereDocBodies_.size()) {
+                hereDoc = &hereDocBodies_[hereDocIndex];
+            }
+            ++hereDocIndex;
+        }
+        addStatement(cmd, statement.second, hereDoc, out);
+    }
+}
+
+void ScriptParser::addStatement(const std::string& cmd, const std::string& sep, std::string* hereDoc, ast::NodeList& out) {
+    // Function definition: "function name [{]" or "name() {"
+    bool isFunction = false;
+    std::string funcName;
+    if (cmd.rfind("function ", 0) == 0) {
+        funcName = Parser::trim(cmd.substr(9));
+        size_t bracePos = funcName.find('{');
+        if (bracePos != std::string::npos) {
+            funcName = Parser::trim(funcName.substr(0, bracePos));
+        }
+        isFunction = true;
+    } else {
+        size_t parenPos = cmd.find("()");
+        if (parenPos != std::string::npos && cmd.find('{') != std::string::npos) {
+            funcName = Parser::trim(cmd.substr(0, parenPos));
+            isFunction = true;
+        }
+    }
+
+    if (isFunction) {
+        recordSource(cmd);
+        OpenBlock block;
+        block.node.kind = ast::NodeKind::Function;
+        block.node.text = funcName;
+        blocks_.push_back(std::move(block));
+        return;
+    }
+
+    if (cmd.rfind("if ", 0) == 0 || cmd.rfind("while ", 0) == 0 || cmd.rfind("for ", 0) == 0) {
+        recordSource(cmd);
+        OpenBlock block;
+        if (cmd[0] == 'i') {
+            block.node.kind = ast::NodeKind::If;
+            block.node.text = cmd.substr(3);
+            block.node.pipeline = parseCommand(block.node.text);
+        } else if (cmd[0] == 'w') {
+            block.node.kind = ast::NodeKind::While;
+            block.node.text = cmd.substr(6);
+            block.node.pipeline = parseCommand(block.node.text);
+        } else {
+            // for var in item1 item2 ...
+            block.node.kind = ast::NodeKind::For;
+            std::string rest = cmd.substr(4);
+            size_t inPos = rest.find(" in ");
+            if (inPos != std::string::npos) {
+                block.node.loopVar = Parser::trim(rest.substr(0, inPos));
+                for (const Token& token : Lexer::lex(std::string_view(rest).substr(inPos + 4))) {
+                    block.node.items.emplace_back(token.text);
+                }
+            }
+        }
+        blocks_.push_back(std::move(block));
+        return;
+    }
+
+    if (cmd == "else") {
+        if (!blocks_.empty() && blocks_.back().node.kind == ast::NodeKind::If) {
+            recordSource(cmd);
+            blocks_.back().inElse = true;
+        } else {
+            std::cerr << "Error: else without if\n";
+        }
+        return;
+    }
+
+    if (cmd == "end" || cmd == "}") {
+        if (blocks_.empty()) {
+            if (cmd == "end") std::cerr << "Error: end without block\n";
+            return;
+        }
+        ast::Node node = std::move(blocks_.back().node);
+        blocks_.pop_back();
+        recordSource(cmd);
+        node.separator = sep;
+        currentList(out).push_back(std::move(node));
+        return;
+    }
+
+    recordSource(cmd);
+    ast::Node node;
+    node.kind = ast::NodeKind::Command;
+    node.text = cmd;
+    node.pipeline = parseCommand(cmd);
+    node.separator = sep;
+    if (hereDoc) {
+        node.hasHereDoc = true;
+        node.hereDoc = std::move(*hereDoc);
+    }
+    currentList(out).push_back(std::move(node));
+}
+
+void ScriptParser::finish(ast::NodeList& out) {
+    if (inHereDoc()) {
+        auto statements = std::move(heldStatements_);
+        heldStatements_.clear();
+        hereDocDelims_.clear();
+        processLine(statements, out);
+        hereDocBodies_.clear();
+    }
+    if (!blocks_.empty()) {
+        std::cerr << "Error: missing end for open block\n";
+        blocks_.clear();
+    }
+}
+
+ast::NodeList ScriptParser::parse(std::istream& in) {
+    ScriptParser parser;
+    ast::NodeList out;
+    std::string line;
+    while (std::getline(in, line)) {
+        parser.feed(line, out);
+    }
+    parser.finish(out);
+    return out;
+}
+
+ast::NodeList ScriptParser::parse(const std::vector<std::string>& lines) {
+    ScriptParser parser;
+    ast::NodeList out;
+    for (const auto& line : lines) {
+        parser.feed(line, out);
+    }
+    parser.finish(out);
+    return out;
+}
+
+} // namespace termidash
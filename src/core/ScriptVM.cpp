@@ -0,0 +1,162 @@
+#include "core/ScriptVM.hpp"
+#include "core/BytecodeCompiler.hpp"
+#include "core/FunctionManager.hpp"
+#include "core/ScriptParser.hpp"
+#include "core/VariableManager.hpp"
+#include "core/WordExpander.hpp"
+#include <iostream>
+
+namespace termidash {
+
+using bytecode::OpCode;
+using bytecode::NoOperand;
+
+std::shared_ptr<const bytecode::Chunk> ScriptVM::functionBody(const std::string& name) {
+    auto& functions = FunctionManager::instance();
+    auto body = functions.getCompiled(name);
+    if (!body) {
+        // Defined from source lines only: compile once and cache
+        std::vector<std::string> source = functions.getBody(name);
+        body = std::make_shared<const bytecode::Chunk>(BytecodeCompiler::compile(ScriptParser::parse(source)));
+        functions.define(name, source, body);
+    }
+    return body;
+}
+
+int ScriptVM::run(const bytecode::Chunk& chunk) {
+    std::vector<Frame> frames;
+    std::vector<Loop> loops;
+    frames.push_back({&chunk, nullptr, 0, 0});
+
+    ExpandedCommand reg;
+    int status = 0;
+
+    while (true) {
+        Frame& frame = frames.back();
+        const bytecode::Instruction& ins = frame.chunk->code[frame.pc++];
+        ++profile_.instructions;
+        ++profile_.opCounts[static_cast<size_t>(ins.op)];
+
+        switch (ins.op) {
+        case OpCode::Stage:
+            host_.expand(frame.chunk->stages[ins.a], reg, ins.b != 1);
+            break;
+
+        case OpCode::Call: {
+            // The function name and arguments are the words of the first stage
+            if (reg.stages().empty() || reg.stages()[0].wordCount == 0)
+                break;
+            const ExpandedCommand::Stage& stage = reg.stages()[0];
+            const auto& args = reg.tokens();
+            std::string name(args[stage.firstWord].text);
+            if (!FunctionManager::instance().has(name))
+                break;
+
+            auto body = functionBody(name);
+            VariableManager::instance().pushScope();
+            for (uint32_t i = 1; i < stage.wordCount; ++i) {
+                VariableManager::instance().set(std::to_string(i), std::string(args[stage.firstWord + i].text));
+            }
+            reg.clear();
+            ++profile_.functionCalls;
+            frame.pc = ins.a;
+            frames.push_back({body.get(), body, 0, loops.size()});
+            break;
+        }
+
+        case OpCode::Exec:
+            ++profile_.commands;
+            status = host_.execute(reg, ins.a == NoOperand ? nullptr : &frame.chunk->strings[ins.a], ins.b == 1);
+            reg.clear();
+            break;
+
+        case OpCode::Run:
+            ++profile_.commands;
+            status = host_.run(reg);
+            reg.clear();
+            break;
+
+        case OpCode::Jump:
+            frame.pc = ins.a;
+            break;
+
+        case OpCode::JumpIfFail:
+            if (status != 0) frame.pc = ins.a;
+            break;
+
+        case OpCode::JumpIfOk:
+            if (status == 0) frame.pc = ins.a;
+            break;
+
+        case OpCode::SetStatus:
+            status = static_cast<int>(ins.a);
+            break;
+
+        case OpCode::LoopInit:
+            loops.emplace_back();
+            break;
+
+        case OpCode::LoopNext: {
+            Loop& loop = loops.back();
+            if (loop.started) loop.status = status;
+            loop.started = true;
+            if (maxWhileIterations_ != 0 && loop.iterations == maxWhileIterations_) {
+                std::cerr << "while: loop stopped after " << maxWhileIterations_ << " iterations\n";
+                frame.pc = ins.a;
+                break;
+            }
+            ++loop.iterations;
+            break;
+        }
+
+        case OpCode::ForInit: {
+            Loop loop;
+            loop.items = reg.words();
+            reg.clear();
+            loops.push_back(std::move(loop));
+            break;
+        }
+
+        case OpCode::ForNext: {
+            Loop& loop = loops.back();
+            if (loop.started) loop.status = status;
+            loop.started = true;
+            if (loop.next < loop.items.size()) {
+                VariableManager::instance().set(frame.chunk->strings[ins.a], loop.items[loop.next++]);
+            } else {
+                frame.pc = ins.b;
+            }
+            break;
+        }
+
+        case OpCode::EndLoop:
+            status = loops.back().status;
+            loops.pop_back();
+            break;
+
+        case OpCode::Define: {
+            const bytecode::FunctionDef& def = frame.chunk->functions[ins.a];
+            std::vector<std::string> source;
+            source.reserve(def.source.size());
+            for (uint32_t index : def.source) {
+                source.push_back(frame.chunk->strings[index]);
+            }
+            FunctionManager::instance().define(frame.chunk->strings[def.name], source, def.body);
+            status = 0;
+            break;
+        }
+
+        case OpCode::Halt:
+            if (frames.size() == 1) {
+                return status;
+            }
+            // Return from a shell function
+            loops.resize(frame.loopBase);
+            frames.pop_back();
+            VariableManager::instance().popScope();
+            break;
+        }
+    }
+}
+
+} // namespace termidash
@@ -0,0 +1,749 @@
+#include "core/SortCommand.hpp"
+#include "core/BlockReader.hpp"
+#include "core/WorkerPool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace termidash {
+
+namespace {
+
+const size_t defaultBudget = 256 * 1024 * 1024;
+const size_t mergeFanIn = 16;
+const size_t outputBlock = 256 * 1024;
+// Chunks smaller than this are sorted on the calling thread only
+const size_t minPieceRecords = 16 * 1024;
+
+struct Key {
+    size_t startField = 1;
+    size_t startChar = 0; // 0: start of the field
+    size_t endField = 0;  // 0: end of the line
+    size_t endChar = 0;   // 0: end of the field
+    bool blanks = false;
+    bool numeric = false;
+    bool reverse = false;
+    bool hasOptions = false;
+};
+
+struct Options {
+    std::vector<Key> keys;
+    int separator = -1; // -t; -1 means runs of blanks
+    bool blanks = false;
+    bool numeric = false;
+    bool reverse = false;
+    bool unique = false;
+    size_t budget = defaultBudget;
+    size_t threads = 1;
+    std::string tempDir;
+};
+
+// A line in an arena. The key range is that of the first key, relative to
+// the line. prefix orders most pairs without touching the arena: the key's
+// first 8 bytes big-endian, or for -n its value as an ordered double, which
+// can only tie numbers that are really different, never reorder them
+struct Record {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t keyBegin;
+    uint32_t keyEnd;
+    uint64_t prefix;
+};
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+int compareBytes(const char* a, size_t aLength, const char* b, size_t bLength) {
+    int diff = std::memcmp(a, b, std::min(aLength, bLength));
+    if (diff != 0) return diff;
+    return aLength < bLength ? -1 : aLength > bLength ? 1 : 0;
+}
+
+uint64_t keyPrefix(const char* key, size_t length) {
+    uint64_t prefix = 0;
+    size_t n = std::min<size_t>(length, 8);
+    for (size_t i = 0; i < 8; ++i) {
+        prefix = (prefix << 8) | (i < n ? static_cast<unsigned char>(key[i]) : 0u);
+    }
+    return prefix;
+}
+
+// The number at the start of a key as a double whose bits compare as
+// unsigned integers in numeric order. Keeping only the leading significant
+// digits and rounding are both monotonic, so two different numbers may tie
+// but are never inverted
+uint64_t numberPrefix(const char* p, const char* end) {
+    const size_t maxDigits = 20;
+    char text[maxDigits + 32] = "-0.";
+    bool negative = false;
+    p = skipBlanks(p, end);
+    if (p < end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+    while (p < end && *p == '0') ++p;
+    long exponent = 0;
+    size_t n = 3;
+    for (; p < end && std::isdigit(static_cast<unsigned char>(*p)); ++p, ++exponent) {
+        if (n < 3 + maxDigits) text[n++] = *p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        if (exponent == 0) {
+            for (; p < end && *p == '0'; ++p) --exponent;
+        }
+        for (; p < end && std::isdigit(static_cast<unsigned char>(*p)) && n < 3 + maxDigits; ++p) text[n++] = *p;
+    }
+    double value = 0;
+    if (n > 3) {
+        std::snprintf(text + n, sizeof(text) - n, "e%ld", exponent);
+        value = std::strtod(negative ? text : text + 1, nullptr);
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+class Comparator {
+public:
+    explicit Comparator(const Options& options) : options_(options) {}
+
+    Record make(const char* base, uint64_t offset, size_t length) const {
+        const char* line = base + offset;
+        const char* begin;
+        const char* end;
+        keyRange(options_.keys.front(), line, line + length, begin, end);
+        Record record;
+        record.offset = offset;
+        record.length = static_cast<uint32_t>(length);
+        record.keyBegin = static_cast<uint32_t>(begin - line);
+        record.keyEnd = static_cast<uint32_t>(end - line);
+        record.prefix = options_.keys.front().numeric ? numberPrefix(begin, end)
+                                                      : keyPrefix(begin, static_cast<size_t>(end - begin));
+        return record;
+    }
+
+    int compare(const char* aBase, const Record& a, const char* bBase, const Record& b) const {
+        const char* aLine = aBase + a.offset;
+        const char* bLine = bBase + b.offset;
+        for (size_t i = 0; i < options_.keys.size(); ++i) {
+            const Key& key = options_.keys[i];
+            const char *aKey, *aKeyEnd, *bKey, *bKeyEnd;
+            if (i == 0) {
+                aKey = aLine + a.keyBegin;
+                aKeyEnd = aLine + a.keyEnd;
+                bKey = bLine + b.keyBegin;
+                bKeyEnd = bLine + b.keyEnd;
+            } else {
+                keyRange(key, aLine, aLine + a.length, aKey, aKeyEnd);
+                keyRange(key, bLine, bLine + b.length, bKey, bKeyEnd);
+            }
+            int diff;
+            if (i == 0 && a.prefix != b.prefix) {
+                diff = a.prefix < b.prefix ? -1 : 1;
+            } else if (key.numeric) {
+                diff = SortCommand::compareNumbers(aKey, aKeyEnd, bKey, bKeyEnd);
+            } else {
+                diff = compareBytes(aKey, static_cast<size_t>(aKeyEnd - aKey), bKey, static_cast<size_t>(bKeyEnd - bKey));
+            }
+            if (diff != 0) return key.reverse ? -diff : diff;
+        }
+        if (options_.unique) return 0;
+        // Last resort: the whole line
+        int diff = compareBytes(aLine, a.length, bLine, b.length);
+        return options_.reverse ? -diff : diff;
+    }
+
+private:
+    // Start of field number `field` (1-based); with blanks as separators a
+    // field includes the blanks before it
+    const char* fieldStart(const char* p, const char* end, size_t field) const {
+        for (size_t n = field - 1; n > 0 && p < end; --n) {
+            if (options_.separator >= 0) {
+                const char* next = static_cast<const char*>(std::memchr(p, options_.separator, static_cast<size_t>(end - p)));
+                p = next ? next + 1 : end;
+            } else {
+                p = skipBlanks(p, end);
+                while (p < end && !isBlank(*p)) ++p;
+            }
+        }
+        return p;
+    }
+
+    const char* fieldEnd(const char* p, const char* end) const {
+        if (options_.separator >= 0) {
+            const char* next = static_cast<const char*>(std::memchr(p, options_.separator, static_cast<size_t>(end - p)));
+            return next ? next : end;
+        }
+        p = skipBlanks(p, end);
+        while (p < end && !isBlank(*p)) ++p;
+        return p;
+    }
+
+    void keyRange(const Key& key, const char* line, const char* end, const char*& begin, const char*& limit) const {
+        begin = fieldStart(line, end, key.startField);
+        if (key.blanks) begin = skipBlanks(begin, end);
+        if (key.startChar > 0) begin = std::min(end, begin + (key.startChar - 1));
+
+        if (key.endField == 0) {
+            limit = end;
+        } else {
+            limit = fieldStart(line, end, key.endField);
+            if (key.endChar == 0) {
+                limit = fieldEnd(limit, end);
+            } else {
+                if (key.blanks) limit = skipBlanks(limit, end);
+                limit = std::min(end, limit + key.endChar);
+            }
+        }
+        if (limit < begin) limit = begin;
+    }
+
+    const Options& options_;
+};
+
+// Buffered line output to the command's output or to a run file
+class LineWriter {
+public:
+    explicit LineWriter(ExecContext& ctx) : ctx_(&ctx) { buffer_.reserve(outputBlock); }
+    explicit LineWriter(long handle) : handle_(handle) { buffer_.reserve(outputBlock); }
+
+    bool add(const char* line, size_t length) {
+        if (buffer_.size() + length + 1 > outputBlock && !flush()) return false;
+        buffer_.append(line, length);
+        buffer_ += '\n';
+        return true;
+    }
+
+    bool flush() {
+        bool ok = ctx_ ? ctx_->write(buffer_.data(), buffer_.size())
+                       : PlatformUtils::writeAll(handle_, buffer_.data(), buffer_.size());
+        buffer_.clear();
+        return ok;
+    }
+
+    bool cancelled() const { return ctx_ && ctx_->cancelled(); }
+
+private:
+    ExecContext* ctx_ = nullptr;
+    long handle_ = -1;
+    std::string buffer_;
+};
+
+// One sorted piece of the in-memory chunk
+struct PieceSource {
+    const char* arena;
+    const Record* next;
+    const Record* end;
+
+    bool valid() const { return next < end; }
+    const char* base() const { return arena; }
+    const Record& record() const { return *next; }
+    void advance() { ++next; }
+};
+
+// A sorted run file, read a line at a time
+class RunSource {
+public:
+    RunSource(const std::string& path, const Comparator& comparator) : reader_(path), comparator_(comparator) {
+        advance();
+    }
+
+    bool ok() const { return reader_.ok(); }
+    bool valid() const { return valid_; }
+    const char* base() const { return line_; }
+    const Record& record() const { return record_; }
+
+    void advance() {
+        while (pos_ >= block_.size()) {
+            if (!reader_.ok() || !reader_.next(block_)) {
+                valid_ = false;
+                return;
+            }
+            pos_ = 0;
+        }
+        line_ = block_.data() + pos_;
+        const char* newline = static_cast<const char*>(std::memchr(line_, '\n', block_.size() - pos_));
+        size_t length = newline ? static_cast<size_t>(newline - line_) : block_.size() - pos_;
+        record_ = comparator_.make(line_, 0, length);
+        pos_ += length + 1;
+        valid_ = true;
+    }
+
+private:
+    BlockReader reader_;
+    const Comparator& comparator_;
+    std::string_view block_;
+    size_t pos_ = 0;
+    const char* line_ = nullptr;
+    Record record_{};
+    bool valid_ = false;
+};
+
+// K-way merge of sorted sources; on equal lines the earlier source wins,
+// so -u keeps the first line in input order
+template <typename Source>
+bool merge(std::vector<Source*>& sources, const Comparator& comparator, bool unique, LineWriter& out) {
+    auto after = [&](size_t a, size_t b) {
+        int diff = comparator.compare(sources[a]->base(), sources[a]->record(), sources[b]->base(), sources[b]->record());
+        return diff != 0 ? diff > 0 : a > b;
+    };
+    std::vector<size_t> heap;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (sources[i]->valid()) heap.push_back(i);
+    }
+    std::make_heap(heap.begin(), heap.end(), after);
+
+    std::string last;
+    Record lastRecord{};
+    bool haveLast = false;
+    size_t emitted = 0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), after);
+        Source& source = *sources[heap.back()];
+        const Record& record = source.record();
+        const char* line = source.base() + record.offset;
+        bool duplicate = unique && haveLast &&
+                         comparator.compare(last.data(), lastRecord, source.base(), record) == 0;
+        if (!duplicate) {
+            if (!out.add(line, record.length)) return false;
+            if (unique) {
+                last.assign(line, record.length);
+                lastRecord = record;
+                lastRecord.offset = 0;
+                haveLast = true;
+            }
+        }
+        if ((++emitted & 0xfff) == 0 && out.cancelled()) return false;
+        source.advance();
+        if (source.valid()) {
+            std::push_heap(heap.begin(), heap.end(), after);
+        } else {
+            heap.pop_back();
+        }
+    }
+    return out.flush();
+}
+
+// Temporary directory for run files, removed with everything in it
+class TempDir {
+public:
+    explicit TempDir(std::string parent) : parent_(std::move(parent)) {}
+
+    ~TempDir() {
+        std::error_code ec;
+        if (!path_.empty()) fs::remove_all(path_, ec);
+    }
+
+    // Path for a new run file; empty if the directory cannot be created
+    std::string newFile() {
+        if (path_.empty() && !create()) return std::string();
+        return (path_ / ("run" + std::to_string(next_++))).string();
+    }
+
+    const std::string& parent() const { return parent_; }
+
+private:
+    bool create() {
+        std::error_code ec;
+        fs::path parent = parent_.empty() ? fs::temp_directory_path(ec) : fs::path(parent_);
+        std::random_device random;
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            fs::path candidate = parent / ("termidash-sort-" + std::to_string(random()));
+            if (fs::create_directory(candidate, ec)) {
+                path_ = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string parent_;
+    fs::path path_;
+    size_t next_ = 0;
+};
+
+class Sorter {
+public:
+    Sorter(const Options& options, ExecContext& ctx)
+        : options_(options), ctx_(ctx), comparator_(options), temp_(options.tempDir) {}
+
+    bool add(BlockReader& reader) {
+        std::string_view block;
+        while (!ctx_.cancelled() && reader.next(block)) {
+            const char* p = block.data();
+            const char* end = p + block.size();
+            while (p < end) {
+                const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                const char* lineEnd = newline ? newline : end;
+                if (!addLine(p, static_cast<size_t>(lineEnd - p))) return false;
+                if (lineEnd == end) break;
+                p = lineEnd + 1;
+            }
+        }
+        return true;
+    }
+
+    bool finish() {
+        if (runs_.empty()) {
+            LineWriter out(ctx_);
+            return mergeChunk(out);
+        }
+        if (!records_.empty() && !spill()) return false;
+        std::vector<char>().swap(arena_);
+        std::vector<Record>().swap(records_);
+
+        // Merge passes until the rest fit in one final merge. Groups are
+        // consecutive and stay in order, so earlier input still wins ties
+        while (runs_.size() > mergeFanIn) {
+            std::vector<std::string> merged;
+            for (size_t i = 0; i < runs_.size(); i += mergeFanIn) {
+                auto begin = runs_.begin() + static_cast<std::ptrdiff_t>(i);
+                std::vector<std::string> group(begin, begin + static_cast<std::ptrdiff_t>(std::min(mergeFanIn, runs_.size() - i)));
+                if (group.size() == 1) {
+                    merged.push_back(group.front());
+                    continue;
+                }
+                std::string path = temp_.newFile();
+                if (path.empty() || !mergeRuns(group, path)) return false;
+                merged.push_back(path);
+            }
+            runs_.swap(merged);
+        }
+        return mergeRuns(runs_, std::string());
+    }
+
+private:
+    bool addLine(const char* line, size_t length) {
+        size_t needed = arena_.size() + length;
+        if (!records_.empty() && needed + (records_.size() + 1) * sizeof(Record) > options_.budget) {
+            if (!spill()) return false;
+            needed = length;
+        }
+        if (needed > arena_.capacity()) {
+            // Grow within the budget rather than doubling past it
+            size_t capacity = std::max(needed, std::min(arena_.capacity() * 2 + outputBlock, options_.budget));
+            arena_.reserve(capacity);
+        }
+        uint64_t offset = arena_.size();
+        arena_.insert(arena_.end(), line, line + length);
+        records_.push_back(comparator_.make(arena_.data(), offset, length));
+        return true;
+    }
+
+    // Sort the chunk in one piece per thread; returns the piece boundaries
+    std::vector<size_t> sortChunk() {
+        size_t pieces = std::max<size_t>(1, std::min(options_.threads, records_.size() / minPieceRecords));
+        std::vector<size_t> bounds;
+        for (size_t i = 0; i <= pieces; ++i) bounds.push_back(records_.size() * i / pieces);
+
+        const char* arena = arena_.data();
+        auto less = [&](const Record& a, const Record& b) { return comparator_.compare(arena, a, arena, b) < 0; };
+        auto sortPiece = [&](size_t i) {
+            auto begin = records_.begin() + static_cast<std::ptrdiff_t>(bounds[i]);
+            auto end = records_.begin() + static_cast<std::ptrdiff_t>(bounds[i + 1]);
+            // Stable under -u so the first of equal lines is the one kept
+            if (options_.unique) {
+                std::stable_sort(begin, end, less);
+            } else {
+                std::sort(begin, end, less);
+            }
+        };
+        if (pieces == 1) {
+            sortPiece(0);
+        } else {
+            TaskGroup group;
+            for (size_t i = 1; i < pieces; ++i) group.run([&sortPiece, i]() { sortPiece(i); });
+            sortPiece(0);
+            group.wait();
+        }
+        return bounds;
+    }
+
+    bool mergeChunk(LineWriter& out) {
+        std::vector<size_t> bounds = sortChunk();
+        std::vector<PieceSource> pieces;
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            pieces.push_back({arena_.data(), records_.data() + bounds[i], records_.data() + bounds[i + 1]});
+        }
+        std::vector<PieceSource*> sources;
+        for (auto& piece : pieces) sources.push_back(&piece);
+        return merge(sources, comparator_, options_.unique, out);
+    }
+
+    bool spill() {
+        std::string path = temp_.newFile();
+        long handle = path.empty() ? -1 : PlatformUtils::openFileForWrite(path, false);
+        if (handle == -1) {
+            ctx_.err << "sort: cannot create temporary file in "
+                     << (temp_.parent().empty() ? "the temporary directory" : temp_.parent()) << "\n";
+            return false;
+        }
+        LineWriter out(handle);
+        bool ok = mergeChunk(out);
+        PlatformUtils::closeFile(handle);
+        if (!ok) {
+            ctx_.err << "sort: write failed: " << path << "\n";
+            return false;
+        }
+        runs_.push_back(path);
+        arena_.clear();
+        records_.clear();
+        return true;
+    }
+
+    // Merge run files into path, or to the output when path is empty
+    bool mergeRuns(const std::vector<std::string>& runs, const std::string& path) {
+        std::vector<std::unique_ptr<RunSource>> owned;
+        std::vector<RunSource*> sources;
+        for (const auto& run : runs) {
+            owned.push_back(std::make_unique<RunSource>(run, comparator_));
+            if (!owned.back()->ok()) {
+                ctx_.err << "sort: cannot read temporary file " << run << "\n";
+                return false;
+            }
+            sources.push_back(owned.back().get());
+        }
+        bool ok;
+        if (path.empty()) {
+            LineWriter out(ctx_);
+            ok = merge(sources, comparator_, options_.unique, out);
+        } else {
+            long handle = PlatformUtils::openFileForWrite(path, false);
+            if (handle == -1) {
+                ctx_.err << "sort: cannot create temporary file " << path << "\n";
+                return false;
+            }
+            LineWriter out(handle);
+            ok = merge(sources, comparator_, options_.unique, out);
+            PlatformUtils::closeFile(handle);
+            if (!ok) ctx_.err << "sort: write failed: " << path << "\n";
+        }
+        owned.clear();
+        std::error_code ec;
+        for (const auto& run : runs) fs::remove(run, ec);
+        return ok;
+    }
+
+    const Options& options_;
+    ExecContext& ctx_;
+    Comparator comparator_;
+    TempDir temp_;
+    std::vector<char> arena_;
+    std::vector<Record> records_;
+    std::vector<std::string> runs_;
+};
+
+bool parseCount(const char*& p, size_t& value) {
+    if (!std::isdigit(static_cast<unsigned char>(*p))) return false;
+    value = 0;
+    while (std::isdigit(static_cast<unsigned char>(*p))) value = value * 10 + static_cast<size_t>(*p++ - '0');
+    return true;
+}
+
+void parseModifiers(const char*& p, Key& key) {
+    for (;; ++p) {
+        if (*p == 'b') key.blanks = true;
+        else if (*p == 'n') key.numeric = true;
+        else if (*p == 'r') key.reverse = true;
+        else return;
+        key.hasOptions = true;
+    }
+}
+
+// F[.C][bnr][,F[.C][bnr]]
+bool parseKey(const std::string& spec, Key& key) {
+    const char* p = spec.c_str();
+    if (!parseCount(p, key.startField) || key.startField == 0) return false;
+    if (*p == '.' && (!parseCount(++p, key.startChar) || key.startChar == 0)) return false;
+    parseModifiers(p, key);
+    if (*p == ',') {
+        ++p;
+        if (!parseCount(p, key.endField) || key.endField == 0) return false;
+        if (*p == '.' && !parseCount(++p, key.endChar)) return false;
+        parseModifiers(p, key);
+    }
+    return *p == '\0';
+}
+
+// Size with an optional b, K, M or G suffix; KiB when there is none
+bool parseSize(const std::string& text, size_t& bytes) {
+    const char* p = text.c_str();
+    size_t value;
+    if (!parseCount(p, value)) return false;
+    size_t unit = 1024;
+    if (*p != '\0') {
+        switch (std::toupper(static_cast<unsigned char>(*p))) {
+        case 'B': unit = 1; break;
+        case 'K': unit = 1024; break;
+        case 'M': unit = 1024 * 1024; break;
+        case 'G': unit = 1024 * 1024 * 1024; break;
+        default: return false;
+        }
+        if (*++p != '\0') return false;
+    }
+    bytes = std::max<size_t>(1, value * unit);
+    return true;
+}
+
+} // namespace
+
+int SortCommand::compareNumbers(const char* a, const char* aEnd, const char* b, const char* bEnd) {
+    struct Number {
+        bool negative = false;
+        const char* integer;
+        size_t integerDigits = 0;
+        const char* fraction;
+        size_t fractionDigits = 0;
+
+        Number(const char* p, const char* end) {
+            p = skipBlanks(p, end);
+            if (p < end && *p == '-') {
+                negative = true;
+                ++p;
+            }
+            while (p < end && *p == '0') ++p;
+            integer = p;
+            while (p < end && std::isdigit(static_cast<unsigned char>(*p))) ++p;
+            integerDigits = static_cast<size_t>(p - integer);
+            fraction = p;
+            if (p < end && *p == '.') {
+                fraction = ++p;
+                while (p < end && std::isdigit(static_cast<unsigned char>(*p))) ++p;
+                fractionDigits = static_cast<size_t>(p - fraction);
+                while (fractionDigits > 0 && fraction[fractionDigits - 1] == '0') --fractionDigits;
+            }
+            if (integerDigits == 0 && fractionDigits == 0) negative = false; // -0 == 0
+        }
+    };
+
+    Number x(a, aEnd);
+    Number y(b, bEnd);
+    if (x.negative != y.negative) return x.negative ? -1 : 1;
+
+    int magnitude;
+    if (x.integerDigits != y.integerDigits) {
+        magnitude = x.integerDigits < y.integerDigits ? -1 : 1;
+    } else {
+        magnitude = std::memcmp(x.integer, y.integer, x.integerDigits);
+        if (magnitude == 0) {
+            // Trailing zeros are gone, so the longer fraction is larger on a tie
+            magnitude = compareBytes(x.fraction, x.fractionDigits, y.fraction, y.fractionDigits);
+        }
+    }
+    return x.negative ? -magnitude : magnitude;
+}
+
+int SortCommand::run(const std::vector<std::string>& args, ExecContext& ctx) {
+    Options options;
+    options.threads = WorkerPool::instance().retained();
+    options.tempDir = PlatformUtils::getEnv("TMPDIR");
+    std::vector<std::string> files;
+
+    auto usage = [&](const std::string& message) {
+        ctx.err << "sort: " << message << "\n";
+        return 2;
+    };
+
+    size_t i = 1;
+    for (; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (arg == "--") {
+            ++i;
+            break;
+        }
+        if (arg.compare(0, 11, "--parallel=") == 0) {
+            size_t threads = 0;
+            const char* p = arg.c_str() + 11;
+            if (!parseCount(p, threads) || threads == 0 || *p != '\0') return usage("invalid --parallel: " + arg);
+            options.threads = threads;
+            continue;
+        }
+        if (arg.size() < 2 || arg[0] != '-') {
+            files.push_back(arg);
+            continue;
+        }
+        for (size_t j = 1; j < arg.size(); ++j) {
+            char flag = arg[j];
+            if (flag == 'b') {
+                options.blanks = true;
+            } else if (flag == 'n') {
+                options.numeric = true;
+            } else if (flag == 'r') {
+                options.reverse = true;
+            } else if (flag == 'u') {
+                options.unique = true;
+            } else if (flag == 'k' || flag == 't' || flag == 'S' || flag == 'T') {
+                // The value is the rest of this word or the next word
+                std::string value;
+                if (j + 1 < arg.size()) {
+                    value = arg.substr(j + 1);
+                } else if (i + 1 < args.size()) {
+                    value = args[++i];
+                } else {
+                    return usage(std::string("option requires an argument -- ") + flag);
+                }
+                if (flag == 'k') {
+                    Key key;
+                    if (!parseKey(value, key)) return usage("invalid key: " + value);
+                    options.keys.push_back(key);
+                } else if (flag == 't') {
+                    if (value.size() != 1) return usage("separator must be one character: " + value);
+                    options.separator = static_cast<unsigned char>(value[0]);
+                } else if (flag == 'S') {
+                    if (!parseSize(value, options.budget)) return usage("invalid buffer size: " + value);
+                } else {
+                    options.tempDir = value;
+                }
+                break;
+            } else {
+                return usage(std::string("invalid option -- ") + flag);
+            }
+        }
+    }
+    files.insert(files.end(), args.begin() + static_cast<std::ptrdiff_t>(std::min(i, args.size())), args.end());
+
+    // Keys without their own ordering options take the global ones; no key
+    // means the whole line
+    if (options.keys.empty()) options.keys.emplace_back();
+    for (auto& key : options.keys) {
+        if (key.hasOptions) continue;
+        key.blanks = options.blanks;
+        key.numeric = options.numeric;
+        key.reverse = options.reverse;
+    }
+
+    Sorter sorter(options, ctx);
+    if (files.empty()) files.push_back("-");
+    for (const auto& file : files) {
+        if (file == "-") {
+            BlockReader reader(ctx);
+            if (!sorter.add(reader)) return 2;
+            continue;
+        }
+        BlockReader reader(file);
+        if (!reader.ok()) {
+            ctx.err << "sort: " << file << ": No such file\n";
+            return 2;
+        }
+        if (!sorter.add(reader)) return 2;
+    }
+    if (ctx.cancelled()) return 0;
+    return sorter.finish() || ctx.cancelled() ? 0 : 2;
+}
+
+} // namespace termidash
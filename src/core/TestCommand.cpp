@@ -0,0 +1,336 @@
+#include "core/TestCommand.hpp"
+#include "core/GlobExpander.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <regex>
+
+#ifdef _WIN32
+#include <filesystem>
+#include <io.h>
+#define isatty _isatty
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace termidash {
+
+namespace {
+
+// What the file predicates need to know about a path
+struct FileInfo {
+    enum class Type { Regular, Directory, Symlink, Fifo, Socket, Block, Char, Other };
+    Type type = Type::Other;
+    uint64_t size = 0;
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    int64_t mtimeSec = 0;
+    uint32_t mtimeNsec = 0;
+    uint32_t mode = 0; // permission and set-id bits
+    uint32_t uid = 0;
+    uint32_t gid = 0;
+};
+
+#ifndef _WIN32
+FileInfo::Type typeOf(uint32_t mode) {
+    if (S_ISREG(mode)) return FileInfo::Type::Regular;
+    if (S_ISDIR(mode)) return FileInfo::Type::Directory;
+    if (S_ISLNK(mode)) return FileInfo::Type::Symlink;
+    if (S_ISFIFO(mode)) return FileInfo::Type::Fifo;
+    if (S_ISSOCK(mode)) return FileInfo::Type::Socket;
+    if (S_ISBLK(mode)) return FileInfo::Type::Block;
+    if (S_ISCHR(mode)) return FileInfo::Type::Char;
+    return FileInfo::Type::Other;
+}
+#endif
+
+// One stat call per operand: false if the path does not exist
+bool lookUp(const std::string& path, bool followLinks, FileInfo& info) {
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    struct statx stx;
+    int flags = AT_STATX_SYNC_AS_STAT | (followLinks ? 0 : AT_SYMLINK_NOFOLLOW);
+    unsigned mask = STATX_TYPE | STATX_MODE | STATX_UID | STATX_GID | STATX_INO | STATX_SIZE | STATX_MTIME;
+    if (statx(AT_FDCWD, path.c_str(), flags, mask, &stx) != 0) return false;
+    info.type = typeOf(stx.stx_mode);
+    info.size = stx.stx_size;
+    info.device = (static_cast<uint64_t>(stx.stx_dev_major) << 32) | stx.stx_dev_minor;
+    info.inode = stx.stx_ino;
+    info.mtimeSec = stx.stx_mtime.tv_sec;
+    info.mtimeNsec = stx.stx_mtime.tv_nsec;
+    info.mode = stx.stx_mode & 07777;
+    info.uid = stx.stx_uid;
+    info.gid = stx.stx_gid;
+    return true;
+#elif !defined(_WIN32)
+    struct stat st;
+    if ((followLinks ? stat(path.c_str(), &st) : lstat(path.c_str(), &st)) != 0) return false;
+    info.type = typeOf(st.st_mode);
+    info.size = static_cast<uint64_t>(st.st_size);
+    info.device = static_cast<uint64_t>(st.st_dev);
+    info.inode = static_cast<uint64_t>(st.st_ino);
+    info.mtimeSec = st.st_mtime;
+    info.mode = st.st_mode & 07777;
+    info.uid = st.st_uid;
+    info.gid = st.st_gid;
+    return true;
+#else
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::file_status status = followLinks ? fs::status(path, ec) : fs::symlink_status(path, ec);
+    if (ec || !fs::exists(status)) return false;
+    switch (status.type()) {
+    case fs::file_type::regular: info.type = FileInfo::Type::Regular; break;
+    case fs::file_type::directory: info.type = FileInfo::Type::Directory; break;
+    case fs::file_type::symlink: info.type = FileInfo::Type::Symlink; break;
+    default: info.type = FileInfo::Type::Other; break;
+    }
+    if (info.type == FileInfo::Type::Regular) info.size = fs::file_size(path, ec);
+    auto time = fs::last_write_time(path, ec).time_since_epoch();
+    info.mtimeSec = std::chrono::duration_cast<std::chrono::seconds>(time).count();
+    info.mtimeNsec = static_cast<uint32_t>((std::chrono::duration_cast<std::chrono::nanoseconds>(time) % std::chrono::seconds(1)).count());
+    info.mode = static_cast<uint32_t>(status.permissions()) & 0777;
+    return true;
+#endif
+}
+
+// Access check from the looked-up mode bits (bit: 4 read, 2 write, 1 execute)
+bool permitted(const FileInfo& info, uint32_t bit) {
+#ifdef _WIN32
+    return (info.mode & (bit << 6)) != 0;
+#else
+    uid_t uid = geteuid();
+    if (uid == 0) {
+        // Root may read and write anything, and execute if anyone may
+        return bit != 1 || (info.mode & 0111) != 0 || info.type == FileInfo::Type::Directory;
+    }
+    if (uid == info.uid) return (info.mode & (bit << 6)) != 0;
+    bool inGroup = getegid() == info.gid;
+    if (!inGroup) {
+        gid_t groups[256];
+        int count = getgroups(256, groups);
+        for (int i = 0; i < count && !inGroup; ++i) inGroup = groups[i] == info.gid;
+    }
+    return (info.mode & (inGroup ? bit << 3 : bit)) != 0;
+#endif
+}
+
+// Mode bits do not show a read-only mount, so -w also asks the kernel
+bool writable(const std::string& path, const FileInfo& info) {
+#ifdef _WIN32
+    (void)path;
+    return permitted(info, 2);
+#else
+    return permitted(info, 2) && faccessat(AT_FDCWD, path.c_str(), W_OK, AT_EACCESS) == 0;
+#endif
+}
+
+bool isUnaryOperator(const std::string& op) {
+    static const std::string ops = "efdhLpSbcsrwxugkOGtzn";
+    return op.size() == 2 && op[0] == '-' && ops.find(op[1]) != std::string::npos;
+}
+
+class Evaluator {
+public:
+    Evaluator(const std::vector<std::string>& words, size_t begin, size_t end, bool extended)
+        : words_(words), pos_(begin), end_(end), extended_(extended) {}
+
+    // Evaluates the whole expression; error() is set if it is malformed
+    bool evaluate() {
+        if (pos_ == end_) return false;
+        bool result = parseOr();
+        if (error_.empty() && pos_ != end_) error_ = "unexpected argument '" + words_[pos_] + "'";
+        return result;
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool isBinaryOperator(const std::string& op) const {
+        static const char* ops[] = {"=", "==", "!=", "<", ">", "-eq", "-ne", "-lt", "-le", "-gt", "-ge",
+                                    "-nt", "-ot", "-ef"};
+        for (const char* candidate : ops) {
+            if (op == candidate) return true;
+        }
+        return extended_ && op == "=~";
+    }
+
+    size_t remaining() const { return end_ - pos_; }
+
+    // [[ ]] joins tests with && and ||; test and [ with -a and -o
+    const char* orOperator() const { return extended_ ? "||" : "-o"; }
+    const char* andOperator() const { return extended_ ? "&&" : "-a"; }
+
+    bool parseOr() {
+        bool result = parseAnd();
+        while (error_.empty() && remaining() > 1 && words_[pos_] == orOperator()) {
+            ++pos_;
+            bool rhs = parseAnd();
+            result = result || rhs;
+        }
+        return result;
+    }
+
+    bool parseAnd() {
+        bool result = parseNot();
+        while (error_.empty() && remaining() > 1 && words_[pos_] == andOperator()) {
+            ++pos_;
+            bool rhs = parseNot();
+            result = result && rhs;
+        }
+        return result;
+    }
+
+    bool parseNot() {
+        // "! = x" compares the string "!"; a lone "!" is a non-empty string
+        if (words_[pos_] == "!" && remaining() > 1 && !(remaining() > 2 && isBinaryOperator(words_[pos_ + 1]))) {
+            ++pos_;
+            return !parseNot();
+        }
+        return parsePrimary();
+    }
+
+    bool parsePrimary() {
+        if (pos_ == end_) {
+            error_ = "argument expected";
+            return false;
+        }
+        const std::string& word = words_[pos_];
+        if (remaining() >= 3 && isBinaryOperator(words_[pos_ + 1])) {
+            pos_ += 3;
+            return binary(words_[pos_ - 3], words_[pos_ - 2], words_[pos_ - 1]);
+        }
+        if (word == "(" && remaining() > 1) {
+            ++pos_;
+            bool result = parseOr();
+            if (error_.empty() && (pos_ == end_ || words_[pos_] != ")")) error_ = "')' expected";
+            if (error_.empty()) ++pos_;
+            return result;
+        }
+        if (isUnaryOperator(word) && remaining() > 1) {
+            pos_ += 2;
+            return unary(word[1], words_[pos_ - 1]);
+        }
+        ++pos_;
+        return !word.empty();
+    }
+
+    bool integer(const std::string& text, long long& value) {
+        errno = 0;
+        char* end = nullptr;
+        value = std::strtoll(text.c_str(), &end, 10);
+        while (end && (*end == ' ' || *end == '\t')) ++end;
+        if (text.empty() || end == text.c_str() || *end != '\0' || errno == ERANGE) {
+            if (error_.empty()) error_ = text + ": integer expression expected";
+            return false;
+        }
+        return true;
+    }
+
+    bool unary(char op, const std::string& operand) {
+        switch (op) {
+        case 'z': return operand.empty();
+        case 'n': return !operand.empty();
+        case 't': {
+            long long fd = 0;
+            return integer(operand, fd) && isatty(static_cast<int>(fd));
+        }
+        default: break;
+        }
+
+        FileInfo info;
+        bool link = op == 'h' || op == 'L';
+        if (!lookUp(operand, !link, info)) return false;
+        switch (op) {
+        case 'e': return true;
+        case 'f': return info.type == FileInfo::Type::Regular;
+        case 'd': return info.type == FileInfo::Type::Directory;
+        case 'h':
+        case 'L': return info.type == FileInfo::Type::Symlink;
+        case 'p': return info.type == FileInfo::Type::Fifo;
+        case 'S': return info.type == FileInfo::Type::Socket;
+        case 'b': return info.type == FileInfo::Type::Block;
+        case 'c': return info.type == FileInfo::Type::Char;
+        case 's': return info.size > 0;
+        case 'r': return permitted(info, 4);
+        case 'w': return writable(operand, info);
+        case 'x': return permitted(info, 1);
+        case 'u': return (info.mode & 04000) != 0;
+        case 'g': return (info.mode & 02000) != 0;
+        case 'k': return (info.mode & 01000) != 0;
+#ifndef _WIN32
+        case 'O': return info.uid == geteuid();
+        case 'G': return info.gid == getegid();
+#endif
+        default: return false;
+        }
+    }
+
+    bool binary(const std::string& lhs, const std::string& op, const std::string& rhs) {
+        if (op == "=" || op == "==") return extended_ ? GlobExpander::matchPattern(rhs, lhs) : lhs == rhs;
+        if (op == "!=") return extended_ ? !GlobExpander::matchPattern(rhs, lhs) : lhs != rhs;
+        if (op == "<") return lhs < rhs;
+        if (op == ">") return lhs > rhs;
+        if (op == "=~") {
+            try {
+                return std::regex_search(lhs, std::regex(rhs, std::regex::extended));
+            } catch (const std::regex_error&) {
+                error_ = rhs + ": invalid regular expression";
+                return false;
+            }
+        }
+        if (op == "-nt" || op == "-ot" || op == "-ef") {
+            FileInfo left, right;
+            bool hasLeft = lookUp(lhs, true, left);
+            bool hasRight = lookUp(rhs, true, right);
+            if (op == "-ef") return hasLeft && hasRight && left.device == right.device && left.inode == right.inode;
+            // A missing file is older than any existing one
+            if (!hasLeft || !hasRight) return op == "-nt" ? hasLeft && !hasRight : hasRight && !hasLeft;
+            bool newer = left.mtimeSec != right.mtimeSec ? left.mtimeSec > right.mtimeSec : left.mtimeNsec > right.mtimeNsec;
+            bool older = left.mtimeSec != right.mtimeSec ? left.mtimeSec < right.mtimeSec : left.mtimeNsec < right.mtimeNsec;
+            return op == "-nt" ? newer : older;
+        }
+
+        long long a = 0, b = 0;
+        if (!integer(lhs, a) || !integer(rhs, b)) return false;
+        if (op == "-eq") return a == b;
+        if (op == "-ne") return a != b;
+        if (op == "-lt") return a < b;
+        if (op == "-le") return a <= b;
+        if (op == "-gt") return a > b;
+        return a >= b; // -ge
+    }
+
+    const std::vector<std::string>& words_;
+    size_t pos_;
+    size_t end_;
+    bool extended_;
+    std::string error_;
+};
+
+} // namespace
+
+int TestCommand::run(const std::vector<std::string>& args, std::ostream& err) {
+    if (args.empty()) return 2;
+    const std::string& name = args[0];
+    size_t end = args.size();
+    if (name == "[" || name == "[[") {
+        std::string close = name == "[" ? "]" : "]]";
+        if (end < 2 || args[end - 1] != close) {
+            err << name << ": missing '" << close << "'\n";
+            return 2;
+        }
+        --end;
+    }
+
+    Evaluator evaluator(args, 1, end, name == "[[");
+    bool result = evaluator.evaluate();
+    if (!evaluator.error().empty()) {
+        err << name << ": " << evaluator.error() << "\n";
+        return 2;
+    }
+    return result ? 0 : 1;
+}
+
+} // namespace termidash
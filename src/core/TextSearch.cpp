@@ -0,0 +1,44 @@
+#include "core/TextSearch.hpp"
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace termidash {
+
+const char* SubstringFinder::find(const char* begin, const char* end) const {
+    size_t size = needle_.size();
+    if (size == 0) return begin;
+    if (static_cast<size_t>(end - begin) < size) return nullptr;
+    const char* first = needle_.data();
+    if (size == 1) return static_cast<const char*>(std::memchr(begin, *first, static_cast<size_t>(end - begin)));
+
+    // Candidates start in [begin, last]
+    const char* last = end - size;
+    const char* p = begin;
+#ifdef __SSE2__
+    const __m128i firstByte = _mm_set1_epi8(first[0]);
+    const __m128i lastByte = _mm_set1_epi8(first[size - 1]);
+    for (; last - p >= 15; p += 16) {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + size - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, firstByte), _mm_cmpeq_epi8(tail, lastByte))));
+        while (mask != 0) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(p + bit + 1, first + 1, size - 2) == 0) return p + bit;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    while (p <= last) {
+        p = static_cast<const char*>(std::memchr(p, first[0], static_cast<size_t>(last - p) + 1));
+        if (!p) return nullptr;
+        if (p[size - 1] == first[size - 1] && std::memcmp(p + 1, first + 1, size - 2) == 0) return p;
+        ++p;
+    }
+    return nullptr;
+}
+
+} // namespace termidash
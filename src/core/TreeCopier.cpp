@@ -0,0 +1,232 @@
+#ifndef _WIN32 // POSIX only
+
+#include "core/TreeCopier.hpp"
+#include "common/PlatformUtils.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace termidash {
+
+namespace {
+
+// What copying needs to know about a source
+const unsigned copyFields = StatMode | StatSize | StatMTime | StatATime | StatIdentity;
+
+std::string join(const std::string& directory, std::string_view name) {
+    std::string path = directory;
+    if (path.empty() || path.back() != '/') path += '/';
+    path += name;
+    return path;
+}
+
+// Access and modification times of info, as utimensat takes them
+void timesOf(const FileStat& info, struct timespec times[2]) {
+    times[0].tv_sec = info.atime;
+    times[0].tv_nsec = info.atimeNsec;
+    times[1].tv_sec = info.mtime;
+    times[1].tv_nsec = info.mtimeNsec;
+}
+
+void setTimes(const char* path, const FileStat& info, int flags) {
+    struct timespec times[2];
+    timesOf(info, times);
+    utimensat(AT_FDCWD, path, times, flags);
+}
+
+} // namespace
+
+TreeCopier::TreeCopier(Options options) : options_(std::move(options)), group_(options_.workers) {}
+
+void TreeCopier::add(const std::string& from, const std::string& to) {
+    FileStat info;
+    if (!DirectoryReader::statAt(AT_FDCWD, from.c_str(), copyFields, info, !options_.recursive)) {
+        fail(from, to, errno);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (info.type == EntryType::Directory && !options_.recursive) {
+        errors_.push_back("-r not specified; omitting directory '" + from + "'");
+        return;
+    }
+    FileStat target;
+    if (DirectoryReader::statAt(AT_FDCWD, to.c_str(), StatIdentity, target, true) &&
+        target.device == info.device && target.inode == info.inode) {
+        errors_.push_back("'" + from + "' and '" + to + "' are the same file");
+        return;
+    }
+    if (info.type == EntryType::Directory) {
+        std::error_code ec;
+        std::string source = fs::canonical(from, ec).string() + "/";
+        std::string destination = fs::weakly_canonical(to, ec).string() + "/";
+        if (!ec && destination.compare(0, source.size(), source) == 0) {
+            errors_.push_back("cannot copy a directory, '" + from + "', into itself, '" + to + "'");
+            return;
+        }
+    }
+    group_.spawn([this, from, to, info]() { copyEntry(from, to, info); });
+}
+
+bool TreeCopier::run() {
+    start_ = std::chrono::steady_clock::now();
+    lastReport_ = start_;
+    group_.run();
+
+    // Directories were created writable so they could be filled; give them
+    // their final mode (and times) now, deepest first
+    std::sort(fixups_.begin(), fixups_.end(),
+              [](const DirectoryFixup& a, const DirectoryFixup& b) { return a.path.size() > b.path.size(); });
+    for (const auto& fixup : fixups_) {
+        chmod(fixup.path.c_str(), fixup.info.mode & 07777);
+        if (options_.preserve) setTimes(fixup.path.c_str(), fixup.info, 0);
+    }
+    fixups_.clear();
+
+    if (options_.progress) options_.progress(progress());
+    return errors_.empty();
+}
+
+TreeCopier::Progress TreeCopier::progress() const {
+    Progress progress;
+    progress.files = files_;
+    progress.directories = directories_;
+    progress.bytes = bytes_;
+    progress.cloned = cloned_;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    progress.seconds = elapsed.count();
+    return progress;
+}
+
+void TreeCopier::copyEntry(const std::string& from, const std::string& to, const FileStat& info) {
+    switch (info.type) {
+    case EntryType::Directory: copyDirectory(from, to, info); break;
+    case EntryType::Regular: copyFile(from, to, info); break;
+    case EntryType::Symlink: copyLink(from, to, info); break;
+    default: {
+        std::lock_guard<std::mutex> lock(mutex_);
+        errors_.push_back("'" + from + "': not copying special file");
+        break;
+    }
+    }
+}
+
+void TreeCopier::copyDirectory(const std::string& from, const std::string& to, const FileStat& info) {
+    mode_t mode = info.mode & 07777;
+    if (mkdir(to.c_str(), mode | S_IRWXU) != 0) {
+        int error = errno;
+        FileStat existing;
+        if (error != EEXIST || !DirectoryReader::statAt(AT_FDCWD, to.c_str(), StatType, existing, true) ||
+            existing.type != EntryType::Directory) {
+            fail(from, to, error == EEXIST ? ENOTDIR : error);
+            return;
+        }
+    }
+    if (options_.preserve || (mode & S_IRWXU) != S_IRWXU) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fixups_.push_back({to, info});
+    }
+    ++directories_;
+
+    DirectoryReader reader(from);
+    if (!reader.ok()) {
+        fail(from, to, reader.error());
+        return;
+    }
+    DirectoryReader::Entry entry;
+    while (reader.next(entry) && !group_.cancelled()) {
+        std::string childFrom = join(from, entry.name);
+        std::string childTo = join(to, entry.name);
+        group_.spawn([this, childFrom, childTo]() {
+            FileStat child;
+            if (!DirectoryReader::statAt(AT_FDCWD, childFrom.c_str(), copyFields, child)) {
+                fail(childFrom, childTo, errno);
+                return;
+            }
+            copyEntry(childFrom, childTo, child);
+        });
+    }
+    if (reader.error() != 0) fail(from, to, reader.error());
+}
+
+void TreeCopier::copyFile(const std::string& from, const std::string& to, const FileStat& info) {
+    int in = open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in == -1) {
+        fail(from, to, errno);
+        return;
+    }
+    int out = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, info.mode & 0777);
+    if (out == -1) {
+        fail(from, to, errno);
+        close(in);
+        return;
+    }
+
+    bool cloned = PlatformUtils::cloneFile(in, out);
+    bool ok = cloned || PlatformUtils::copyAll(in, out);
+    int error = errno;
+    if (ok && options_.preserve) {
+        fchmod(out, info.mode & 07777);
+        struct timespec times[2];
+        timesOf(info, times);
+        futimens(out, times);
+    }
+    close(in);
+    if (close(out) != 0 && ok) {
+        ok = false;
+        error = errno;
+    }
+    if (!ok) {
+        fail(from, to, error);
+        return;
+    }
+
+    ++files_;
+    bytes_ += info.size;
+    if (cloned) ++cloned_;
+    report();
+}
+
+void TreeCopier::copyLink(const std::string& from, const std::string& to, const FileStat& info) {
+    std::string target(std::max<uint64_t>(info.size, 255) + 1, '\0');
+    ssize_t n = readlink(from.c_str(), &target[0], target.size());
+    if (n < 0) {
+        fail(from, to, errno);
+        return;
+    }
+    target.resize(static_cast<size_t>(n));
+    if (symlink(target.c_str(), to.c_str()) != 0) {
+        // Replace what is there, as for files
+        if (errno != EEXIST || unlink(to.c_str()) != 0 || symlink(target.c_str(), to.c_str()) != 0) {
+            fail(from, to, errno);
+            return;
+        }
+    }
+    if (options_.preserve) setTimes(to.c_str(), info, AT_SYMLINK_NOFOLLOW);
+    ++files_;
+    report();
+}
+
+void TreeCopier::fail(const std::string& from, const std::string& to, int error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    errors_.push_back("cannot copy '" + from + "' to '" + to + "': " + std::generic_category().message(error));
+}
+
+void TreeCopier::report() {
+    if (!options_.progress) return;
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock) return;
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastReport_ < std::chrono::milliseconds(250)) return;
+    lastReport_ = now;
+    options_.progress(progress());
+}
+
+} // namespace termidash
+
+#endif // _WIN32
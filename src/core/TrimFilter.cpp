@@ -0,0 +1,66 @@
+#include "core/TrimFilter.hpp"
+#include <cstring>
+#include <vector>
+
+namespace termidash {
+
+namespace {
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+} // namespace
+
+size_t TrimFilter::filter(char* data, size_t size, size_t& consumed) {
+    char* out = data;
+    char* p = data;
+    char* end = data + size;
+    while (p < end) {
+        char* newline = static_cast<char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        char* lineEnd = newline ? newline : end;
+        if (lineStart_) {
+            while (p < lineEnd && isBlank(*p)) ++p;
+        }
+        char* last = lineEnd;
+        while (last > p && isBlank(last[-1])) --last;
+        if (last > p) {
+            if (out != p) std::memmove(out, p, static_cast<size_t>(last - p));
+            out += last - p;
+            lineStart_ = false;
+        }
+        if (!newline) {
+            consumed = static_cast<size_t>(last - data);
+            return static_cast<size_t>(out - data);
+        }
+        if (!lineStart_) {
+            *out++ = '\n';
+            lineStart_ = true;
+        }
+        p = newline + 1;
+    }
+    consumed = size;
+    return static_cast<size_t>(out - data);
+}
+
+void TrimFilter::run(ExecContext& ctx, size_t blockSize) {
+    TrimFilter trimmer;
+    std::vector<char> buffer(blockSize);
+    size_t carried = 0;
+    while (!ctx.cancelled()) {
+        // A single run of whitespace filled the whole block
+        if (carried == buffer.size()) buffer.resize(buffer.size() * 2);
+        size_t n = ctx.read(buffer.data() + carried, buffer.size() - carried);
+        if (n == 0) break;
+        size_t size = carried + n;
+        size_t consumed = 0;
+        size_t kept = trimmer.filter(buffer.data(), size, consumed);
+        if (kept > 0 && !ctx.write(buffer.data(), kept)) break;
+        carried = size - consumed;
+        std::memmove(buffer.data(), buffer.data() + consumed, carried);
+    }
+    if (trimmer.pendingNewline() && !ctx.cancelled()) ctx.write("\n", 1);
+    ctx.out.flush();
+}
+
+} // namespace termidash
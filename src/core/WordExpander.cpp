@@ -0,0 +1,530 @@
+#include "core/WordExpander.hpp"
+#include "core/AliasManager.hpp"
+#include "core/BraceExpander.hpp"
+#include "core/ExpressionEvaluator.hpp"
+#include "core/GlobExpander.hpp"
+#include "core/Parser.hpp"
+#include "core/VariableManager.hpp"
+#include <iostream>
+
+namespace termidash {
+
+namespace {
+
+bool isNameChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isFieldSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Index just past the ')' matching the '(' at text[open], or npos
+size_t matchParen(std::string_view text, size_t open) {
+    int depth = 0;
+    char quote = 0;
+    for (size_t i = open; i < text.size(); ++i) {
+        char c = text[i];
+        if (quote == '\'' || (quote == '"' && c != '$')) {
+            if (c == quote) quote = 0;
+        } else if (quote == '"') {
+            if (i + 1 < text.size() && text[i + 1] == '(') {
+                size_t close = matchParen(text, i + 1);
+                if (close == std::string_view::npos) return close;
+                i = close - 1;
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '(') {
+            ++depth;
+        } else if (c == ')' && --depth == 0) {
+            return i + 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// Bracket globs need a closing ']' so a lone "[" (the test builtin) is not scanned for
+bool looksLikeGlob(std::string_view field) {
+    if (field.find_first_of("*?") != std::string_view::npos) return true;
+    size_t open = field.find('[');
+    return open != std::string_view::npos && field.find(']', open + 1) != std::string_view::npos;
+}
+
+// Brace expansion applies to an unquoted '{' that is not part of ${...}
+bool hasBraceExpansion(std::string_view word) {
+    char quote = 0;
+    for (size_t i = 0; i < word.size(); ++i) {
+        char c = word[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '{' && (i == 0 || word[i - 1] != '$')) {
+            return BraceExpander::hasBraces(std::string(word));
+        }
+    }
+    return false;
+}
+
+void stripTrailingNewlines(std::string& text) {
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+        text.pop_back();
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// ExpandedCommand
+// ============================================================================
+
+std::vector<std::string> ExpandedCommand::words() const {
+    std::vector<std::string> out;
+    out.reserve(tokens_.size());
+    for (const auto& token : tokens_) {
+        out.emplace_back(token.text);
+    }
+    return out;
+}
+
+std::string_view ExpandedCommand::target(const Redirect& redirect) const {
+    return redirect.target == NoTarget ? std::string_view() : tokens_[redirect.target].text;
+}
+
+std::string ExpandedCommand::text() const {
+    std::string out;
+    auto add = [&out](std::string_view piece) {
+        if (!out.empty()) out += ' ';
+        out.append(piece.data(), piece.size());
+    };
+    if (stages_.empty()) {
+        for (const auto& token : tokens_) add(token.text);
+        return out;
+    }
+    for (size_t s = 0; s < stages_.size(); ++s) {
+        const Stage& stage = stages_[s];
+        for (uint32_t i = 0; i < stage.wordCount; ++i) add(tokens_[stage.firstWord + i].text);
+        for (uint32_t i = 0; i < stage.redirectCount; ++i) {
+            const Redirect& redirect = redirects_[stage.firstRedirect + i];
+            add(Parser::redirectOperator(redirect.kind));
+            if (redirect.target != NoTarget) add(target(redirect));
+        }
+        if (s + 1 < stages_.size()) add(stage.trimAfter ? "|>" : "|");
+    }
+    return out;
+}
+
+void ExpandedCommand::clear() {
+    source_.clear();
+    buffer_.clear();
+    lexed_.clear();
+    tokens_.clear();
+    offsets_.clear();
+    stages_.clear();
+    redirects_.clear();
+}
+
+void ExpandedCommand::startStage() {
+    Stage stage;
+    stage.firstWord = static_cast<uint32_t>(tokens_.size());
+    stage.firstRedirect = static_cast<uint32_t>(redirects_.size());
+    stages_.push_back(stage);
+}
+
+// Expanded words are pushed before the buffer stops growing; once it has,
+// point them into it
+void ExpandedCommand::pointIntoBuffer() {
+    for (size_t i = 0; i < tokens_.size(); ++i) {
+        if (offsets_[i] != InSource) {
+            tokens_[i].text = std::string_view(buffer_.data() + offsets_[i], tokens_[i].text.size());
+        }
+        tokens_[i].quoted = false;
+    }
+}
+
+// ============================================================================
+// WordExpander
+// ============================================================================
+
+struct WordExpander::Dollar {
+    enum class Kind { None, Variable, Arithmetic, Command } kind = Kind::None;
+    std::string_view inner; // variable name, expression or command
+    std::string_view raw;   // full text including $ and delimiters
+};
+
+/**
+ * Builds output fields at the end of the command's buffer. Quoted text is
+ * appended as-is; unquoted expansion results are split on whitespace.
+ */
+class WordExpander::FieldBuilder {
+public:
+    explicit FieldBuilder(ExpandedCommand& out) : out_(out), start_(out.buffer_.size()) {}
+
+    void append(char c) { out_.buffer_ += c; }
+    void append(std::string_view text) { out_.buffer_.append(text.data(), text.size()); }
+
+    void appendSplit(std::string_view text) {
+        if (literal_) {
+            append(text);
+            return;
+        }
+        for (char c : text) {
+            if (isFieldSeparator(c)) {
+                endField();
+            } else {
+                if (c == '*' || c == '?' || c == '[') glob_ = true;
+                out_.buffer_ += c;
+            }
+        }
+    }
+
+    void markQuoted() { quoted_ = true; }
+    void markGlob() { glob_ = !literal_; }
+
+    // Keep every word as one field, even when empty, and never glob it
+    void keepLiteral() {
+        literal_ = true;
+        quoted_ = true;
+    }
+
+    // Emit the current field (an empty one only if it was quoted)
+    void endField() {
+        std::string& buffer = out_.buffer_;
+        size_t length = buffer.size() - start_;
+        if (length > 0 || quoted_) {
+            std::string_view field(buffer.data() + start_, length);
+            if (glob_ && looksLikeGlob(field)) {
+                auto matches = GlobExpander::expand(std::string(field));
+                if (!(matches.size() == 1 && matches[0] == field)) {
+                    buffer.resize(start_);
+                    for (const auto& match : matches) {
+                        push(buffer.size(), match.size());
+                        buffer += match;
+                    }
+                    reset();
+                    return;
+                }
+            }
+            push(start_, length);
+        }
+        reset();
+    }
+
+private:
+    void push(size_t offset, size_t length) {
+        Token token;
+        token.kind = TokenKind::Word;
+        token.text = std::string_view(nullptr, length);
+        out_.tokens_.push_back(token);
+        out_.offsets_.push_back(static_cast<uint32_t>(offset));
+    }
+
+    void reset() {
+        start_ = out_.buffer_.size();
+        quoted_ = literal_;
+        glob_ = false;
+    }
+
+    ExpandedCommand& out_;
+    size_t start_;
+    bool quoted_ = false;
+    bool glob_ = false;
+    bool literal_ = false;
+};
+
+WordExpander::WordExpander(SubstituteFunc substitute) : substitute_(std::move(substitute)) {}
+
+bool WordExpander::isPlain(std::string_view word) {
+    return word.find_first_of("$`{*?[\"'") == std::string_view::npos;
+}
+
+WordExpander::Dollar WordExpander::scanDollar(std::string_view text, size_t pos) const {
+    Dollar d;
+    if (text[pos] == '`') {
+        size_t close = text.find('`', pos + 1);
+        if (close == std::string_view::npos) return d;
+        d.kind = Dollar::Kind::Command;
+        d.inner = text.substr(pos + 1, close - pos - 1);
+        d.raw = text.substr(pos, close + 1 - pos);
+        return d;
+    }
+
+    size_t next = pos + 1;
+    if (next >= text.size()) return d;
+
+    if (text[next] == '(') {
+        size_t end = matchParen(text, next);
+        if (end == std::string_view::npos) return d;
+        d.raw = text.substr(pos, end - pos);
+        if (next + 1 < text.size() && text[next + 1] == '(' && d.raw.size() >= 6 &&
+            d.raw[d.raw.size() - 2] == ')') {
+            d.kind = Dollar::Kind::Arithmetic;
+            d.inner = text.substr(pos + 3, end - pos - 5);
+        } else {
+            d.kind = Dollar::Kind::Command;
+            d.inner = text.substr(pos + 2, end - pos - 3);
+        }
+        return d;
+    }
+
+    if (text[next] == '{') {
+        size_t close = text.find('}', next);
+        if (close == std::string_view::npos) return d;
+        d.kind = Dollar::Kind::Variable;
+        d.inner = text.substr(next + 1, close - next - 1);
+        d.raw = text.substr(pos, close + 1 - pos);
+        return d;
+    }
+
+    size_t end = next;
+    while (end < text.size() && isNameChar(text[end])) ++end;
+    if (end == next) return d;
+    d.kind = Dollar::Kind::Variable;
+    d.inner = text.substr(next, end - next);
+    d.raw = text.substr(pos, end - pos);
+    return d;
+}
+
+std::string WordExpander::evaluate(const Dollar& d) {
+    switch (d.kind) {
+    case Dollar::Kind::Variable:
+        return VariableManager::instance().get(std::string(d.inner));
+
+    case Dollar::Kind::Arithmetic: {
+        std::string expr = expandText(d.inner);
+        try {
+            return std::to_string(ExpressionEvaluator::evaluate(expr));
+        } catch (const std::exception& e) {
+            std::cerr << "Arithmetic error: " << e.what() << "\n";
+            return "$((" + expr + "))";
+        }
+    }
+
+    case Dollar::Kind::Command: {
+        if (!substitute_) return std::string(d.raw);
+        std::string output = substitute_(std::string(d.inner));
+        stripTrailingNewlines(output);
+        return output;
+    }
+
+    case Dollar::Kind::None:
+        break;
+    }
+    return std::string();
+}
+
+std::string WordExpander::expandText(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    bool inSingle = false;
+    bool inDouble = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '\'' && !inDouble) {
+            inSingle = !inSingle;
+        } else if (c == '"' && !inSingle) {
+            inDouble = !inDouble;
+        } else if (!inSingle && (c == '$' || c == '`')) {
+            Dollar d = scanDollar(text, i);
+            if (d.kind != Dollar::Kind::None) {
+                out += evaluate(d);
+                i += d.raw.size() - 1;
+                continue;
+            }
+        }
+        out += c;
+    }
+    return out;
+}
+
+void WordExpander::expandFields(std::string_view word, FieldBuilder& fields) {
+    char quote = 0;
+    for (size_t i = 0; i < word.size(); ++i) {
+        char c = word[i];
+        if (quote == '\'') {
+            if (c == '\'') quote = 0;
+            else fields.append(c);
+            continue;
+        }
+        if (c == '"') {
+            quote = quote ? 0 : '"';
+            fields.markQuoted();
+            continue;
+        }
+        if (c == '\'' && !quote) {
+            quote = '\'';
+            fields.markQuoted();
+            continue;
+        }
+        if (c == '$' || c == '`') {
+            Dollar d = scanDollar(word, i);
+            if (d.kind != Dollar::Kind::None) {
+                std::string value = evaluate(d);
+                if (quote) fields.append(value);
+                else fields.appendSplit(value);
+                i += d.raw.size() - 1;
+                continue;
+            }
+        }
+        if (!quote && (c == '*' || c == '?' || c == '[')) fields.markGlob();
+        fields.append(c);
+    }
+    fields.endField();
+}
+
+void WordExpander::expandWord(std::string_view word, ExpandedCommand& out, bool conditional) {
+    FieldBuilder fields(out);
+
+    // Arithmetic commands are evaluated later as a whole: no splitting or globbing
+    if (word.size() >= 4 && word.compare(0, 2, "((") == 0) {
+        fields.append(expandText(word));
+        fields.endField();
+        return;
+    }
+
+    // Inside [[ ]] each word is one operand, even when empty, and patterns
+    // are left for the command to match
+    if (conditional) {
+        fields.keepLiteral();
+        expandFields(word, fields);
+        return;
+    }
+
+    if (hasBraceExpansion(word)) {
+        for (const auto& piece : BraceExpander::expand(std::string(word))) {
+            expandFields(piece, fields);
+        }
+        return;
+    }
+    expandFields(word, fields);
+}
+
+void WordExpander::expand(const std::string& text, ExpandedCommand& out) {
+    out.clear();
+    std::string_view source = text;
+
+    // Alias substitution applies to the first word only
+    size_t start = text.find_first_not_of(" \t");
+    if (start != std::string::npos) {
+        size_t end = text.find_first_of(" \t", start);
+        std::string name = text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (AliasManager::instance().has(name)) {
+            out.source_ = AliasManager::instance().get(name);
+            if (end != std::string::npos) out.source_.append(text, end, std::string::npos);
+            source = out.source_;
+        }
+    }
+
+    Lexer::lex(source, out.lexed_);
+    bool conditional = !out.lexed_.empty() && out.lexed_[0].kind == TokenKind::Word && out.lexed_[0].text == "[[";
+    for (const Token& token : out.lexed_) {
+        if (token.kind != TokenKind::Word || isPlain(token.text)) {
+            out.tokens_.push_back(token);
+            out.offsets_.push_back(ExpandedCommand::InSource);
+            continue;
+        }
+        expandWord(token.text, out, conditional);
+    }
+
+    out.pointIntoBuffer();
+}
+
+struct WordExpander::PendingRedirect {
+    ast::RedirectKind kind;
+    std::string_view target; // raw word, empty for descriptor duplication
+};
+
+void WordExpander::addWord(std::string_view word, ExpandedCommand& out, bool conditional) {
+    if (isPlain(word)) {
+        out.tokens_.push_back({TokenKind::Word, word, false});
+        out.offsets_.push_back(ExpandedCommand::InSource);
+        return;
+    }
+    expandWord(word, out, conditional);
+}
+
+// An alias is source text: it is lexed here, and its pipes and redirections
+// apply around the words that follow it
+void WordExpander::addAlias(const std::string& name, std::vector<PendingRedirect>& redirects, ExpandedCommand& out) {
+    out.source_ = AliasManager::instance().get(name);
+    Lexer::lex(out.source_, out.lexed_);
+    const std::vector<Token>& tokens = out.lexed_;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token& token = tokens[i];
+        if (token.kind == TokenKind::Pipe || token.kind == TokenKind::TrimPipe) {
+            endStage(redirects, token.kind == TokenKind::TrimPipe, out);
+            redirects.clear();
+            out.startStage();
+            continue;
+        }
+        ast::RedirectKind kind;
+        if (token.kind == TokenKind::Redirect && Parser::redirectKind(token.text, kind)) {
+            if (!Parser::takesTarget(kind)) {
+                if (kind != ast::RedirectKind::None) redirects.push_back({kind, std::string_view()});
+                continue;
+            }
+            if (i + 1 < tokens.size() && tokens[i + 1].kind == TokenKind::Word) {
+                redirects.push_back({kind, tokens[++i].text});
+                continue;
+            }
+        }
+        addWord(token.text, out, false);
+    }
+}
+
+void WordExpander::endStage(const std::vector<PendingRedirect>& redirects, bool trimAfter, ExpandedCommand& out) {
+    ExpandedCommand::Stage& stage = out.stages_.back();
+    stage.wordCount = static_cast<uint32_t>(out.tokens_.size()) - stage.firstWord;
+    stage.trimAfter = trimAfter;
+    for (const PendingRedirect& redirect : redirects) {
+        uint32_t target = ExpandedCommand::NoTarget;
+        if (!redirect.target.empty()) {
+            target = static_cast<uint32_t>(out.tokens_.size());
+            if (isPlain(redirect.target)) {
+                out.tokens_.push_back({TokenKind::Word, redirect.target, false});
+                out.offsets_.push_back(ExpandedCommand::InSource);
+            } else {
+                // One word, whatever it expands to: no splitting or globbing
+                FieldBuilder fields(out);
+                fields.keepLiteral();
+                expandFields(redirect.target, fields);
+            }
+        }
+        out.redirects_.push_back({redirect.kind, target});
+    }
+    stage.redirectCount = static_cast<uint32_t>(out.redirects_.size()) - stage.firstRedirect;
+}
+
+void WordExpander::expandStage(const ast::Stage& stage, ExpandedCommand& out, bool command) {
+    std::vector<PendingRedirect> redirects;
+    out.startStage();
+
+    // Alias substitution applies to the first word of the statement only
+    size_t first = 0;
+    if (command && out.stages_.size() == 1 && !stage.words.empty() &&
+        AliasManager::instance().has(stage.words[0])) {
+        addAlias(stage.words[0], redirects, out);
+        first = 1;
+    }
+
+    const ExpandedCommand::Stage& current = out.stages_.back();
+    bool conditional;
+    if (out.tokens_.size() > current.firstWord) {
+        conditional = out.offsets_[current.firstWord] == ExpandedCommand::InSource &&
+                      out.tokens_[current.firstWord].text == "[[";
+    } else {
+        conditional = first < stage.words.size() && stage.words[first] == "[[";
+    }
+
+    for (size_t i = first; i < stage.words.size(); ++i) {
+        addWord(stage.words[i], out, conditional);
+    }
+    for (const ast::Redirection& redirection : stage.redirections) {
+        redirects.push_back({redirection.kind, redirection.target});
+    }
+    endStage(redirects, stage.trimAfter, out);
+    out.pointIntoBuffer();
+}
+
+} // namespace termidash
@@ -0,0 +1,191 @@
+#include "core/WorkerPool.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace termidash {
+
+WorkerPool& WorkerPool::instance() {
+    // Never destroyed: parked workers may still be waiting at exit
+    static WorkerPool* instance = new WorkerPool(std::max(1u, std::thread::hardware_concurrency()));
+    return *instance;
+}
+
+WorkerPool::WorkerPool(size_t retain, std::chrono::milliseconds idleTimeout)
+    : retain_(retain), idleTimeout_(idleTimeout) {}
+
+WorkerPool::~WorkerPool() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+    wake_.notify_all();
+    retired_.wait(lock, [this] { return workers_ == 0; });
+}
+
+void WorkerPool::submit(Task task, Task done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_ > 0) {
+            --idle_;
+            queue_.push_back({std::move(task), std::move(done)});
+            wake_.notify_one();
+            return;
+        }
+        ++workers_;
+    }
+    std::thread(&WorkerPool::workerLoop, this, Job{std::move(task), std::move(done)}).detach();
+}
+
+void WorkerPool::workerLoop(Job job) {
+    while (true) {
+        job.task();
+        {
+            // Park before reporting completion, so a caller that submits
+            // again right away finds this worker idle
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++idle_;
+        }
+        if (job.done) job.done();
+        job = Job();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (queue_.empty()) {
+            bool surplus = stopping_ || workers_ > retain_;
+            if (!surplus) {
+                wake_.wait(lock);
+            } else if (stopping_ || wake_.wait_for(lock, idleTimeout_) == std::cv_status::timeout) {
+                if (!queue_.empty() || !(stopping_ || workers_ > retain_)) continue;
+                // Nobody claimed this worker: retire it
+                --idle_;
+                --workers_;
+                retired_.notify_all();
+                return;
+            }
+        }
+        job = std::move(queue_.front());
+        queue_.pop_front();
+    }
+}
+
+size_t WorkerPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return workers_;
+}
+
+size_t WorkerPool::idle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_;
+}
+
+void TaskGroup::run(WorkerPool::Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_;
+    }
+    pool_.submit(std::move(task), [this]() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) done_.notify_all();
+    });
+}
+
+void TaskGroup::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+}
+
+namespace {
+
+// The group and worker the current thread is running a task for
+struct CurrentWorker {
+    const WorkStealingGroup* group = nullptr;
+    size_t index = 0;
+};
+thread_local CurrentWorker currentWorker;
+
+} // namespace
+
+WorkStealingGroup::WorkStealingGroup(size_t workers, WorkerPool& pool) : pool_(pool) {
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < workers; ++i) queues_.push_back(std::make_unique<Queue>());
+}
+
+void WorkStealingGroup::spawn(Task task) {
+    size_t index = currentWorker.group == this ? currentWorker.index
+                                                : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    // Counted before it is visible, so no worker sees the group finished
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        Queue& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_front(std::move(task));
+        queued_.fetch_add(1, std::memory_order_release);
+    }
+    // A worker checks queued_ under idleMutex_ before it sleeps, so taking
+    // the lock here means it either saw the task or is already waiting
+    std::lock_guard<std::mutex> lock(idleMutex_);
+    if (sleeping_ > 0) idle_.notify_one();
+}
+
+void WorkStealingGroup::run() {
+    {
+        TaskGroup helpers(pool_);
+        for (size_t i = 1; i < queues_.size(); ++i) helpers.run([this, i]() { workerLoop(i); });
+        workerLoop(0);
+    }
+    cancelled_ = false;
+}
+
+void WorkStealingGroup::cancel() {
+    cancelled_ = true;
+    std::lock_guard<std::mutex> lock(idleMutex_);
+    idle_.notify_all();
+}
+
+bool WorkStealingGroup::take(size_t index, Task& task) {
+    for (size_t i = 0; i < queues_.size(); ++i) {
+        Queue& queue = *queues_[(index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        if (i == 0) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        } else {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingGroup::finished() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        idle_.notify_all();
+    }
+}
+
+void WorkStealingGroup::workerLoop(size_t index) {
+    CurrentWorker saved = currentWorker;
+    currentWorker = {this, index};
+    Task task;
+    while (true) {
+        if (take(index, task)) {
+            // Cancelled tasks are dropped but still counted off
+            if (!cancelled()) task();
+            task = nullptr;
+            finished();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        if (pending_.load(std::memory_order_acquire) == 0) break;
+        if (queued_.load(std::memory_order_acquire) > 0) continue; // queued since take() looked
+        // Nothing queued, but running tasks may still spawn more: sleep
+        // until spawn() or the last finished() wakes us
+        ++sleeping_;
+        idle_.wait(lock);
+        --sleeping_;
+    }
+    currentWorker = saved;
+}
+
+} // namespace termidash
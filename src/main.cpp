@@ -2,8 +2,10 @@
 #include "common/PlatformInit.hpp"
 #include "common/SecurityUtils.hpp"
 #include "core/PlatformFactory.hpp"
+#include "core/ScriptCache.hpp"
 #include "core/ShellLoop.hpp"
 #include <cstring>
+#include <filesystem>
 #include <iostream>
 
 
@@ -12,6 +14,8 @@ void printUsage(const char *programName) {
       << "Usage: " << programName << " [options] [script_file]\n"
       << "\nOptions:\n"
       << "  -c <command>    Execute a single command and exit\n"
+      << "  --compile <script> [-o <file.tdc>]\n"
+      << "                  Precompile a script (run the .tdc like any script)\n"
       << "  --safe-mode     Run in safe mode (blocks dangerous commands)\n"
       << "  --help, -h      Show this help message\n"
       << "  --version, -v   Show version information\n";
@@ -33,6 +37,8 @@ int main(int argc, char *argv[]) {
   std::string scriptPath;
   bool runCommand = false;
   bool runScript = false;
+  std::string compilePath;
+  std::string compileOutput;
 
   for (int i = 1; i < argc; ++i) {
     if (std::strcmp(argv[i], "--safe-mode") == 0) {
@@ -51,12 +57,29 @@ int main(int argc, char *argv[]) {
     } else if (std::strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
       command = argv[++i];
       runCommand = true;
+    } else if (std::strcmp(argv[i], "--compile") == 0 && i + 1 < argc) {
+      compilePath = argv[++i];
+    } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      compileOutput = argv[++i];
     } else if (argv[i][0] != '-') {
       scriptPath = argv[i];
       runScript = true;
     }
   }
 
+  // Precompiling needs no terminal or process manager
+  if (!compilePath.empty()) {
+    if (compileOutput.empty()) {
+      compileOutput =
+          std::filesystem::path(compilePath).replace_extension(".tdc").string();
+    }
+    termidash::Logger::info("Compiling script: " + compilePath + " -> " +
+                            compileOutput);
+    bool ok = termidash::ScriptCache::compileFile(compilePath, compileOutput);
+    termidash::Logger::shutdown();
+    return ok ? 0 : 1;
+  }
+
   // Enable safe mode if requested
   if (safeMode) {
     termidash::security::setSafeMode(true);
@@ -88,10 +111,10 @@ int main(int argc, char *argv[]) {
   if (runCommand) {
     termidash::Logger::info("Executing command: " +
                             termidash::security::maskSensitiveArgs(command));
-    termidash::runCommand(command, terminal.get(), processManager.get());
+    termidash::runCommand(command, processManager.get());
   } else if (runScript) {
     termidash::Logger::info("Executing script: " + scriptPath);
-    termidash::runScript(scriptPath, terminal.get(), processManager.get());
+    termidash::runScript(scriptPath, processManager.get());
   } else {
     termidash::Logger::info("Starting interactive shell");
     termidash::runShell(terminal.get(), processManager.get());
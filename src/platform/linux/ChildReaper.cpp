@@ -0,0 +1,161 @@
+#include "platform/linux/ChildReaper.hpp"
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#endif
+#include <cerrno>
+#include <cstdint>
+#include <thread>
+
+namespace termidash {
+namespace platform {
+namespace linux_platform {
+
+namespace {
+
+// Reap one child by pid. With WNOHANG, returns false if it has not exited
+bool reap(pid_t pid, int options, ChildStatus& result) {
+    int status = 0;
+    struct rusage usage;
+    pid_t got;
+    do {
+        got = wait4(pid, &status, options, &usage);
+    } while (got == -1 && errno == EINTR);
+    if (got == 0) return false;
+
+    result.pid = pid;
+    if (got == -1) {
+        result.exitCode = -1;
+        return true;
+    }
+    if (WIFEXITED(status)) {
+        result.exitCode = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.termSignal = WTERMSIG(status);
+        result.exitCode = 128 + result.termSignal;
+    }
+    result.userSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+    result.systemSeconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+#ifdef __APPLE__
+    result.maxRssKb = usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    result.maxRssKb = usage.ru_maxrss;
+#endif
+    return true;
+}
+
+} // namespace
+
+ChildReaper& ChildReaper::instance() {
+    // Never destroyed: its thread runs until the process exits
+    static ChildReaper* instance = new ChildReaper;
+    return *instance;
+}
+
+ChildReaper::ChildReaper() {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    epfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd_ == -1) return;
+
+    // The thread starts with every signal blocked, so signals keep going to
+    // the shell's own thread
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &previous);
+    std::thread(&ChildReaper::run, this).detach();
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif
+}
+
+void ChildReaper::add(pid_t pid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Child& child = children_[pid];
+    child = Child();
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    if (epfd_ == -1) return;
+    // A child that has already exited is still a zombie here, so its pidfd
+    // can be opened and is immediately readable
+    int fd = (int)syscall(SYS_pidfd_open, pid, 0);
+    if (fd == -1) return;
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = (uint64_t)pid;
+    if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+        close(fd);
+        return;
+    }
+    child.pidfd = fd;
+#endif
+}
+
+void ChildReaper::run() {
+#ifdef __linux__
+    struct epoll_event events[16];
+    while (true) {
+        int ready = epoll_wait(epfd_, events, 16, -1);
+        if (ready == -1) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        // Reaped under the lock, so a pid cannot be reused and registered
+        // again before its status is recorded
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int k = 0; k < ready; ++k) {
+            auto it = children_.find((pid_t)events[k].data.u64);
+            if (it == children_.end() || it->second.pidfd == -1) continue;
+            Child& child = it->second;
+            reap(it->first, 0, child.status);
+            epoll_ctl(epfd_, EPOLL_CTL_DEL, child.pidfd, nullptr);
+            close(child.pidfd);
+            child.pidfd = -1;
+            child.exited = true;
+        }
+        exited_.notify_all();
+    }
+#endif
+}
+
+ChildStatus ChildReaper::wait(pid_t pid) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = children_.find(pid);
+    if (it != children_.end() && it->second.pidfd != -1) {
+        Child& child = it->second; // references survive a rehash, iterators do not
+        exited_.wait(lock, [&child] { return child.exited; });
+        it = children_.find(pid);
+    }
+
+    ChildStatus status;
+    if (it != children_.end()) {
+        bool exited = it->second.exited;
+        status = it->second.status;
+        children_.erase(it);
+        if (exited) return status;
+    }
+    // Not watched: reap it here
+    lock.unlock();
+    reap(pid, 0, status);
+    return status;
+}
+
+bool ChildReaper::poll(pid_t pid, ChildStatus& status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = children_.find(pid);
+    if (it != children_.end() && it->second.pidfd != -1) return false;
+    if (it != children_.end() && it->second.exited) {
+        status = it->second.status;
+        children_.erase(it);
+        return true;
+    }
+    // Not watched: look at it directly
+    if (!reap(pid, WNOHANG, status)) return false;
+    if (it != children_.end()) children_.erase(it);
+    return true;
+}
+
+} // namespace linux_platform
+} // namespace platform
+} // namespace termidash
@@ -1,4 +1,6 @@
 #include "platform/linux/LinuxJobManager.hpp"
+#include "platform/linux/ChildReaper.hpp"
+#include <cerrno>
 #include <iostream>
 #include <unistd.h>
 #include <sys/wait.h>
@@ -21,22 +23,23 @@ namespace termidash {
             }
 
             int LinuxJobManager::startJob(const std::string& command) {
+                // Parse command before forking: the shell has other threads
+                // (ChildReaper), so the child should not allocate
+                std::vector<std::string> tokens;
+                std::string token;
+                std::istringstream tokenStream(command);
+                while (std::getline(tokenStream, token, ' ')) {
+                    tokens.push_back(token);
+                }
+                std::vector<char*> args;
+                for (auto& s : tokens) args.push_back(&s[0]);
+                args.push_back(nullptr);
+
                 pid_t pid = fork();
                 if (pid == 0) {
                     // Child process
                     setpgid(0, 0); // Put in its own process group
 
-                    // Parse command
-                    std::vector<std::string> tokens;
-                    std::string token;
-                    std::istringstream tokenStream(command);
-                    while (std::getline(tokenStream, token, ' ')) {
-                        tokens.push_back(token);
-                    }
-                    std::vector<char*> args;
-                    for (auto& s : tokens) args.push_back(&s[0]);
-                    args.push_back(nullptr);
-
                     // Restore default signal handlers
                     signal(SIGINT, SIG_DFL);
                     signal(SIGQUIT, SIG_DFL);
@@ -47,7 +50,7 @@ namespace termidash {
 
                     execvp(args[0], args.data());
                     perror("execvp");
-                    exit(1);
+                    _exit(1);
                 } else if (pid < 0) {
                     perror("fork");
                     return -1;
@@ -55,6 +58,7 @@ namespace termidash {
 
                 // Parent process
                 setpgid(pid, pid); // Ensure process group is set
+                ChildReaper::instance().add(pid);
 
                 Job job;
                 job.jobId = nextJobId++;
@@ -88,18 +92,29 @@ namespace termidash {
                     job.running = true;
                 }
 
-                // Wait for it
-                int status;
-                waitpid(job.pid, &status, WUNTRACED);
+                // Wait for it to stop or exit. WNOWAIT leaves an exit to
+                // ChildReaper; if it has already reaped the job, waitid fails
+                siginfo_t info = {};
+                int rc;
+                do {
+                    rc = waitid(P_PID, job.pid, &info, WEXITED | WSTOPPED | WNOWAIT);
+                } while (rc == -1 && errno == EINTR);
+                bool stopped = rc == 0 && info.si_code == CLD_STOPPED;
+                if (stopped) {
+                    // Consume the stop report; this never reaps
+                    siginfo_t ignored = {};
+                    waitid(P_PID, job.pid, &ignored, WSTOPPED | WNOHANG);
+                } else {
+                    ChildReaper::instance().wait(job.pid);
+                }
 
                 tcsetpgrp(STDIN_FILENO, getpid()); // Take back terminal control
                 tcsetattr(STDIN_FILENO, TCSADRAIN, &shell_tmodes); // Restore modes
 
-                if (WIFSTOPPED(status)) {
+                if (stopped) {
                     std::cout << "\n[" << job.jobId << "]+  Stopped                 " << job.command << "\n";
                     job.running = false;
-                    return true;
-                } else if (WIFEXITED(status) || WIFSIGNALED(status)) {
+                } else {
                     jobs.erase(jobId);
                 }
                 return true;
@@ -118,29 +133,30 @@ namespace termidash {
             std::vector<TermiDashJobInfo> LinuxJobManager::listJobs() {
                 std::vector<TermiDashJobInfo> list;
                 for (auto it = jobs.begin(); it != jobs.end(); ) {
-                    int status;
-                    pid_t result = waitpid(it->second.pid, &status, WNOHANG | WUNTRACED | WCONTINUED);
-                    if (result == 0) {
-                        // Running
-                    } else if (result > 0) {
-                        if (WIFEXITED(status) || WIFSIGNALED(status)) {
-                            it = jobs.erase(it);
-                            continue;
-                        } else if (WIFSTOPPED(status)) {
-                            it->second.running = false;
-                        } else if (WIFCONTINUED(status)) {
-                            it->second.running = true;
-                        }
-                    } else {
-                        // Error or no child
-                        it = jobs.erase(it);
-                        continue;
-                    }
-
                     TermiDashJobInfo info;
                     info.jobId = it->second.jobId;
                     info.command = it->second.command;
                     info.pid = (unsigned long)it->second.pid;
+
+                    // Finished jobs were reaped by ChildReaper; they are
+                    // listed once with how they ended, then dropped
+                    ChildStatus ended;
+                    if (ChildReaper::instance().poll(it->second.pid, ended)) {
+                        if (ended.termSignal != 0) info.status = strsignal(ended.termSignal);
+                        else if (ended.exitCode == 0) info.status = "Done";
+                        else info.status = "Exit " + std::to_string(ended.exitCode);
+                        list.push_back(info);
+                        it = jobs.erase(it);
+                        continue;
+                    }
+
+                    // Stop and continue reports, which waitid takes without reaping
+                    siginfo_t change = {};
+                    if (waitid(P_PID, it->second.pid, &change, WSTOPPED | WCONTINUED | WNOHANG) == 0 &&
+                        change.si_pid == it->second.pid) {
+                        it->second.running = change.si_code == CLD_CONTINUED;
+                    }
+
                     info.status = it->second.running ? "Running" : "Stopped";
                     list.push_back(info);
                     ++it;
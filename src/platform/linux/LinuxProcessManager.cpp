@@ -1,10 +1,16 @@
 #include "platform/linux/LinuxProcessManager.hpp"
+#include "platform/linux/ChildReaper.hpp"
+#include "common/PlatformUtils.hpp"
+#include "core/PathIndex.hpp"
 #include <unistd.h>
-#include <sys/wait.h>
+#include <fcntl.h>
+#include <spawn.h>
 #include <signal.h>
+#include <cerrno>
 #include <cstring>
 #include <vector>
-#include <iostream>
+
+extern char** environ;
 
 namespace termidash {
 namespace platform {
@@ -12,58 +18,135 @@ namespace linux_platform {
 
 long LinuxProcessManager::spawn(const std::string& command, const std::vector<std::string>& args, bool background,
                                 long stdIn, long stdOut, long stdErr) {
+    (void)background; // the caller decides whether to wait
+
+    // Bare names are looked up in the shared PATH index, so the child execs
+    // the resolved file directly instead of walking PATH again
+    std::string resolved;
+    if (command.find('/') == std::string::npos) {
+        resolved = PathIndex::instance().resolve(command);
+    }
+    const char* file = resolved.empty() ? command.c_str() : resolved.c_str();
+
+    // argv is built before the child exists, so the child never allocates
+    std::vector<char*> argv;
+    argv.reserve(args.size() + 2);
+    argv.push_back(const_cast<char*>(command.c_str()));
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // The handles stay owned by the caller; they are not closed here
+    long pid = backend_ == SpawnBackend::PosixSpawn
+                   ? spawnWithPosixSpawn(file, argv.data(), stdIn, stdOut, stdErr)
+                   : spawnWithFork(file, argv.data(), stdIn, stdOut, stdErr);
+    if (pid != -1) ChildReaper::instance().add((pid_t)pid);
+    return pid;
+}
+
+long LinuxProcessManager::spawnWithPosixSpawn(const char* file, char* const argv[], long stdIn, long stdOut, long stdErr) {
+    // Pipeline stages are spawned from worker threads that may have SIGPIPE
+    // blocked; the child must not inherit that
+    posix_spawnattr_t attr;
+    if (!PlatformUtils::initSpawnAttributes(attr)) {
+        return spawnWithFork(file, argv, stdIn, stdOut, stdErr);
+    }
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0) {
+        posix_spawnattr_destroy(&attr);
+        return spawnWithFork(file, argv, stdIn, stdOut, stdErr);
+    }
+
+    // stdout and stderr may share one handle (2>&1, &>): dup2 everything,
+    // then close each distinct original once
+    long handles[] = {stdIn, stdOut, stdErr};
+    int rc = 0;
+    for (int target = 0; target < 3 && rc == 0; ++target) {
+        if (handles[target] != -1)
+            rc = posix_spawn_file_actions_adddup2(&actions, (int)handles[target], target);
+    }
+    for (int i = 0; i < 3 && rc == 0; ++i) {
+        bool repeated = (i > 0 && handles[i] == handles[0]) || (i > 1 && handles[i] == handles[1]);
+        if (handles[i] > STDERR_FILENO && !repeated)
+            rc = posix_spawn_file_actions_addclose(&actions, (int)handles[i]);
+    }
+
+    pid_t pid = -1;
+    if (rc == 0) {
+        // A path is executed as is; a name the index did not know is left to
+        // posix_spawnp, which reports it as not found
+        if (strchr(file, '/'))
+            rc = posix_spawn(&pid, file, &actions, &attr, argv, environ);
+        else
+            rc = posix_spawnp(&pid, file, &actions, &attr, argv, environ);
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    if (rc == ENOSYS) {
+        return spawnWithFork(file, argv, stdIn, stdOut, stdErr);
+    }
+    if (rc != 0) {
+        lastError = std::string("Exec failed: ") + strerror(rc);
+        return -1;
+    }
+    return (long)pid;
+}
+
+long LinuxProcessManager::spawnWithFork(const char* file, char* const argv[], long stdIn, long stdOut, long stdErr) {
     pid_t pid = fork();
     if (pid == -1) {
         lastError = "Fork failed";
         return -1;
     } else if (pid == 0) {
-        // Child process
-        if (stdIn != -1) {
-            dup2((int)stdIn, STDIN_FILENO);
-            close((int)stdIn);
-        }
-        if (stdOut != -1) {
-            dup2((int)stdOut, STDOUT_FILENO);
-            close((int)stdOut);
-        }
-        if (stdErr != -1) {
-            dup2((int)stdErr, STDERR_FILENO);
-            close((int)stdErr);
-        }
-
-        std::vector<char*> c_args;
-        c_args.push_back(const_cast<char*>(command.c_str()));
-        for (const auto& arg : args) {
-            c_args.push_back(const_cast<char*>(arg.c_str()));
-        }
-        c_args.push_back(nullptr);
-
-        execvp(command.c_str(), c_args.data());
-        // If execvp returns, it failed
-        std::cerr << "Exec failed: " << strerror(errno) << std::endl;
-        exit(1);
-    } else {
-        // Parent process
-        if (stdIn != -1) close((int)stdIn);
-        if (stdOut != -1) close((int)stdOut);
-        if (stdErr != -1) close((int)stdErr);
-
-        if (!background) {
-            // Wait handled by caller or here?
-            // Interface says 'spawn', caller usually waits.
-            // But for consistency with Windows implementation where we returned the handle/pid
-            return (long)pid;
-        }
-        return (long)pid;
+        // Child process: same signal state posix_spawn would give it
+        sigset_t none;
+        sigemptyset(&none);
+        sigprocmask(SIG_SETMASK, &none, nullptr);
+        signal(SIGPIPE, SIG_DFL);
+
+        // stdout and stderr may share one handle (2>&1, &>), so close only
+        // after every dup2 has been made
+        if (stdIn != -1) dup2((int)stdIn, STDIN_FILENO);
+        if (stdOut != -1) dup2((int)stdOut, STDOUT_FILENO);
+        if (stdErr != -1) dup2((int)stdErr, STDERR_FILENO);
+        if (stdIn > STDERR_FILENO) close((int)stdIn);
+        if (stdOut > STDERR_FILENO) close((int)stdOut);
+        if (stdErr > STDERR_FILENO && stdErr != stdOut) close((int)stdErr);
+
+        if (strchr(file, '/'))
+            execve(file, argv, environ);
+        else
+            execvp(file, argv);
+        // If exec returns, it failed; only async-signal-safe calls from here
+        const char* reason = strerror(errno);
+        const char prefix[] = "Exec failed: ";
+        ssize_t ignored = write(STDERR_FILENO, prefix, sizeof(prefix) - 1);
+        ignored = write(STDERR_FILENO, reason, strlen(reason));
+        ignored = write(STDERR_FILENO, "\n", 1);
+        (void)ignored;
+        _exit(1);
     }
+    return (long)pid;
 }
 
 bool LinuxProcessManager::createPipe(long& readHandle, long& writeHandle) {
+    // Close-on-exec: a child only keeps the ends it was given as stdio
     int pipefd[2];
+#ifdef __linux__
+    if (pipe2(pipefd, O_CLOEXEC) == -1) {
+        lastError = "Pipe failed";
+        return false;
+    }
+#else
     if (pipe(pipefd) == -1) {
         lastError = "Pipe failed";
         return false;
     }
+    fcntl(pipefd[0], F_SETFD, FD_CLOEXEC);
+    fcntl(pipefd[1], F_SETFD, FD_CLOEXEC);
+#endif
     readHandle = (long)pipefd[0];
     writeHandle = (long)pipefd[1];
     return true;
@@ -76,14 +159,21 @@ void LinuxProcessManager::closeHandle(long handle) {
 }
 
 int LinuxProcessManager::wait(long pid) {
-    int status;
-    if (waitpid((pid_t)pid, &status, 0) == -1) {
-        return -1;
+    ChildStatus status = ChildReaper::instance().wait((pid_t)pid);
+    if (status.exitCode == -1) {
+        lastError = "Wait failed";
     }
-    if (WIFEXITED(status)) {
-        return WEXITSTATUS(status);
+    return status.exitCode;
+}
+
+std::vector<ChildStatus> LinuxProcessManager::waitAll(const std::vector<long>& pids) {
+    // ChildReaper collects every stage as soon as it exits, whatever the
+    // order they are waited for in
+    std::vector<ChildStatus> statuses(pids.size());
+    for (size_t i = 0; i < pids.size(); ++i) {
+        statuses[i] = ChildReaper::instance().wait((pid_t)pids[i]);
     }
-    return -1;
+    return statuses;
 }
 
 bool LinuxProcessManager::kill(long pid) {
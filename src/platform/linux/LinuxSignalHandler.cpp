@@ -1,7 +1,6 @@
 #include "platform/linux/LinuxSignalHandler.hpp"
 #include <iostream>
 #include <unistd.h>
-#include <sys/wait.h>
 
 namespace termidash {
 namespace platform {
@@ -35,10 +34,9 @@ void LinuxSignalHandler::handleSignal(int signal) {
         std::cout << "\n^C" << std::endl;
     } else if (signal == SIGTSTP) {
         std::cout << "\n^Z" << std::endl;
-    } else if (signal == SIGCHLD) {
-        // Reap zombie processes
-        while (waitpid(-1, NULL, WNOHANG) > 0);
     }
+    // SIGCHLD reaps nothing here: every child is reaped by ChildReaper as
+    // soon as it exits, by pid, so no waiter's status is ever stolen
 }
 
 } // namespace linux_platform
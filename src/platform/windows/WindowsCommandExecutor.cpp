@@ -1,4 +1,5 @@
 #include "platform/windows/WindowsCommandExecutor.hpp"
+#include "core/Lexer.hpp"
 
 #include <windows.h>
 #include <shellapi.h>
@@ -8,38 +9,6 @@
 #include <cstdlib> // for _strdup
 #include <cstring> // for strlen, memcpy if needed
 
-// Helper: tokenize command into args, respecting quotes
-static std::vector<std::string> tokenizeCommand(const std::string &input)
-{
-    std::vector<std::string> tokens;
-    std::string cur;
-    bool inQuotes = false;
-    for (size_t i = 0; i < input.size(); ++i)
-    {
-        char c = input[i];
-        if (c == '\"')
-        {
-            inQuotes = !inQuotes;
-            continue;
-        }
-        if (!inQuotes && (c == ' ' || c == '\t'))
-        {
-            if (!cur.empty())
-            {
-                tokens.push_back(cur);
-                cur.clear();
-            }
-        }
-        else
-        {
-            cur.push_back(c);
-        }
-    }
-    if (!cur.empty())
-        tokens.push_back(cur);
-    return tokens;
-}
-
 int WindowsCommandExecutor::execute(const std::string &command, bool background)
 {
     STARTUPINFOA si;
@@ -48,7 +17,7 @@ int WindowsCommandExecutor::execute(const std::string &command, bool background)
     ZeroMemory(&pi, sizeof(pi));
     si.cb = sizeof(si);
 
-    std::vector<std::string> tokens = tokenizeCommand(command);
+    std::vector<std::string> tokens = termidash::Lexer::words(command);
     if (tokens.empty())
     {
         lastError = "Empty command";
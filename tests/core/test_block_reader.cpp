@@ -0,0 +1,134 @@
+/**
+ * @file test_block_reader.cpp
+ * @brief Unit tests for BlockReader and SubstringFinder
+ */
+
+#include <gtest/gtest.h>
+#include "core/BlockReader.hpp"
+#include "core/TextSearch.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class BlockReaderTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        fs::remove(path);
+    }
+
+    void writeFile(const std::string& content) {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    // Reassemble the input, checking every block but the last ends a line
+    std::string readAll(BlockReader& reader) {
+        std::string all;
+        std::string_view block;
+        bool lastEndedLine = true;
+        while (reader.next(block)) {
+            EXPECT_TRUE(lastEndedLine);
+            lastEndedLine = !block.empty() && block.back() == '\n';
+            all.append(block.data(), block.size());
+        }
+        return all;
+    }
+
+    static std::string numberedLines(int count) {
+        std::string text;
+        for (int i = 0; i < count; ++i) text += "line " + std::to_string(i) + "\n";
+        return text;
+    }
+
+    fs::path path = fs::temp_directory_path() / "termidash_block_reader_test.txt";
+};
+
+// ============================================================================
+// Reading Tests
+// ============================================================================
+
+TEST_F(BlockReaderTest, ReadsFile) {
+    std::string text = numberedLines(100000) + "no newline";
+    writeFile(text);
+    BlockReader reader(path.string());
+    ASSERT_TRUE(reader.ok());
+    EXPECT_EQ(readAll(reader), text);
+}
+
+TEST_F(BlockReaderTest, MissingFile) {
+    BlockReader reader((fs::temp_directory_path() / "termidash_no_such_file").string());
+    EXPECT_FALSE(reader.ok());
+}
+
+TEST_F(BlockReaderTest, StreamBlocksEndAtLines) {
+    std::string text = numberedLines(100000) + "no newline";
+    std::istringstream in(text);
+    std::ostringstream out, err;
+    ExecContext ctx(in, out, err);
+    BlockReader reader(ctx);
+    EXPECT_EQ(readAll(reader), text);
+}
+
+TEST_F(BlockReaderTest, LineLongerThanBlock) {
+    std::string text = "short\n" + std::string(600 * 1024, 'x') + "\nend\n";
+    std::istringstream in(text);
+    std::ostringstream out, err;
+    ExecContext ctx(in, out, err);
+    BlockReader reader(ctx);
+    EXPECT_EQ(readAll(reader), text);
+}
+
+// ============================================================================
+// Last Lines Tests
+// ============================================================================
+
+TEST_F(BlockReaderTest, LastLinesOfFile) {
+    writeFile(numberedLines(100000));
+    BlockReader reader(path.string());
+    EXPECT_EQ(reader.lastLines(2), "line 99998\nline 99999\n");
+}
+
+TEST_F(BlockReaderTest, LastLinesOfStream) {
+    std::istringstream in(numberedLines(100000) + "partial");
+    std::ostringstream out, err;
+    ExecContext ctx(in, out, err);
+    BlockReader reader(ctx);
+    EXPECT_EQ(reader.lastLines(3), "line 99998\nline 99999\npartial");
+}
+
+TEST_F(BlockReaderTest, LastLinesMoreThanInput) {
+    writeFile("a\nb\n");
+    BlockReader reader(path.string());
+    EXPECT_EQ(reader.lastLines(10), "a\nb\n");
+    BlockReader again(path.string());
+    EXPECT_EQ(again.lastLines(0), "");
+}
+
+// ============================================================================
+// Substring Search Tests
+// ============================================================================
+
+TEST(SubstringFinderTest, MatchesStdFind) {
+    std::string haystack;
+    for (int i = 0; i < 2000; ++i) haystack += static_cast<char>('a' + (i * 7 + i / 13) % 5);
+    for (const std::string needle : {"a", "ab", "abc", "eda", "cdeab", "bbbbbbbbbbbbbbbbbbbbbb", "zz"}) {
+        SubstringFinder finder(needle);
+        for (size_t start = 0; start < 40; ++start) {
+            size_t expected = haystack.find(needle, start);
+            const char* hit = finder.find(haystack.data() + start, haystack.data() + haystack.size());
+            size_t got = hit ? static_cast<size_t>(hit - haystack.data()) : std::string::npos;
+            EXPECT_EQ(got, expected) << needle << " from " << start;
+        }
+    }
+}
+
+TEST(SubstringFinderTest, MatchAtEnd) {
+    std::string haystack(100, 'x');
+    haystack += "needle";
+    SubstringFinder finder("needle");
+    EXPECT_EQ(finder.find(haystack.data(), haystack.data() + haystack.size()), haystack.data() + 100);
+    EXPECT_EQ(finder.find(haystack.data(), haystack.data() + haystack.size() - 1), nullptr);
+    EXPECT_EQ(SubstringFinder("").find(haystack.data(), haystack.data() + 3), haystack.data());
+}
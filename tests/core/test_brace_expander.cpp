@@ -21,6 +21,13 @@ TEST(BraceExpander, HasBraces_False) {
     EXPECT_FALSE(BraceExpander::hasBraces("unmatched}"));
 }
 
+TEST(BraceExpander, HasBraces_LiteralBraces) {
+    EXPECT_FALSE(BraceExpander::hasBraces("{}"));
+    EXPECT_FALSE(BraceExpander::hasBraces("{solo}"));
+    EXPECT_FALSE(BraceExpander::hasBraces("a{b}c"));
+    EXPECT_TRUE(BraceExpander::hasBraces("{a{b,c}}"));
+}
+
 // ============================================================================
 // Comma List Expansion Tests
 // ============================================================================
@@ -149,16 +156,24 @@ TEST(BraceExpander, Expand_NoBraces) {
 }
 
 TEST(BraceExpander, Expand_EmptyBraces) {
+    // {} stays literal, as find -exec relies on
     auto result = BraceExpander::expand("{}");
     ASSERT_EQ(result.size(), 1);
-    EXPECT_EQ(result[0], "");
+    EXPECT_EQ(result[0], "{}");
 }
 
 TEST(BraceExpander, Expand_SingleItem) {
-    // Single item in braces (no comma) - treated as literal
+    // Single item in braces (no comma) - kept literally, braces included
     auto result = BraceExpander::expand("{solo}");
     ASSERT_EQ(result.size(), 1);
-    EXPECT_EQ(result[0], "solo");
+    EXPECT_EQ(result[0], "{solo}");
+}
+
+TEST(BraceExpander, Expand_LiteralOuterBraces) {
+    auto result = BraceExpander::expand("{a{b,c}}");
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0], "{ab}");
+    EXPECT_EQ(result[1], "{ac}");
 }
 
 TEST(BraceExpander, Expand_UnmatchedOpen) {
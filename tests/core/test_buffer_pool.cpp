@@ -0,0 +1,124 @@
+/**
+ * @file test_buffer_pool.cpp
+ * @brief Unit tests for BufferPool and adaptive bridge sizing
+ */
+
+#include <gtest/gtest.h>
+#include "core/BufferPool.hpp"
+#include "core/RingBuffer.hpp"
+#include <thread>
+
+using namespace termidash;
+
+class BufferPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        saved = BufferPool::instance().policy();
+        BufferPool::instance().clear();
+    }
+
+    void TearDown() override {
+        BufferPool::instance().setPolicy(saved);
+        BufferPool::instance().clear();
+    }
+
+    BufferPool::Policy saved;
+};
+
+// ============================================================================
+// Pool Tests
+// ============================================================================
+
+TEST_F(BufferPoolTest, ReleasedBlocksAreReused) {
+    auto& pool = BufferPool::instance();
+    BufferPool::Block block = pool.acquire(8192);
+    char* address = block.get();
+    pool.release(std::move(block), 8192);
+    EXPECT_EQ(pool.pooledBytes(), 8192);
+
+    BufferPool::Block again = pool.acquire(8192);
+    EXPECT_EQ(again.get(), address);
+    EXPECT_EQ(pool.pooledBytes(), 0);
+    pool.release(std::move(again), 8192);
+}
+
+TEST_F(BufferPoolTest, RetainsAtMostTheLimit) {
+    auto& pool = BufferPool::instance();
+    size_t size = BufferPool::retainLimit / 2;
+    pool.release(pool.acquire(size), size);
+    pool.release(pool.acquire(size), size);
+    pool.release(pool.acquire(size), size);
+    EXPECT_LE(pool.pooledBytes(), BufferPool::retainLimit);
+}
+
+TEST_F(BufferPoolTest, BridgeReturnsStorageToPool) {
+    {
+        StreamBridge bridge(BufferPool::Policy{4096, 65536});
+        EXPECT_EQ(bridge.buffer()->capacity(), 4096);
+        EXPECT_EQ(bridge.buffer()->maxCapacity(), 65536);
+    }
+    EXPECT_EQ(BufferPool::instance().pooledBytes(), 4096);
+}
+
+// ============================================================================
+// Growth Tests
+// ============================================================================
+
+TEST_F(BufferPoolTest, RingGrowsUnderBackpressureUpToMax) {
+    CircularBuffer ring(4096, 32768);
+    std::string sent;
+    for (int i = 0; i < 200000; ++i) sent += static_cast<char>('a' + i % 26);
+
+    std::thread writer([&]() {
+        ring.write(sent.data(), sent.size());
+        ring.close();
+    });
+
+    std::string received;
+    char chunk[512];
+    while (size_t n = ring.read(chunk, sizeof(chunk))) {
+        received.append(chunk, n);
+        // A slow reader keeps the writer blocked on a full ring
+        if (received.size() % 8192 < sizeof(chunk)) std::this_thread::yield();
+    }
+    writer.join();
+
+    EXPECT_EQ(received, sent);
+    EXPECT_GT(ring.capacity(), 4096);
+    EXPECT_LE(ring.capacity(), 32768);
+}
+
+TEST_F(BufferPoolTest, FixedRingDoesNotGrow) {
+    CircularBuffer ring(4096);
+    EXPECT_EQ(ring.maxCapacity(), 4096);
+}
+
+// ============================================================================
+// Policy Tests
+// ============================================================================
+
+TEST_F(BufferPoolTest, ParsePolicy) {
+    BufferPool::Policy policy;
+    ASSERT_TRUE(BufferPool::parsePolicy("4K:1M", policy));
+    EXPECT_EQ(policy.initial, 4096);
+    EXPECT_EQ(policy.max, 1024 * 1024);
+    ASSERT_TRUE(BufferPool::parsePolicy("8192:65536", policy));
+    EXPECT_EQ(policy.initial, 8192);
+    EXPECT_EQ(BufferPool::formatPolicy(policy), "8K:64K");
+}
+
+TEST_F(BufferPoolTest, ParsePolicyRejectsBadInput) {
+    BufferPool::Policy policy;
+    EXPECT_FALSE(BufferPool::parsePolicy("4K", policy));
+    EXPECT_FALSE(BufferPool::parsePolicy("1M:4K", policy));
+    EXPECT_FALSE(BufferPool::parsePolicy("4X:1M", policy));
+    EXPECT_FALSE(BufferPool::parsePolicy("0:1M", policy));
+    EXPECT_FALSE(BufferPool::parsePolicy(":1M", policy));
+}
+
+TEST_F(BufferPoolTest, DefaultBridgeFollowsPolicy) {
+    BufferPool::instance().setPolicy(BufferPool::Policy{16384, 131072});
+    StreamBridge bridge;
+    EXPECT_EQ(bridge.buffer()->capacity(), 16384);
+    EXPECT_EQ(bridge.buffer()->maxCapacity(), 131072);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file test_bytecode_compiler.cpp
+ * @brief Unit tests for the BytecodeCompiler class
+ */
+
+#include <gtest/gtest.h>
+#include "core/BytecodeCompiler.hpp"
+#include "core/ScriptParser.hpp"
+#include <sstream>
+
+using namespace termidash;
+using bytecode::OpCode;
+
+static bytecode::Chunk compileText(const std::string& text) {
+    std::istringstream in(text);
+    return BytecodeCompiler::compile(ScriptParser::parse(in));
+}
+
+TEST(BytecodeCompilerTest, EmptyScriptHalts) {
+    auto chunk = compileText("");
+    ASSERT_EQ(chunk.code.size(), 1);
+    EXPECT_EQ(chunk.code[0].op, OpCode::Halt);
+}
+
+TEST(BytecodeCompilerTest, CommandLowersToStageCallExec) {
+    auto chunk = compileText("echo hi\n");
+    ASSERT_EQ(chunk.code.size(), 4);
+    EXPECT_EQ(chunk.code[0].op, OpCode::Stage);
+    ASSERT_EQ(chunk.stages.size(), 1u);
+    EXPECT_EQ(chunk.stages[chunk.code[0].a].words, (std::vector<std::string>{"echo", "hi"}));
+    EXPECT_EQ(chunk.code[1].op, OpCode::Call);
+    EXPECT_EQ(chunk.code[1].a, 3u);
+    EXPECT_EQ(chunk.code[2].op, OpCode::Exec);
+    EXPECT_EQ(chunk.code[2].a, bytecode::NoOperand);
+    EXPECT_EQ(chunk.code[2].b, bytecode::NoOperand);
+}
+
+TEST(BytecodeCompilerTest, PipelineLowersToOneStageOpPerStage) {
+    auto chunk = compileText("sort < in | uniq -c > out &\n");
+    // STAGE 0, STAGE 1, CALL, EXEC, HALT
+    ASSERT_EQ(chunk.code.size(), 5u);
+    EXPECT_EQ(chunk.code[0].op, OpCode::Stage);
+    EXPECT_EQ(chunk.code[1].op, OpCode::Stage);
+    EXPECT_EQ(chunk.code[1].a, 1u);
+    EXPECT_EQ(chunk.code[3].op, OpCode::Exec);
+    EXPECT_EQ(chunk.code[3].b, 1u);
+    ASSERT_EQ(chunk.stages.size(), 2u);
+    ASSERT_EQ(chunk.stages[1].redirections.size(), 1u);
+    EXPECT_EQ(chunk.stages[1].redirections[0].kind, ast::RedirectKind::Output);
+    EXPECT_EQ(chunk.stages[1].redirections[0].target, "out");
+}
+
+TEST(BytecodeCompilerTest, StringsAreInterned) {
+    auto chunk = compileText("cat << EOF\nx\nEOF\ncat << EOF\nx\nEOF\n");
+    EXPECT_EQ(chunk.strings.size(), 1);
+}
+
+TEST(BytecodeCompilerTest, AndListJumpsOverNextCommand) {
+    auto chunk = compileText("a && b\n");
+    // STAGE a, CALL, EXEC, JUMP_IF_FAIL, STAGE b, CALL, EXEC, HALT
+    ASSERT_EQ(chunk.code.size(), 8);
+    EXPECT_EQ(chunk.code[3].op, OpCode::JumpIfFail);
+    EXPECT_EQ(chunk.code[3].a, 7u);
+}
+
+TEST(BytecodeCompilerTest, WhileLoopShape) {
+    auto chunk = compileText("while test x\necho body\nend\n");
+    EXPECT_EQ(chunk.code.front().op, OpCode::LoopInit);
+    bool hasRun = false;
+    bool hasEndLoop = false;
+    for (const auto& ins : chunk.code) {
+        if (ins.op == OpCode::Run) hasRun = true;
+        if (ins.op == OpCode::EndLoop) hasEndLoop = true;
+        if (ins.op == OpCode::Jump || ins.op == OpCode::JumpIfFail || ins.op == OpCode::LoopNext) {
+            EXPECT_LT(ins.a, chunk.code.size());
+        }
+    }
+    EXPECT_TRUE(hasRun);
+    EXPECT_TRUE(hasEndLoop);
+}
+
+TEST(BytecodeCompilerTest, FunctionCompiledIntoOwnChunk) {
+    auto chunk = compileText("function greet\necho hello\nend\n");
+    ASSERT_EQ(chunk.functions.size(), 1);
+    EXPECT_EQ(chunk.strings[chunk.functions[0].name], "greet");
+    ASSERT_NE(chunk.functions[0].body, nullptr);
+    EXPECT_EQ(chunk.functions[0].body->code.back().op, OpCode::Halt);
+    ASSERT_EQ(chunk.functions[0].source.size(), 1);
+    EXPECT_EQ(chunk.code[0].op, OpCode::Define);
+}
+
+TEST(BytecodeCompilerTest, HereDocBecomesExecOperand) {
+    auto chunk = compileText("cat << EOF\nbody\nEOF\n");
+    ASSERT_GE(chunk.code.size(), 3);
+    ASSERT_EQ(chunk.code[2].op, OpCode::Exec);
+    EXPECT_EQ(chunk.strings[chunk.code[2].a], "body\n");
+}
+
+TEST(BytecodeCompilerTest, DisassembleListsOps) {
+    auto chunk = compileText("for i in 1 2\necho $i\nend\n");
+    std::string listing = bytecode::disassemble(chunk);
+    EXPECT_NE(listing.find("FOR_INIT"), std::string::npos);
+    EXPECT_NE(listing.find("FOR_NEXT"), std::string::npos);
+    EXPECT_NE(listing.find("HALT"), std::string::npos);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file test_directory_reader.cpp
+ * @brief Unit tests for DirectoryReader
+ */
+
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include "core/DirectoryReader.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class DirectoryReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / "termidash_directory_reader_test";
+        fs::remove_all(root);
+        fs::create_directories(root / "sub");
+        std::ofstream(root / "file.txt") << "hello";
+        fs::create_symlink("file.txt", root / "link");
+    }
+
+    void TearDown() override {
+        fs::remove_all(root);
+    }
+
+    std::map<std::string, EntryType> list(DirectoryReader& reader) {
+        std::map<std::string, EntryType> entries;
+        DirectoryReader::Entry entry;
+        while (reader.next(entry)) entries[std::string(entry.name)] = entry.type;
+        return entries;
+    }
+
+    fs::path root;
+};
+
+// ============================================================================
+// Reading Tests
+// ============================================================================
+
+TEST_F(DirectoryReaderTest, ListsEntriesWithoutDots) {
+    DirectoryReader reader(root.string());
+    ASSERT_TRUE(reader.ok());
+    auto entries = list(reader);
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_TRUE(entries.count("file.txt"));
+    EXPECT_TRUE(entries.count("sub"));
+    EXPECT_TRUE(entries.count("link"));
+    EXPECT_EQ(reader.error(), 0);
+}
+
+TEST_F(DirectoryReaderTest, ReportsTypesWhenKnown) {
+    DirectoryReader reader(root.string());
+    for (const auto& [name, type] : list(reader)) {
+        // d_type is optional; when given it must be right
+        if (type == EntryType::Unknown) continue;
+        if (name == "sub") {
+            EXPECT_EQ(type, EntryType::Directory);
+        }
+        if (name == "file.txt") {
+            EXPECT_EQ(type, EntryType::Regular);
+        }
+        if (name == "link") {
+            EXPECT_EQ(type, EntryType::Symlink);
+        }
+    }
+}
+
+TEST_F(DirectoryReaderTest, ManyEntriesSpanSeveralReads) {
+    for (int i = 0; i < 3000; ++i) std::ofstream(root / "sub" / ("entry_with_a_long_name_" + std::to_string(i)));
+    DirectoryReader reader((root / "sub").string());
+    EXPECT_EQ(list(reader).size(), 3000u);
+}
+
+TEST_F(DirectoryReaderTest, OpensRelativeToParent) {
+    DirectoryReader parent(root.string());
+    DirectoryReader child(parent.fd(), "sub");
+    ASSERT_TRUE(child.ok());
+    EXPECT_TRUE(list(child).empty());
+
+    // A symlink is not followed
+    fs::create_symlink("sub", root / "sublink");
+    DirectoryReader link(parent.fd(), "sublink");
+    EXPECT_FALSE(link.ok());
+}
+
+TEST_F(DirectoryReaderTest, MissingDirectory) {
+    DirectoryReader reader((root / "missing").string());
+    EXPECT_FALSE(reader.ok());
+    EXPECT_EQ(reader.error(), ENOENT);
+    DirectoryReader::Entry entry;
+    EXPECT_FALSE(reader.next(entry));
+}
+
+// ============================================================================
+// Stat Tests
+// ============================================================================
+
+TEST_F(DirectoryReaderTest, StatAtFetchesRequestedFields) {
+    DirectoryReader reader(root.string());
+    FileStat info;
+    ASSERT_TRUE(DirectoryReader::statAt(reader.fd(), "file.txt", StatType | StatSize | StatLinks, info));
+    EXPECT_EQ(info.type, EntryType::Regular);
+    EXPECT_EQ(info.size, 5u);
+    EXPECT_EQ(info.links, 1u);
+
+    ASSERT_TRUE(DirectoryReader::statAt(reader.fd(), "link", StatType, info));
+    EXPECT_EQ(info.type, EntryType::Symlink);
+    ASSERT_TRUE(DirectoryReader::statAt(reader.fd(), "link", StatType | StatSize, info, true));
+    EXPECT_EQ(info.type, EntryType::Regular);
+    EXPECT_EQ(info.size, 5u);
+
+    EXPECT_FALSE(DirectoryReader::statAt(reader.fd(), "missing", StatType, info));
+    EXPECT_TRUE(DirectoryReader::statAt(AT_FDCWD, root.c_str(), StatType, info));
+    EXPECT_EQ(info.type, EntryType::Directory);
+}
+
+#endif // _WIN32
@@ -0,0 +1,175 @@
+/**
+ * @file test_disk_usage.cpp
+ * @brief Unit tests for DiskUsage
+ */
+
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include "core/DiskUsage.hpp"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class DiskUsageTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / "termidash_disk_usage_test";
+        fs::remove_all(root);
+        fs::create_directories(root / "a" / "b");
+        fs::create_directories(root / "c");
+        write(root / "top", 100);
+        write(root / "a" / "one", 3000);
+        write(root / "a" / "b" / "two", 70000);
+        write(root / "c" / "three", 5);
+    }
+
+    void TearDown() override {
+        fs::permissions(root / "c", fs::perms::owner_all, fs::perm_options::add);
+        fs::remove_all(root);
+    }
+
+    static void write(const fs::path& path, size_t size) {
+        std::ofstream(path) << std::string(size, 'x');
+    }
+
+    static uint64_t blocks(const fs::path& path) {
+        struct stat st {};
+        lstat(path.c_str(), &st);
+        return static_cast<uint64_t>(st.st_blocks) * 512;
+    }
+
+    static uint64_t size(const fs::path& path) {
+        struct stat st {};
+        lstat(path.c_str(), &st);
+        return static_cast<uint64_t>(st.st_size);
+    }
+
+    // Reports by path relative to root, in the order they came
+    uint64_t measure(DiskUsage::Options options, const fs::path& path = {}) {
+        reports.clear();
+        order.clear();
+        DiskUsage usage(options, [&](const std::string& reported, uint64_t bytes) {
+            std::string name = reported == root.string() ? "." : fs::relative(reported, root).string();
+            reports[name] = bytes;
+            order.push_back(name);
+            return true;
+        });
+        uint64_t total = usage.measure((path.empty() ? root : path).string());
+        errors = usage.errors();
+        return total;
+    }
+
+    fs::path root;
+    std::map<std::string, uint64_t> reports;
+    std::vector<std::string> order;
+    std::vector<std::string> errors;
+};
+
+// ============================================================================
+// Total Tests
+// ============================================================================
+
+TEST_F(DiskUsageTest, ApparentSizeAddsUp) {
+    DiskUsage::Options options;
+    options.apparentSize = true;
+    uint64_t total = measure(options);
+
+    uint64_t b = size(root / "a" / "b") + 70000;
+    uint64_t a = size(root / "a") + 3000 + b;
+    uint64_t c = size(root / "c") + 5;
+    EXPECT_EQ(reports["a/b"], b);
+    EXPECT_EQ(reports["a"], a);
+    EXPECT_EQ(reports["c"], c);
+    EXPECT_EQ(total, size(root) + 100 + a + c);
+    EXPECT_EQ(reports["."], total);
+    EXPECT_TRUE(errors.empty());
+}
+
+TEST_F(DiskUsageTest, BlocksAddUp) {
+    uint64_t total = measure({});
+    uint64_t expected = blocks(root) + blocks(root / "top") + blocks(root / "a") + blocks(root / "a" / "one") +
+                        blocks(root / "a" / "b") + blocks(root / "a" / "b" / "two") + blocks(root / "c") +
+                        blocks(root / "c" / "three");
+    EXPECT_EQ(total, expected);
+}
+
+TEST_F(DiskUsageTest, ReportsDirectoriesAfterTheirSubdirectories) {
+    measure({});
+    ASSERT_EQ(order.size(), 4u); // directories only
+    EXPECT_EQ(order.back(), ".");
+    auto position = [&](const std::string& name) { return std::find(order.begin(), order.end(), name) - order.begin(); };
+    EXPECT_LT(position("a/b"), position("a"));
+}
+
+TEST_F(DiskUsageTest, WideTree) {
+    for (int i = 0; i < 40; ++i) {
+        fs::create_directories(root / "wide" / std::to_string(i) / "sub");
+        write(root / "wide" / std::to_string(i) / "sub" / "f", 10);
+    }
+    DiskUsage::Options options;
+    options.apparentSize = true;
+    measure(options);
+    uint64_t expected = size(root / "wide");
+    for (int i = 0; i < 40; ++i) {
+        expected += size(root / "wide" / std::to_string(i)) + size(root / "wide" / std::to_string(i) / "sub") + 10;
+    }
+    EXPECT_EQ(reports["wide"], expected);
+}
+
+// ============================================================================
+// Option Tests
+// ============================================================================
+
+TEST_F(DiskUsageTest, MaxDepthLimitsReports) {
+    DiskUsage::Options options;
+    options.maxDepth = 0;
+    uint64_t total = measure(options);
+    ASSERT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports["."], total);
+
+    options.maxDepth = 1;
+    measure(options);
+    EXPECT_EQ(reports.size(), 3u);
+    EXPECT_FALSE(reports.count("a/b"));
+}
+
+TEST_F(DiskUsageTest, FileOperand) {
+    DiskUsage::Options options;
+    options.apparentSize = true;
+    EXPECT_EQ(measure(options, root / "a" / "one"), 3000u);
+    EXPECT_EQ(reports["a/one"], 3000u);
+}
+
+TEST_F(DiskUsageTest, HardLinksCountOnce) {
+    fs::create_hard_link(root / "a" / "b" / "two", root / "c" / "again");
+    DiskUsage::Options options;
+    options.apparentSize = true;
+    uint64_t total = measure(options);
+    EXPECT_EQ(reports["a/b"] + reports["c"], size(root / "a" / "b") + size(root / "c") + 70000 + 5);
+    EXPECT_EQ(total, size(root) + 100 + size(root / "a") + 3000 + size(root / "a" / "b") + 70000 + size(root / "c") + 5);
+}
+
+TEST_F(DiskUsageTest, UnreadableDirectory) {
+    if (geteuid() == 0) GTEST_SKIP() << "root can read any directory";
+    fs::permissions(root / "c", fs::perms::none);
+    measure({});
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_NE(errors[0].find("cannot read directory"), std::string::npos);
+    EXPECT_TRUE(reports.count("."));
+}
+
+TEST_F(DiskUsageTest, MissingOperand) {
+    EXPECT_EQ(measure({}, root / "missing"), 0u);
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_NE(errors[0].find("No such file"), std::string::npos);
+    EXPECT_TRUE(reports.empty());
+}
+
+#endif // _WIN32
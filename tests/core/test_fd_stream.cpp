@@ -0,0 +1,155 @@
+/**
+ * @file test_fd_stream.cpp
+ * @brief Unit tests for the handle-backed streams and block I/O used by builtins
+ */
+
+#include <gtest/gtest.h>
+#include "core/FdStream.hpp"
+#include "core/ExecContext.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class FdStreamTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        fs::remove(path);
+    }
+
+    std::string readFile() {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    fs::path path = fs::temp_directory_path() / "termidash_fd_stream_test.txt";
+};
+
+TEST_F(FdStreamTest, ReadsLinesFromHandle) {
+    long handle = PlatformUtils::openMemoryForRead("alpha\nbeta\ngamma");
+    ASSERT_NE(handle, -1);
+    {
+        FdInputStream in(handle);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(in, line)) lines.push_back(line);
+        EXPECT_EQ(lines, (std::vector<std::string>{"alpha", "beta", "gamma"}));
+    }
+    PlatformUtils::closeFile(handle);
+}
+
+TEST_F(FdStreamTest, ReadsDataLargerThanBuffer) {
+    std::string data(200 * 1024, 'x');
+    data.back() = 'y';
+    long handle = PlatformUtils::openMemoryForRead(data);
+    ASSERT_NE(handle, -1);
+    std::string out;
+    {
+        FdInputStream in(handle);
+        std::stringstream copy;
+        copy << in.rdbuf();
+        out = copy.str();
+    }
+    PlatformUtils::closeFile(handle);
+    EXPECT_EQ(out, data);
+}
+
+TEST_F(FdStreamTest, WritesAreFlushedOnDestruction) {
+    long handle = PlatformUtils::openFileForWrite(path.string(), false);
+    ASSERT_NE(handle, -1);
+    {
+        FdOutputStream out(handle);
+        out << "line " << 1 << "\n";
+        out << std::string(100 * 1024, 'z');
+    }
+    PlatformUtils::closeFile(handle);
+    EXPECT_EQ(readFile(), "line 1\n" + std::string(100 * 1024, 'z'));
+}
+
+TEST_F(FdStreamTest, FailedWriteSetsBadbit) {
+    FdOutputStream out(-1);
+    out << std::string(100 * 1024, 'z');
+    EXPECT_TRUE(out.failed());
+    EXPECT_TRUE(out.bad());
+}
+
+// ============================================================================
+// Handle-to-handle copies and ExecContext block I/O
+// ============================================================================
+
+TEST_F(FdStreamTest, CopyAllBetweenHandles) {
+    std::string data(300 * 1024, 'c');
+    data.back() = 'd';
+    long from = PlatformUtils::openMemoryForRead(data);
+    long to = PlatformUtils::openFileForWrite(path.string(), false);
+    ASSERT_NE(from, -1);
+    ASSERT_NE(to, -1);
+    EXPECT_TRUE(PlatformUtils::copyAll(from, to));
+    PlatformUtils::closeFile(from);
+    PlatformUtils::closeFile(to);
+    EXPECT_EQ(readFile(), data);
+}
+
+TEST_F(FdStreamTest, CopyAllAppends) {
+    long to = PlatformUtils::openFileForWrite(path.string(), false);
+    ASSERT_TRUE(PlatformUtils::writeAll(to, "head\n", 5));
+    PlatformUtils::closeFile(to);
+
+    long from = PlatformUtils::openMemoryForRead("tail\n");
+    to = PlatformUtils::openFileForWrite(path.string(), true);
+    EXPECT_TRUE(PlatformUtils::copyAll(from, to));
+    PlatformUtils::closeFile(from);
+    PlatformUtils::closeFile(to);
+    EXPECT_EQ(readFile(), "head\ntail\n");
+}
+
+TEST_F(FdStreamTest, ContextReadsBufferedDataBeforeHandle) {
+    long handle = PlatformUtils::openMemoryForRead("first\nrest of the input");
+    ASSERT_NE(handle, -1);
+    std::string line, rest;
+    {
+        FdInputStream in(handle);
+        std::ostringstream out, err;
+        ExecContext ctx(in, out, err);
+        ctx.inFd = handle;
+        std::getline(in, line);
+        char buffer[4];
+        while (size_t n = ctx.read(buffer, sizeof(buffer))) rest.append(buffer, n);
+    }
+    PlatformUtils::closeFile(handle);
+    EXPECT_EQ(line, "first");
+    EXPECT_EQ(rest, "rest of the input");
+}
+
+TEST_F(FdStreamTest, ContextWritesKeepStreamOrder) {
+    long handle = PlatformUtils::openFileForWrite(path.string(), false);
+    ASSERT_NE(handle, -1);
+    {
+        FdOutputStream out(handle);
+        std::istringstream in;
+        std::ostringstream err;
+        ExecContext ctx(in, out, err);
+        ctx.outFd = handle;
+        out << "streamed ";
+        EXPECT_TRUE(ctx.write("block "));
+        out << "streamed\n";
+    }
+    PlatformUtils::closeFile(handle);
+    EXPECT_EQ(readFile(), "streamed block streamed\n");
+}
+
+TEST_F(FdStreamTest, ContextReadsFromPlainStream) {
+    std::istringstream in("no handle here");
+    std::ostringstream out, err;
+    ExecContext ctx(in, out, err);
+    std::string got;
+    char buffer[5];
+    while (size_t n = ctx.read(buffer, sizeof(buffer))) got.append(buffer, n);
+    EXPECT_EQ(got, "no handle here");
+    EXPECT_TRUE(ctx.write(got));
+    EXPECT_EQ(out.str(), got);
+}
@@ -0,0 +1,221 @@
+/**
+ * @file test_find_command.cpp
+ * @brief Unit tests for the find builtin
+ */
+
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include "core/FindCommand.hpp"
+#include <algorithm>
+#include <csignal>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <pthread.h>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class FindCommandTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / "termidash_find_test";
+        fs::remove_all(root);
+        fs::create_directories(root / "src" / "util");
+        fs::create_directories(root / "build" / "obj");
+        std::ofstream(root / "README") << "readme";
+        std::ofstream(root / "src" / "main.cpp") << std::string(2000, 'x');
+        std::ofstream(root / "src" / "util" / "str.cpp") << "s";
+        std::ofstream(root / "src" / "util" / "str.hpp") << "h";
+        std::ofstream(root / "build" / "obj" / "main.o") << std::string(5000, 'o');
+        fs::create_symlink("README", root / "link");
+    }
+
+    void TearDown() override {
+        fs::remove_all(root);
+    }
+
+    // Output lines relative to root, sorted since the walk is parallel
+    std::vector<std::string> find(std::vector<std::string> args) {
+        args.insert(args.begin(), {"find", root.string()});
+        std::istringstream in;
+        std::ostringstream out;
+        err.str("");
+        ExecContext ctx(in, out, err);
+        status = FindCommand::run(args, ctx);
+        std::vector<std::string> lines;
+        std::istringstream text(out.str());
+        std::string line;
+        std::string prefix = root.string();
+        while (std::getline(text, line)) {
+            if (line.compare(0, prefix.size(), prefix) == 0) line = "." + line.substr(prefix.size());
+            lines.push_back(line);
+        }
+        std::sort(lines.begin(), lines.end());
+        return lines;
+    }
+
+    using Lines = std::vector<std::string>;
+
+    fs::path root;
+    std::ostringstream err;
+    int status = -1;
+};
+
+// ============================================================================
+// Walk Tests
+// ============================================================================
+
+TEST_F(FindCommandTest, ListsEverythingByDefault) {
+    EXPECT_EQ(find({}), (Lines{".", "./README", "./build", "./build/obj", "./build/obj/main.o", "./link",
+                              "./src", "./src/main.cpp", "./src/util", "./src/util/str.cpp",
+                              "./src/util/str.hpp"}));
+    EXPECT_EQ(status, 0);
+}
+
+TEST_F(FindCommandTest, WalksWideTrees) {
+    for (int i = 0; i < 50; ++i) {
+        fs::create_directories(root / "wide" / std::to_string(i));
+        for (int j = 0; j < 20; ++j) std::ofstream(root / "wide" / std::to_string(i) / ("f" + std::to_string(j)));
+    }
+    EXPECT_EQ(find({"-path", "*/wide/*", "-type", "f"}).size(), 1000u);
+}
+
+TEST_F(FindCommandTest, DepthLimits) {
+    EXPECT_EQ(find({"-maxdepth", "0"}), (Lines{"."}));
+    EXPECT_EQ(find({"-maxdepth", "1", "-type", "d"}), (Lines{".", "./build", "./src"}));
+    EXPECT_EQ(find({"-mindepth", "3"}), (Lines{"./build/obj/main.o", "./src/util/str.cpp", "./src/util/str.hpp"}));
+}
+
+TEST_F(FindCommandTest, PruneSkipsSubtree) {
+    EXPECT_EQ(find({"-name", "build", "-prune", "-o", "-type", "f", "-print"}),
+              (Lines{"./README", "./src/main.cpp", "./src/util/str.cpp", "./src/util/str.hpp"}));
+}
+
+TEST_F(FindCommandTest, MissingStartPoint) {
+    std::istringstream in;
+    std::ostringstream out;
+    ExecContext ctx(in, out, err);
+    EXPECT_EQ(FindCommand::run({"find", (root / "missing").string()}, ctx), 1);
+    EXPECT_NE(err.str().find("No such file"), std::string::npos);
+    EXPECT_TRUE(out.str().empty());
+}
+
+// ============================================================================
+// Test Predicate Tests
+// ============================================================================
+
+TEST_F(FindCommandTest, NamePatterns) {
+    EXPECT_EQ(find({"-name", "*.cpp"}), (Lines{"./src/main.cpp", "./src/util/str.cpp"}));
+    EXPECT_EQ(find({"-name", "str*"}), (Lines{"./src/util/str.cpp", "./src/util/str.hpp"}));
+    EXPECT_EQ(find({"-name", "*ai*"}), (Lines{"./build/obj/main.o", "./src/main.cpp"}));
+    EXPECT_EQ(find({"-name", "README"}), (Lines{"./README"}));
+    EXPECT_EQ(find({"-name", "str.[ch]pp"}), (Lines{"./src/util/str.cpp", "./src/util/str.hpp"}));
+    EXPECT_EQ(find({"-name", "m?in.*"}), (Lines{"./build/obj/main.o", "./src/main.cpp"}));
+}
+
+TEST_F(FindCommandTest, PathPattern) {
+    EXPECT_EQ(find({"-path", "*/util/*"}), (Lines{"./src/util/str.cpp", "./src/util/str.hpp"}));
+}
+
+TEST_F(FindCommandTest, TypeTest) {
+    EXPECT_EQ(find({"-type", "l"}), (Lines{"./link"}));
+    EXPECT_EQ(find({"-type", "d"}), (Lines{".", "./build", "./build/obj", "./src", "./src/util"}));
+    mkfifo((root / "fifo").c_str(), 0600);
+    EXPECT_EQ(find({"-type", "p"}), (Lines{"./fifo"}));
+}
+
+TEST_F(FindCommandTest, SizeTest) {
+    // Sizes are rounded up to whole units: 2000 bytes is 4 blocks, 2k
+    EXPECT_EQ(find({"-type", "f", "-size", "+4"}), (Lines{"./build/obj/main.o"}));
+    EXPECT_EQ(find({"-type", "f", "-size", "4"}), (Lines{"./src/main.cpp"}));
+    EXPECT_EQ(find({"-type", "f", "-size", "-2k"}), (Lines{"./README", "./src/util/str.cpp", "./src/util/str.hpp"}));
+    EXPECT_EQ(find({"-type", "f", "-size", "6c"}), (Lines{"./README"}));
+}
+
+TEST_F(FindCommandTest, MTimeTest) {
+    struct timespec times[2] = {{0, UTIME_OMIT}, {std::time(nullptr) - 10 * 86400, 0}};
+    utimensat(AT_FDCWD, (root / "README").c_str(), times, 0);
+    EXPECT_EQ(find({"-type", "f", "-mtime", "+5"}), (Lines{"./README"}));
+    EXPECT_EQ(find({"-mtime", "10"}), (Lines{"./README"}));
+    EXPECT_EQ(find({"-type", "f", "-mtime", "-1"}).size(), 4u);
+}
+
+TEST_F(FindCommandTest, Operators) {
+    EXPECT_EQ(find({"-name", "*.cpp", "-o", "-name", "*.o"}),
+              (Lines{"./build/obj/main.o", "./src/main.cpp", "./src/util/str.cpp"}));
+    EXPECT_EQ(find({"-type", "f", "!", "-name", "*.?pp"}), (Lines{"./README", "./build/obj/main.o"}));
+    EXPECT_EQ(find({"(", "-name", "*.cpp", "-o", "-name", "*.hpp", ")", "-a", "-path", "*/util/*"}),
+              (Lines{"./src/util/str.cpp", "./src/util/str.hpp"}));
+}
+
+TEST_F(FindCommandTest, Print0) {
+    std::istringstream in;
+    std::ostringstream out;
+    ExecContext ctx(in, out, err);
+    FindCommand::run({"find", root.string(), "-name", "README", "-print0"}, ctx);
+    EXPECT_EQ(out.str(), (root / "README").string() + '\0');
+}
+
+TEST_F(FindCommandTest, InvalidExpressions) {
+    find({"-bogus"});
+    EXPECT_EQ(status, 1);
+    EXPECT_NE(err.str().find("unknown predicate '-bogus'"), std::string::npos);
+    find({"-name"});
+    EXPECT_NE(err.str().find("missing argument"), std::string::npos);
+    find({"(", "-name", "x"});
+    EXPECT_EQ(status, 1);
+    find({"-type", "q"});
+    EXPECT_EQ(status, 1);
+    find({"-exec", "echo", "{}"});
+    EXPECT_NE(err.str().find("missing argument to '-exec'"), std::string::npos);
+}
+
+// ============================================================================
+// Exec Tests
+// ============================================================================
+
+TEST_F(FindCommandTest, ExecPerMatch) {
+    EXPECT_EQ(find({"-name", "*.hpp", "-exec", "echo", "{}", ";"}), (Lines{"./src/util/str.hpp"}));
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(find({"-name", "README", "-exec", "echo", "[{}]", ";"}).size(), 1u);
+}
+
+TEST_F(FindCommandTest, ExecResultIsATest) {
+    EXPECT_EQ(find({"-type", "f", "-exec", "test", "-s", "{}", ";", "-name", "str*", "-print"}),
+              (Lines{"./src/util/str.cpp", "./src/util/str.hpp"}));
+}
+
+TEST_F(FindCommandTest, ExecBatches) {
+    Lines lines = find({"-name", "*.?pp", "-exec", "echo", "batch", "{}", "+"});
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0].compare(0, 6, "batch "), 0);
+    EXPECT_NE(lines[0].find("str.cpp"), std::string::npos);
+    EXPECT_NE(lines[0].find("main.cpp"), std::string::npos);
+    EXPECT_NE(lines[0].find("str.hpp"), std::string::npos);
+}
+
+TEST_F(FindCommandTest, ExecBatchFailureSetsStatus) {
+    find({"-name", "*.cpp", "-exec", "false", "{}", "+"});
+    EXPECT_EQ(status, 1);
+}
+
+#ifdef __linux__
+TEST_F(FindCommandTest, ExecChildDoesNotInheritBlockedSignals) {
+    // As on a pipeline worker thread
+    sigset_t pipeSignal, previous;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, &previous);
+    Lines lines = find({"-name", "README", "-exec", "grep", "SigBlk", "/proc/self/status", ";"});
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "SigBlk:\t0000000000000000");
+}
+#endif
+
+#endif // _WIN32
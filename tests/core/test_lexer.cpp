@@ -0,0 +1,140 @@
+/**
+ * @file test_lexer.cpp
+ * @brief Unit tests for the Lexer class
+ */
+
+#include <gtest/gtest.h>
+#include "core/Lexer.hpp"
+
+using namespace termidash;
+
+static std::vector<std::string> texts(const std::vector<Token>& tokens) {
+    std::vector<std::string> out;
+    for (const auto& token : tokens) out.emplace_back(token.text);
+    return out;
+}
+
+// ============================================================================
+// Word Tests
+// ============================================================================
+
+TEST(LexerTest, SplitsWordsOnWhitespace) {
+    auto tokens = Lexer::lex("  echo\thello   world ");
+    ASSERT_EQ(tokens.size(), 3);
+    EXPECT_EQ(texts(tokens), (std::vector<std::string>{"echo", "hello", "world"}));
+    for (const auto& token : tokens) EXPECT_EQ(token.kind, TokenKind::Word);
+}
+
+TEST(LexerTest, TokensViewTheOriginalLine) {
+    std::string line = "ls -la";
+    auto tokens = Lexer::lex(line);
+    ASSERT_EQ(tokens.size(), 2);
+    EXPECT_EQ(tokens[0].text.data(), line.data());
+    EXPECT_EQ(tokens[1].text.data(), line.data() + 3);
+}
+
+TEST(LexerTest, QuotesKeepWordsTogether) {
+    auto tokens = Lexer::lex("echo \"a b\" 'c d' mi\"x y\"ed");
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[1].text, "\"a b\"");
+    EXPECT_TRUE(tokens[1].quoted);
+    EXPECT_EQ(tokens[2].text, "'c d'");
+    EXPECT_EQ(tokens[3].text, "mi\"x y\"ed");
+    EXPECT_FALSE(tokens[0].quoted);
+}
+
+TEST(LexerTest, OperatorsInsideQuotesAreText) {
+    auto tokens = Lexer::lex("echo \"a | b; c && d\" 'x > y'");
+    ASSERT_EQ(tokens.size(), 3);
+    for (const auto& token : tokens) EXPECT_EQ(token.kind, TokenKind::Word);
+}
+
+TEST(LexerTest, SubstitutionsStayInOneWord) {
+    auto tokens = Lexer::lex("echo $(ls | grep \")\") `a|b` x");
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[1].text, "$(ls | grep \")\")");
+    EXPECT_EQ(tokens[2].text, "`a|b`");
+}
+
+TEST(LexerTest, QuotesInsideQuotedSubstitution) {
+    auto tokens = Lexer::lex("echo \"$(printf \"a b\")\" x");
+    ASSERT_EQ(tokens.size(), 3);
+    EXPECT_EQ(tokens[1].text, "\"$(printf \"a b\")\"");
+}
+
+TEST(LexerTest, ArithmeticCommandIsOneWord) {
+    auto tokens = Lexer::lex("((x < 3))");
+    ASSERT_EQ(tokens.size(), 1);
+    EXPECT_EQ(tokens[0].kind, TokenKind::Word);
+    EXPECT_EQ(tokens[0].text, "((x < 3))");
+}
+
+TEST(LexerTest, BackslashIsLiteral) {
+    auto words = Lexer::words("dir C:\\Users\\me");
+    ASSERT_EQ(words.size(), 2);
+    EXPECT_EQ(words[1], "C:\\Users\\me");
+}
+
+// ============================================================================
+// Operator Tests
+// ============================================================================
+
+TEST(LexerTest, ControlOperators) {
+    auto tokens = Lexer::lex("a&&b||c;d|e|>f &");
+    ASSERT_EQ(tokens.size(), 12);
+    EXPECT_EQ(tokens[1].kind, TokenKind::AndIf);
+    EXPECT_EQ(tokens[3].kind, TokenKind::OrIf);
+    EXPECT_EQ(tokens[5].kind, TokenKind::Semicolon);
+    EXPECT_EQ(tokens[7].kind, TokenKind::Pipe);
+    EXPECT_EQ(tokens[9].kind, TokenKind::TrimPipe);
+    EXPECT_EQ(tokens[11].kind, TokenKind::Background);
+}
+
+TEST(LexerTest, RedirectionOperators) {
+    auto tokens = Lexer::lex("c <in >out >>app 2>err 2>>e2 &>all &>>all2 2>&1 <<EOF <<<str");
+    std::vector<std::string> ops;
+    for (const auto& token : tokens) {
+        if (token.kind == TokenKind::Redirect) ops.emplace_back(token.text);
+    }
+    EXPECT_EQ(ops, (std::vector<std::string>{"<", ">", ">>", "2>", "2>>", "&>", "&>>", "2>&1", "<<", "<<<"}));
+}
+
+TEST(LexerTest, DigitRedirectOnlyAtWordStart) {
+    auto tokens = Lexer::lex("echo file2>out");
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[1].text, "file2");
+    EXPECT_EQ(tokens[2].text, ">");
+}
+
+TEST(LexerTest, ConditionalOperatorsAreWords) {
+    auto tokens = Lexer::lex("if [[ a < b && c || d > e ]]; then x && y; fi");
+    EXPECT_EQ(texts(tokens), (std::vector<std::string>{"if", "[[", "a", "<", "b", "&&", "c", "||", "d", ">", "e", "]]",
+                                                       ";", "then", "x", "&&", "y", ";", "fi"}));
+    for (size_t i = 1; i <= 11; ++i) EXPECT_EQ(tokens[i].kind, TokenKind::Word) << i;
+    EXPECT_EQ(tokens[15].kind, TokenKind::AndIf);
+
+    // [[ is only a keyword where a command starts
+    tokens = Lexer::lex("echo [[ a && b ]]");
+    EXPECT_EQ(tokens[3].kind, TokenKind::AndIf);
+}
+
+// ============================================================================
+// Helper Tests
+// ============================================================================
+
+TEST(LexerTest, UnquoteRemovesBothQuoteTypes) {
+    EXPECT_EQ(Lexer::unquote("\"a 'b'\""), "a 'b'");
+    EXPECT_EQ(Lexer::unquote("'say \"hi\"'"), "say \"hi\"");
+    EXPECT_EQ(Lexer::unquote("pre\"fix\""), "prefix");
+}
+
+TEST(LexerTest, SpanCoversOriginalText) {
+    std::string line = "echo   a   b | wc";
+    auto tokens = Lexer::lex(line);
+    EXPECT_EQ(Lexer::span(tokens[0], tokens[2]), "echo   a   b");
+}
+
+TEST(LexerTest, Trim) {
+    EXPECT_EQ(Lexer::trim("  x y \t"), "x y");
+    EXPECT_EQ(Lexer::trim("   "), "");
+}
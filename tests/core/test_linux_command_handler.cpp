@@ -0,0 +1,200 @@
+/**
+ * @file test_linux_command_handler.cpp
+ * @brief Unit tests for the Linux/macOS builtins: ls, chmod, chown, ln, df
+ */
+
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include "core/BuiltIn/LinuxCommandHandler.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class LinuxCommandHandlerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / "termidash_linux_handler_test";
+        fs::remove_all(root);
+        fs::create_directories(root);
+    }
+
+    void TearDown() override {
+        fs::remove_all(root);
+    }
+
+    // Runs a command and returns its output
+    std::string run(const std::vector<std::string>& tokens) {
+        std::istringstream in;
+        std::ostringstream out;
+        err.str("");
+        ExecContext ctx(in, out, err);
+        status = handler.handleWithContext(tokens, ctx);
+        return out.str();
+    }
+
+    std::string path(const std::string& name) const {
+        return (root / name).string();
+    }
+
+    void touch(const std::string& name) {
+        std::ofstream(root / name) << name;
+    }
+
+    mode_t mode(const std::string& name) const {
+        struct stat st;
+        stat(path(name).c_str(), &st);
+        return st.st_mode & 07777;
+    }
+
+    LinuxCommandHandler handler;
+    fs::path root;
+    std::ostringstream err;
+    int status = -1;
+};
+
+// ============================================================================
+// ls Tests
+// ============================================================================
+
+TEST_F(LinuxCommandHandlerTest, LsListsSortedAndHidesDotFiles) {
+    touch("b");
+    touch("a");
+    touch(".hidden");
+    EXPECT_EQ(run({"ls", root.string()}), "a\nb\n");
+    EXPECT_EQ(status, 0);
+    EXPECT_NE(run({"ls", "-a", root.string()}).find(".hidden\n"), std::string::npos);
+}
+
+TEST_F(LinuxCommandHandlerTest, LsListsFilesBeforeDirectories) {
+    fs::create_directories(root / "dir");
+    touch("dir/inner");
+    touch("file");
+    EXPECT_EQ(run({"ls", path("dir"), path("file")}), path("file") + "\n\n" + path("dir") + ":\ninner\n");
+}
+
+TEST_F(LinuxCommandHandlerTest, LsRecursiveIsInSerialOrder) {
+    // Wide and deep enough that workers finish out of order
+    for (int i = 0; i < 12; ++i) {
+        std::string dir = "d" + std::to_string(i);
+        for (int j = 0; j < 4; ++j) {
+            fs::create_directories(root / dir / ("s" + std::to_string(j)) / "leaf");
+            touch(dir + "/s" + std::to_string(j) + "/leaf/f");
+        }
+        touch(dir + "/file");
+    }
+
+    std::string expected;
+    std::function<void(const fs::path&)> walk = [&](const fs::path& dir) {
+        std::vector<std::string> names;
+        for (const auto& entry : fs::directory_iterator(dir)) names.push_back(entry.path().filename().string());
+        std::sort(names.begin(), names.end());
+        expected += (expected.empty() ? "" : "\n") + dir.string() + ":\n";
+        for (const auto& name : names) expected += name + "\n";
+        for (const auto& name : names) {
+            if (fs::is_directory(dir / name)) walk(dir / name);
+        }
+    };
+    walk(root);
+
+    EXPECT_EQ(run({"ls", "-R", root.string()}), expected);
+    EXPECT_EQ(status, 0);
+}
+
+TEST_F(LinuxCommandHandlerTest, LsMissingPathFails) {
+    run({"ls", path("missing")});
+    EXPECT_EQ(status, 2);
+    EXPECT_NE(err.str().find("cannot access"), std::string::npos);
+}
+
+// ============================================================================
+// chmod / chown / ln Tests
+// ============================================================================
+
+TEST_F(LinuxCommandHandlerTest, ChmodOctalAndSymbolic) {
+    touch("f");
+    run({"chmod", "644", path("f")});
+    EXPECT_EQ(mode("f"), 0644u);
+    run({"chmod", "u+x,go-r", path("f")});
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(mode("f"), 0700u);
+    run({"chmod", "a=r", path("f")});
+    EXPECT_EQ(mode("f"), 0444u);
+    run({"chmod", "-r", path("f")});
+    EXPECT_EQ(mode("f"), 0u);
+}
+
+TEST_F(LinuxCommandHandlerTest, ChmodRecursive) {
+    fs::create_directories(root / "dir" / "sub");
+    touch("dir/sub/f");
+    run({"chmod", "644", path("dir/sub/f")});
+    run({"chmod", "-R", "g+w", path("dir")});
+    EXPECT_EQ(status, 0);
+    EXPECT_TRUE(mode("dir/sub/f") & S_IWGRP);
+    EXPECT_TRUE(mode("dir/sub") & S_IWGRP);
+}
+
+TEST_F(LinuxCommandHandlerTest, ChmodRejectsInvalidMode) {
+    touch("f");
+    run({"chmod", "u+q", path("f")});
+    EXPECT_EQ(status, 1);
+    EXPECT_NE(err.str().find("invalid mode"), std::string::npos);
+}
+
+TEST_F(LinuxCommandHandlerTest, ChownRejectsUnknownUser) {
+    touch("f");
+    run({"chown", "no_such_user_termidash", path("f")});
+    EXPECT_EQ(status, 1);
+    EXPECT_NE(err.str().find("invalid user"), std::string::npos);
+}
+
+TEST_F(LinuxCommandHandlerTest, ChownAcceptsNumericIds) {
+    touch("f");
+    run({"chown", std::to_string(getuid()) + ":" + std::to_string(getgid()), path("f")});
+    EXPECT_EQ(status, 0);
+}
+
+TEST_F(LinuxCommandHandlerTest, LnSymbolicForceReplaces) {
+    touch("a");
+    touch("b");
+    run({"ln", "-s", path("a"), path("link")});
+    EXPECT_EQ(fs::read_symlink(root / "link"), root / "a");
+    run({"ln", "-s", path("b"), path("link")});
+    EXPECT_EQ(status, 1);
+    run({"ln", "-sf", path("b"), path("link")});
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(fs::read_symlink(root / "link"), root / "b");
+}
+
+TEST_F(LinuxCommandHandlerTest, LnHardLinkIntoDirectory) {
+    touch("a");
+    fs::create_directories(root / "dir");
+    run({"ln", path("a"), path("dir")});
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(fs::hard_link_count(root / "a"), 2u);
+    EXPECT_TRUE(fs::exists(root / "dir" / "a"));
+}
+
+// ============================================================================
+// df Tests
+// ============================================================================
+
+TEST_F(LinuxCommandHandlerTest, DfShowsFileSystemOfOperand) {
+    std::string text = run({"df", root.string()});
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 2);
+}
+
+TEST_F(LinuxCommandHandlerTest, DfMissingOperandFails) {
+    run({"df", path("missing")});
+    EXPECT_EQ(status, 1);
+}
+
+#endif // _WIN32
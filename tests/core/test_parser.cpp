@@ -199,3 +199,107 @@ TEST(ParserTest, ApplyTrimToLinesEmptyLines) {
     std::string output = Parser::applyTrimToLines(input);
     EXPECT_EQ(output, "hello\nworld\n");
 }
+
+// ============================================================================
+// Shared Lexer Behaviour Tests
+// ============================================================================
+
+TEST(ParserTest, SplitBatchIgnoresQuotedSeparators) {
+    auto result = Parser::splitBatch("echo \"a; b && c\"; echo d");
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].first, "echo \"a; b && c\"");
+    EXPECT_EQ(result[1].first, "echo d");
+}
+
+TEST(ParserTest, SplitPipelineIgnoresSubstitution) {
+    auto segments = Parser::splitPipelineOperators("echo $(ls | wc -l) | cat");
+    ASSERT_EQ(segments.size(), 2);
+    EXPECT_EQ(segments[0].cmd, "echo $(ls | wc -l)");
+}
+
+TEST(ParserTest, TokenizeSingleQuotes) {
+    auto tokens = Parser::tokenize("grep 'a b' file");
+    ASSERT_EQ(tokens.size(), 3);
+    EXPECT_EQ(tokens[1], "a b");
+}
+
+TEST(ParserTest, ParseRedirectionWithoutSpaces) {
+    auto info = Parser::parseRedirection("sort <in.txt >\"out file.txt\"");
+    EXPECT_EQ(info.command, "sort");
+    EXPECT_EQ(info.inFile, "in.txt");
+    EXPECT_EQ(info.outFile, "out file.txt");
+}
+
+TEST(ParserTest, ParseRedirectionArgsAreUnquoted) {
+    auto info = Parser::parseRedirection("grep \"two words\" f > out");
+    EXPECT_EQ(info.command, "grep \"two words\" f");
+    ASSERT_EQ(info.args.size(), 3);
+    EXPECT_EQ(info.args[1], "two words");
+}
+
+TEST(ParserTest, ParseRedirectionErrToOut) {
+    auto info = Parser::parseRedirection("make > log 2>&1");
+    EXPECT_EQ(info.command, "make");
+    EXPECT_EQ(info.outFile, "log");
+    EXPECT_TRUE(info.errToOut);
+    EXPECT_EQ(info.errFile, "");
+}
+
+TEST(ParserTest, ParseRedirectionOutToErr) {
+    auto info = Parser::parseRedirection("echo msg >&2");
+    EXPECT_TRUE(info.outToErr);
+    ASSERT_EQ(info.args.size(), 2u);
+    EXPECT_EQ(info.args[1], "msg");
+
+    info = Parser::parseRedirection("echo msg 1>&2");
+    EXPECT_TRUE(info.outToErr);
+    EXPECT_EQ(info.args.size(), 2u);
+}
+
+TEST(ParserTest, ParseRedirectionSameDescriptorIsNoOp) {
+    auto info = Parser::parseRedirection("echo msg 1>&1 2>&2");
+    EXPECT_FALSE(info.outToErr);
+    EXPECT_FALSE(info.errToOut);
+    EXPECT_EQ(info.args.size(), 2u);
+}
+
+TEST(ParserTest, ParsePipelineStages) {
+    std::vector<Token> tokens;
+    Lexer::lex("cat \"$f\" 2> err |> sort >> out 1>&2 &", tokens);
+    ast::Pipeline pipeline = Parser::parsePipeline(tokens.data(), tokens.data() + tokens.size());
+    EXPECT_TRUE(pipeline.background);
+    ASSERT_EQ(pipeline.stages.size(), 2u);
+    EXPECT_EQ(pipeline.stages[0].words, (std::vector<std::string>{"cat", "\"$f\""}));
+    EXPECT_TRUE(pipeline.stages[0].trimAfter);
+    ASSERT_EQ(pipeline.stages[0].redirections.size(), 1u);
+    EXPECT_EQ(pipeline.stages[0].redirections[0].kind, ast::RedirectKind::Error);
+    EXPECT_EQ(pipeline.stages[0].redirections[0].target, "err");
+    EXPECT_EQ(pipeline.stages[1].words, (std::vector<std::string>{"sort"}));
+    ASSERT_EQ(pipeline.stages[1].redirections.size(), 2u);
+    EXPECT_EQ(pipeline.stages[1].redirections[0].kind, ast::RedirectKind::Append);
+    EXPECT_EQ(pipeline.stages[1].redirections[1].kind, ast::RedirectKind::OutputToError);
+}
+
+TEST(ParserTest, ParsePipelineKeepsUnsupportedOperators) {
+    std::vector<Token> tokens;
+    Lexer::lex("exec 3>&1 1>&1 >", tokens);
+    ast::Pipeline pipeline = Parser::parsePipeline(tokens.data(), tokens.data() + tokens.size());
+    EXPECT_FALSE(pipeline.background);
+    ASSERT_EQ(pipeline.stages.size(), 1u);
+    EXPECT_EQ(pipeline.stages[0].words, (std::vector<std::string>{"exec", "3>&1", ">"}));
+    EXPECT_TRUE(pipeline.stages[0].redirections.empty());
+}
+
+TEST(ParserTest, ParseRedirectionQuotedHereDocDelimiter) {
+    auto info = Parser::parseRedirection("cat << 'EOF'");
+    EXPECT_TRUE(info.isHereDoc);
+    EXPECT_EQ(info.hereDocDelim, "EOF");
+}
+
+TEST(ParserTest, ParseRedirectionHereString) {
+    auto info = Parser::parseRedirection("grep b <<< \"a b c\"");
+    EXPECT_TRUE(info.isHereString);
+    EXPECT_FALSE(info.isHereDoc);
+    EXPECT_EQ(info.hereString, "a b c");
+    EXPECT_EQ(info.args, (std::vector<std::string>{"grep", "b"}));
+}
@@ -0,0 +1,105 @@
+/**
+ * @file test_path_index.cpp
+ * @brief Unit tests for the PathIndex class
+ */
+
+#include <gtest/gtest.h>
+#include "core/PathIndex.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+#ifdef _WIN32
+static const char* listSeparator = ";";
+static const char* exeSuffix = ".exe";
+static void setPath(const std::string& value) { _putenv_s("PATH", value.c_str()); }
+#else
+static const char* listSeparator = ":";
+static const char* exeSuffix = "";
+static void setPath(const std::string& value) { setenv("PATH", value.c_str(), 1); }
+#endif
+
+class PathIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const char* path = std::getenv("PATH");
+        savedPath = path ? path : "";
+        root = fs::temp_directory_path() / "path_index_test";
+        fs::remove_all(root);
+        fs::create_directories(root / "a");
+        fs::create_directories(root / "b");
+        setPath((root / "a").string() + listSeparator + (root / "b").string());
+        PathIndex::instance().reset();
+    }
+
+    void TearDown() override {
+        setPath(savedPath);
+        PathIndex::instance().reset();
+        fs::remove_all(root);
+    }
+
+    fs::path makeExecutable(const std::string& dir, const std::string& name) {
+        fs::path file = root / dir / (name + exeSuffix);
+        std::ofstream(file) << "#!/bin/sh\n";
+        fs::permissions(file, fs::perms::owner_all, fs::perm_options::add);
+        return file;
+    }
+
+    std::string savedPath;
+    fs::path root;
+};
+
+TEST_F(PathIndexTest, ResolvesFirstMatchInPathOrder) {
+    fs::path first = makeExecutable("a", "tool");
+    makeExecutable("b", "tool");
+    EXPECT_EQ(fs::path(PathIndex::instance().resolve("tool")), fs::absolute(first));
+    EXPECT_EQ(PathIndex::instance().resolve("missing"), "");
+}
+
+#ifndef _WIN32
+TEST_F(PathIndexTest, SkipsFilesWithoutExecuteBit) {
+    std::ofstream(root / "a" / "data.txt") << "x";
+    fs::permissions(root / "a" / "data.txt", fs::perms::owner_read | fs::perms::owner_write);
+    EXPECT_EQ(PathIndex::instance().resolve("data.txt"), "");
+}
+#endif
+
+TEST_F(PathIndexTest, CompleteReturnsSortedPrefixMatches) {
+    makeExecutable("a", "zeta");
+    makeExecutable("b", "zap");
+    makeExecutable("b", "other");
+    EXPECT_EQ(PathIndex::instance().complete("z"), (std::vector<std::string>{"zap", "zeta"}));
+    EXPECT_EQ(PathIndex::instance().size(), 3u);
+}
+
+TEST_F(PathIndexTest, RebuildsWhenPathChanges) {
+    makeExecutable("b", "only-b");
+    EXPECT_NE(PathIndex::instance().resolve("only-b"), "");
+    setPath((root / "a").string());
+    EXPECT_EQ(PathIndex::instance().resolve("only-b"), "");
+}
+
+TEST_F(PathIndexTest, RebuildsWhenDirectoryChanges) {
+    EXPECT_EQ(PathIndex::instance().resolve("late"), "");
+    // Make sure the directory's mtime moves even on coarse file systems
+    auto before = fs::last_write_time(root / "a");
+    makeExecutable("a", "late");
+    fs::last_write_time(root / "a", before + std::chrono::seconds(2));
+    EXPECT_NE(PathIndex::instance().resolve("late"), "");
+}
+
+TEST_F(PathIndexTest, HitsAndReset) {
+    makeExecutable("a", "counted");
+    PathIndex::instance().resolve("counted");
+    PathIndex::instance().resolve("counted");
+    auto hits = PathIndex::instance().hits();
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0].name, "counted");
+    EXPECT_EQ(hits[0].hits, 2u);
+
+    PathIndex::instance().reset();
+    EXPECT_TRUE(PathIndex::instance().hits().empty());
+}
@@ -0,0 +1,145 @@
+/**
+ * @file test_pipeline_executor.cpp
+ * @brief Execution tests for the PipelineExecutor class
+ */
+
+#include <gtest/gtest.h>
+#include "core/PipelineExecutor.hpp"
+#include "core/VariableManager.hpp"
+#include "platform/linux/LinuxProcessManager.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class PipelineExecutorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = fs::temp_directory_path() / "termidash_pipeline_test";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        out = (dir / "out.txt").string();
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+        VariableManager::instance().unset("PIPESTATUS");
+    }
+
+    // Parse and expand a statement the way the VM does, then run it
+    int run(const std::string& text, std::istream* input = nullptr) {
+        std::vector<Token> tokens;
+        Lexer::lex(text, tokens);
+        pipeline = Parser::parsePipeline(tokens.data(), tokens.data() + tokens.size());
+        command.clear();
+        for (const auto& stage : pipeline.stages) expander.expandStage(stage, command);
+        return PipelineExecutor::execute(command, handler, &processManager, input);
+    }
+
+    std::string output() {
+        std::ifstream in(out);
+        std::stringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    std::vector<int> exitCodes() {
+        std::vector<int> codes;
+        for (const auto& status : PipelineExecutor::lastPipeStatus()) codes.push_back(status.exitCode);
+        return codes;
+    }
+
+    fs::path dir;
+    std::string out;
+    ast::Pipeline pipeline;
+    ExpandedCommand command;
+    WordExpander expander;
+    BuiltInCommandHandler handler;
+    platform::linux_platform::LinuxProcessManager processManager;
+};
+
+// ============================================================================
+// Status Tests
+// ============================================================================
+
+TEST_F(PipelineExecutorTest, PipeStatusOfBuiltinPipeline) {
+    EXPECT_EQ(run("false | true"), 0);
+    EXPECT_EQ(exitCodes(), (std::vector<int>{1, 0}));
+    EXPECT_EQ(VariableManager::instance().get("PIPESTATUS"), "1 0");
+}
+
+TEST_F(PipelineExecutorTest, ExternalStageIsReapedWithItsStatus) {
+    EXPECT_EQ(run("sh -c \"exit 3\" | true"), 0);
+    EXPECT_EQ(exitCodes(), (std::vector<int>{3, 0}));
+    EXPECT_EQ(PipelineExecutor::lastPipeStatus()[0].termSignal, 0);
+    EXPECT_GT(PipelineExecutor::lastPipeStatus()[0].pid, 0);
+    EXPECT_EQ(VariableManager::instance().get("PIPESTATUS"), "3 0");
+
+    EXPECT_EQ(run("sh -c \"exit 5\""), 5);
+    EXPECT_EQ(exitCodes(), (std::vector<int>{5}));
+}
+
+TEST_F(PipelineExecutorTest, KilledStageReportsItsSignal) {
+    run("sh -c 'kill -TERM $$'");
+    ASSERT_EQ(PipelineExecutor::lastPipeStatus().size(), 1u);
+    EXPECT_EQ(PipelineExecutor::lastPipeStatus()[0].termSignal, SIGTERM);
+    EXPECT_EQ(PipelineExecutor::lastPipeStatus()[0].exitCode, 128 + SIGTERM);
+}
+
+// ============================================================================
+// Here-String and Here-Document Tests
+// ============================================================================
+
+TEST_F(PipelineExecutorTest, HereStringFeedsBuiltin) {
+    EXPECT_EQ(run("cat <<< \"hi there\" > " + out), 0);
+    EXPECT_EQ(output(), "hi there\n");
+}
+
+TEST_F(PipelineExecutorTest, HereStringFeedsExternal) {
+    EXPECT_EQ(run("tr a-z A-Z <<< \"hi there\" > " + out), 0);
+    EXPECT_EQ(output(), "HI THERE\n");
+}
+
+TEST_F(PipelineExecutorTest, HereDocFeedsBuiltin) {
+    std::istringstream body("line one\nline two\nEOF\nafter\n");
+    EXPECT_EQ(run("cat << EOF > " + out, &body), 0);
+    EXPECT_EQ(output(), "line one\nline two\n");
+}
+
+TEST_F(PipelineExecutorTest, HereDocFeedsExternal) {
+    std::istringstream body("a\nc\nb\nEOF\n");
+    EXPECT_EQ(run("sort -r << EOF > " + out, &body), 0);
+    EXPECT_EQ(output(), "c\nb\na\n");
+}
+
+TEST_F(PipelineExecutorTest, HereDocFeedsFirstStageOfPipeline) {
+    std::istringstream body("quiet\nEOF\n");
+    EXPECT_EQ(run("cat << EOF | tr a-z A-Z > " + out, &body), 0);
+    EXPECT_EQ(output(), "QUIET\n");
+}
+
+// ============================================================================
+// Mixed Pipeline Tests
+// ============================================================================
+
+TEST_F(PipelineExecutorTest, BuiltinExternalBuiltinPipeline) {
+    std::ofstream(dir / "in.txt") << "b\na\nc\n";
+    EXPECT_EQ(run("cat " + (dir / "in.txt").string() + " | tr a-z A-Z | sort -r > " + out), 0);
+    EXPECT_EQ(output(), "C\nB\nA\n");
+    EXPECT_EQ(exitCodes(), (std::vector<int>{0, 0, 0}));
+}
+
+TEST_F(PipelineExecutorTest, ExternalBuiltinExternalPipeline) {
+    EXPECT_EQ(run("printf \"x1\\ny2\\ny3\\n\" | grep y | tr y Y > " + out), 0);
+    EXPECT_EQ(output(), "Y2\nY3\n");
+}
+
+TEST_F(PipelineExecutorTest, EarlyExitingReaderDoesNotStallPipeline) {
+    std::ofstream lines(dir / "in.txt");
+    for (int i = 0; i < 100000; ++i) lines << i << "\n";
+    lines.close();
+    EXPECT_EQ(run("cat " + (dir / "in.txt").string() + " | head -n 1 | tr 0 Z > " + out), 0);
+    EXPECT_EQ(output(), "Z\n");
+}
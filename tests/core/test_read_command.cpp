@@ -0,0 +1,109 @@
+/**
+ * @file test_read_command.cpp
+ * @brief Unit tests for the read builtin
+ */
+
+#include <gtest/gtest.h>
+#include "core/ReadCommand.hpp"
+#include "core/VariableManager.hpp"
+#include <sstream>
+
+using namespace termidash;
+
+class ReadCommandTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const char* name : {"RD_A", "RD_B", "RD_C", "REPLY", "IFS"}) VariableManager::instance().unset(name);
+    }
+
+    int read(std::vector<std::string> args) {
+        args.insert(args.begin(), "read");
+        ExecContext ctx(in, out, err);
+        return ReadCommand::run(args, ctx);
+    }
+
+    std::string var(const std::string& name) {
+        return VariableManager::instance().get(name);
+    }
+
+    std::istringstream in;
+    std::ostringstream out, err;
+};
+
+// ============================================================================
+// Splitting Tests
+// ============================================================================
+
+TEST_F(ReadCommandTest, SplitOnWhitespace) {
+    EXPECT_EQ(ReadCommand::split("  a  b\tc  ", {}, " \t\n", 0), (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(ReadCommand::split("  a  b\tc  ", {}, " \t\n", 2), (std::vector<std::string>{"a", "b\tc"}));
+}
+
+TEST_F(ReadCommandTest, SplitOnOtherSeparators) {
+    EXPECT_EQ(ReadCommand::split("a::b", {}, ":", 0), (std::vector<std::string>{"a", "", "b"}));
+    EXPECT_EQ(ReadCommand::split("a : b", {}, ": ", 0), (std::vector<std::string>{"a", "b"}));
+}
+
+TEST_F(ReadCommandTest, LiteralCharactersDoNotSplit) {
+    std::vector<bool> literal = {false, true, false};
+    EXPECT_EQ(ReadCommand::split("a b", literal, " ", 0), (std::vector<std::string>{"a b"}));
+}
+
+// ============================================================================
+// Reading Tests
+// ============================================================================
+
+TEST_F(ReadCommandTest, ConsecutiveReadsShareTheStream) {
+    in.str("one two three\nfour\n");
+    EXPECT_EQ(read({"RD_A", "RD_B"}), 0);
+    EXPECT_EQ(var("RD_A"), "one");
+    EXPECT_EQ(var("RD_B"), "two three");
+    EXPECT_EQ(read({"RD_A", "RD_B"}), 0);
+    EXPECT_EQ(var("RD_A"), "four");
+    EXPECT_EQ(var("RD_B"), "");
+    EXPECT_EQ(read({"RD_A"}), 1);
+}
+
+TEST_F(ReadCommandTest, ReplyKeepsTheWholeRecord) {
+    in.str("  padded  \n");
+    EXPECT_EQ(read({}), 0);
+    EXPECT_EQ(var("REPLY"), "  padded  ");
+}
+
+TEST_F(ReadCommandTest, LastRecordWithoutNewline) {
+    in.str("tail");
+    EXPECT_EQ(read({"RD_A"}), 1);
+    EXPECT_EQ(var("RD_A"), "tail");
+}
+
+TEST_F(ReadCommandTest, BackslashesWithoutRaw) {
+    in.str("a\\ b c\\\nd\n");
+    EXPECT_EQ(read({"RD_A", "RD_B"}), 0);
+    EXPECT_EQ(var("RD_A"), "a b");
+    EXPECT_EQ(var("RD_B"), "cd");
+}
+
+TEST_F(ReadCommandTest, RawKeepsBackslashes) {
+    in.str("a\\ b\\\n");
+    EXPECT_EQ(read({"-r", "RD_A", "RD_B"}), 0);
+    EXPECT_EQ(var("RD_A"), "a\\");
+    EXPECT_EQ(var("RD_B"), "b\\");
+}
+
+TEST_F(ReadCommandTest, Delimiter) {
+    in.str("a b;c");
+    EXPECT_EQ(read({"-d", ";", "RD_A"}), 0);
+    EXPECT_EQ(var("RD_A"), "a b");
+}
+
+TEST_F(ReadCommandTest, ArrayFieldsAndIfs) {
+    VariableManager::instance().set("IFS", ",");
+    in.str("x,y,,z\n");
+    EXPECT_EQ(read({"-a", "RD_C"}), 0);
+    EXPECT_EQ(var("RD_C"), "x y  z");
+}
+
+TEST_F(ReadCommandTest, InvalidOption) {
+    EXPECT_EQ(read({"-q"}), 2);
+    EXPECT_NE(err.str().find("usage"), std::string::npos);
+}
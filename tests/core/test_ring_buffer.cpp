@@ -0,0 +1,152 @@
+/**
+ * @file test_ring_buffer.cpp
+ * @brief Unit tests for CircularBuffer and StreamBridge
+ */
+
+#include <gtest/gtest.h>
+#include "core/RingBuffer.hpp"
+#include "core/ExecContext.hpp"
+#include <sstream>
+#include <numeric>
+#include <thread>
+
+using namespace termidash;
+
+// ============================================================================
+// CircularBuffer Tests
+// ============================================================================
+
+TEST(CircularBufferTest, CapacityIsRoundedToPowerOfTwo) {
+    CircularBuffer ring(5000);
+    EXPECT_EQ(ring.capacity(), 8192);
+    EXPECT_EQ(ring.free_space(), 8192);
+}
+
+TEST(CircularBufferTest, WrapsAround) {
+    CircularBuffer ring(4096);
+    std::string first(3000, 'a');
+    std::string second(3000, 'b');
+    char out[4096];
+
+    ASSERT_EQ(ring.write(first.data(), first.size()), first.size());
+    ASSERT_EQ(ring.read(out, sizeof(out)), first.size());
+    ASSERT_EQ(ring.write(second.data(), second.size()), second.size());
+    EXPECT_EQ(ring.available(), second.size());
+    ASSERT_EQ(ring.read(out, sizeof(out)), second.size());
+    EXPECT_EQ(std::string(out, second.size()), second);
+}
+
+TEST(CircularBufferTest, ReadReturnsZeroWhenClosedAndDrained) {
+    CircularBuffer ring(4096);
+    ring.write("xyz", 3);
+    ring.close();
+    char out[8];
+    EXPECT_EQ(ring.read(out, sizeof(out)), 3);
+    EXPECT_EQ(ring.read(out, sizeof(out)), 0);
+    EXPECT_EQ(ring.write("more", 4), 0);
+}
+
+TEST(CircularBufferTest, ProducerBlocksUntilConsumerDrains) {
+    CircularBuffer ring(4096);
+    std::vector<unsigned char> sent(1 << 20);
+    std::iota(sent.begin(), sent.end(), 0);
+
+    std::thread writer([&]() {
+        ring.write(reinterpret_cast<const char*>(sent.data()), sent.size());
+        ring.close();
+    });
+
+    std::vector<unsigned char> received;
+    char chunk[1000];
+    while (size_t n = ring.read(chunk, sizeof(chunk))) {
+        received.insert(received.end(), chunk, chunk + n);
+    }
+    writer.join();
+    EXPECT_EQ(received, sent);
+}
+
+TEST(CircularBufferTest, CloseReaderUnblocksWriter) {
+    CircularBuffer ring(4096);
+    std::string data(64 * 1024, 'w');
+    size_t written = data.size();
+    std::thread writer([&]() { written = ring.write(data.data(), data.size()); });
+
+    char chunk[100];
+    ASSERT_GT(ring.read(chunk, sizeof(chunk)), 0);
+    ring.closeReader();
+    writer.join();
+    EXPECT_LT(written, data.size());
+    EXPECT_EQ(ring.write("x", 1), 0);
+}
+
+// ============================================================================
+// StreamBridge Tests
+// ============================================================================
+
+TEST(StreamBridgeTest, LinesArriveInOrder) {
+    StreamBridge bridge(4096);
+    std::thread writer([&]() {
+        for (int i = 0; i < 10000; ++i) bridge.out() << "line " << i << '\n';
+        bridge.closeWriter();
+    });
+
+    std::string line;
+    int count = 0;
+    bool inOrder = true;
+    while (std::getline(bridge.in(), line)) {
+        inOrder = inOrder && line == "line " + std::to_string(count);
+        ++count;
+    }
+    writer.join();
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(count, 10000);
+}
+
+TEST(StreamBridgeTest, CloseWriterFlushesBufferedOutput) {
+    StreamBridge bridge;
+    bridge.out() << "partial";
+    EXPECT_EQ(bridge.buffer()->available(), 0);
+    bridge.closeWriter();
+
+    std::string word;
+    bridge.in() >> word;
+    EXPECT_EQ(word, "partial");
+}
+
+TEST(StreamBridgeTest, ClosedReaderCancelsWriter) {
+    StreamBridge bridge(4096);
+    std::istringstream input;
+    ExecContext ctx(input, bridge.out(), std::cerr);
+    ctx.cancel = bridge.buffer()->readerClosedFlag();
+
+    std::thread reader([&]() {
+        std::string line;
+        std::getline(bridge.in(), line);
+        bridge.closeReader();
+    });
+
+    // An endless producer: stops only because the reader went away
+    long lines = 0;
+    while (!ctx.cancelled()) {
+        ctx.out << "line " << lines++ << '\n';
+    }
+    bridge.closeWriter();
+    reader.join();
+    EXPECT_TRUE(ctx.cancelled());
+}
+
+TEST(StreamBridgeTest, LargeBlockReads) {
+    StreamBridge bridge(4096);
+    std::string sent(300 * 1024, 'q');
+    sent.back() = 'z';
+    std::thread writer([&]() {
+        bridge.out().write(sent.data(), sent.size());
+        bridge.closeWriter();
+    });
+
+    std::string received(sent.size() + 10, '\0');
+    bridge.in().read(&received[0], received.size());
+    received.resize(bridge.in().gcount());
+    writer.join();
+    EXPECT_EQ(received, sent);
+}
@@ -0,0 +1,243 @@
+/**
+ * @file test_script_cache.cpp
+ * @brief Unit tests for chunk serialization and the ScriptCache class
+ */
+
+#include <gtest/gtest.h>
+#include "core/ScriptCache.hpp"
+#include "core/BytecodeCompiler.hpp"
+#include "core/ScriptParser.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace termidash;
+namespace fs = std::filesystem;
+
+static bytecode::Chunk compileText(const std::string& text) {
+    std::istringstream in(text);
+    return BytecodeCompiler::compile(ScriptParser::parse(in));
+}
+
+class ScriptCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() /
+               ("termidash_cache_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(root);
+        fs::create_directories(root);
+        script = (root / "script.tdsh").string();
+        cacheDir = (root / "cache").string();
+    }
+
+    void TearDown() override {
+        fs::remove_all(root);
+    }
+
+    void writeScript(const std::string& text) {
+        std::ofstream out(script, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+
+    fs::path root;
+    std::string script;
+    std::string cacheDir;
+};
+
+// ============================================================================
+// Serialization Tests
+// ============================================================================
+
+TEST(BytecodeSerializeTest, RoundTripKeepsListing) {
+    auto chunk = compileText("for i in 1 2\nif test $i\necho $i\nelse\necho no\nend\nend\n");
+    std::string data = bytecode::serialize(chunk);
+
+    bytecode::Chunk decoded;
+    ASSERT_TRUE(bytecode::deserialize(data.data(), data.size(), decoded));
+    EXPECT_EQ(bytecode::disassemble(decoded), bytecode::disassemble(chunk));
+    EXPECT_EQ(decoded.strings, chunk.strings);
+}
+
+TEST(BytecodeSerializeTest, RoundTripNestedFunctions) {
+    auto chunk = compileText("function outer\nfunction inner\necho deep\nend\ninner\nend\n");
+    std::string data = bytecode::serialize(chunk);
+
+    bytecode::Chunk decoded;
+    ASSERT_TRUE(bytecode::deserialize(data.data(), data.size(), decoded));
+    ASSERT_EQ(decoded.functions.size(), 1);
+    ASSERT_TRUE(decoded.functions[0].body);
+    EXPECT_EQ(decoded.functions[0].source.size(), chunk.functions[0].source.size());
+    ASSERT_EQ(decoded.functions[0].body->functions.size(), 1);
+    EXPECT_EQ(bytecode::disassemble(*decoded.functions[0].body->functions[0].body),
+              bytecode::disassemble(*chunk.functions[0].body->functions[0].body));
+}
+
+TEST(BytecodeSerializeTest, RoundTripKeepsStages) {
+    auto chunk = compileText("grep -v x < in |> sort 2>> err >&2\n");
+    std::string data = bytecode::serialize(chunk);
+
+    bytecode::Chunk decoded;
+    ASSERT_TRUE(bytecode::deserialize(data.data(), data.size(), decoded));
+    ASSERT_EQ(decoded.stages.size(), 2u);
+    EXPECT_EQ(decoded.stages[0].words, chunk.stages[0].words);
+    EXPECT_TRUE(decoded.stages[0].trimAfter);
+    ASSERT_EQ(decoded.stages[1].redirections.size(), 2u);
+    EXPECT_EQ(decoded.stages[1].redirections[0].kind, ast::RedirectKind::ErrorAppend);
+    EXPECT_EQ(decoded.stages[1].redirections[0].target, "err");
+    EXPECT_EQ(decoded.stages[1].redirections[1].kind, ast::RedirectKind::OutputToError);
+    EXPECT_EQ(bytecode::disassemble(decoded), bytecode::disassemble(chunk));
+}
+
+TEST(BytecodeSerializeTest, RejectsTruncatedData) {
+    std::string data = bytecode::serialize(compileText("echo a\necho b\n"));
+    bytecode::Chunk decoded;
+    for (size_t size = 0; size < data.size(); ++size) {
+        EXPECT_FALSE(bytecode::deserialize(data.data(), size, decoded)) << "size " << size;
+    }
+}
+
+TEST(BytecodeSerializeTest, RejectsOutOfRangeOperands) {
+    bytecode::Chunk chunk;
+    chunk.code.push_back({bytecode::OpCode::Jump, 7});
+    chunk.code.push_back({bytecode::OpCode::Halt});
+    std::string data = bytecode::serialize(chunk);
+
+    bytecode::Chunk decoded;
+    EXPECT_FALSE(bytecode::deserialize(data.data(), data.size(), decoded));
+
+    chunk.code[0] = {bytecode::OpCode::Stage, 0};
+    data = bytecode::serialize(chunk);
+    EXPECT_FALSE(bytecode::deserialize(data.data(), data.size(), decoded));
+}
+
+// ============================================================================
+// Cache Tests
+// ============================================================================
+
+TEST_F(ScriptCacheTest, MissThenHit) {
+    writeScript("echo hello\n");
+    ScriptCache cache(cacheDir);
+
+    auto first = cache.load(script);
+    ASSERT_TRUE(first);
+    EXPECT_FALSE(cache.lastLoadWasHit());
+    EXPECT_TRUE(fs::exists(cache.entryPath(script)));
+
+    auto second = cache.load(script);
+    ASSERT_TRUE(second);
+    EXPECT_TRUE(cache.lastLoadWasHit());
+    EXPECT_EQ(bytecode::disassemble(*second), bytecode::disassemble(*first));
+}
+
+TEST_F(ScriptCacheTest, ContentChangeInvalidates) {
+    writeScript("echo aaa\n");
+    ScriptCache cache(cacheDir);
+    cache.load(script);
+    auto mtime = fs::last_write_time(script);
+
+    // Same size and mtime, different bytes
+    writeScript("echo bbb\n");
+    fs::last_write_time(script, mtime);
+
+    auto chunk = cache.load(script);
+    ASSERT_TRUE(chunk);
+    EXPECT_FALSE(cache.lastLoadWasHit());
+    ASSERT_EQ(chunk->stages.size(), 1u);
+    EXPECT_EQ(chunk->stages[0].words, (std::vector<std::string>{"echo", "bbb"}));
+}
+
+TEST_F(ScriptCacheTest, MtimeChangeInvalidates) {
+    writeScript("echo same\n");
+    ScriptCache cache(cacheDir);
+    cache.load(script);
+
+    fs::last_write_time(script, fs::last_write_time(script) + std::chrono::seconds(5));
+    cache.load(script);
+    EXPECT_FALSE(cache.lastLoadWasHit());
+
+    cache.load(script);
+    EXPECT_TRUE(cache.lastLoadWasHit());
+}
+
+TEST_F(ScriptCacheTest, CorruptEntryIsRecompiled) {
+    writeScript("echo fine\n");
+    ScriptCache cache(cacheDir);
+    cache.load(script);
+
+    std::string entry = cache.entryPath(script);
+    auto size = fs::file_size(entry);
+    fs::resize_file(entry, size - 3);
+
+    auto chunk = cache.load(script);
+    ASSERT_TRUE(chunk);
+    EXPECT_FALSE(cache.lastLoadWasHit());
+
+    cache.load(script);
+    EXPECT_TRUE(cache.lastLoadWasHit());
+}
+
+TEST_F(ScriptCacheTest, OtherCompilerRevisionIsRecompiled) {
+    writeScript("echo old\n");
+    ScriptCache cache(cacheDir);
+    cache.load(script);
+
+    // The revision follows magic, format version and flags in the header
+    std::string entry = cache.entryPath(script);
+    {
+        std::fstream file(entry, std::ios::binary | std::ios::in | std::ios::out);
+        uint32_t revision = BytecodeCompiler::Revision - 1;
+        file.seekp(12);
+        file.write(reinterpret_cast<const char*>(&revision), sizeof(revision));
+    }
+
+    ASSERT_TRUE(cache.load(script));
+    EXPECT_FALSE(cache.lastLoadWasHit());
+
+    cache.load(script);
+    EXPECT_TRUE(cache.lastLoadWasHit());
+}
+
+TEST_F(ScriptCacheTest, MissingScriptReturnsNull) {
+    ScriptCache cache(cacheDir);
+    EXPECT_FALSE(cache.load((root / "missing.tdsh").string()));
+}
+
+TEST_F(ScriptCacheTest, EmptyDirectoryDisablesStoring) {
+    writeScript("echo x\n");
+    ScriptCache cache("");
+    ASSERT_TRUE(cache.load(script));
+    ASSERT_TRUE(cache.load(script));
+    EXPECT_FALSE(cache.lastLoadWasHit());
+}
+
+// ============================================================================
+// Precompiled File Tests
+// ============================================================================
+
+TEST_F(ScriptCacheTest, CompileFileRoundTrip) {
+    writeScript("function greet\necho hi $1\nend\ngreet you\n");
+    std::string output = (root / "script.tdc").string();
+
+    ASSERT_TRUE(ScriptCache::compileFile(script, output));
+    EXPECT_TRUE(ScriptCache::isCompiledPath(output));
+    EXPECT_FALSE(ScriptCache::isCompiledPath(script));
+
+    // A precompiled file no longer depends on its source
+    fs::remove(script);
+    auto chunk = ScriptCache::loadCompiled(output);
+    ASSERT_TRUE(chunk);
+    EXPECT_EQ(bytecode::disassemble(*chunk),
+              bytecode::disassemble(compileText("function greet\necho hi $1\nend\ngreet you\n")));
+}
+
+TEST_F(ScriptCacheTest, CacheEntryIsNotAStandaloneFile) {
+    writeScript("echo x\n");
+    ScriptCache cache(cacheDir);
+    cache.load(script);
+
+    testing::internal::CaptureStderr();
+    EXPECT_FALSE(ScriptCache::loadCompiled(cache.entryPath(script)));
+    EXPECT_NE(testing::internal::GetCapturedStderr().find("Invalid compiled script"), std::string::npos);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file test_script_parser.cpp
+ * @brief Unit tests for the ScriptParser class
+ */
+
+#include <gtest/gtest.h>
+#include "core/ScriptParser.hpp"
+#include <sstream>
+
+using namespace termidash;
+
+static ast::NodeList parseText(const std::string& text) {
+    std::istringstream in(text);
+    return ScriptParser::parse(in);
+}
+
+// ============================================================================
+// Simple Command Tests
+// ============================================================================
+
+TEST(ScriptParserTest, SingleCommand) {
+    auto nodes = parseText("echo hello\n");
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0].kind, ast::NodeKind::Command);
+    EXPECT_EQ(nodes[0].text, "echo hello");
+    EXPECT_EQ(nodes[0].separator, "");
+}
+
+TEST(ScriptParserTest, BatchKeepsSeparators) {
+    auto nodes = parseText("a && b || c; d\n");
+    ASSERT_EQ(nodes.size(), 4);
+    EXPECT_EQ(nodes[0].separator, "&&");
+    EXPECT_EQ(nodes[1].separator, "||");
+    EXPECT_EQ(nodes[2].separator, ";");
+    EXPECT_EQ(nodes[3].separator, "");
+}
+
+TEST(ScriptParserTest, SkipsCommentsAndBlankLines) {
+    auto nodes = parseText("# comment\n\n   \necho hi\n");
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0].text, "echo hi");
+}
+
+// ============================================================================
+// Block Tests
+// ============================================================================
+
+TEST(ScriptParserTest, IfElseBlock) {
+    auto nodes = parseText("if test 1\necho yes\nelse\necho no\nend\n");
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0].kind, ast::NodeKind::If);
+    EXPECT_EQ(nodes[0].text, "test 1");
+    ASSERT_EQ(nodes[0].body.size(), 1);
+    EXPECT_EQ(nodes[0].body[0].text, "echo yes");
+    ASSERT_EQ(nodes[0].elseBody.size(), 1);
+    EXPECT_EQ(nodes[0].elseBody[0].text, "echo no");
+}
+
+TEST(ScriptParserTest, NestedLoops) {
+    auto nodes = parseText("for i in 1 2\nwhile false\necho $i\nend\nend\n");
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0].kind, ast::NodeKind::For);
+    EXPECT_EQ(nodes[0].loopVar, "i");
+    EXPECT_EQ(nodes[0].items, (std::vector<std::string>{"1", "2"}));
+    ASSERT_EQ(nodes[0].body.size(), 1);
+    EXPECT_EQ(nodes[0].body[0].kind, ast::NodeKind::While);
+    ASSERT_EQ(nodes[0].body[0].body.size(), 1);
+}
+
+TEST(ScriptParserTest, CommandIsParsedIntoStages) {
+    auto nodes = parseText("grep -v x < in.txt | sort -r > \"out file\" 2>&1 &\n");
+    ASSERT_EQ(nodes.size(), 1);
+    const ast::Pipeline& pipeline = nodes[0].pipeline;
+    EXPECT_TRUE(pipeline.background);
+    ASSERT_EQ(pipeline.stages.size(), 2);
+    EXPECT_EQ(pipeline.stages[0].words, (std::vector<std::string>{"grep", "-v", "x"}));
+    ASSERT_EQ(pipeline.stages[0].redirections.size(), 1);
+    EXPECT_EQ(pipeline.stages[0].redirections[0].kind, ast::RedirectKind::Input);
+    EXPECT_EQ(pipeline.stages[0].redirections[0].target, "in.txt");
+    EXPECT_EQ(pipeline.stages[1].words, (std::vector<std::string>{"sort", "-r"}));
+    ASSERT_EQ(pipeline.stages[1].redirections.size(), 2);
+    EXPECT_EQ(pipeline.stages[1].redirections[0].target, "\"out file\"");
+    EXPECT_EQ(pipeline.stages[1].redirections[1].kind, ast::RedirectKind::ErrorToOutput);
+}
+
+TEST(ScriptParserTest, ConditionIsParsedIntoStages) {
+    auto nodes = parseText("while test -f lock\nsleep 1\nend\n");
+    ASSERT_EQ(nodes.size(), 1);
+    ASSERT_EQ(nodes[0].pipeline.stages.size(), 1);
+    EXPECT_EQ(nodes[0].pipeline.stages[0].words, (std::vector<std::string>{"test", "-f", "lock"}));
+}
+
+TEST(ScriptParserTest, SingleLineBlock) {
+    auto nodes = parseText("if true; echo a && echo b; end\n");
+    ASSERT_EQ(nodes.size(), 1);
+    ASSERT_EQ(nodes[0].body.size(), 2);
+    EXPECT_EQ(nodes[0].body[0].separator, "&&");
+}
+
+TEST(ScriptParserTest, FunctionKeepsSource) {
+    auto nodes = parseText("function greet\necho hello\nif true\necho x\nend\nend\n");
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0].kind, ast::NodeKind::Function);
+    EXPECT_EQ(nodes[0].text, "greet");
+    EXPECT_EQ(nodes[0].body.size(), 2);
+    ASSERT_EQ(nodes[0].source.size(), 4);
+    EXPECT_EQ(nodes[0].source[0], "echo hello");
+    EXPECT_EQ(nodes[0].source[3], "end");
+}
+
+TEST(ScriptParserTest, ParenFunctionStyle) {
+    auto nodes = parseText("greet() {\necho hello\n}\n");
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0].kind, ast::NodeKind::Function);
+    EXPECT_EQ(nodes[0].text, "greet");
+}
+
+// ============================================================================
+// Incremental Feed Tests
+// ============================================================================
+
+TEST(ScriptParserTest, FeedEmitsOnlyCompletedStatements) {
+    ScriptParser parser;
+    ast::NodeList out;
+    parser.feed("while true", out);
+    EXPECT_TRUE(out.empty());
+    EXPECT_TRUE(parser.needsMoreInput());
+    parser.feed("echo loop", out);
+    EXPECT_TRUE(out.empty());
+    parser.feed("end", out);
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_FALSE(parser.needsMoreInput());
+}
+
+TEST(ScriptParserTest, FinishDropsUnterminatedBlock) {
+    ScriptParser parser;
+    ast::NodeList out;
+    parser.feed("if true", out);
+    parser.finish(out);
+    EXPECT_TRUE(out.empty());
+    EXPECT_FALSE(parser.needsMoreInput());
+}
+
+// ============================================================================
+// Here-Document Tests
+// ============================================================================
+
+TEST(ScriptParserTest, HereDocBodyCollected) {
+    auto nodes = parseText("cat << EOF\nline one\n  line two\nEOF\necho after\n");
+    ASSERT_EQ(nodes.size(), 2);
+    EXPECT_TRUE(nodes[0].hasHereDoc);
+    EXPECT_EQ(nodes[0].hereDoc, "line one\n  line two\n");
+    EXPECT_EQ(nodes[1].text, "echo after");
+}
+
+TEST(ScriptParserTest, HereDocLinesAreNotParsed) {
+    ScriptParser parser;
+    ast::NodeList out;
+    parser.feed("cat << END", out);
+    EXPECT_TRUE(parser.inHereDoc());
+    parser.feed("if this were code", out);
+    parser.feed("# not a comment", out);
+    parser.feed("END", out);
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].hereDoc, "if this were code\n# not a comment\n");
+    EXPECT_FALSE(parser.needsMoreInput());
+}
+
+TEST(ScriptParserTest, HereDocInsideLoop) {
+    auto nodes = parseText("for i in 1 2\ncat << EOF\nbody\nEOF\nend\n");
+    ASSERT_EQ(nodes.size(), 1);
+    ASSERT_EQ(nodes[0].body.size(), 1);
+    EXPECT_EQ(nodes[0].body[0].hereDoc, "body\n");
+}
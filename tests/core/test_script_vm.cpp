@@ -0,0 +1,175 @@
+/**
+ * @file test_script_vm.cpp
+ * @brief Unit tests for the ScriptVM class
+ */
+
+#include <gtest/gtest.h>
+#include "core/ScriptVM.hpp"
+#include "core/AliasManager.hpp"
+#include "core/BytecodeCompiler.hpp"
+#include "core/ScriptParser.hpp"
+#include "core/FunctionManager.hpp"
+#include "core/VariableManager.hpp"
+#include "core/WordExpander.hpp"
+#include <algorithm>
+#include <sstream>
+
+using namespace termidash;
+
+// Records executed commands; "true"/"false" set the status,
+// expansion uses the shell's WordExpander
+class RecordingHost : public ScriptVM::Host {
+public:
+    std::vector<std::string> executed;
+
+    void expand(const ast::Stage& stage, ExpandedCommand& out, bool command) override {
+        expander.expandStage(stage, out, command);
+    }
+
+    int execute(const ExpandedCommand& command, const std::string* hereDoc, bool background) override {
+        std::string text = command.text();
+        if (background) text += " &";
+        executed.push_back(hereDoc ? text + " <<" + *hereDoc : text);
+        return status(text);
+    }
+
+    int run(const ExpandedCommand& command) override {
+        std::string text = command.text();
+        executed.push_back("?" + text);
+        return status(text);
+    }
+
+private:
+    int status(const std::string& command) {
+        if (command == "false") return 1;
+        if (command.rfind("countdown", 0) == 0) {
+            int n = std::stoi(VariableManager::instance().get("n"));
+            if (n <= 0) return 1;
+            VariableManager::instance().set("n", std::to_string(n - 1));
+        }
+        return 0;
+    }
+
+    WordExpander expander;
+};
+
+class ScriptVMTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto all = FunctionManager::instance().getAll();
+        for (const auto& pair : all) {
+            FunctionManager::instance().unset(pair.first);
+        }
+    }
+
+    int runText(const std::string& text) {
+        std::istringstream in(text);
+        ScriptVM vm(host);
+        return vm.run(BytecodeCompiler::compile(ScriptParser::parse(in)));
+    }
+
+    RecordingHost host;
+};
+
+TEST_F(ScriptVMTest, RunsCommandsInOrder) {
+    runText("a\nb\n");
+    ASSERT_EQ(host.executed.size(), 2);
+    EXPECT_EQ(host.executed[0], "a");
+    EXPECT_EQ(host.executed[1], "b");
+}
+
+TEST_F(ScriptVMTest, AndOrShortCircuit) {
+    int status = runText("false && skipped || recovered; after\n");
+    std::vector<std::string> expected = {"false", "recovered", "after"};
+    EXPECT_EQ(host.executed, expected);
+    EXPECT_EQ(status, 0);
+}
+
+TEST_F(ScriptVMTest, IfElse) {
+    runText("if false\nthen-branch\nelse\nelse-branch\nend\n");
+    std::vector<std::string> expected = {"?false", "else-branch"};
+    EXPECT_EQ(host.executed, expected);
+}
+
+TEST_F(ScriptVMTest, IfWithoutElseReturnsZero) {
+    EXPECT_EQ(runText("if false\nx\nend\n"), 0);
+}
+
+TEST_F(ScriptVMTest, ForLoopSetsVariable) {
+    runText("for item in a b c\nuse $item\nend\n");
+    std::vector<std::string> expected = {"use a", "use b", "use c"};
+    EXPECT_EQ(host.executed, expected);
+}
+
+TEST_F(ScriptVMTest, ForLoopItemsAreNotAliases) {
+    AliasManager::instance().set("vm_alias", "ls -l");
+    runText("for item in vm_alias b\nvm_alias $item\nend\n");
+    AliasManager::instance().unset("vm_alias");
+    std::vector<std::string> expected = {"ls -l vm_alias", "ls -l b"};
+    EXPECT_EQ(host.executed, expected);
+}
+
+TEST_F(ScriptVMTest, WhileLoopRunsUntilConditionFails) {
+    VariableManager::instance().set("n", "3");
+    int status = runText("while countdown\nbody\nend\n");
+    EXPECT_EQ(std::count(host.executed.begin(), host.executed.end(), "body"), 3);
+    EXPECT_EQ(status, 0);
+}
+
+TEST_F(ScriptVMTest, WhileLoopHasNoDefaultLimit) {
+    VariableManager::instance().set("n", "20000");
+    runText("while countdown\nbody\nend\n");
+    EXPECT_EQ(std::count(host.executed.begin(), host.executed.end(), "body"), 20000);
+}
+
+TEST_F(ScriptVMTest, WhileLoopLimitIsConfigurable) {
+    ScriptVM vm(host);
+    vm.setMaxWhileIterations(5);
+    std::istringstream in("while true\nend\n");
+    testing::internal::CaptureStderr();
+    vm.run(BytecodeCompiler::compile(ScriptParser::parse(in)));
+    std::string warning = testing::internal::GetCapturedStderr();
+    EXPECT_EQ(host.executed.size(), 5u);
+    EXPECT_NE(warning.find("5 iterations"), std::string::npos);
+}
+
+TEST_F(ScriptVMTest, FunctionCallWithArguments) {
+    runText("function greet\nhello $1 $2\nend\ngreet world \"two words\"\n");
+    ASSERT_EQ(host.executed.size(), 1);
+    EXPECT_EQ(host.executed[0], "hello world two words");
+}
+
+TEST_F(ScriptVMTest, FunctionDefinedFromSourceLines) {
+    FunctionManager::instance().define("legacy", {"inner $1"});
+    runText("legacy x\n");
+    ASSERT_EQ(host.executed.size(), 1);
+    EXPECT_EQ(host.executed[0], "inner x");
+    EXPECT_NE(FunctionManager::instance().getCompiled("legacy"), nullptr);
+}
+
+TEST_F(ScriptVMTest, NestedFunctionLoopsUnwindOnReturn) {
+    runText("function f\nfor i in 1 2\nstep $i\nend\nend\nfor j in a b\nf\nend\n");
+    EXPECT_EQ(host.executed.size(), 4);
+}
+
+TEST_F(ScriptVMTest, HereDocPassedToExec) {
+    runText("cat << EOF\nbody\nEOF\n");
+    ASSERT_EQ(host.executed.size(), 1);
+    EXPECT_EQ(host.executed[0], "cat << EOF <<body\n");
+}
+
+TEST_F(ScriptVMTest, PipelineReachesHostAsStages) {
+    VariableManager::instance().set("vm_word", "a b");
+    runText("echo $vm_word | wc -w > \"$vm_word\" &\n");
+    VariableManager::instance().unset("vm_word");
+    ASSERT_EQ(host.executed.size(), 1);
+    EXPECT_EQ(host.executed[0], "echo a b | wc -w > a b &");
+}
+
+TEST_F(ScriptVMTest, ProfileCountsCommands) {
+    std::istringstream in("a\nb\n");
+    ScriptVM vm(host);
+    vm.run(BytecodeCompiler::compile(ScriptParser::parse(in)));
+    EXPECT_EQ(vm.profile().commands, 2u);
+    EXPECT_GT(vm.profile().instructions, 2u);
+}
@@ -0,0 +1,198 @@
+/**
+ * @file test_sort_command.cpp
+ * @brief Unit tests for the sort builtin
+ */
+
+#include <gtest/gtest.h>
+#include "core/SortCommand.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class SortCommandTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempDir = fs::temp_directory_path() / "termidash_sort_test";
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override {
+        fs::remove_all(tempDir);
+    }
+
+    std::string sort(const std::string& input, std::vector<std::string> args = {}) {
+        args.insert(args.begin(), "sort");
+        std::istringstream in(input);
+        std::ostringstream out;
+        err.str("");
+        ExecContext ctx(in, out, err);
+        status = SortCommand::run(args, ctx);
+        return out.str();
+    }
+
+    bool tempDirEmpty() const {
+        return fs::is_empty(tempDir);
+    }
+
+    static int compare(const char* a, const char* b) {
+        int diff = SortCommand::compareNumbers(a, a + std::strlen(a), b, b + std::strlen(b));
+        return diff < 0 ? -1 : diff > 0 ? 1 : 0;
+    }
+
+    fs::path tempDir;
+    std::ostringstream err;
+    int status = -1;
+};
+
+// ============================================================================
+// Ordering Tests
+// ============================================================================
+
+TEST_F(SortCommandTest, SortsBytewise) {
+    EXPECT_EQ(sort("pear\napple\nBanana\napple pie\n"), "Banana\napple\napple pie\npear\n");
+    EXPECT_EQ(status, 0);
+}
+
+TEST_F(SortCommandTest, AddsMissingNewline) {
+    EXPECT_EQ(sort("b\na"), "a\nb\n");
+    EXPECT_EQ(sort(""), "");
+}
+
+TEST_F(SortCommandTest, ComparesLongSharedPrefixes) {
+    EXPECT_EQ(sort("abcdefghZ\nabcdefgh\nabcdefghA\n"), "abcdefgh\nabcdefghA\nabcdefghZ\n");
+}
+
+TEST_F(SortCommandTest, Reverse) {
+    EXPECT_EQ(sort("b\nc\na\n", {"-r"}), "c\nb\na\n");
+}
+
+TEST_F(SortCommandTest, Numeric) {
+    EXPECT_EQ(sort("10\n9\n-3\n2.5\nx\n  7\n", {"-n"}), "-3\nx\n2.5\n  7\n9\n10\n");
+    EXPECT_EQ(sort("1\n3\n2\n", {"-nr"}), "3\n2\n1\n");
+}
+
+TEST_F(SortCommandTest, NumberComparison) {
+    EXPECT_EQ(compare("2", "10"), -1);
+    EXPECT_EQ(compare("-2", "-10"), 1);
+    EXPECT_EQ(compare("007", "7"), 0);
+    EXPECT_EQ(compare("1.50", "1.5"), 0);
+    EXPECT_EQ(compare("1.05", "1.5"), -1);
+    EXPECT_EQ(compare("-0", "0"), 0);
+    EXPECT_EQ(compare("abc", "0"), 0);
+    EXPECT_EQ(compare("-.5", "0"), -1);
+    EXPECT_EQ(compare("123456789012345678901234567890", "123456789012345678901234567891"), -1);
+}
+
+TEST_F(SortCommandTest, Unique) {
+    EXPECT_EQ(sort("b\na\nb\na\nc\n", {"-u"}), "a\nb\nc\n");
+    // Equal keys: the first line in input order is kept
+    EXPECT_EQ(sort("1 z\n2 y\n1 x\n", {"-u", "-k1,1"}), "1 z\n2 y\n");
+}
+
+// ============================================================================
+// Key Tests
+// ============================================================================
+
+TEST_F(SortCommandTest, KeyWithSeparator) {
+    EXPECT_EQ(sort("a,3\nb,1\nc,2\n", {"-t", ",", "-k", "2"}), "b,1\nc,2\na,3\n");
+    EXPECT_EQ(sort("a:10\nb:9\n", {"-t:", "-k2n"}), "b:9\na:10\n");
+}
+
+TEST_F(SortCommandTest, KeyOnBlankSeparatedFields) {
+    // A field includes the blanks before it unless -b is given
+    EXPECT_EQ(sort("x  b 2\ny a 1\nz  c 0\n", {"-k2,2"}), "x  b 2\nz  c 0\ny a 1\n");
+    EXPECT_EQ(sort("x  b 2\ny a 1\nz  c 0\n", {"-b", "-k2,2"}), "y a 1\nx  b 2\nz  c 0\n");
+    EXPECT_EQ(sort("x 1 b\ny 1 a\nz 0 c\n", {"-k2,2n", "-k3"}), "z 0 c\ny 1 a\nx 1 b\n");
+}
+
+TEST_F(SortCommandTest, KeyModifiersOverrideGlobalOptions) {
+    EXPECT_EQ(sort("a 2\nb 10\nc 1\n", {"-r", "-k2n"}), "c 1\na 2\nb 10\n");
+    EXPECT_EQ(sort("a 2\nb 10\nc 1\n", {"-r", "-n", "-k2"}), "b 10\na 2\nc 1\n");
+}
+
+TEST_F(SortCommandTest, KeyCharacterPositions) {
+    EXPECT_EQ(sort("xb\nya\nzc\n", {"-k1.2"}), "ya\nxb\nzc\n");
+    EXPECT_EQ(sort("abz\naby\nacx\n", {"-k1.1,1.2", "-k1.3"}), "aby\nabz\nacx\n");
+}
+
+TEST_F(SortCommandTest, EqualKeysFallBackToWholeLine) {
+    EXPECT_EQ(sort("1 b\n1 a\n0 c\n", {"-k1,1"}), "0 c\n1 a\n1 b\n");
+}
+
+// ============================================================================
+// Usage Tests
+// ============================================================================
+
+TEST_F(SortCommandTest, UsageErrors) {
+    sort("", {"-k", "0"});
+    EXPECT_EQ(status, 2);
+    sort("", {"-t", "ab"});
+    EXPECT_EQ(status, 2);
+    sort("", {"-q"});
+    EXPECT_EQ(status, 2);
+    sort("", {"-S", "10X"});
+    EXPECT_EQ(status, 2);
+    sort("", {"/no/such/file"});
+    EXPECT_EQ(status, 2);
+    EXPECT_NE(err.str().find("No such file"), std::string::npos);
+}
+
+TEST_F(SortCommandTest, FilesAndStandardInput) {
+    fs::path file = tempDir / "input.txt";
+    {
+        std::ofstream(file) << "c\na\n";
+    }
+    EXPECT_EQ(sort("b\n", {file.string(), "-"}), "a\nb\nc\n");
+    fs::remove(file);
+}
+
+// ============================================================================
+// External Merge Tests
+// ============================================================================
+
+TEST_F(SortCommandTest, SpillsAndMergesRuns) {
+    std::vector<std::string> lines;
+    std::mt19937 random(42);
+    for (int i = 0; i < 5000; ++i) lines.push_back(std::to_string(random() % 100000));
+    std::string input;
+    for (const auto& line : lines) input += line + "\n";
+    std::sort(lines.begin(), lines.end());
+    std::string expected;
+    for (const auto& line : lines) expected += line + "\n";
+
+    // 1 KiB chunks make a few hundred runs, so several merge passes
+    EXPECT_EQ(sort(input, {"-S", "1K", "-T", tempDir.string()}), expected);
+    EXPECT_EQ(status, 0);
+    EXPECT_TRUE(tempDirEmpty());
+}
+
+TEST_F(SortCommandTest, UniqueAcrossRuns) {
+    std::string input;
+    for (int i = 0; i < 3000; ++i) input += std::to_string(i % 7) + " " + std::to_string(i) + "\n";
+    EXPECT_EQ(sort(input, {"-u", "-k1,1", "-S", "512b", "-T", tempDir.string()}), "0 0\n1 1\n2 2\n3 3\n4 4\n5 5\n6 6\n");
+    EXPECT_TRUE(tempDirEmpty());
+}
+
+TEST_F(SortCommandTest, ParallelPiecesMatchSingleThread) {
+    std::string input;
+    std::mt19937 random(7);
+    for (int i = 0; i < 100000; ++i) input += std::to_string(random() % 1000) + "\t" + std::to_string(random()) + "\n";
+    std::string single = sort(input, {"--parallel=1", "-n", "-k2"});
+    EXPECT_EQ(sort(input, {"--parallel=4", "-n", "-k2"}), single);
+    EXPECT_EQ(sort(input, {"--parallel=4", "-n", "-k2", "-S", "64K", "-T", tempDir.string()}), single);
+}
+
+TEST_F(SortCommandTest, NumericBeyondDoublePrecision) {
+    std::string big(400, '9');
+    std::string input = "1" + std::string(400, '0') + "\n" + big + "\n" +
+                        "9007199254740993\n9007199254740992\n0.000000000000000000001\n-0.1\n0.0000000000000000000009\n";
+    std::string expected = "-0.1\n0.0000000000000000000009\n0.000000000000000000001\n9007199254740992\n9007199254740993\n" +
+                           big + "\n1" + std::string(400, '0') + "\n";
+    EXPECT_EQ(sort(input, {"-n"}), expected);
+}
@@ -0,0 +1,160 @@
+/**
+ * @file test_test_command.cpp
+ * @brief Unit tests for the test, [ and [[ builtins
+ */
+
+#include <gtest/gtest.h>
+#include "core/TestCommand.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class TestCommandTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::create_directories(dir);
+        std::ofstream(dir / "full.txt") << "data";
+        std::ofstream(dir / "empty.txt");
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+
+    int run(std::vector<std::string> args) {
+        err.str("");
+        return TestCommand::run(args, err);
+    }
+
+    std::string path(const std::string& name) {
+        return (dir / name).string();
+    }
+
+    fs::path dir = fs::temp_directory_path() / "termidash_test_command";
+    std::ostringstream err;
+};
+
+// ============================================================================
+// String and Integer Tests
+// ============================================================================
+
+TEST_F(TestCommandTest, Strings) {
+    EXPECT_EQ(run({"test", "abc"}), 0);
+    EXPECT_EQ(run({"test", ""}), 1);
+    EXPECT_EQ(run({"test"}), 1);
+    EXPECT_EQ(run({"[", "-z", "", "]"}), 0);
+    EXPECT_EQ(run({"[", "-n", "", "]"}), 1);
+    EXPECT_EQ(run({"[", "a", "=", "a", "]"}), 0);
+    EXPECT_EQ(run({"[", "a", "!=", "a", "]"}), 1);
+    EXPECT_EQ(run({"[", "a", "<", "b", "]"}), 0);
+}
+
+TEST_F(TestCommandTest, OperatorsAsOperands) {
+    // A lone operator word is just a non-empty string
+    EXPECT_EQ(run({"[", "-n", "]"}), 0);
+    EXPECT_EQ(run({"[", "!", "]"}), 0);
+    EXPECT_EQ(run({"[", "-n", "=", "-n", "]"}), 0);
+    EXPECT_EQ(run({"[", "!", "=", "!", "]"}), 0);
+}
+
+TEST_F(TestCommandTest, Integers) {
+    EXPECT_EQ(run({"test", "10", "-gt", "9"}), 0);
+    EXPECT_EQ(run({"test", "-3", "-lt", "2"}), 0);
+    EXPECT_EQ(run({"test", "5", "-eq", "05"}), 0);
+    EXPECT_EQ(run({"test", "5", "-ne", "5"}), 1);
+    EXPECT_EQ(run({"test", "x", "-eq", "1"}), 2);
+    EXPECT_NE(err.str().find("integer expression expected"), std::string::npos);
+}
+
+TEST_F(TestCommandTest, Combinators) {
+    EXPECT_EQ(run({"test", "!", "a", "=", "b"}), 0);
+    EXPECT_EQ(run({"test", "1", "-eq", "1", "-a", "2", "-eq", "3"}), 1);
+    EXPECT_EQ(run({"test", "1", "-eq", "2", "-o", "2", "-eq", "2"}), 0);
+    EXPECT_EQ(run({"test", "(", "a", "=", "b", ")", "-o", "x"}), 0);
+    EXPECT_EQ(run({"test", "(", "a", "=", "a"}), 2);
+}
+
+TEST_F(TestCommandTest, MissingCloseBracket) {
+    EXPECT_EQ(run({"[", "a", "=", "a"}), 2);
+    EXPECT_EQ(run({"[[", "a", "]"}), 2);
+    EXPECT_NE(err.str().find("missing"), std::string::npos);
+}
+
+// ============================================================================
+// File Tests
+// ============================================================================
+
+TEST_F(TestCommandTest, FilePredicates) {
+    EXPECT_EQ(run({"test", "-e", path("full.txt")}), 0);
+    EXPECT_EQ(run({"test", "-f", path("full.txt")}), 0);
+    EXPECT_EQ(run({"test", "-d", path("full.txt")}), 1);
+    EXPECT_EQ(run({"test", "-d", dir.string()}), 0);
+    EXPECT_EQ(run({"test", "-s", path("full.txt")}), 0);
+    EXPECT_EQ(run({"test", "-s", path("empty.txt")}), 1);
+    EXPECT_EQ(run({"test", "-r", path("full.txt")}), 0);
+    EXPECT_EQ(run({"test", "-e", path("missing")}), 1);
+    EXPECT_EQ(run({"test", "-f", path("missing")}), 1);
+}
+
+TEST_F(TestCommandTest, FileComparisons) {
+    EXPECT_EQ(run({"test", path("full.txt"), "-ef", path("full.txt")}), 0);
+    EXPECT_EQ(run({"test", path("full.txt"), "-ef", path("empty.txt")}), 1);
+    EXPECT_EQ(run({"test", path("full.txt"), "-nt", path("missing")}), 0);
+    EXPECT_EQ(run({"test", path("missing"), "-ot", path("full.txt")}), 0);
+}
+
+#ifndef _WIN32
+TEST_F(TestCommandTest, SymlinkIsNotFollowedForLinkTest) {
+    fs::create_symlink(path("full.txt"), path("link"));
+    EXPECT_EQ(run({"test", "-L", path("link")}), 0);
+    EXPECT_EQ(run({"test", "-h", path("full.txt")}), 1);
+    EXPECT_EQ(run({"test", "-f", path("link")}), 0);
+}
+#endif
+
+// ============================================================================
+// [[ ]] Tests
+// ============================================================================
+
+TEST_F(TestCommandTest, DoubleBracketMatchesPatterns) {
+    EXPECT_EQ(run({"[[", "report.txt", "==", "*.txt", "]]"}), 0);
+    EXPECT_EQ(run({"[[", "report.txt", "!=", "*.txt", "]]"}), 1);
+    EXPECT_EQ(run({"[", "report.txt", "==", "*.txt", "]"}), 1);
+    EXPECT_EQ(run({"[[", "abc123", "=~", "^[a-z]+[0-9]+$", "]]"}), 0);
+    EXPECT_EQ(run({"[[", "abc", "=~", "(", "]]"}), 2);
+}
+
+TEST_F(TestCommandTest, DoubleBracketCombinesWithAndOr) {
+    EXPECT_EQ(run({"[[", "a", "&&", "b", "]]"}), 0);
+    EXPECT_EQ(run({"[[", "a", "&&", "", "]]"}), 1);
+    EXPECT_EQ(run({"[[", "", "||", "b", "]]"}), 0);
+    EXPECT_EQ(run({"[[", "!", "-e", path("missing"), "&&", "(", "x", "<", "y", ")", "]]"}), 0);
+    // -a and -o combine only for test and [
+    EXPECT_EQ(run({"[[", "a", "-a", "b", "]]"}), 2);
+    EXPECT_EQ(run({"[", "a", "-a", "b", "]"}), 0);
+}
+
+#ifndef _WIN32
+TEST_F(TestCommandTest, WriteTestSeesReadOnlyMount) {
+    // Mode bits allow writing here, root's above all, but the mount does not
+    std::ifstream mounts("/proc/mounts");
+    std::string device, mountpoint, type, options, line;
+    std::string readOnly;
+    while (mounts >> device >> mountpoint >> type >> options && std::getline(mounts, line)) {
+        if ((options == "ro" || options.compare(0, 3, "ro,") == 0) && access(mountpoint.c_str(), F_OK) == 0) {
+            readOnly = mountpoint;
+            break;
+        }
+    }
+    if (readOnly.empty()) GTEST_SKIP() << "no read-only mount";
+    EXPECT_EQ(run({"test", "-w", readOnly}), 1);
+    EXPECT_EQ(run({"test", "-w", path("full.txt")}), 0);
+}
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file test_tree_copier.cpp
+ * @brief Unit tests for TreeCopier
+ */
+
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include "core/TreeCopier.hpp"
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class TreeCopierTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / "termidash_tree_copier_test";
+        fs::remove_all(root);
+        fs::create_directories(root / "src" / "a" / "b");
+        std::ofstream(root / "src" / "top.txt") << "top";
+        std::ofstream(root / "src" / "a" / "one.txt") << "one";
+        std::ofstream(root / "src" / "a" / "b" / "two.txt") << std::string(1 << 20, 'x');
+        fs::create_symlink("a/one.txt", root / "src" / "link");
+    }
+
+    void TearDown() override {
+        fs::permissions(root / "src", fs::perms::owner_all, fs::perm_options::add);
+        fs::remove_all(root);
+    }
+
+    static std::string contents(const fs::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream out;
+        out << in.rdbuf();
+        return out.str();
+    }
+
+    static struct stat statOf(const fs::path& path) {
+        struct stat st {};
+        lstat(path.c_str(), &st);
+        return st;
+    }
+
+    fs::path root;
+};
+
+// ============================================================================
+// Copy Tests
+// ============================================================================
+
+TEST_F(TreeCopierTest, CopiesSingleFile) {
+    TreeCopier copier({});
+    copier.add((root / "src" / "top.txt").string(), (root / "copy.txt").string());
+    ASSERT_TRUE(copier.run());
+    EXPECT_EQ(contents(root / "copy.txt"), "top");
+    EXPECT_EQ(copier.progress().files, 1u);
+    EXPECT_EQ(copier.progress().bytes, 3u);
+}
+
+TEST_F(TreeCopierTest, OverwritesExistingFile) {
+    std::ofstream(root / "copy.txt") << "a much longer old content";
+    TreeCopier copier({});
+    copier.add((root / "src" / "top.txt").string(), (root / "copy.txt").string());
+    ASSERT_TRUE(copier.run());
+    EXPECT_EQ(contents(root / "copy.txt"), "top");
+}
+
+TEST_F(TreeCopierTest, CopiesTreeRecursively) {
+    TreeCopier::Options options;
+    options.recursive = true;
+    TreeCopier copier(options);
+    copier.add((root / "src").string(), (root / "dst").string());
+    ASSERT_TRUE(copier.run()) << copier.errors().front();
+
+    EXPECT_EQ(contents(root / "dst" / "top.txt"), "top");
+    EXPECT_EQ(contents(root / "dst" / "a" / "one.txt"), "one");
+    EXPECT_EQ(contents(root / "dst" / "a" / "b" / "two.txt"), std::string(1 << 20, 'x'));
+    ASSERT_TRUE(fs::is_symlink(root / "dst" / "link"));
+    EXPECT_EQ(fs::read_symlink(root / "dst" / "link"), "a/one.txt");
+
+    auto progress = copier.progress();
+    EXPECT_EQ(progress.files, 4u);
+    EXPECT_EQ(progress.directories, 3u);
+}
+
+TEST_F(TreeCopierTest, ReadOnlyDirectoryIsFilledBeforeItsModeIsSet) {
+    chmod((root / "src" / "a").c_str(), 0555);
+    TreeCopier::Options options;
+    options.recursive = true;
+    TreeCopier copier(options);
+    copier.add((root / "src").string(), (root / "dst").string());
+    bool ok = copier.run();
+    chmod((root / "src" / "a").c_str(), 0755);
+    ASSERT_TRUE(ok);
+    EXPECT_TRUE(fs::exists(root / "dst" / "a" / "b" / "two.txt"));
+    EXPECT_EQ(statOf(root / "dst" / "a").st_mode & 07777, 0555u);
+    chmod((root / "dst" / "a").c_str(), 0755);
+}
+
+TEST_F(TreeCopierTest, PreserveKeepsModeAndTimes) {
+    fs::path file = root / "src" / "a" / "one.txt";
+    chmod(file.c_str(), 0640);
+    struct timespec times[2] = {{1000000000, 123456789}, {1200000000, 987654321}};
+    utimensat(AT_FDCWD, file.c_str(), times, 0);
+    utimensat(AT_FDCWD, (root / "src" / "a").c_str(), times, 0);
+
+    TreeCopier::Options options;
+    options.recursive = true;
+    options.preserve = true;
+    TreeCopier copier(options);
+    copier.add((root / "src").string(), (root / "dst").string());
+    ASSERT_TRUE(copier.run());
+
+    auto st = statOf(root / "dst" / "a" / "one.txt");
+    EXPECT_EQ(st.st_mode & 07777, 0640u);
+    EXPECT_EQ(st.st_mtim.tv_sec, 1200000000);
+    EXPECT_EQ(st.st_mtim.tv_nsec, 987654321);
+    EXPECT_EQ(statOf(root / "dst" / "a").st_mtim.tv_sec, 1200000000);
+}
+
+TEST_F(TreeCopierTest, ReportsProgress) {
+    TreeCopier::Options options;
+    options.recursive = true;
+    TreeCopier::Progress last;
+    int calls = 0;
+    options.progress = [&](const TreeCopier::Progress& progress) {
+        last = progress;
+        ++calls;
+    };
+    TreeCopier copier(options);
+    copier.add((root / "src").string(), (root / "dst").string());
+    ASSERT_TRUE(copier.run());
+    EXPECT_GE(calls, 1);
+    EXPECT_EQ(last.files, 4u);
+    EXPECT_EQ(last.bytes, 6u + (1u << 20));
+}
+
+// ============================================================================
+// Error Tests
+// ============================================================================
+
+TEST_F(TreeCopierTest, DirectoryNeedsRecursive) {
+    TreeCopier copier({});
+    copier.add((root / "src").string(), (root / "dst").string());
+    EXPECT_FALSE(copier.run());
+    ASSERT_EQ(copier.errors().size(), 1u);
+    EXPECT_NE(copier.errors()[0].find("-r not specified"), std::string::npos);
+    EXPECT_FALSE(fs::exists(root / "dst"));
+}
+
+TEST_F(TreeCopierTest, RejectsSameFile) {
+    TreeCopier copier({});
+    copier.add((root / "src" / "top.txt").string(), (root / "src" / "a" / ".." / "top.txt").string());
+    EXPECT_FALSE(copier.run());
+    ASSERT_EQ(copier.errors().size(), 1u);
+    EXPECT_NE(copier.errors()[0].find("are the same file"), std::string::npos);
+    EXPECT_EQ(contents(root / "src" / "top.txt"), "top");
+}
+
+TEST_F(TreeCopierTest, RejectsCopyIntoItself) {
+    TreeCopier::Options options;
+    options.recursive = true;
+    TreeCopier copier(options);
+    copier.add((root / "src").string(), (root / "src" / "a" / "inside").string());
+    EXPECT_FALSE(copier.run());
+    ASSERT_EQ(copier.errors().size(), 1u);
+    EXPECT_NE(copier.errors()[0].find("into itself"), std::string::npos);
+    EXPECT_FALSE(fs::exists(root / "src" / "a" / "inside"));
+}
+
+TEST_F(TreeCopierTest, MissingSource) {
+    TreeCopier copier({});
+    copier.add((root / "missing").string(), (root / "dst").string());
+    EXPECT_FALSE(copier.run());
+    ASSERT_EQ(copier.errors().size(), 1u);
+    EXPECT_NE(copier.errors()[0].find("No such file"), std::string::npos);
+}
+
+#endif // _WIN32
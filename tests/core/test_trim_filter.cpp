@@ -0,0 +1,71 @@
+/**
+ * @file test_trim_filter.cpp
+ * @brief Unit tests for the streaming `|>` line trimmer
+ */
+
+#include <gtest/gtest.h>
+#include "core/TrimFilter.hpp"
+#include "core/Parser.hpp"
+#include <sstream>
+
+using namespace termidash;
+
+namespace {
+
+// Feed input in blocks of the given size the way TrimFilter::run does
+std::string trimInBlocks(const std::string& input, size_t blockSize) {
+    TrimFilter trimmer;
+    std::string out, block;
+    for (size_t pos = 0; pos < input.size(); pos += blockSize) {
+        block += input.substr(pos, blockSize);
+        size_t consumed = 0;
+        size_t kept = trimmer.filter(&block[0], block.size(), consumed);
+        out.append(block, 0, kept);
+        block.erase(0, consumed);
+    }
+    if (trimmer.pendingNewline()) out += '\n';
+    return out;
+}
+
+std::string runTrim(const std::string& input, size_t blockSize) {
+    std::istringstream in(input);
+    std::ostringstream out, err;
+    ExecContext ctx(in, out, err);
+    TrimFilter::run(ctx, blockSize);
+    return out.str();
+}
+
+} // namespace
+
+TEST(TrimFilterTest, TrimsInPlace) {
+    std::string data = "  one  \n\ttwo\t\n";
+    TrimFilter trimmer;
+    size_t consumed = 0;
+    size_t kept = trimmer.filter(&data[0], data.size(), consumed);
+    EXPECT_EQ(data.substr(0, kept), "one\ntwo\n");
+    EXPECT_EQ(consumed, data.size());
+    EXPECT_FALSE(trimmer.pendingNewline());
+}
+
+TEST(TrimFilterTest, BlockBoundariesDoNotChangeOutput) {
+    std::string input = "  alpha beta  \n \t \n\tgamma\t\t\n   delta   epsilon\n\n  zeta  ";
+    std::string expected = "alpha beta\ngamma\ndelta   epsilon\nzeta\n";
+    EXPECT_EQ(Parser::applyTrimToLines(input), expected);
+    for (size_t blockSize = 1; blockSize <= input.size(); ++blockSize) {
+        EXPECT_EQ(trimInBlocks(input, blockSize), expected) << "block size " << blockSize;
+    }
+}
+
+TEST(TrimFilterTest, RunStreamsThroughContext) {
+    std::string input, expected;
+    for (int i = 0; i < 5000; ++i) {
+        input += "   line " + std::to_string(i) + "  \n";
+        expected += "line " + std::to_string(i) + "\n";
+    }
+    EXPECT_EQ(runTrim(input, 64), expected);
+}
+
+TEST(TrimFilterTest, RunKeepsInnerWhitespaceLongerThanBlock) {
+    std::string gap(1000, ' ');
+    EXPECT_EQ(runTrim("a" + gap + "b" + gap + "\n", 16), "a" + gap + "b\n");
+}
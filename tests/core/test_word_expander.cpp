@@ -0,0 +1,254 @@
+/**
+ * @file test_word_expander.cpp
+ * @brief Unit tests for the WordExpander class
+ */
+
+#include <gtest/gtest.h>
+#include "core/WordExpander.hpp"
+#include "core/AliasManager.hpp"
+#include "core/Parser.hpp"
+#include "core/VariableManager.hpp"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using namespace termidash;
+
+class WordExpanderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        VariableManager::instance().set("WX_NAME", "world");
+        VariableManager::instance().set("WX_SPLIT", "a  b c");
+    }
+
+    void TearDown() override {
+        VariableManager::instance().unset("WX_NAME");
+        VariableManager::instance().unset("WX_SPLIT");
+        AliasManager::instance().unset("wxll");
+        AliasManager::instance().unset("wxcount");
+    }
+
+    std::vector<std::string> words(const std::string& text) {
+        source = text;
+        expander.expand(source, result);
+        return result.words();
+    }
+
+    // Parse one statement and expand it stage by stage
+    void expandStages(const std::string& text) {
+        std::vector<Token> tokens;
+        Lexer::lex(text, tokens);
+        pipeline = Parser::parsePipeline(tokens.data(), tokens.data() + tokens.size());
+        result.clear();
+        for (const auto& stage : pipeline.stages) expander.expandStage(stage, result);
+    }
+
+    std::vector<std::string> stageWords(size_t index) {
+        const ExpandedCommand::Stage& stage = result.stages()[index];
+        std::vector<std::string> out;
+        for (uint32_t i = 0; i < stage.wordCount; ++i) out.emplace_back(result.tokens()[stage.firstWord + i].text);
+        return out;
+    }
+
+    WordExpander expander{[](const std::string& cmd) { return "<" + cmd + ">\n"; }};
+    ExpandedCommand result;
+    std::string source;
+    ast::Pipeline pipeline;
+};
+
+// ============================================================================
+// Fast Path Tests
+// ============================================================================
+
+TEST_F(WordExpanderTest, PlainWordsViewTheSource) {
+    EXPECT_EQ(words("ls -la /tmp"), (std::vector<std::string>{"ls", "-la", "/tmp"}));
+    ASSERT_EQ(result.tokens().size(), 3);
+    EXPECT_EQ(result.tokens()[0].text.data(), source.data());
+    EXPECT_EQ(result.tokens()[2].text.data(), source.data() + 7);
+}
+
+TEST_F(WordExpanderTest, IsPlain) {
+    EXPECT_TRUE(WordExpander::isPlain("file.txt"));
+    EXPECT_FALSE(WordExpander::isPlain("$HOME"));
+    EXPECT_FALSE(WordExpander::isPlain("*.txt"));
+    EXPECT_FALSE(WordExpander::isPlain("\"quoted\""));
+    EXPECT_FALSE(WordExpander::isPlain("{a,b}"));
+}
+
+TEST_F(WordExpanderTest, OperatorsPassThrough) {
+    words("echo $WX_NAME | wc -c > out");
+    ASSERT_EQ(result.tokens().size(), 7);
+    EXPECT_EQ(result.tokens()[2].kind, TokenKind::Pipe);
+    EXPECT_EQ(result.tokens()[5].kind, TokenKind::Redirect);
+    EXPECT_EQ(result.text(), "echo world | wc -c > out");
+}
+
+// ============================================================================
+// Parameter Expansion Tests
+// ============================================================================
+
+TEST_F(WordExpanderTest, Variables) {
+    EXPECT_EQ(words("echo $WX_NAME ${WX_NAME}s x$WX_NAME"),
+              (std::vector<std::string>{"echo", "world", "worlds", "xworld"}));
+}
+
+TEST_F(WordExpanderTest, UnquotedResultsAreFieldSplit) {
+    EXPECT_EQ(words("args $WX_SPLIT"), (std::vector<std::string>{"args", "a", "b", "c"}));
+    EXPECT_EQ(words("args \"$WX_SPLIT\""), (std::vector<std::string>{"args", "a  b c"}));
+}
+
+TEST_F(WordExpanderTest, SingleQuotesAreLiteral) {
+    EXPECT_EQ(words("echo '$WX_NAME' \"$WX_NAME\""), (std::vector<std::string>{"echo", "$WX_NAME", "world"}));
+}
+
+TEST_F(WordExpanderTest, EmptyExpansions) {
+    EXPECT_EQ(words("echo $WX_UNSET_VAR end"), (std::vector<std::string>{"echo", "end"}));
+    EXPECT_EQ(words("echo \"\" end"), (std::vector<std::string>{"echo", "", "end"}));
+}
+
+TEST_F(WordExpanderTest, Arithmetic) {
+    VariableManager::instance().set("WX_N", "4");
+    EXPECT_EQ(words("echo $(( $WX_N * 3 + 1 ))"), (std::vector<std::string>{"echo", "13"}));
+    VariableManager::instance().unset("WX_N");
+}
+
+TEST_F(WordExpanderTest, ArithmeticCommandStaysOneWord) {
+    VariableManager::instance().set("WX_N", "4");
+    EXPECT_EQ(words("(($WX_N < 5))"), (std::vector<std::string>{"((4 < 5))"}));
+    VariableManager::instance().unset("WX_N");
+}
+
+// ============================================================================
+// Command Substitution Tests
+// ============================================================================
+
+TEST_F(WordExpanderTest, CommandSubstitutionStripsTrailingNewlines) {
+    EXPECT_EQ(words("echo x$(date)y"), (std::vector<std::string>{"echo", "x<date>y"}));
+    EXPECT_EQ(words("echo `pwd`"), (std::vector<std::string>{"echo", "<pwd>"}));
+}
+
+TEST_F(WordExpanderTest, QuotedSubstitutionWithInnerQuotes) {
+    EXPECT_EQ(words("echo \"$(printf \"a b\")\""), (std::vector<std::string>{"echo", "<printf \"a b\">"}));
+}
+
+TEST_F(WordExpanderTest, SubstitutedOperatorsAreText) {
+    WordExpander pipeOut([](const std::string&) { return "a | b"; });
+    source = "echo $(x)";
+    pipeOut.expand(source, result);
+    ASSERT_EQ(result.tokens().size(), 4);
+    for (const auto& token : result.tokens()) EXPECT_EQ(token.kind, TokenKind::Word);
+}
+
+TEST_F(WordExpanderTest, NoHandlerKeepsSubstitution) {
+    WordExpander plain;
+    source = "echo $(date)";
+    plain.expand(source, result);
+    EXPECT_EQ(result.words(), (std::vector<std::string>{"echo", "$(date)"}));
+}
+
+// ============================================================================
+// Alias, Brace and Glob Tests
+// ============================================================================
+
+TEST_F(WordExpanderTest, AliasOnFirstWordOnly) {
+    AliasManager::instance().set("wxll", "ls -l");
+    EXPECT_EQ(words("wxll wxll"), (std::vector<std::string>{"ls", "-l", "wxll"}));
+}
+
+TEST_F(WordExpanderTest, BraceExpansion) {
+    EXPECT_EQ(words("touch f{1..3}.txt"), (std::vector<std::string>{"touch", "f1.txt", "f2.txt", "f3.txt"}));
+    EXPECT_EQ(words("echo \"{a,b}\""), (std::vector<std::string>{"echo", "{a,b}"}));
+}
+
+TEST_F(WordExpanderTest, BracesWithoutListStayLiteral) {
+    EXPECT_EQ(words("find . -exec echo {} ;"),
+              (std::vector<std::string>{"find", ".", "-exec", "echo", "{}", ";"}));
+    EXPECT_EQ(words("echo a{b}c"), (std::vector<std::string>{"echo", "a{b}c"}));
+}
+
+TEST_F(WordExpanderTest, GlobExpansion) {
+    fs::path dir = fs::temp_directory_path() / "word_expander_glob";
+    fs::create_directories(dir);
+    std::ofstream(dir / "one.txt") << "1";
+    std::ofstream(dir / "two.txt") << "2";
+
+    std::string pattern = (dir / "*.txt").string();
+    auto out = words("ls " + pattern + " \"" + pattern + "\"");
+    fs::remove_all(dir);
+
+    ASSERT_EQ(out.size(), 4);
+    EXPECT_EQ(fs::path(out[1]).filename(), "one.txt");
+    EXPECT_EQ(fs::path(out[2]).filename(), "two.txt");
+    EXPECT_EQ(out[3], pattern);
+}
+
+TEST_F(WordExpanderTest, LoneBracketIsNotAGlob) {
+    EXPECT_EQ(words("[ -f x ]"), (std::vector<std::string>{"[", "-f", "x", "]"}));
+}
+
+TEST_F(WordExpanderTest, ConditionalWordsAreNotSplitOrGlobbed) {
+    VariableManager::instance().set("WX_EMPTY", "");
+    EXPECT_EQ(words("[[ $WX_SPLIT == *.txt ]]"), (std::vector<std::string>{"[[", "a  b c", "==", "*.txt", "]]"}));
+    EXPECT_EQ(words("[[ $WX_EMPTY == \"\" ]]"), (std::vector<std::string>{"[[", "", "==", "", "]]"}));
+    VariableManager::instance().unset("WX_EMPTY");
+}
+
+// ============================================================================
+// Text Expansion Tests
+// ============================================================================
+
+TEST_F(WordExpanderTest, ExpandTextKeepsQuotes) {
+    EXPECT_EQ(expander.expandText("grep \"$WX_NAME\" '$WX_NAME'"), "grep \"world\" '$WX_NAME'");
+}
+
+TEST_F(WordExpanderTest, ResultIsReusable) {
+    words("echo $WX_SPLIT");
+    EXPECT_EQ(words("echo $WX_NAME"), (std::vector<std::string>{"echo", "world"}));
+}
+
+// ============================================================================
+// Stage Tests
+// ============================================================================
+
+TEST_F(WordExpanderTest, StageWordsAreExpanded) {
+    expandStages("echo $WX_SPLIT | wc -c");
+    ASSERT_EQ(result.stages().size(), 2u);
+    EXPECT_EQ(stageWords(0), (std::vector<std::string>{"echo", "a", "b", "c"}));
+    EXPECT_EQ(stageWords(1), (std::vector<std::string>{"wc", "-c"}));
+    EXPECT_EQ(result.tokens()[0].text.data(), pipeline.stages[0].words[0].data());
+}
+
+TEST_F(WordExpanderTest, RedirectionTargetIsOneWord) {
+    expandStages("cat < $WX_SPLIT > \"$WX_NAME.txt\" 2>&1");
+    ASSERT_EQ(result.stages().size(), 1u);
+    EXPECT_EQ(stageWords(0), (std::vector<std::string>{"cat"}));
+    ASSERT_EQ(result.redirects().size(), 3u);
+    EXPECT_EQ(result.redirects()[0].kind, ast::RedirectKind::Input);
+    EXPECT_EQ(result.target(result.redirects()[0]), "a  b c");
+    EXPECT_EQ(result.target(result.redirects()[1]), "world.txt");
+    EXPECT_EQ(result.redirects()[2].target, ExpandedCommand::NoTarget);
+    EXPECT_EQ(result.text(), "cat < a  b c > world.txt 2>&1");
+}
+
+TEST_F(WordExpanderTest, AliasMayAddStages) {
+    AliasManager::instance().set("wxcount", "sort -u | wc -l >> log");
+    expandStages("wxcount -c < in");
+    ASSERT_EQ(result.stages().size(), 2u);
+    EXPECT_EQ(stageWords(0), (std::vector<std::string>{"sort", "-u"}));
+    EXPECT_EQ(stageWords(1), (std::vector<std::string>{"wc", "-l", "-c"}));
+    EXPECT_EQ(result.text(), "sort -u | wc -l -c >> log < in");
+}
+
+TEST_F(WordExpanderTest, WordListHasNoAlias) {
+    AliasManager::instance().set("wxll", "ls -l");
+    std::vector<Token> tokens;
+    Lexer::lex("wxll b", tokens);
+    pipeline = Parser::parsePipeline(tokens.data(), tokens.data() + tokens.size());
+    expander.expandStage(pipeline.stages[0], result, false);
+    EXPECT_EQ(result.words(), (std::vector<std::string>{"wxll", "b"}));
+}
+
+TEST_F(WordExpanderTest, ConditionalStageIsNotSplit) {
+    expandStages("[[ $WX_SPLIT == *.txt ]]");
+    EXPECT_EQ(stageWords(0), (std::vector<std::string>{"[[", "a  b c", "==", "*.txt", "]]"}));
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_worker_pool.cpp
+ * @brief Unit tests for WorkerPool, TaskGroup and WorkStealingGroup
+ */
+
+#include <gtest/gtest.h>
+#include "core/WorkerPool.hpp"
+#include "core/RingBuffer.hpp"
+#include <atomic>
+#include <set>
+#include <thread>
+
+using namespace termidash;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Wait (bounded) until the pool has retired its surplus workers
+void waitForRetire(WorkerPool& pool, size_t workers) {
+    for (int i = 0; i < 500 && pool.size() > workers; ++i) std::this_thread::sleep_for(10ms);
+}
+
+} // namespace
+
+TEST(WorkerPoolTest, RunsAllTasks) {
+    std::atomic<int> count{0};
+    {
+        TaskGroup group;
+        for (int i = 0; i < 100; ++i) group.run([&count]() { ++count; });
+    }
+    EXPECT_EQ(count, 100);
+}
+
+TEST(WorkerPoolTest, WorkersAreReused) {
+    WorkerPool pool(4, 50ms);
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    for (int round = 0; round < 20; ++round) {
+        TaskGroup group(pool);
+        group.run([&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(ids.size(), 1);
+}
+
+TEST(WorkerPoolTest, BlockedTasksDoNotStarveOthers) {
+    // A pipeline wider than the retained worker count must not deadlock
+    WorkerPool pool(1, 20ms);
+    const int stages = 8;
+    std::vector<std::shared_ptr<StreamBridge>> bridges;
+    for (int i = 0; i < stages - 1; ++i) bridges.push_back(std::make_shared<StreamBridge>(4096));
+
+    std::string result;
+    {
+        TaskGroup group(pool);
+        for (int i = 0; i < stages; ++i) {
+            group.run([&, i]() {
+                if (i == 0) {
+                    for (int n = 0; n < 20000; ++n) bridges[0]->out() << n << '\n';
+                    bridges[0]->closeWriter();
+                    return;
+                }
+                std::string line, last;
+                while (std::getline(bridges[i - 1]->in(), line)) {
+                    if (i < stages - 1) bridges[i]->out() << line << '\n';
+                    last = line;
+                }
+                if (i < stages - 1) bridges[i]->closeWriter();
+                else result = last;
+            });
+        }
+    }
+    EXPECT_EQ(result, "19999");
+    EXPECT_EQ(pool.size(), stages);
+
+    // Surplus workers retire after the idle timeout
+    waitForRetire(pool, 1);
+    EXPECT_EQ(pool.size(), 1);
+}
+
+TEST(WorkerPoolTest, DefaultPoolRetainsOnePerCore) {
+    EXPECT_GE(WorkerPool::instance().retained(), 1);
+}
+
+// ============================================================================
+// WorkStealingGroup Tests
+// ============================================================================
+
+namespace {
+
+// Spawn a full tree of the given depth and fan-out, counting the nodes
+void spawnTree(WorkStealingGroup& group, std::atomic<int>& nodes, int depth) {
+    ++nodes;
+    if (depth == 0) return;
+    for (int i = 0; i < 4; ++i) group.spawn([&group, &nodes, depth]() { spawnTree(group, nodes, depth - 1); });
+}
+
+} // namespace
+
+TEST(WorkStealingGroupTest, RunsSpawnedTasks) {
+    WorkStealingGroup group(4);
+    std::atomic<int> nodes{0};
+    group.spawn([&]() { spawnTree(group, nodes, 6); });
+    group.run();
+    EXPECT_EQ(nodes, (1 << 14) / 3); // (4^7 - 1) / 3
+}
+
+TEST(WorkStealingGroupTest, UsesAFixedNumberOfThreads) {
+    WorkStealingGroup group(3);
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    for (int i = 0; i < 200; ++i) {
+        group.spawn([&]() {
+            std::this_thread::sleep_for(100us);
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+    group.run();
+    EXPECT_LE(ids.size(), 3u);
+    EXPECT_GE(ids.size(), 1u);
+}
+
+TEST(WorkStealingGroupTest, CancelDropsQueuedTasks) {
+    WorkStealingGroup group(2);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 1000; ++i) {
+        group.spawn([&]() {
+            if (++ran == 10) group.cancel();
+        });
+    }
+    group.run();
+    EXPECT_LT(ran, 1000);
+
+    // The group can be used again afterwards
+    ran = 0;
+    group.spawn([&]() { ++ran; });
+    group.run();
+    EXPECT_EQ(ran, 1);
+}
+
+TEST(WorkStealingGroupTest, RunWithNothingQueued) {
+    WorkStealingGroup group;
+    group.run();
+    EXPECT_GE(group.workers(), 1u);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file test_child_reaper.cpp
+ * @brief Unit tests for the ChildReaper class
+ */
+
+#include <gtest/gtest.h>
+#include "platform/linux/ChildReaper.hpp"
+#include <chrono>
+#include <csignal>
+#include <thread>
+#include <unistd.h>
+
+using termidash::platform::ChildStatus;
+using termidash::platform::linux_platform::ChildReaper;
+
+namespace {
+
+pid_t startChild(int exitCode, int delayMs = 0) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (delayMs > 0) usleep(delayMs * 1000);
+        _exit(exitCode);
+    }
+    return pid;
+}
+
+} // namespace
+
+TEST(ChildReaperTest, WaitReturnsExitStatus) {
+    pid_t pid = startChild(7);
+    ASSERT_GT(pid, 0);
+    ChildReaper::instance().add(pid);
+    ChildStatus status = ChildReaper::instance().wait(pid);
+    EXPECT_EQ(status.pid, pid);
+    EXPECT_EQ(status.exitCode, 7);
+    EXPECT_EQ(status.termSignal, 0);
+}
+
+TEST(ChildReaperTest, ChildIsReapedWithoutWaiter) {
+    pid_t pid = startChild(0);
+    ASSERT_GT(pid, 0);
+    ChildReaper::instance().add(pid);
+
+    // No zombie is left even though nobody waits
+    bool gone = false;
+    for (int i = 0; i < 200 && !gone; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        gone = ::kill(pid, 0) == -1;
+    }
+    EXPECT_TRUE(gone);
+
+    ChildStatus status;
+    EXPECT_TRUE(ChildReaper::instance().poll(pid, status));
+    EXPECT_EQ(status.exitCode, 0);
+}
+
+TEST(ChildReaperTest, PollWhileRunning) {
+    pid_t pid = startChild(2, 300);
+    ASSERT_GT(pid, 0);
+    ChildReaper::instance().add(pid);
+    ChildStatus status;
+    EXPECT_FALSE(ChildReaper::instance().poll(pid, status));
+    status = ChildReaper::instance().wait(pid);
+    EXPECT_EQ(status.exitCode, 2);
+}
+
+TEST(ChildReaperTest, KilledChildReportsSignal) {
+    pid_t pid = startChild(0, 5000);
+    ASSERT_GT(pid, 0);
+    ChildReaper::instance().add(pid);
+    ::kill(pid, SIGKILL);
+    ChildStatus status = ChildReaper::instance().wait(pid);
+    EXPECT_EQ(status.termSignal, SIGKILL);
+    EXPECT_EQ(status.exitCode, 128 + SIGKILL);
+}